@@ -29,6 +29,7 @@ bool create_access_context(mdcursor_t* cursor, col_index_t col_idx, bool make_wr
     acxt->col_details = col;
     if (make_writable)
     {
+        update_table_indexes(table->cxt, table->table_id, row + 1);
         acxt->writable_data = get_writable_table_data(table, make_writable) + offset_to_table_data;
     }
     else
@@ -0,0 +1,842 @@
+#include "internal.h"
+
+// The type of a fixed argument, named argument or array element.
+typedef struct ca_type__
+{
+    uint8_t type; // As md_custom_attribute_argument_t.type, SERIALIZATION_TYPE_TAGGED_OBJECT for object
+    uint8_t element_type; // Element type of ELEMENT_TYPE_SZARRAY
+    uint8_t underlying_type; // Underlying type of the enum value or elements
+    mdToken enum_type;
+    char const* enum_type_name;
+    uint32_t enum_type_name_len;
+} ca_type_t;
+
+static bool is_enum_underlying_type(uint8_t type)
+{
+    return type == ELEMENT_TYPE_BOOLEAN
+        || type == ELEMENT_TYPE_CHAR
+        || (type >= ELEMENT_TYPE_I1 && type <= ELEMENT_TYPE_U8);
+}
+
+static bool is_primitive_type(uint8_t type)
+{
+    return type >= ELEMENT_TYPE_BOOLEAN && type <= ELEMENT_TYPE_R8;
+}
+
+static bool skip_custom_modifiers(uint8_t const** sig, size_t* sig_len)
+{
+    uint8_t const* s = *sig;
+    size_t len = *sig_len;
+    uint8_t elem;
+    while (len > 0 && (*s == ELEMENT_TYPE_CMOD_REQD || *s == ELEMENT_TYPE_CMOD_OPT))
+    {
+        uint32_t type;
+        if (!read_u8(&s, &len, &elem)
+            || !decompress_u32(&s, &len, &type))
+            return false;
+    }
+    *sig = s;
+    *sig_len = len;
+    return true;
+}
+
+// Generic instantiations nest, so limit the depth of the types skipped below.
+#define MAX_SKIPPED_TYPE_DEPTH 64
+
+static bool skip_type(uint8_t const** sig, size_t* sig_len, uint32_t depth);
+
+static bool skip_method_signature(uint8_t const** sig, size_t* sig_len, uint32_t depth)
+{
+    uint8_t call_conv;
+    uint32_t count;
+    if (!read_u8(sig, sig_len, &call_conv))
+        return false;
+    if ((call_conv & IMAGE_CEE_CS_CALLCONV_GENERIC) != 0 && !decompress_u32(sig, sig_len, &count))
+        return false;
+    if (!decompress_u32(sig, sig_len, &count)
+        || !skip_type(sig, sig_len, depth))
+        return false;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (*sig_len > 0 && **sig == ELEMENT_TYPE_SENTINEL)
+        {
+            (*sig)++;
+            (*sig_len)--;
+        }
+        if (!skip_type(sig, sig_len, depth))
+            return false;
+    }
+    return true;
+}
+
+// Skip a Type, RetType or Param - ECMA-335 II.23.2.
+static bool skip_type(uint8_t const** sig, size_t* sig_len, uint32_t depth)
+{
+    uint8_t elem;
+    uint32_t value;
+    if (depth > MAX_SKIPPED_TYPE_DEPTH
+        || !skip_custom_modifiers(sig, sig_len)
+        || !read_u8(sig, sig_len, &elem))
+        return false;
+
+    if (elem == ELEMENT_TYPE_VOID
+        || is_primitive_type(elem)
+        || elem == ELEMENT_TYPE_STRING
+        || elem == ELEMENT_TYPE_OBJECT
+        || elem == ELEMENT_TYPE_I
+        || elem == ELEMENT_TYPE_U
+        || elem == ELEMENT_TYPE_TYPEDBYREF)
+        return true;
+
+    switch (elem)
+    {
+    case ELEMENT_TYPE_CLASS:
+    case ELEMENT_TYPE_VALUETYPE:
+    case ELEMENT_TYPE_VAR:
+    case ELEMENT_TYPE_MVAR:
+        return decompress_u32(sig, sig_len, &value);
+    case ELEMENT_TYPE_PTR:
+    case ELEMENT_TYPE_BYREF:
+    case ELEMENT_TYPE_SZARRAY:
+    case ELEMENT_TYPE_PINNED:
+        return skip_type(sig, sig_len, depth + 1);
+    case ELEMENT_TYPE_GENERICINST:
+    {
+        uint32_t count;
+        if (!read_u8(sig, sig_len, &elem)
+            || (elem != ELEMENT_TYPE_CLASS && elem != ELEMENT_TYPE_VALUETYPE)
+            || !decompress_u32(sig, sig_len, &value)
+            || !decompress_u32(sig, sig_len, &count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!skip_type(sig, sig_len, depth + 1))
+                return false;
+        }
+        return true;
+    }
+    case ELEMENT_TYPE_ARRAY:
+    {
+        // Element type, rank, sizes and lower bounds - II.23.2.13.
+        uint32_t count;
+        int32_t bound;
+        if (!skip_type(sig, sig_len, depth + 1)
+            || !decompress_u32(sig, sig_len, &value)
+            || !decompress_u32(sig, sig_len, &count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!decompress_u32(sig, sig_len, &value))
+                return false;
+        }
+        if (!decompress_u32(sig, sig_len, &count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!decompress_i32(sig, sig_len, &bound))
+                return false;
+        }
+        return true;
+    }
+    case ELEMENT_TYPE_FNPTR:
+        return skip_method_signature(sig, sig_len, depth + 1);
+    default:
+        return false;
+    }
+}
+
+// Get the type of the value__ field of an enum TypeDef.
+static bool get_typedef_underlying_type(mdcursor_t type_def, uint8_t* underlying_type)
+{
+    mdcursor_t field;
+    uint32_t count;
+    if (!md_get_column_value_as_range(type_def, mdtTypeDef_FieldList, &field, &count))
+        return false;
+
+    for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&field))
+    {
+        mdcursor_t target;
+        uint32_t flags;
+        if (!md_resolve_indirect_cursor(field, &target)
+            || !md_get_column_value_as_constant(target, mdtField_Flags, &flags))
+            return false;
+
+        if (IsFdStatic(flags))
+            continue;
+
+        uint8_t const* sig;
+        uint32_t sig_len;
+        if (!md_get_column_value_as_blob(target, mdtField_Signature, &sig, &sig_len))
+            return false;
+
+        size_t len = sig_len;
+        uint8_t call_conv;
+        if (!read_u8(&sig, &len, &call_conv)
+            || call_conv != IMAGE_CEE_CS_CALLCONV_FIELD
+            || !skip_custom_modifiers(&sig, &len)
+            || !read_u8(&sig, &len, underlying_type))
+            return false;
+
+        return is_enum_underlying_type(*underlying_type);
+    }
+    return false;
+}
+
+static bool copy_name(char* buffer, size_t buffer_len, char const* name, size_t name_len)
+{
+    if (name_len >= buffer_len)
+        return false;
+    memcpy(buffer, name, name_len);
+    buffer[name_len] = '\0';
+    return true;
+}
+
+// The underlying type of each TypeDef row, or ELEMENT_TYPE_END if it isn't an enum.
+typedef struct enum_underlying_types__
+{
+    uint32_t row_count;
+    uint8_t* types;
+} enum_underlying_types_t;
+
+static enum_underlying_types_t* build_enum_underlying_types(mdcxt_t* cxt)
+{
+    mdtable_t* table = &cxt->tables[mdtid_TypeDef];
+    uint32_t row_count = table->cxt != NULL ? table->row_count : 0;
+    size_t alloc_size;
+    if (!safe_add_size(sizeof(enum_underlying_types_t), row_count, &alloc_size))
+        return NULL;
+
+    enum_underlying_types_t* types = (enum_underlying_types_t*)calloc(1, alloc_size);
+    if (types == NULL)
+        return NULL;
+    types->row_count = row_count;
+    types->types = (uint8_t*)(types + 1);
+    for (uint32_t row = 1; row <= row_count; ++row)
+    {
+        uint8_t underlying_type;
+        if (get_typedef_underlying_type(create_cursor(table, row), &underlying_type))
+            types->types[row - 1] = underlying_type;
+    }
+    return types;
+}
+
+// Get the underlying type of an enum TypeDef through a side table, so attributes that use
+// the same enums don't walk their fields each time.
+static bool get_enum_underlying_type(mdcursor_t type_def, uint8_t* underlying_type)
+{
+    mdcxt_t* cxt = CursorTable(&type_def)->cxt;
+    enum_underlying_types_t* types = (enum_underlying_types_t*)get_side_table(cxt, mdst_EnumUnderlyingTypes);
+    if (types == NULL)
+    {
+        types = build_enum_underlying_types(cxt);
+        if (types != NULL)
+            types = (enum_underlying_types_t*)publish_side_table(cxt, mdst_EnumUnderlyingTypes, types);
+    }
+
+    // Rows added after the side table was built are read directly.
+    uint32_t row = CursorRow(&type_def);
+    if (types == NULL || row > types->row_count)
+        return get_typedef_underlying_type(type_def, underlying_type);
+
+    *underlying_type = types->types[row - 1];
+    return *underlying_type != ELEMENT_TYPE_END;
+}
+
+// Resolve an enum from a constructor signature. TypeRefs to types in the same module are resolved through their TypeDef.
+static bool resolve_enum_token(md_custom_attribute_iterator_t* iterator, mdToken type, ca_type_t* ca_type)
+{
+    mdcursor_t c;
+    if (!md_token_to_cursor(iterator->_handle, type, &c))
+        return false;
+
+    ca_type->enum_type = type;
+    ca_type->enum_type_name = NULL;
+    ca_type->enum_type_name_len = 0;
+
+    if (ExtractTokenType(type) == mdtid_TypeRef)
+    {
+        mdToken scope;
+        char const* type_namespace;
+        char const* type_name;
+        if (md_get_column_value_as_token(c, mdtTypeRef_ResolutionScope, &scope)
+            && ExtractTokenType(scope) == mdtid_Module
+            && md_get_column_value_as_utf8(c, mdtTypeRef_TypeNamespace, &type_namespace)
+            && md_get_column_value_as_utf8(c, mdtTypeRef_TypeName, &type_name)
+            && find_toplevel_typedef(extract_mdcxt(iterator->_handle), type_namespace, type_name, &c))
+        {
+            return get_enum_underlying_type(c, &ca_type->underlying_type);
+        }
+    }
+    else if (ExtractTokenType(type) == mdtid_TypeDef)
+    {
+        return get_enum_underlying_type(c, &ca_type->underlying_type);
+    }
+
+    return iterator->_resolve_enum != NULL
+        && iterator->_resolve_enum(iterator->_context, type, NULL, 0, &ca_type->underlying_type)
+        && is_enum_underlying_type(ca_type->underlying_type);
+}
+
+// Resolve an enum from a serialized type name, e.g. "N.E, A, Version=1.0.0.0".
+// Only top-level types without an assembly qualifier are looked up in the handle.
+static bool resolve_enum_name(md_custom_attribute_iterator_t* iterator, char const* name, uint32_t name_len, ca_type_t* ca_type)
+{
+    ca_type->enum_type = mdTokenNil;
+    ca_type->enum_type_name = name;
+    ca_type->enum_type_name_len = name_len;
+
+    char const* last_dot = NULL;
+    bool local = name_len > 0;
+    for (uint32_t i = 0; i < name_len && local; ++i)
+    {
+        if (name[i] == '.')
+            last_dot = &name[i];
+        else if (name[i] == ',' || name[i] == '+' || name[i] == '[' || name[i] == '\\')
+            local = false;
+    }
+
+    if (local)
+    {
+        char type_namespace[512];
+        char type_name[512];
+        size_t namespace_len = last_dot != NULL ? (size_t)(last_dot - name) : 0;
+        char const* simple_name = last_dot != NULL ? last_dot + 1 : name;
+        mdcursor_t type_def;
+        if (copy_name(type_namespace, sizeof(type_namespace), name, namespace_len)
+            && copy_name(type_name, sizeof(type_name), simple_name, name_len - (size_t)(simple_name - name))
+            && find_toplevel_typedef(extract_mdcxt(iterator->_handle), type_namespace, type_name, &type_def))
+        {
+            return get_enum_underlying_type(type_def, &ca_type->underlying_type);
+        }
+    }
+
+    return iterator->_resolve_enum != NULL
+        && iterator->_resolve_enum(iterator->_context, mdTokenNil, name, name_len, &ca_type->underlying_type)
+        && is_enum_underlying_type(ca_type->underlying_type);
+}
+
+static bool is_system_type(mdhandle_t handle, mdToken type)
+{
+    mdcursor_t c;
+    char const* type_namespace;
+    char const* type_name;
+    if (ExtractTokenType(type) == mdtid_TypeRef)
+    {
+        return md_token_to_cursor(handle, type, &c)
+            && md_get_column_value_as_utf8(c, mdtTypeRef_TypeNamespace, &type_namespace)
+            && md_get_column_value_as_utf8(c, mdtTypeRef_TypeName, &type_name)
+            && strcmp(type_namespace, "System") == 0
+            && strcmp(type_name, "Type") == 0;
+    }
+    else if (ExtractTokenType(type) == mdtid_TypeDef)
+    {
+        return md_token_to_cursor(handle, type, &c)
+            && md_get_column_value_as_utf8(c, mdtTypeDef_TypeNamespace, &type_namespace)
+            && md_get_column_value_as_utf8(c, mdtTypeDef_TypeName, &type_name)
+            && strcmp(type_namespace, "System") == 0
+            && strcmp(type_name, "Type") == 0;
+    }
+    return false;
+}
+
+// Read a parameter type of the constructor signature, or the element type of an array parameter.
+static bool read_parameter_type(md_custom_attribute_iterator_t* iterator, bool is_element, uint8_t* type)
+{
+    uint8_t elem;
+    if (!skip_custom_modifiers(&iterator->_signature, &iterator->_signature_len)
+        || !read_u8(&iterator->_signature, &iterator->_signature_len, &elem))
+        return false;
+
+    if (is_primitive_type(elem) || elem == ELEMENT_TYPE_STRING)
+    {
+        *type = elem;
+        return true;
+    }
+
+    switch (elem)
+    {
+    case ELEMENT_TYPE_OBJECT:
+        *type = SERIALIZATION_TYPE_TAGGED_OBJECT;
+        return true;
+    case ELEMENT_TYPE_SZARRAY:
+        *type = ELEMENT_TYPE_SZARRAY;
+        return !is_element;
+    case ELEMENT_TYPE_CLASS:
+    case ELEMENT_TYPE_VALUETYPE:
+        *type = elem;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool read_signature_type(md_custom_attribute_iterator_t* iterator, bool is_element, ca_type_t* ca_type);
+
+// Read the type argument of the constructor's generic parent that a '!n' parameter refers to.
+static bool read_type_argument(md_custom_attribute_iterator_t* iterator, bool is_element, ca_type_t* ca_type)
+{
+    uint8_t elem;
+    uint32_t index;
+    if (!read_u8(&iterator->_signature, &iterator->_signature_len, &elem)
+        || !decompress_u32(&iterator->_signature, &iterator->_signature_len, &index)
+        || index >= iterator->_type_arg_count)
+        return false;
+
+    uint8_t const* type_arg = iterator->_type_args;
+    size_t type_arg_len = iterator->_type_args_len;
+    for (uint32_t i = 0; i < index; ++i)
+    {
+        if (!skip_type(&type_arg, &type_arg_len, 0))
+            return false;
+    }
+
+    // Read the type argument in place of the parameter.
+    // Type arguments can't refer to type parameters, so none are available while it is read.
+    uint8_t const* signature = iterator->_signature;
+    size_t signature_len = iterator->_signature_len;
+    uint32_t type_arg_count = iterator->_type_arg_count;
+    iterator->_signature = type_arg;
+    iterator->_signature_len = type_arg_len;
+    iterator->_type_arg_count = 0;
+    bool success = read_signature_type(iterator, is_element, ca_type);
+    iterator->_signature = signature;
+    iterator->_signature_len = signature_len;
+    iterator->_type_arg_count = type_arg_count;
+    return success;
+}
+
+static bool read_signature_type(md_custom_attribute_iterator_t* iterator, bool is_element, ca_type_t* ca_type)
+{
+    if (!skip_custom_modifiers(&iterator->_signature, &iterator->_signature_len))
+        return false;
+
+    if (iterator->_signature_len > 0 && *iterator->_signature == ELEMENT_TYPE_VAR)
+        return read_type_argument(iterator, is_element, ca_type);
+
+    uint8_t type;
+    if (!read_parameter_type(iterator, is_element, &type))
+        return false;
+
+    if (type == ELEMENT_TYPE_CLASS || type == ELEMENT_TYPE_VALUETYPE)
+    {
+        uint32_t type_def_or_ref;
+        mdtable_id_t table;
+        uint32_t row_id;
+        if (!decompress_u32(&iterator->_signature, &iterator->_signature_len, &type_def_or_ref)
+            || !decompose_coded_index(type_def_or_ref, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
+            return false;
+
+        mdToken tk = CreateTokenType(table) | row_id;
+
+        if (type == ELEMENT_TYPE_CLASS)
+        {
+            if (!is_system_type(iterator->_handle, tk))
+                return false;
+            type = SERIALIZATION_TYPE_TYPE;
+        }
+        else
+        {
+            if (!resolve_enum_token(iterator, tk, ca_type))
+                return false;
+            type = SERIALIZATION_TYPE_ENUM;
+        }
+    }
+
+    if (is_element)
+    {
+        ca_type->element_type = type;
+        return true;
+    }
+
+    ca_type->type = type;
+    if (type == ELEMENT_TYPE_SZARRAY)
+        return read_signature_type(iterator, true, ca_type);
+    return true;
+}
+
+static bool read_ser_string(md_custom_attribute_iterator_t* iterator, char const** str, uint32_t* str_len)
+{
+    if (iterator->_blob_len == 0)
+        return false;
+
+    if (*iterator->_blob == 0xff)
+    {
+        iterator->_blob++;
+        iterator->_blob_len--;
+        *str = NULL;
+        *str_len = 0;
+        return true;
+    }
+
+    uint32_t len;
+    if (!decompress_u32(&iterator->_blob, &iterator->_blob_len, &len)
+        || len > iterator->_blob_len)
+        return false;
+
+    *str = (char const*)iterator->_blob;
+    *str_len = len;
+    iterator->_blob += len;
+    iterator->_blob_len -= len;
+    return true;
+}
+
+// Read a FieldOrPropType from the blob - ECMA-335 II.23.3.
+static bool read_serialized_type(md_custom_attribute_iterator_t* iterator, bool is_element, ca_type_t* ca_type)
+{
+    uint8_t type;
+    if (!read_u8(&iterator->_blob, &iterator->_blob_len, &type))
+        return false;
+
+    if (type == SERIALIZATION_TYPE_ENUM)
+    {
+        char const* name;
+        uint32_t name_len;
+        if (!read_ser_string(iterator, &name, &name_len)
+            || name == NULL
+            || !resolve_enum_name(iterator, name, name_len, ca_type))
+            return false;
+    }
+    else if (type == ELEMENT_TYPE_SZARRAY)
+    {
+        if (is_element)
+            return false;
+        ca_type->type = type;
+        return read_serialized_type(iterator, true, ca_type);
+    }
+    else if (!is_primitive_type(type)
+        && type != ELEMENT_TYPE_STRING
+        && type != SERIALIZATION_TYPE_TYPE
+        && type != SERIALIZATION_TYPE_TAGGED_OBJECT)
+    {
+        return false;
+    }
+
+    if (is_element)
+        ca_type->element_type = type;
+    else
+        ca_type->type = type;
+    return true;
+}
+
+static void init_type(ca_type_t* ca_type)
+{
+    memset(ca_type, 0, sizeof(*ca_type));
+}
+
+// Decode a value of the type, which is SERIALIZATION_TYPE_ENUM for enums, into the argument.
+static bool read_value(md_custom_attribute_iterator_t* iterator, uint8_t type, ca_type_t const* ca_type, md_custom_attribute_argument_t* argument)
+{
+    if (type == SERIALIZATION_TYPE_TAGGED_OBJECT)
+    {
+        ca_type_t boxed;
+        init_type(&boxed);
+        if (!read_serialized_type(iterator, false, &boxed))
+            return false;
+        // Objects can't box another object.
+        if (boxed.type == SERIALIZATION_TYPE_TAGGED_OBJECT)
+            return false;
+        argument->is_boxed = true;
+        return read_value(iterator, boxed.type, &boxed, argument);
+    }
+
+    argument->is_enum = false;
+    argument->enum_type = mdTokenNil;
+    argument->enum_type_name = NULL;
+    argument->enum_type_name_len = 0;
+    if (type == SERIALIZATION_TYPE_ENUM || (type == ELEMENT_TYPE_SZARRAY && ca_type->element_type == SERIALIZATION_TYPE_ENUM))
+    {
+        argument->is_enum = type == SERIALIZATION_TYPE_ENUM;
+        argument->enum_type = ca_type->enum_type;
+        argument->enum_type_name = ca_type->enum_type_name;
+        argument->enum_type_name_len = ca_type->enum_type_name_len;
+        if (type == SERIALIZATION_TYPE_ENUM)
+            type = ca_type->underlying_type;
+    }
+
+    argument->type = type;
+    uint8_t const** blob = &iterator->_blob;
+    size_t* blob_len = &iterator->_blob_len;
+    switch (type)
+    {
+    case ELEMENT_TYPE_BOOLEAN:
+    {
+        uint8_t v;
+        if (!read_u8(blob, blob_len, &v))
+            return false;
+        argument->value.boolean = v != 0;
+        return true;
+    }
+    case ELEMENT_TYPE_CHAR:
+        return read_u16(blob, blob_len, &argument->value.character);
+    case ELEMENT_TYPE_I1:
+    {
+        int8_t v;
+        if (!read_i8(blob, blob_len, &v))
+            return false;
+        argument->value.i = v;
+        return true;
+    }
+    case ELEMENT_TYPE_U1:
+    {
+        uint8_t v;
+        if (!read_u8(blob, blob_len, &v))
+            return false;
+        argument->value.u = v;
+        return true;
+    }
+    case ELEMENT_TYPE_I2:
+    {
+        int16_t v;
+        if (!read_i16(blob, blob_len, &v))
+            return false;
+        argument->value.i = v;
+        return true;
+    }
+    case ELEMENT_TYPE_U2:
+    {
+        uint16_t v;
+        if (!read_u16(blob, blob_len, &v))
+            return false;
+        argument->value.u = v;
+        return true;
+    }
+    case ELEMENT_TYPE_I4:
+    {
+        int32_t v;
+        if (!read_i32(blob, blob_len, &v))
+            return false;
+        argument->value.i = v;
+        return true;
+    }
+    case ELEMENT_TYPE_U4:
+    {
+        uint32_t v;
+        if (!read_u32(blob, blob_len, &v))
+            return false;
+        argument->value.u = v;
+        return true;
+    }
+    case ELEMENT_TYPE_I8:
+        return read_i64(blob, blob_len, &argument->value.i);
+    case ELEMENT_TYPE_U8:
+        return read_u64(blob, blob_len, &argument->value.u);
+    case ELEMENT_TYPE_R4:
+    {
+        uint32_t v;
+        if (!read_u32(blob, blob_len, &v))
+            return false;
+        memcpy(&argument->value.r4, &v, sizeof(v));
+        return true;
+    }
+    case ELEMENT_TYPE_R8:
+    {
+        uint64_t v;
+        if (!read_u64(blob, blob_len, &v))
+            return false;
+        memcpy(&argument->value.r8, &v, sizeof(v));
+        return true;
+    }
+    case ELEMENT_TYPE_STRING:
+    case SERIALIZATION_TYPE_TYPE:
+        return read_ser_string(iterator, &argument->value.string.str, &argument->value.string.len);
+    case ELEMENT_TYPE_SZARRAY:
+    {
+        uint32_t count;
+        if (!read_u32(blob, blob_len, &count))
+            return false;
+
+        argument->value.array.element_type = ca_type->element_type == SERIALIZATION_TYPE_ENUM
+            ? ca_type->underlying_type
+            : ca_type->element_type;
+        argument->value.array.count = count;
+        if (count == UINT32_MAX || count == 0)
+            return true;
+
+        // Every element takes at least one byte.
+        if (count > *blob_len)
+            return false;
+        if (iterator->_array_depth == ARRAY_SIZE(iterator->_arrays))
+            return false;
+
+        uint32_t depth = iterator->_array_depth++;
+        iterator->_arrays[depth].remaining = count;
+        iterator->_arrays[depth].element_type = ca_type->element_type;
+        iterator->_arrays[depth].underlying_type = ca_type->underlying_type;
+        iterator->_arrays[depth].enum_type = ca_type->enum_type;
+        iterator->_arrays[depth].enum_type_name = ca_type->enum_type_name;
+        iterator->_arrays[depth].enum_type_name_len = ca_type->enum_type_name_len;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool md_custom_attribute_iterator_init(mdcursor_t custom_attribute, md_resolve_enum_fn_t resolve_enum, void* context, md_custom_attribute_iterator_t* iterator)
+{
+    if (CursorNull(&custom_attribute) || CursorEnd(&custom_attribute) || iterator == NULL)
+        return false;
+
+    if (CursorTable(&custom_attribute)->table_id != mdtid_CustomAttribute)
+        return false;
+
+    memset(iterator, 0, sizeof(*iterator));
+    iterator->_handle = md_extract_handle_from_cursor(custom_attribute);
+    iterator->_resolve_enum = resolve_enum;
+    iterator->_context = context;
+
+    mdcursor_t ctor;
+    uint8_t const* signature;
+    uint32_t signature_len;
+    uint8_t const* blob;
+    uint32_t blob_len;
+    if (!md_get_column_value_as_cursor(custom_attribute, mdtCustomAttribute_Type, &ctor)
+        || !md_get_column_value_as_blob(ctor, CursorTable(&ctor)->table_id == mdtid_MethodDef ? mdtMethodDef_Signature : mdtMemberRef_Signature, &signature, &signature_len)
+        || !md_get_column_value_as_blob(custom_attribute, mdtCustomAttribute_Value, &blob, &blob_len))
+        return false;
+
+    // Constructors are instance methods without generic parameters that return void.
+    size_t sig_len = signature_len;
+    uint8_t call_conv;
+    uint32_t param_count;
+    uint8_t return_type;
+    if (!read_u8(&signature, &sig_len, &call_conv)
+        || (call_conv & IMAGE_CEE_CS_CALLCONV_GENERIC) != 0
+        || !decompress_u32(&signature, &sig_len, &param_count)
+        || !skip_custom_modifiers(&signature, &sig_len)
+        || !read_u8(&signature, &sig_len, &return_type)
+        || return_type != ELEMENT_TYPE_VOID)
+        return false;
+
+    iterator->_signature = signature;
+    iterator->_signature_len = sig_len;
+    iterator->_fixed_remaining = param_count;
+
+    // Constructors of generic attributes are MemberRefs on a TypeSpec instantiating the attribute type.
+    // Keep its type arguments, which the constructor's parameters refer to as '!n'.
+    mdToken parent;
+    mdcursor_t type_spec;
+    uint8_t const* type_spec_sig;
+    uint32_t type_spec_sig_len;
+    if (CursorTable(&ctor)->table_id == mdtid_MemberRef
+        && md_get_column_value_as_token(ctor, mdtMemberRef_Class, &parent)
+        && ExtractTokenType(parent) == mdtid_TypeSpec)
+    {
+        uint8_t elem;
+        uint32_t generic_type;
+        if (!md_token_to_cursor(iterator->_handle, parent, &type_spec)
+            || !md_get_column_value_as_blob(type_spec, mdtTypeSpec_Signature, &type_spec_sig, &type_spec_sig_len))
+            return false;
+
+        size_t type_spec_len = type_spec_sig_len;
+        if (read_u8(&type_spec_sig, &type_spec_len, &elem) && elem == ELEMENT_TYPE_GENERICINST)
+        {
+            if (!read_u8(&type_spec_sig, &type_spec_len, &elem)
+                || !decompress_u32(&type_spec_sig, &type_spec_len, &generic_type)
+                || !decompress_u32(&type_spec_sig, &type_spec_len, &iterator->_type_arg_count))
+                return false;
+            iterator->_type_args = type_spec_sig;
+            iterator->_type_args_len = type_spec_len;
+        }
+    }
+
+    // An empty blob is allowed for a constructor without parameters.
+    if (blob_len == 0)
+    {
+        iterator->_named_read = true;
+        return param_count == 0;
+    }
+
+    uint16_t prolog;
+    iterator->_blob = blob;
+    iterator->_blob_len = blob_len;
+    return read_u16(&iterator->_blob, &iterator->_blob_len, &prolog)
+        && prolog == 0x0001;
+}
+
+static bool next_argument(md_custom_attribute_iterator_t* iterator, md_custom_attribute_argument_t* argument)
+{
+    ca_type_t ca_type;
+    init_type(&ca_type);
+    argument->name = NULL;
+    argument->name_len = 0;
+    argument->is_boxed = false;
+
+    if (iterator->_array_depth > 0)
+    {
+        uint32_t depth = iterator->_array_depth - 1;
+        uint8_t element_type = iterator->_arrays[depth].element_type;
+        ca_type.underlying_type = iterator->_arrays[depth].underlying_type;
+        ca_type.enum_type = iterator->_arrays[depth].enum_type;
+        ca_type.enum_type_name = iterator->_arrays[depth].enum_type_name;
+        ca_type.enum_type_name_len = iterator->_arrays[depth].enum_type_name_len;
+        // Pop the array before reading its last element, which can be a boxed array itself.
+        if (--iterator->_arrays[depth].remaining == 0)
+            iterator->_array_depth--;
+
+        argument->kind = mdcaa_ArrayElement;
+        return read_value(iterator, element_type, &ca_type, argument);
+    }
+
+    if (iterator->_fixed_remaining > 0)
+    {
+        iterator->_fixed_remaining--;
+        argument->kind = mdcaa_Fixed;
+        return read_signature_type(iterator, false, &ca_type)
+            && read_value(iterator, ca_type.type, &ca_type, argument);
+    }
+
+    iterator->_named_remaining--;
+    uint8_t kind;
+    if (!read_u8(&iterator->_blob, &iterator->_blob_len, &kind))
+        return false;
+
+    if (kind == SERIALIZATION_TYPE_FIELD)
+        argument->kind = mdcaa_NamedField;
+    else if (kind == SERIALIZATION_TYPE_PROPERTY)
+        argument->kind = mdcaa_NamedProperty;
+    else
+        return false;
+
+    return read_serialized_type(iterator, false, &ca_type)
+        && read_ser_string(iterator, &argument->name, &argument->name_len)
+        && argument->name != NULL
+        && read_value(iterator, ca_type.type, &ca_type, argument);
+}
+
+bool md_custom_attribute_iterator_next(md_custom_attribute_iterator_t* iterator, md_custom_attribute_argument_t* argument)
+{
+    if (iterator == NULL || argument == NULL || iterator->_failed)
+        return false;
+
+    if (iterator->_array_depth == 0 && iterator->_fixed_remaining == 0)
+    {
+        if (!iterator->_named_read)
+        {
+            uint16_t named_count;
+            if (!read_u16(&iterator->_blob, &iterator->_blob_len, &named_count))
+            {
+                iterator->_failed = true;
+                return false;
+            }
+            iterator->_named_read = true;
+            iterator->_named_remaining = named_count;
+        }
+
+        if (iterator->_named_remaining == 0)
+            return false;
+    }
+
+    if (!next_argument(iterator, argument))
+    {
+        iterator->_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool md_custom_attribute_iterator_failed(md_custom_attribute_iterator_t const* iterator)
+{
+    return iterator == NULL || iterator->_failed;
+}
@@ -1,5 +1,13 @@
 #include "internal.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DECOMPRESS_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define DECOMPRESS_NEON
+#include <arm_neon.h>
+#endif
+
 uint32_t align_to(uint32_t val, uint32_t align)
 {
     assert(align != 0);
@@ -281,15 +289,16 @@ bool decompress_u32(uint8_t const** data, size_t* data_len, uint32_t* o)
 
     uint32_t val;
 
+    // The first byte gives the length, so it must be read before the length can be checked.
+    if (*data_len < 1)
+        return false;
+
     // The valid leading bits are 00, 10, and 110.
     // All others are invalid.
     // PERF: Check for 00 vs 10 first as we get better codegen
     // on Intel/AMD processors (shorter instruction sequences and better branch prediction).
     if ((*s & 0x80) == 0x00)
     {
-        if (*data_len < 1)
-            return false;
-
         *data_len -= 1;
         val = *s++;
     }
@@ -363,6 +372,182 @@ bool decompress_i32(uint8_t const** data, size_t* data_len, int32_t* o)
     return true;
 }
 
+// Number of bytes in a compressed integer, indexed by the top three bits of the first byte.
+// The valid leading bits are 0, 10 and 110, 0 marks an invalid value.
+static uint8_t const compressed_size_by_lead[8] = { 1, 1, 1, 1, 2, 2, 4, 0 };
+
+// Decode one compressed integer without the bit pattern branches of decompress_u32().
+static bool decompress_one(uint8_t const** data, size_t* data_len, uint32_t* value, uint32_t* size)
+{
+    uint8_t const* s = *data;
+    uint32_t len = compressed_size_by_lead[s[0] >> 5];
+    if (len == 0 || *data_len < len)
+        return false;
+
+    switch (len)
+    {
+    case 1:
+        *value = s[0];
+        break;
+    case 2:
+        *value = ((uint32_t)(s[0] & 0x3f) << 8) | s[1];
+        break;
+    default:
+        *value = ((uint32_t)(s[0] & 0x1f) << 24) | ((uint32_t)s[1] << 16) | ((uint32_t)s[2] << 8) | s[3];
+        break;
+    }
+    *data = s + len;
+    *data_len -= len;
+    *size = len;
+    return true;
+}
+
+// Widen 16 single byte values, returns false if any of the bytes starts a longer value.
+static bool try_decompress_u32_block(uint8_t const* data, uint32_t* values)
+{
+#if defined(DECOMPRESS_SSE2)
+    __m128i block = _mm_loadu_si128((__m128i const*)data);
+    if (_mm_movemask_epi8(block) != 0)
+        return false;
+
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(block, zero);
+    __m128i hi = _mm_unpackhi_epi8(block, zero);
+    _mm_storeu_si128((__m128i*)values, _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(values + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(values + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i*)(values + 12), _mm_unpackhi_epi16(hi, zero));
+    return true;
+#elif defined(DECOMPRESS_NEON)
+    uint8x16_t block = vld1q_u8(data);
+    if (vmaxvq_u8(block) >= 0x80)
+        return false;
+
+    uint16x8_t lo = vmovl_u8(vget_low_u8(block));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(block));
+    vst1q_u32(values, vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32(values + 4, vmovl_u16(vget_high_u16(lo)));
+    vst1q_u32(values + 8, vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32(values + 12, vmovl_u16(vget_high_u16(hi)));
+    return true;
+#else
+    for (size_t i = 0; i < 16; ++i)
+    {
+        if (data[i] & 0x80)
+            return false;
+    }
+    for (size_t i = 0; i < 16; ++i)
+        values[i] = data[i];
+    return true;
+#endif
+}
+
+uint32_t md_decompress_u32_many(uint8_t const** data, size_t* data_len, uint32_t count, uint32_t* values)
+{
+    if (data == NULL || *data == NULL || data_len == NULL || (values == NULL && count != 0))
+        return 0;
+
+    uint8_t const* s = *data;
+    size_t len = *data_len;
+    uint32_t i = 0;
+    while (i < count && len > 0)
+    {
+        if (count - i >= 16 && len >= 16 && try_decompress_u32_block(s, &values[i]))
+        {
+            s += 16;
+            len -= 16;
+            i += 16;
+            continue;
+        }
+
+        uint32_t size;
+        if (!decompress_one(&s, &len, &values[i], &size))
+            break;
+        i++;
+    }
+    *data = s;
+    *data_len = len;
+    return i;
+}
+
+// Move the sign from the least significant bit and extend it over the bits missing for the size.
+static int32_t rotate_signed(uint32_t value, uint32_t size)
+{
+    uint32_t sign_mask = size == 1 ? SIGN_MASK_ONEBYTE
+        : size == 2 ? SIGN_MASK_TWOBYTE
+        : SIGN_MASK_FOURBYTE;
+    return (int32_t)((value >> 1) | ((value & 1) ? sign_mask : 0));
+}
+
+static bool try_decompress_i32_block(uint8_t const* data, int32_t* values)
+{
+#if defined(DECOMPRESS_SSE2)
+    if (!try_decompress_u32_block(data, (uint32_t*)values))
+        return false;
+
+    __m128i one = _mm_set1_epi32(1);
+    __m128i sign_mask = _mm_set1_epi32((int)SIGN_MASK_ONEBYTE);
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((__m128i const*)(values + i));
+        __m128i sign = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one));
+        v = _mm_or_si128(_mm_srli_epi32(v, 1), _mm_and_si128(sign, sign_mask));
+        _mm_storeu_si128((__m128i*)(values + i), v);
+    }
+    return true;
+#elif defined(DECOMPRESS_NEON)
+    if (!try_decompress_u32_block(data, (uint32_t*)values))
+        return false;
+
+    uint32x4_t one = vdupq_n_u32(1);
+    uint32x4_t sign_mask = vdupq_n_u32(SIGN_MASK_ONEBYTE);
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        uint32x4_t v = vld1q_u32((uint32_t const*)(values + i));
+        uint32x4_t sign = vnegq_s32(vreinterpretq_s32_u32(vandq_u32(v, one)));
+        v = vorrq_u32(vshrq_n_u32(v, 1), vandq_u32(vreinterpretq_u32_s32(sign), sign_mask));
+        vst1q_u32((uint32_t*)(values + i), v);
+    }
+    return true;
+#else
+    if (!try_decompress_u32_block(data, (uint32_t*)values))
+        return false;
+
+    for (size_t i = 0; i < 16; ++i)
+        values[i] = rotate_signed((uint32_t)values[i], 1);
+    return true;
+#endif
+}
+
+uint32_t md_decompress_i32_many(uint8_t const** data, size_t* data_len, uint32_t count, int32_t* values)
+{
+    if (data == NULL || *data == NULL || data_len == NULL || (values == NULL && count != 0))
+        return 0;
+
+    uint8_t const* s = *data;
+    size_t len = *data_len;
+    uint32_t i = 0;
+    while (i < count && len > 0)
+    {
+        if (count - i >= 16 && len >= 16 && try_decompress_i32_block(s, &values[i]))
+        {
+            s += 16;
+            len -= 16;
+            i += 16;
+            continue;
+        }
+
+        uint32_t value;
+        uint32_t size;
+        if (!decompress_one(&s, &len, &value, &size))
+            break;
+        values[i++] = rotate_signed(value, size);
+    }
+    *data = s;
+    *data_len = len;
+    return i;
+}
+
 // II.23.2
 // This is a big-endian format in the physical form.
 bool compress_u32(uint32_t data, uint8_t* compressed, size_t* compressed_len)
@@ -399,3 +584,47 @@ bool compress_u32(uint32_t data, uint8_t* compressed, size_t* compressed_len)
     }
     return true;
 }
+
+// II.23.2
+// The value is rotated left by one bit, with the sign bit moved to the least significant bit,
+// in the smallest size whose range holds the value. The size is chosen from the signed range,
+// since the rotated form of the smallest value of a range also fits in a smaller size.
+bool compress_i32(int32_t data, uint8_t* compressed, size_t* compressed_len)
+{
+    assert(compressed != NULL && compressed_len != NULL);
+    uint32_t sign_bit = data < 0 ? 1 : 0;
+    uint32_t rotated;
+    if (data >= -0x40 && data <= 0x3f)
+    {
+        if (*compressed_len < 1)
+            return false;
+        rotated = (((uint32_t)data & ~(uint32_t)SIGN_MASK_ONEBYTE) << 1) | sign_bit;
+        compressed[0] = (uint8_t)rotated;
+        *compressed_len = 1;
+    }
+    else if (data >= -0x2000 && data <= 0x1fff)
+    {
+        if (*compressed_len < 2)
+            return false;
+        rotated = (((uint32_t)data & ~(uint32_t)SIGN_MASK_TWOBYTE) << 1) | sign_bit;
+        compressed[0] = (uint8_t)((rotated >> 8) | 0x80);
+        compressed[1] = (uint8_t)rotated;
+        *compressed_len = 2;
+    }
+    else if (data >= -0x10000000 && data <= 0x0fffffff)
+    {
+        if (*compressed_len < 4)
+            return false;
+        rotated = (((uint32_t)data & ~(uint32_t)SIGN_MASK_FOURBYTE) << 1) | sign_bit;
+        compressed[0] = (uint8_t)((rotated >> 24) | 0xc0);
+        compressed[1] = (uint8_t)(rotated >> 16);
+        compressed[2] = (uint8_t)(rotated >> 8);
+        compressed[3] = (uint8_t)rotated;
+        *compressed_len = 4;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
@@ -382,7 +382,7 @@ bool merge_in_delta(mdcxt_t* cxt, mdcxt_t* delta)
     // We don't want to manipulate the heap sizes, so we'll pull the heap offset directly from the delta and use that
     // in the base image.
     uint32_t new_enc_base_id_offset;
-    if (!get_column_value_as_heap_offset(delta_module, mdtModule_EncId, &new_enc_base_id_offset))
+    if (!md_get_column_value_as_heap_offset(delta_module, mdtModule_EncId, &new_enc_base_id_offset))
         return false;
     if (!set_column_value_as_heap_offset(base_module, mdtModule_EncId, new_enc_base_id_offset))
         return false;
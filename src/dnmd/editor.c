@@ -453,6 +453,8 @@ bool insert_row_into_table(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t row_ind
             return false;
     }
 
+    update_table_indexes(cxt, table_id, row_index);
+
     size_t next_row_start_offset = target_table_editor->table->row_size_bytes * (size_t)(row_index - 1);
     size_t last_row_end_offset = target_table_editor->table->row_size_bytes * (size_t)target_table_editor->table->row_count;
 
@@ -671,36 +673,48 @@ uint32_t add_to_string_heap(mdcxt_t* cxt, char const* str)
     return heap_offset;
 }
 
-uint32_t add_to_blob_heap(mdcxt_t* cxt, uint8_t const* data, uint32_t length)
+uint8_t* reserve_blob_heap_slot(mdcxt_t* cxt, uint32_t length, uint32_t* heap_offset)
 {
-    // II.24.2.4 - When the #Blob heap is present, the first entry is always the empty blob.
-    // II.24.2.2 -  Streams need not be there if they are empty.
-    // We can avoid allocating the heap if the only entry is the empty blob.
-    // Columns that point to the blob heap can be 0 if there is no #Blob heap.
-    // In that case, they represent the empty blob.
-    if (length == 0)
-        return 0;
+    assert(length != 0 && heap_offset != NULL);
 
     mdeditor_t* editor = get_editor(cxt);
     if (editor == NULL)
-        return 0;
+        return NULL;
 
-    // TODO: Deduplicate heap
     uint8_t compressed_length[4];
     size_t compressed_length_size = ARRAY_SIZE(compressed_length);
     if (!compress_u32(length, compressed_length, &compressed_length_size))
-        return 0;
+        return NULL;
+
+    if (length > UINT32_MAX - (uint32_t)compressed_length_size)
+        return NULL;
 
     uint32_t heap_slot_size = length + (uint32_t)compressed_length_size;
+    if (!reserve_heap_space(editor, heap_slot_size, mdtc_hblob, false, heap_offset))
+        return NULL;
 
+    uint8_t* slot = editor->blob_heap.heap.ptr + *heap_offset;
+    memcpy(slot, compressed_length, compressed_length_size);
+    return slot + compressed_length_size;
+}
+
+uint32_t add_to_blob_heap(mdcxt_t* cxt, uint8_t const* data, uint32_t length)
+{
+    // II.24.2.4 - When the #Blob heap is present, the first entry is always the empty blob.
+    // II.24.2.2 -  Streams need not be there if they are empty.
+    // We can avoid allocating the heap if the only entry is the empty blob.
+    // Columns that point to the blob heap can be 0 if there is no #Blob heap.
+    // In that case, they represent the empty blob.
+    if (length == 0)
+        return 0;
+
+    // TODO: Deduplicate heap
     uint32_t heap_offset;
-    if (!reserve_heap_space(editor, heap_slot_size, mdtc_hblob, false, &heap_offset))
-    {
+    uint8_t* blob = reserve_blob_heap_slot(cxt, length, &heap_offset);
+    if (blob == NULL)
         return 0;
-    }
 
-    memcpy(editor->blob_heap.heap.ptr + heap_offset, compressed_length, compressed_length_size);
-    memcpy(editor->blob_heap.heap.ptr + heap_offset + compressed_length_size, data, length);
+    memcpy(blob, data, length);
     return heap_offset;
 }
 
@@ -865,3 +879,389 @@ mduserstringcursor_t md_add_userstring_to_heap(mdhandle_t handle, char16_t const
 
     return add_to_user_string_heap(cxt, userstring);
 }
+
+// The largest number of sort keys of any table - see get_table_keys().
+#define MAX_TABLE_KEY_COUNT 3
+
+typedef struct row_sort_key__
+{
+    uint32_t keys[MAX_TABLE_KEY_COUNT];
+    uint32_t row;
+} row_sort_key_t;
+
+static int compare_row_sort_keys(void const* lhs, void const* rhs)
+{
+    row_sort_key_t const* l = (row_sort_key_t const*)lhs;
+    row_sort_key_t const* r = (row_sort_key_t const*)rhs;
+    for (size_t i = 0; i < MAX_TABLE_KEY_COUNT; i++)
+    {
+        if (l->keys[i] != r->keys[i])
+            return l->keys[i] < r->keys[i] ? -1 : 1;
+    }
+
+    // Break ties with the current row to keep the sort stable.
+    return l->row < r->row ? -1 : (l->row > r->row ? 1 : 0);
+}
+
+// Rewrite every table and coded index column that refers to a row of the reordered table.
+static bool remap_row_references(mdcxt_t* cxt, mdtable_id_t reordered_table, uint32_t const* old_to_new)
+{
+    uint32_t reordered_row_count = cxt->tables[reordered_table].row_count;
+    for (mdtable_id_t table_id = mdtid_First; table_id < mdtid_End; table_id++)
+    {
+        mdtable_t* table = &cxt->tables[table_id];
+        if (table->cxt == NULL || table->row_count == 0)
+            continue;
+
+        for (uint8_t i = 0; i < table->column_count; i++)
+        {
+            mdtcol_t col_details = table->column_details[i];
+            bool is_table_index = (col_details & mdtc_idx_table) == mdtc_idx_table && ExtractTable(col_details) == reordered_table;
+            bool is_coded_index = (col_details & mdtc_idx_coded) == mdtc_idx_coded && is_coded_index_target(col_details, reordered_table);
+            if (!is_table_index && !is_coded_index)
+                continue;
+
+            col_index_t col = index_to_col(i, table_id);
+            for (uint32_t row = 1; row <= table->row_count; row++)
+            {
+                mdcursor_t c = create_cursor(table, row);
+                access_cxt_t acxt;
+                if (!create_access_context(&c, col, true, &acxt))
+                    return false;
+
+                uint32_t raw;
+                if (!read_column_data(&acxt, &raw))
+                    return false;
+
+                mdtable_id_t target_table = reordered_table;
+                uint32_t target_row = raw;
+                if (is_coded_index && !decompose_coded_index(raw, col_details, &target_table, &target_row))
+                    return false;
+
+                // Nil references and references one past the end of the table don't move.
+                if (target_table != reordered_table || target_row == 0 || target_row > reordered_row_count)
+                    continue;
+
+                uint32_t new_row = old_to_new[target_row - 1];
+                if (new_row == target_row)
+                    continue;
+
+                raw = new_row;
+                if (is_coded_index && !compose_coded_index(TokenFromRid(new_row, CreateTokenType(reordered_table)), col_details, &raw))
+                    return false;
+
+                if (!write_column_data(&acxt, raw))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Physically reorder the rows of a table so that new row i + 1 is the row new_to_old[i].
+// References to the table are updated and the cumulative mapping from each original row
+// to its current row is maintained in 'remaps'.
+static bool reorder_table_rows(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t const* new_to_old, uint32_t** remaps)
+{
+    mdtable_t* table = &cxt->tables[table_id];
+    uint32_t row_count = table->row_count;
+    size_t row_size = table->row_size_bytes;
+
+    uint8_t* data = get_writable_table_data(table, true);
+    if (data == NULL)
+        return false;
+
+    uint8_t* original_rows = (uint8_t*)malloc(row_size * row_count);
+    uint32_t* old_to_new = (uint32_t*)malloc(sizeof(uint32_t) * row_count);
+    if (original_rows == NULL || old_to_new == NULL)
+    {
+        free(original_rows);
+        free(old_to_new);
+        return false;
+    }
+
+    if (remaps[table_id] == NULL)
+    {
+        remaps[table_id] = (uint32_t*)malloc(sizeof(uint32_t) * row_count);
+        if (remaps[table_id] == NULL)
+        {
+            free(original_rows);
+            free(old_to_new);
+            return false;
+        }
+        for (uint32_t i = 0; i < row_count; i++)
+            remaps[table_id][i] = i + 1;
+    }
+
+    memcpy(original_rows, data, row_size * row_count);
+    for (uint32_t i = 0; i < row_count; i++)
+    {
+        memcpy(data + row_size * i, original_rows + row_size * (new_to_old[i] - 1), row_size);
+        old_to_new[new_to_old[i] - 1] = i + 1;
+    }
+    free(original_rows);
+
+    update_table_indexes(cxt, table_id, 1);
+
+    // The rows have moved, so record the move even if the references can't all be updated.
+    for (uint32_t i = 0; i < row_count; i++)
+        remaps[table_id][i] = old_to_new[remaps[table_id][i] - 1];
+
+    bool success = remap_row_references(cxt, table_id, old_to_new);
+    free(old_to_new);
+    return success;
+}
+
+// Sort the rows of a table by its keys if they are no longer in order.
+static bool sort_table_rows(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t** remaps, bool* reordered)
+{
+    *reordered = false;
+    mdtable_t* table = &cxt->tables[table_id];
+    md_key_info_t const* keys;
+    uint8_t key_count = get_table_keys(table_id, &keys);
+    assert(key_count <= MAX_TABLE_KEY_COUNT);
+
+    row_sort_key_t* sort_keys = (row_sort_key_t*)calloc(table->row_count, sizeof(row_sort_key_t));
+    if (sort_keys == NULL)
+        return false;
+
+    bool is_sorted = true;
+    for (uint32_t row = 1; row <= table->row_count; row++)
+    {
+        row_sort_key_t* sort_key = &sort_keys[row - 1];
+        sort_key->row = row;
+        mdcursor_t c = create_cursor(table, row);
+        for (uint8_t i = 0; i < key_count; i++)
+        {
+            access_cxt_t acxt;
+            uint32_t value;
+            if (!create_access_context(&c, index_to_col(keys[i].index, table_id), false, &acxt)
+                || !read_column_data(&acxt, &value))
+            {
+                free(sort_keys);
+                return false;
+            }
+            // Invert descending keys so all keys can be compared in ascending order.
+            sort_key->keys[i] = keys[i].descending ? UINT32_MAX - value : value;
+        }
+
+        if (row > 1 && compare_row_sort_keys(&sort_keys[row - 2], sort_key) > 0)
+            is_sorted = false;
+    }
+
+    if (is_sorted)
+    {
+        free(sort_keys);
+        return true;
+    }
+
+    qsort(sort_keys, table->row_count, sizeof(row_sort_key_t), compare_row_sort_keys);
+
+    uint32_t* new_to_old = (uint32_t*)malloc(sizeof(uint32_t) * table->row_count);
+    if (new_to_old == NULL)
+    {
+        free(sort_keys);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < table->row_count; i++)
+        new_to_old[i] = sort_keys[i].row;
+    free(sort_keys);
+
+    bool success = reorder_table_rows(cxt, table_id, new_to_old, remaps);
+    free(new_to_old);
+    *reordered = success;
+    return success;
+}
+
+md_remove_indirection_result_t md_remove_indirection_tables(mdhandle_t handle, md_token_remap_fn_t remap, void* context)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return MD_INDIRECTION_TABLES_ERROR;
+
+    static mdtable_id_t const indirect_tables[] = { mdtid_FieldPtr, mdtid_MethodPtr, mdtid_ParamPtr, mdtid_EventPtr, mdtid_PropertyPtr };
+
+    bool has_indirect_tables = false;
+    for (size_t i = 0; i < ARRAY_SIZE(indirect_tables); i++)
+    {
+        if (cxt->tables[indirect_tables[i]].cxt != NULL && cxt->tables[indirect_tables[i]].row_count != 0)
+            has_indirect_tables = true;
+    }
+
+    if (!has_indirect_tables)
+        return MD_INDIRECTION_TABLES_REMOVED;
+
+    // Tokens in delta images and EnC logs refer to the existing rows, so they can't be reordered.
+    if ((cxt->context_flags & mdc_minimal_delta)
+        || cxt->tables[mdtid_ENCLog].row_count != 0
+        || cxt->tables[mdtid_ENCMap].row_count != 0)
+    {
+        return MD_INDIRECTION_TABLES_NOT_REMOVABLE;
+    }
+
+    for (mdtable_id_t i = mdtid_First; i < mdtid_End; i++)
+    {
+        if (cxt->tables[i].cxt != NULL && cxt->tables[i].is_adding_new_row)
+            return MD_INDIRECTION_TABLES_NOT_REMOVABLE;
+    }
+
+    // Validate that every indirection table is a permutation of its target table before changing anything.
+    uint8_t* seen_rows = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(indirect_tables); i++)
+    {
+        mdtable_t* indirect_table = &cxt->tables[indirect_tables[i]];
+        if (indirect_table->cxt == NULL || indirect_table->row_count == 0)
+            continue;
+
+        mdtable_t* target_table = &cxt->tables[ExtractTable(indirect_table->column_details[0])];
+        if (target_table->row_count != indirect_table->row_count)
+            return MD_INDIRECTION_TABLES_NOT_REMOVABLE;
+
+        seen_rows = (uint8_t*)calloc(target_table->row_count, sizeof(uint8_t));
+        if (seen_rows == NULL)
+            return MD_INDIRECTION_TABLES_ERROR;
+
+        col_index_t col = index_to_col(0, indirect_tables[i]);
+        for (uint32_t row = 1; row <= indirect_table->row_count; row++)
+        {
+            mdcursor_t c = create_cursor(indirect_table, row);
+            access_cxt_t acxt;
+            uint32_t target_row;
+            if (!create_access_context(&c, col, false, &acxt)
+                || !read_column_data(&acxt, &target_row)
+                || target_row == 0
+                || target_row > target_table->row_count
+                || seen_rows[target_row - 1])
+            {
+                free(seen_rows);
+                return MD_INDIRECTION_TABLES_NOT_REMOVABLE;
+            }
+            seen_rows[target_row - 1] = 1;
+        }
+        free(seen_rows);
+    }
+
+    bool was_sorted[MDTABLE_MAX_COUNT] = { 0 };
+    for (mdtable_id_t i = mdtid_First; i < mdtid_End; i++)
+        was_sorted[i] = cxt->tables[i].cxt != NULL && cxt->tables[i].is_sorted;
+
+    uint32_t* remaps[MDTABLE_MAX_COUNT] = { 0 };
+    bool success = true;
+
+    // Move the rows of each target table into the order of its indirection table.
+    // The list columns index the indirection table, so they are already correct for the new order.
+    for (size_t i = 0; success && i < ARRAY_SIZE(indirect_tables); i++)
+    {
+        mdtable_t* indirect_table = &cxt->tables[indirect_tables[i]];
+        if (indirect_table->cxt == NULL || indirect_table->row_count == 0)
+            continue;
+
+        mdtable_id_t target_table_id = ExtractTable(indirect_table->column_details[0]);
+        uint32_t* new_to_old = (uint32_t*)malloc(sizeof(uint32_t) * indirect_table->row_count);
+        if (new_to_old == NULL)
+        {
+            success = false;
+            break;
+        }
+
+        col_index_t col = index_to_col(0, indirect_tables[i]);
+        for (uint32_t row = 1; row <= indirect_table->row_count; row++)
+        {
+            mdcursor_t c = create_cursor(indirect_table, row);
+            access_cxt_t acxt;
+            success = create_access_context(&c, col, false, &acxt)
+                && read_column_data(&acxt, &new_to_old[row - 1]);
+            if (!success)
+                break;
+        }
+
+        success = success && reorder_table_rows(cxt, target_table_id, new_to_old, remaps);
+        free(new_to_old);
+        if (!success)
+            break;
+
+        // Point the list columns at the target table and drop the indirection table.
+        for (mdtable_id_t table_id = mdtid_First; table_id < mdtid_End; table_id++)
+        {
+            mdtable_t* table = &cxt->tables[table_id];
+            if (table->cxt == NULL)
+                continue;
+
+            for (uint8_t j = 0; j < table->column_count; j++)
+            {
+                mdtcol_t* col_details = &table->column_details[j];
+                if ((*col_details & mdtc_idx_table) == mdtc_idx_table && ExtractTable(*col_details) == indirect_tables[i])
+                {
+                    // The indirection table and the target table have the same number of rows, so the column width is unchanged.
+                    *col_details = (*col_details & ~mdtc_timask) | InsertTable(target_table_id);
+                    update_table_indexes(cxt, table_id, 1);
+                }
+            }
+        }
+
+        mdeditor_t* editor = get_editor(cxt);
+        if (editor == NULL)
+        {
+            success = false;
+            break;
+        }
+
+        update_table_indexes(cxt, indirect_tables[i], 1);
+        if (editor->tables[indirect_tables[i]].data.ptr != NULL)
+            free_mdmem(cxt, editor->tables[indirect_tables[i]].data.ptr);
+        editor->tables[indirect_tables[i]].data.ptr = NULL;
+        editor->tables[indirect_tables[i]].data.size = 0;
+        indirect_table->data.ptr = NULL;
+        indirect_table->data.size = 0;
+        indirect_table->row_count = 0;
+        indirect_table->cxt = NULL;
+    }
+
+    // Moving rows can change the keys of sorted tables that refer to them, and sorting a table
+    // can change the keys of other sorted tables (e.g. GenericParam and CustomAttribute), so repeat until all are sorted.
+    bool reordered = success;
+    while (success && reordered)
+    {
+        reordered = false;
+        for (mdtable_id_t i = mdtid_First; success && i < mdtid_End; i++)
+        {
+            if (!was_sorted[i] || cxt->tables[i].row_count <= 1)
+                continue;
+
+            bool table_reordered;
+            success = sort_table_rows(cxt, i, remaps, &table_reordered);
+            reordered |= table_reordered;
+        }
+    }
+
+    if (success)
+    {
+        // Without indirection tables the table heap can be compressed again.
+        cxt->context_flags &= ~mdc_uncompressed_table_heap;
+        for (mdtable_id_t i = mdtid_First; i < mdtid_End; i++)
+        {
+            if (was_sorted[i])
+                cxt->tables[i].is_sorted = true;
+        }
+    }
+
+    // Report the rows that moved even if a later step failed, so the caller knows which tokens changed.
+    for (mdtable_id_t i = mdtid_First; i < mdtid_End; i++)
+    {
+        if (remaps[i] == NULL)
+            continue;
+
+        if (remap != NULL)
+        {
+            for (uint32_t row = 1; row <= cxt->tables[i].row_count; row++)
+            {
+                if (remaps[i][row - 1] != row)
+                    remap(context, TokenFromRid(row, CreateTokenType(i)), TokenFromRid(remaps[i][row - 1], CreateTokenType(i)));
+            }
+        }
+        free(remaps[i]);
+    }
+
+    return success ? MD_INDIRECTION_TABLES_REMOVED : MD_INDIRECTION_TABLES_ERROR;
+}
@@ -3,6 +3,10 @@
 #include <stdio.h>
 #include <inttypes.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
 // mdlib magic number for context
 #define MDLIB_MAGIC_NUMBER 0x3d71b
 
@@ -393,6 +397,19 @@ typedef struct mdmem__
     uint8_t data[];
 } mdmem_t;
 
+static void free_side_table(mdsidetable_id_t id, void* table)
+{
+    if (id == mdst_ReverseIndexes && table != NULL)
+        free_reverse_indexes(table);
+#ifdef DNMD_PORTABLE_PDB
+    if (id == mdst_SequencePoints && table != NULL)
+        free_sequence_point_index(table);
+    if (id == mdst_DocumentPaths && table != NULL)
+        free_document_index(table);
+#endif // DNMD_PORTABLE_PDB
+    free(table);
+}
+
 void md_destroy_handle(mdhandle_t handle)
 {
     mdcxt_t* cxt = extract_mdcxt(handle);
@@ -408,6 +425,9 @@ void md_destroy_handle(mdhandle_t handle)
         curr = tmp;
     }
 
+    for (size_t i = 0; i < ARRAY_SIZE(cxt->side_tables); ++i)
+        free_side_table((mdsidetable_id_t)i, cxt->side_tables[i]);
+
     free(cxt);
 }
 
@@ -732,6 +752,14 @@ char const* md_get_version_string(mdhandle_t handle)
     return cxt->version;
 }
 
+uint64_t md_get_edit_count(mdhandle_t handle)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return 0;
+    return cxt->edit_count;
+}
+
 #ifdef DNMD_PORTABLE_PDB
 bool md_get_pdb_id(mdhandle_t handle, size_t* pdb_id_len, uint8_t* pdb_id)
 {
@@ -755,6 +783,20 @@ bool md_get_pdb_id(mdhandle_t handle, size_t* pdb_id_len, uint8_t* pdb_id)
     memcpy(pdb_id, pdb.pdb_id, ARRAY_SIZE(pdb.pdb_id));
     return true;
 }
+
+bool md_get_pdb_entry_point(mdhandle_t handle, mdToken* entry_point)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || entry_point == NULL)
+        return false;
+
+    md_pdb_t pdb;
+    if (!try_get_pdb(cxt, &pdb))
+        return false;
+
+    *entry_point = pdb.entry_point;
+    return true;
+}
 #endif
 
 mdcxt_t* extract_mdcxt(mdhandle_t md)
@@ -812,6 +854,53 @@ void free_mdmem(mdcxt_t* cxt, void* mem)
     free(m);
 }
 
+void* load_published_pointer(void** slot)
+{
+    assert(slot != NULL);
+#ifdef _MSC_VER
+    return _InterlockedCompareExchangePointer(slot, NULL, NULL);
+#else
+    return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void* publish_pointer(void** slot, void* value)
+{
+    assert(slot != NULL && value != NULL);
+    void* published;
+#ifdef _MSC_VER
+    published = _InterlockedCompareExchangePointer(slot, value, NULL);
+#else
+    published = NULL;
+    (void)__atomic_compare_exchange_n(slot, &published, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+    return published == NULL ? value : published;
+}
+
+void* get_side_table(mdcxt_t* cxt, mdsidetable_id_t id)
+{
+    assert(cxt != NULL && id < mdst_Count);
+    return load_published_pointer(&cxt->side_tables[id]);
+}
+
+void* publish_side_table(mdcxt_t* cxt, mdsidetable_id_t id, void* table)
+{
+    assert(cxt != NULL && id < mdst_Count && table != NULL);
+    void* published = publish_pointer(&cxt->side_tables[id], table);
+
+    // Another thread published the side table first.
+    if (published != table)
+        free_side_table(id, table);
+    return published;
+}
+
+void drop_side_table(mdcxt_t* cxt, mdsidetable_id_t id)
+{
+    assert(cxt != NULL && id < mdst_Count);
+    free_side_table(id, cxt->side_tables[id]);
+    cxt->side_tables[id] = NULL;
+}
+
 static size_t get_stream_header_and_contents_size(char const* heap_name, size_t heap_size)
 {
     assert(heap_name != NULL);
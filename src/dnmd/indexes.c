@@ -0,0 +1,1674 @@
+#include "internal.h"
+
+// Row indexes map a hash of a row's identity to the rows with that hash.
+// Each index covers rows [1, row_count] of its table as they were when the index was built.
+// Rows appended after that are searched directly, see update_row_index().
+typedef struct row_index__
+{
+    uint32_t row_count;
+    uint32_t mask;
+    uint64_t* hashes; // Key hash for each covered row
+    uint32_t* buckets; // First row with a key hash in the bucket, 0 if none
+    uint32_t* next; // Next row in the same bucket, 0 if none
+} row_index_t;
+
+// Compute the key hash of a row, returns false if the row can't be read.
+typedef bool (*row_key_fn_t)(mdcursor_t row, uint64_t* hash);
+
+// Check if a row matches a query, returns false if it doesn't match or can't be read.
+typedef bool (*row_match_fn_t)(mdcursor_t row, void const* query);
+
+// Once this many rows have been appended past the index, the index is rebuilt on the next lookup.
+// The threshold grows with the index so rebuilding is amortized over the appended rows.
+#define MIN_UNINDEXED_ROWS 32
+
+static bool get_row_index_id(mdtable_id_t table_id, mdsidetable_id_t* id)
+{
+    switch (table_id)
+    {
+    case mdtid_TypeDef:
+        *id = mdst_TypeDefIndex;
+        return true;
+    case mdtid_TypeRef:
+        *id = mdst_TypeRefIndex;
+        return true;
+    case mdtid_MemberRef:
+        *id = mdst_MemberRefIndex;
+        return true;
+    case mdtid_ExportedType:
+        *id = mdst_ExportedTypeIndex;
+        return true;
+    case mdtid_ManifestResource:
+        *id = mdst_ManifestResourceIndex;
+        return true;
+    case mdtid_ModuleRef:
+        *id = mdst_ModuleRefIndex;
+        return true;
+    case mdtid_TypeSpec:
+        *id = mdst_TypeSpecIndex;
+        return true;
+    case mdtid_StandAloneSig:
+        *id = mdst_StandAloneSigIndex;
+        return true;
+    case mdtid_MethodSpec:
+        *id = mdst_MethodSpecIndex;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static uint64_t combine_hash(uint64_t seed, uint64_t value)
+{
+    seed = (seed ^ value) * 0x9e3779b97f4a7c15ull;
+    return seed ^ (seed >> 32);
+}
+
+static uint32_t row_index_slot(row_index_t const* index, uint64_t hash)
+{
+    return (uint32_t)hash & index->mask;
+}
+
+static row_index_t* build_row_index(mdtable_t* table, row_key_fn_t get_key)
+{
+    assert(table != NULL && table->row_count > 0);
+    uint32_t row_count = table->row_count;
+
+    // Keep the load factor at or below 50%.
+    uint64_t capacity = 16;
+    while (capacity < (uint64_t)row_count * 2)
+        capacity *= 2;
+    if (capacity > UINT32_MAX)
+        return NULL;
+
+    size_t hashes_size;
+    size_t buckets_size;
+    size_t next_size;
+    size_t alloc_size;
+    if (!safe_mul_size(row_count, sizeof(uint64_t), &hashes_size)
+        || !safe_mul_size((size_t)capacity, sizeof(uint32_t), &buckets_size)
+        || !safe_mul_size(row_count, sizeof(uint32_t), &next_size)
+        || !safe_add_size(sizeof(row_index_t), hashes_size, &alloc_size)
+        || !safe_add_size(alloc_size, buckets_size, &alloc_size)
+        || !safe_add_size(alloc_size, next_size, &alloc_size))
+    {
+        return NULL;
+    }
+
+    // The hashes are placed first so they're 8-byte aligned.
+    row_index_t* index = (row_index_t*)calloc(1, alloc_size);
+    if (index == NULL)
+        return NULL;
+    index->row_count = row_count;
+    index->mask = (uint32_t)(capacity - 1);
+    index->hashes = (uint64_t*)(index + 1);
+    index->buckets = (uint32_t*)(index->hashes + row_count);
+    index->next = index->buckets + capacity;
+
+    // Insert the rows in reverse so each bucket lists its rows in ascending order.
+    // This keeps lookups returning the first matching row in the table.
+    for (uint32_t row = row_count; row > 0; --row)
+    {
+        uint64_t hash;
+        if (!get_key(create_cursor(table, row), &hash))
+        {
+            free(index);
+            return NULL;
+        }
+
+        uint32_t slot = row_index_slot(index, hash);
+        index->hashes[row - 1] = hash;
+        index->next[row - 1] = index->buckets[slot];
+        index->buckets[slot] = row;
+    }
+
+    return index;
+}
+
+static bool find_row_with_index(
+    mdcxt_t* cxt,
+    mdtable_id_t table_id,
+    row_key_fn_t get_key,
+    row_match_fn_t is_match,
+    uint64_t hash,
+    void const* query,
+    mdcursor_t* found)
+{
+    mdtable_t* table = &cxt->tables[table_id];
+    if (table->cxt == NULL || table->row_count == 0)
+        return false;
+
+    mdsidetable_id_t id;
+    bool has_index = get_row_index_id(table_id, &id);
+    assert(has_index);
+    (void)has_index;
+
+    row_index_t* index = (row_index_t*)get_side_table(cxt, id);
+    if (index == NULL)
+    {
+        index = build_row_index(table, get_key);
+        if (index != NULL)
+            index = (row_index_t*)publish_side_table(cxt, id, index);
+    }
+
+    // If the index couldn't be built, fall back to searching every row.
+    uint32_t first_unindexed_row = 1;
+    if (index != NULL)
+    {
+        assert(index->row_count <= table->row_count);
+        for (uint32_t row = index->buckets[row_index_slot(index, hash)]; row != 0; row = index->next[row - 1])
+        {
+            mdcursor_t c = create_cursor(table, row);
+            if (index->hashes[row - 1] == hash && is_match(c, query))
+            {
+                *found = c;
+                return true;
+            }
+        }
+        first_unindexed_row = index->row_count + 1;
+    }
+
+    for (uint32_t row = first_unindexed_row; row <= table->row_count; ++row)
+    {
+        mdcursor_t c = create_cursor(table, row);
+        if (is_match(c, query))
+        {
+            *found = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void update_row_index(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t row)
+{
+    mdsidetable_id_t id;
+    if (!get_row_index_id(table_id, &id))
+        return;
+
+    row_index_t* index = (row_index_t*)get_side_table(cxt, id);
+    if (index == NULL)
+        return;
+
+    // Writing to or inserting before an indexed row invalidates the index.
+    // Appending rows doesn't, but the unindexed rows are searched linearly,
+    // so drop the index once there are too many of them.
+    uint32_t max_unindexed_rows = index->row_count / 4;
+    if (max_unindexed_rows < MIN_UNINDEXED_ROWS)
+        max_unindexed_rows = MIN_UNINDEXED_ROWS;
+    if (row <= index->row_count || row - index->row_count > max_unindexed_rows)
+        drop_side_table(cxt, id);
+}
+
+// Reverse indexes are stored in compressed sparse row form.
+// Column values are mapped to a dense key space with a base key for each referenced table,
+// so a coded index column doesn't need space for every combination of tag and row.
+// The rows referring to row 'r' of table 't' are rows[offsets[k]] to rows[offsets[k + 1] - 1]
+// where k = base_keys[t] + r and r < row_counts[t].
+typedef struct reverse_index__
+{
+    uint32_t base_keys[MDTABLE_MAX_COUNT];
+    uint32_t row_counts[MDTABLE_MAX_COUNT]; // Largest referenced row + 1, 0 if the table isn't referenced
+    uint32_t* offsets;
+    uint32_t* rows;
+} reverse_index_t;
+
+typedef struct reverse_index_set__
+{
+    void* indexes[MDTABLE_MAX_COUNT][MDTABLE_MAX_COLUMN_COUNT]; // reverse_index_t*
+} reverse_index_set_t;
+
+void free_reverse_indexes(void* indexes)
+{
+    reverse_index_set_t* set = (reverse_index_set_t*)indexes;
+    for (size_t i = 0; i < MDTABLE_MAX_COUNT; ++i)
+    {
+        for (size_t j = 0; j < MDTABLE_MAX_COLUMN_COUNT; ++j)
+            free(set->indexes[i][j]);
+    }
+}
+
+static void drop_reverse_indexes(mdcxt_t* cxt, mdtable_id_t table_id)
+{
+    reverse_index_set_t* set = (reverse_index_set_t*)get_side_table(cxt, mdst_ReverseIndexes);
+    if (set == NULL)
+        return;
+
+    for (size_t j = 0; j < MDTABLE_MAX_COLUMN_COUNT; ++j)
+    {
+        free(set->indexes[table_id][j]);
+        set->indexes[table_id][j] = NULL;
+    }
+}
+
+static void drop_list_owners(mdcxt_t* cxt, mdtable_id_t table_id);
+static void drop_custom_attribute_types(mdcxt_t* cxt, mdtable_id_t table_id);
+static void drop_enum_underlying_types(mdcxt_t* cxt, mdtable_id_t table_id);
+
+void update_table_indexes(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t row)
+{
+    assert(cxt != NULL);
+
+    // Appending a row or writing to the row being appended leaves the existing rows unchanged.
+    mdtable_t* table = &cxt->tables[table_id];
+    if (row <= table->row_count && !(table->is_adding_new_row && row == table->row_count))
+        cxt->edit_count++;
+
+    update_row_index(cxt, table_id, row);
+
+    // Reverse indexes, list owners and attribute types can't be extended in place, so any edit drops them.
+    drop_reverse_indexes(cxt, table_id);
+    drop_list_owners(cxt, table_id);
+    drop_custom_attribute_types(cxt, table_id);
+    drop_enum_underlying_types(cxt, table_id);
+#ifdef DNMD_PORTABLE_PDB
+    drop_pdb_indexes(cxt, table_id);
+#endif // DNMD_PORTABLE_PDB
+}
+
+// Decompose a raw index column value into the referenced table and row.
+static bool get_reference(mdtcol_t col_details, uint32_t value, mdtable_id_t* table_id, uint32_t* row)
+{
+    if ((col_details & mdtc_idx_coded) == mdtc_idx_coded)
+    {
+        if (!decompose_coded_index(value, col_details, table_id, row))
+            return false;
+    }
+    else
+    {
+        *table_id = (mdtable_id_t)ExtractTable(col_details);
+        *row = value;
+    }
+    return *table_id >= mdtid_First && *table_id < mdtid_End;
+}
+
+static reverse_index_t* build_reverse_index(mdcxt_t* cxt, mdtable_t* table, col_index_t col_idx)
+{
+    assert(table->row_count > 0);
+    mdtcol_t col_details = table->column_details[col_to_index(col_idx, table)];
+    uint32_t row_count = table->row_count;
+
+    // Reference keys are (table << 24) | row, or UINT32_MAX if the row isn't indexed.
+    size_t refs_size;
+    if (!safe_mul_size(row_count, sizeof(uint32_t), &refs_size))
+        return NULL;
+    uint32_t* refs = (uint32_t*)malloc(refs_size);
+    if (refs == NULL)
+        return NULL;
+
+    mdcursor_t cursor = create_cursor(table, 1);
+    bulk_access_cxt_t acxt;
+    if (!create_bulk_access_context(&cursor, col_idx, row_count, &acxt))
+    {
+        free(refs);
+        return NULL;
+    }
+
+    uint32_t referenced_row_counts[MDTABLE_MAX_COUNT] = { 0 };
+    uint32_t indexed_count = 0;
+    for (uint32_t i = 0; i < row_count; ++i)
+    {
+        uint32_t value;
+        if (!read_column_data_and_advance(&acxt, &value))
+        {
+            free(refs);
+            return NULL;
+        }
+        (void)next_row(&acxt);
+
+        // References past the end of the target table are valid while editing, but a
+        // reference past the combined row counts can only come from corrupt data.
+        // Skipping those bounds the size of the key space.
+        mdtable_id_t target_table;
+        uint32_t target_row;
+        if (!get_reference(col_details, value, &target_table, &target_row)
+            || target_row > (uint64_t)cxt->tables[target_table].row_count + row_count)
+        {
+            refs[i] = UINT32_MAX;
+            continue;
+        }
+
+        refs[i] = ((uint32_t)target_table << 24) | target_row;
+        if (target_row >= referenced_row_counts[target_table])
+            referenced_row_counts[target_table] = target_row + 1;
+        indexed_count++;
+    }
+
+    reverse_index_t index_header;
+    uint64_t key_count = 0;
+    for (size_t t = 0; t < MDTABLE_MAX_COUNT; ++t)
+    {
+        index_header.base_keys[t] = (uint32_t)key_count;
+        index_header.row_counts[t] = referenced_row_counts[t];
+        key_count += referenced_row_counts[t];
+    }
+
+    size_t offsets_size;
+    size_t rows_size;
+    size_t alloc_size;
+    if (key_count >= UINT32_MAX
+        || !safe_mul_size((size_t)key_count + 1, sizeof(uint32_t), &offsets_size)
+        || !safe_mul_size(indexed_count, sizeof(uint32_t), &rows_size)
+        || !safe_add_size(sizeof(reverse_index_t), offsets_size, &alloc_size)
+        || !safe_add_size(alloc_size, rows_size, &alloc_size))
+    {
+        free(refs);
+        return NULL;
+    }
+
+    reverse_index_t* index = (reverse_index_t*)calloc(1, alloc_size);
+    if (index == NULL)
+    {
+        free(refs);
+        return NULL;
+    }
+    *index = index_header;
+    index->offsets = (uint32_t*)(index + 1);
+    index->rows = index->offsets + key_count + 1;
+
+    // Convert the references to keys and count the rows for each key.
+    for (uint32_t i = 0; i < row_count; ++i)
+    {
+        if (refs[i] == UINT32_MAX)
+            continue;
+        refs[i] = index->base_keys[refs[i] >> 24] + (refs[i] & 0x00ffffff);
+        index->offsets[refs[i] + 1]++;
+    }
+    for (uint32_t k = 0; k < key_count; ++k)
+        index->offsets[k + 1] += index->offsets[k];
+
+    // Place the rows in ascending order using offsets[k] as the next free slot for the key.
+    // This leaves offsets[k] at the start of the next key's rows, so shift the offsets back.
+    for (uint32_t i = 0; i < row_count; ++i)
+    {
+        if (refs[i] != UINT32_MAX)
+            index->rows[index->offsets[refs[i]]++] = i + 1;
+    }
+    memmove(index->offsets + 1, index->offsets, (size_t)key_count * sizeof(uint32_t));
+    index->offsets[0] = 0;
+
+    free(refs);
+    return index;
+}
+
+// Get the reverse index for the column, building it if needed.
+// An empty table has no index, so 'index' is set to NULL.
+static bool get_reverse_index(mdcxt_t* cxt, mdtable_id_t table_id, col_index_t col_idx, reverse_index_t** index)
+{
+    if (table_id < mdtid_First || table_id >= mdtid_End)
+        return false;
+
+    *index = NULL;
+    mdtable_t* table = &cxt->tables[table_id];
+    if (table->cxt == NULL || table->row_count == 0)
+        return true;
+
+    uint8_t idx = col_to_index(col_idx, table);
+    if (idx >= table->column_count
+        || !(table->column_details[idx] & (mdtc_idx_table | mdtc_idx_coded)))
+    {
+        return false;
+    }
+
+    reverse_index_set_t* set = (reverse_index_set_t*)get_side_table(cxt, mdst_ReverseIndexes);
+    if (set == NULL)
+    {
+        set = (reverse_index_set_t*)calloc(1, sizeof(reverse_index_set_t));
+        if (set == NULL)
+            return false;
+        set = (reverse_index_set_t*)publish_side_table(cxt, mdst_ReverseIndexes, set);
+    }
+
+    void** slot = &set->indexes[table_id][idx];
+    reverse_index_t* existing = (reverse_index_t*)load_published_pointer(slot);
+    if (existing == NULL)
+    {
+        reverse_index_t* built = build_reverse_index(cxt, table, col_idx);
+        if (built == NULL)
+            return false;
+
+        // Another thread may have built the same index.
+        existing = (reverse_index_t*)publish_pointer(slot, built);
+        if (existing != built)
+            free(built);
+    }
+
+    *index = existing;
+    return true;
+}
+
+bool md_build_reverse_index(mdhandle_t handle, mdtable_id_t table_id, col_index_t col_idx)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return false;
+
+    reverse_index_t* index;
+    return get_reverse_index(cxt, table_id, col_idx, &index);
+}
+
+bool md_find_reverse_references(mdhandle_t handle, mdtable_id_t table_id, col_index_t col_idx, mdToken tk, uint32_t const** rows, uint32_t* count)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || rows == NULL || count == NULL)
+        return false;
+
+    reverse_index_t* index;
+    if (!get_reverse_index(cxt, table_id, col_idx, &index))
+        return false;
+
+    *rows = NULL;
+    *count = 0;
+    if (index == NULL)
+        return true;
+
+    mdtable_id_t target_table = (mdtable_id_t)ExtractTokenType(tk);
+    uint32_t target_row = RidFromToken(tk);
+    if (target_table >= MDTABLE_MAX_COUNT || target_row >= index->row_counts[target_table])
+        return true;
+
+    uint32_t key = index->base_keys[target_table] + target_row;
+    *rows = &index->rows[index->offsets[key]];
+    *count = index->offsets[key + 1] - index->offsets[key];
+    return true;
+}
+
+// List owner side tables map each row of a list table to the row that owns it.
+// For events and properties this is the TypeDef row rather than the EventMap or PropertyMap row.
+typedef struct list_owners__
+{
+    uint32_t row_count;
+    uint32_t owners[]; // 0 if the row isn't in a list
+} list_owners_t;
+
+typedef struct list_owner_details__
+{
+    mdsidetable_id_t id;
+    mdtable_id_t list_owner_table; // Table with the list column
+    col_index_t list_col;
+    bool has_parent_col; // Set if the list owner is a map, the owner is in its parent column
+    col_index_t parent_col;
+    mdtable_id_t owner_table;
+} list_owner_details_t;
+
+static bool get_list_owner_details(mdtable_id_t table_id, list_owner_details_t* details)
+{
+    details->has_parent_col = false;
+    switch (table_id)
+    {
+    case mdtid_Field:
+        details->id = mdst_FieldOwners;
+        details->list_owner_table = mdtid_TypeDef;
+        details->list_col = mdtTypeDef_FieldList;
+        break;
+    case mdtid_MethodDef:
+        details->id = mdst_MethodDefOwners;
+        details->list_owner_table = mdtid_TypeDef;
+        details->list_col = mdtTypeDef_MethodList;
+        break;
+    case mdtid_Param:
+        details->id = mdst_ParamOwners;
+        details->list_owner_table = mdtid_MethodDef;
+        details->list_col = mdtMethodDef_ParamList;
+        break;
+    case mdtid_Event:
+        details->id = mdst_EventOwners;
+        details->list_owner_table = mdtid_EventMap;
+        details->list_col = mdtEventMap_EventList;
+        details->has_parent_col = true;
+        details->parent_col = mdtEventMap_Parent;
+        break;
+    case mdtid_Property:
+        details->id = mdst_PropertyOwners;
+        details->list_owner_table = mdtid_PropertyMap;
+        details->list_col = mdtPropertyMap_PropertyList;
+        details->has_parent_col = true;
+        details->parent_col = mdtPropertyMap_Parent;
+        break;
+#ifdef DNMD_PORTABLE_PDB
+    case mdtid_LocalVariable:
+        details->id = mdst_LocalVariableOwners;
+        details->list_owner_table = mdtid_LocalScope;
+        details->list_col = mdtLocalScope_VariableList;
+        break;
+    case mdtid_LocalConstant:
+        details->id = mdst_LocalConstantOwners;
+        details->list_owner_table = mdtid_LocalScope;
+        details->list_col = mdtLocalScope_ConstantList;
+        break;
+#endif // DNMD_PORTABLE_PDB
+    default:
+        return false;
+    }
+    details->owner_table = details->has_parent_col ? mdtid_TypeDef : details->list_owner_table;
+    return true;
+}
+
+static void drop_list_owners(mdcxt_t* cxt, mdtable_id_t table_id)
+{
+    switch (table_id)
+    {
+    case mdtid_TypeDef:
+    case mdtid_FieldPtr:
+    case mdtid_Field:
+    case mdtid_MethodPtr:
+    case mdtid_MethodDef:
+    case mdtid_ParamPtr:
+    case mdtid_Param:
+    case mdtid_EventMap:
+    case mdtid_EventPtr:
+    case mdtid_Event:
+    case mdtid_PropertyMap:
+    case mdtid_PropertyPtr:
+    case mdtid_Property:
+        drop_side_table(cxt, mdst_FieldOwners);
+        drop_side_table(cxt, mdst_MethodDefOwners);
+        drop_side_table(cxt, mdst_ParamOwners);
+        drop_side_table(cxt, mdst_EventOwners);
+        drop_side_table(cxt, mdst_PropertyOwners);
+        break;
+#ifdef DNMD_PORTABLE_PDB
+    case mdtid_LocalScope:
+    case mdtid_LocalVariable:
+    case mdtid_LocalConstant:
+        drop_side_table(cxt, mdst_LocalVariableOwners);
+        drop_side_table(cxt, mdst_LocalConstantOwners);
+        break;
+#endif // DNMD_PORTABLE_PDB
+    default:
+        break;
+    }
+}
+
+static list_owners_t* build_list_owners(mdcxt_t* cxt, mdtable_t* table, list_owner_details_t const* details)
+{
+    size_t alloc_size;
+    if (!safe_mul_size(table->row_count, sizeof(uint32_t), &alloc_size)
+        || !safe_add_size(alloc_size, sizeof(list_owners_t), &alloc_size))
+    {
+        return NULL;
+    }
+
+    list_owners_t* owners = (list_owners_t*)calloc(1, alloc_size);
+    if (owners == NULL)
+        return NULL;
+    owners->row_count = table->row_count;
+
+    mdtable_t* list_owner_table = &cxt->tables[details->list_owner_table];
+    if (list_owner_table->cxt == NULL || list_owner_table->row_count == 0)
+        return owners;
+
+    // The list column refers to an indirection table if the list has been reordered.
+    mdtable_id_t list_table_id = ExtractTable(list_owner_table->column_details[col_to_index(details->list_col, list_owner_table)]);
+    mdtable_t* list_table = &cxt->tables[list_table_id];
+    bool is_indirect = table_is_indirect_table(list_table_id);
+    uint32_t list_end = list_table->row_count + 1;
+
+    // Each list runs from its start to the start of the next list, see md_get_column_value_as_range().
+    mdToken start;
+    if (!md_get_column_value_as_token(create_cursor(list_owner_table, 1), details->list_col, &start))
+    {
+        free(owners);
+        return NULL;
+    }
+
+    for (uint32_t i = 1; i <= list_owner_table->row_count; ++i)
+    {
+        mdcursor_t list_owner = create_cursor(list_owner_table, i);
+        mdToken next = TokenFromRid(list_end, CreateTokenType(list_table_id));
+        if (i < list_owner_table->row_count
+            && !md_get_column_value_as_token(create_cursor(list_owner_table, i + 1), details->list_col, &next))
+        {
+            free(owners);
+            return NULL;
+        }
+
+        uint32_t owner_row = i;
+        if (details->has_parent_col)
+        {
+            mdToken parent;
+            if (!md_get_column_value_as_token(list_owner, details->parent_col, &parent))
+            {
+                free(owners);
+                return NULL;
+            }
+            owner_row = RidFromToken(parent);
+        }
+
+        uint32_t end = RidFromToken(next) < list_end ? RidFromToken(next) : list_end;
+        for (uint32_t list_row = RidFromToken(start); list_row < end; ++list_row)
+        {
+            uint32_t row = list_row;
+            if (is_indirect)
+            {
+                mdToken target;
+                if (!md_get_column_value_as_token(create_cursor(list_table, list_row), index_to_col(0, list_table_id), &target))
+                {
+                    free(owners);
+                    return NULL;
+                }
+                row = RidFromToken(target);
+            }
+
+            if (row != 0 && row <= owners->row_count)
+                owners->owners[row - 1] = owner_row;
+        }
+        start = next;
+    }
+
+    return owners;
+}
+
+bool try_get_list_owner(mdcursor_t element, mdcursor_t* owner)
+{
+    assert(owner != NULL);
+    mdtable_t* table = CursorTable(&element);
+    list_owner_details_t details;
+    if (table == NULL || !get_list_owner_details(table->table_id, &details))
+        return false;
+
+    mdcxt_t* cxt = table->cxt;
+    list_owners_t* owners = (list_owners_t*)get_side_table(cxt, details.id);
+    if (owners == NULL)
+    {
+        owners = build_list_owners(cxt, table, &details);
+        if (owners == NULL)
+            return false;
+        owners = (list_owners_t*)publish_side_table(cxt, details.id, owners);
+    }
+
+    uint32_t row = CursorRow(&element);
+    if (row == 0 || row > owners->row_count)
+        return false;
+
+    uint32_t owner_row = owners->owners[row - 1];
+    mdtable_t* owner_table = &cxt->tables[details.owner_table];
+    if (owner_row == 0 || owner_row > owner_table->row_count)
+        return false;
+
+    *owner = create_cursor(owner_table, owner_row);
+    return true;
+}
+
+typedef struct typeref_query__
+{
+    mdToken resolution_scope;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+} typeref_query_t;
+
+static uint64_t get_typeref_hash(mdToken resolution_scope, mdstringview_t const* type_namespace, mdstringview_t const* type_name)
+{
+    uint64_t hash = combine_hash(resolution_scope, type_namespace->hash);
+    return combine_hash(hash, type_name->hash);
+}
+
+static bool get_typeref_key(mdcursor_t row, uint64_t* hash)
+{
+    mdToken resolution_scope;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+    if (!md_get_column_value_as_token(row, mdtTypeRef_ResolutionScope, &resolution_scope)
+        || !md_get_column_value_as_utf8_view(row, mdtTypeRef_TypeNamespace, &type_namespace)
+        || !md_get_column_value_as_utf8_view(row, mdtTypeRef_TypeName, &type_name))
+    {
+        return false;
+    }
+
+    *hash = get_typeref_hash(resolution_scope, &type_namespace, &type_name);
+    return true;
+}
+
+static bool is_typeref_match(mdcursor_t row, void const* query)
+{
+    typeref_query_t const* q = (typeref_query_t const*)query;
+    mdToken resolution_scope;
+    if (!md_get_column_value_as_token(row, mdtTypeRef_ResolutionScope, &resolution_scope)
+        || resolution_scope != q->resolution_scope)
+    {
+        return false;
+    }
+
+    mdstringview_t view;
+    if (!md_get_column_value_as_utf8_view(row, mdtTypeRef_TypeName, &view)
+        || !md_utf8_view_equals(&view, &q->type_name))
+    {
+        return false;
+    }
+
+    return md_get_column_value_as_utf8_view(row, mdtTypeRef_TypeNamespace, &view)
+        && md_utf8_view_equals(&view, &q->type_namespace);
+}
+
+bool md_find_typeref(mdhandle_t handle, mdToken resolution_scope, char const* type_namespace, char const* type_name, mdcursor_t* typeref)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || type_namespace == NULL || type_name == NULL || typeref == NULL)
+        return false;
+
+    typeref_query_t query;
+    query.resolution_scope = resolution_scope;
+    md_create_utf8_view(type_namespace, &query.type_namespace);
+    md_create_utf8_view(type_name, &query.type_name);
+
+    uint64_t hash = get_typeref_hash(resolution_scope, &query.type_namespace, &query.type_name);
+    return find_row_with_index(cxt, mdtid_TypeRef, get_typeref_key, is_typeref_match, hash, &query, typeref);
+}
+
+typedef struct typedef_query__
+{
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+} typedef_query_t;
+
+static uint64_t get_typedef_hash(mdstringview_t const* type_namespace, mdstringview_t const* type_name)
+{
+    return combine_hash(type_namespace->hash, type_name->hash);
+}
+
+// Nested types are indexed too, they're only skipped when matching.
+static bool get_typedef_key(mdcursor_t row, uint64_t* hash)
+{
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+    if (!md_get_column_value_as_utf8_view(row, mdtTypeDef_TypeNamespace, &type_namespace)
+        || !md_get_column_value_as_utf8_view(row, mdtTypeDef_TypeName, &type_name))
+    {
+        return false;
+    }
+
+    *hash = get_typedef_hash(&type_namespace, &type_name);
+    return true;
+}
+
+static bool is_toplevel_typedef_match(mdcursor_t row, void const* query)
+{
+    typedef_query_t const* q = (typedef_query_t const*)query;
+    mdstringview_t view;
+    if (!md_get_column_value_as_utf8_view(row, mdtTypeDef_TypeName, &view)
+        || !md_utf8_view_equals(&view, &q->type_name))
+    {
+        return false;
+    }
+
+    uint32_t flags;
+    return md_get_column_value_as_utf8_view(row, mdtTypeDef_TypeNamespace, &view)
+        && md_utf8_view_equals(&view, &q->type_namespace)
+        && md_get_column_value_as_constant(row, mdtTypeDef_Flags, &flags)
+        && !IsTdNested(flags);
+}
+
+bool find_toplevel_typedef(mdcxt_t* cxt, char const* type_namespace, char const* type_name, mdcursor_t* type_def)
+{
+    assert(cxt != NULL && type_namespace != NULL && type_name != NULL && type_def != NULL);
+
+    typedef_query_t query;
+    md_create_utf8_view(type_namespace, &query.type_namespace);
+    md_create_utf8_view(type_name, &query.type_name);
+
+    uint64_t hash = get_typedef_hash(&query.type_namespace, &query.type_name);
+    return find_row_with_index(cxt, mdtid_TypeDef, get_typedef_key, is_toplevel_typedef_match, hash, &query, type_def);
+}
+
+// The signature isn't part of the key so lookups can ignore it.
+// Overloads of a member share a bucket and are told apart when matching.
+typedef struct memberref_query__
+{
+    mdToken parent;
+    mdstringview_t name;
+    uint8_t const* signature;
+    uint32_t signature_len;
+} memberref_query_t;
+
+static uint64_t get_memberref_hash(mdToken parent, mdstringview_t const* name)
+{
+    return combine_hash(parent, name->hash);
+}
+
+static bool get_memberref_key(mdcursor_t row, uint64_t* hash)
+{
+    mdToken parent;
+    mdstringview_t name;
+    if (!md_get_column_value_as_token(row, mdtMemberRef_Class, &parent)
+        || !md_get_column_value_as_utf8_view(row, mdtMemberRef_Name, &name))
+    {
+        return false;
+    }
+
+    *hash = get_memberref_hash(parent, &name);
+    return true;
+}
+
+static bool is_memberref_match(mdcursor_t row, void const* query)
+{
+    memberref_query_t const* q = (memberref_query_t const*)query;
+    mdToken parent;
+    if (!md_get_column_value_as_token(row, mdtMemberRef_Class, &parent)
+        || parent != q->parent)
+    {
+        return false;
+    }
+
+    mdstringview_t name;
+    if (!md_get_column_value_as_utf8_view(row, mdtMemberRef_Name, &name)
+        || !md_utf8_view_equals(&name, &q->name))
+    {
+        return false;
+    }
+
+    if (q->signature == NULL)
+        return true;
+
+    uint8_t const* signature;
+    uint32_t signature_len;
+    return md_get_column_value_as_blob(row, mdtMemberRef_Signature, &signature, &signature_len)
+        && signature_len == q->signature_len
+        && memcmp(signature, q->signature, signature_len) == 0;
+}
+
+bool md_find_memberref(mdhandle_t handle, mdToken parent, char const* name, uint8_t const* signature, uint32_t signature_len, mdcursor_t* memberref)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || name == NULL || memberref == NULL)
+        return false;
+
+    memberref_query_t query;
+    query.parent = parent;
+    md_create_utf8_view(name, &query.name);
+    query.signature = signature;
+    query.signature_len = signature_len;
+
+    uint64_t hash = get_memberref_hash(parent, &query.name);
+    return find_row_with_index(cxt, mdtid_MemberRef, get_memberref_key, is_memberref_match, hash, &query, memberref);
+}
+
+// Nested exported types are keyed by their enclosing type, all others by a nil token.
+typedef struct exportedtype_query__
+{
+    mdToken enclosing_type;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+} exportedtype_query_t;
+
+static mdToken get_enclosing_exportedtype(mdToken implementation)
+{
+    return (ExtractTokenType(implementation) == mdtid_ExportedType && RidFromToken(implementation) != 0)
+        ? implementation
+        : mdTokenNil;
+}
+
+static uint64_t get_exportedtype_hash(mdToken enclosing_type, mdstringview_t const* type_namespace, mdstringview_t const* type_name)
+{
+    uint64_t hash = combine_hash(enclosing_type, type_namespace->hash);
+    return combine_hash(hash, type_name->hash);
+}
+
+static bool get_exportedtype_key(mdcursor_t row, uint64_t* hash)
+{
+    mdToken implementation;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+    if (!md_get_column_value_as_token(row, mdtExportedType_Implementation, &implementation)
+        || !md_get_column_value_as_utf8_view(row, mdtExportedType_TypeNamespace, &type_namespace)
+        || !md_get_column_value_as_utf8_view(row, mdtExportedType_TypeName, &type_name))
+    {
+        return false;
+    }
+
+    *hash = get_exportedtype_hash(get_enclosing_exportedtype(implementation), &type_namespace, &type_name);
+    return true;
+}
+
+static bool is_exportedtype_match(mdcursor_t row, void const* query)
+{
+    exportedtype_query_t const* q = (exportedtype_query_t const*)query;
+    mdToken implementation;
+    if (!md_get_column_value_as_token(row, mdtExportedType_Implementation, &implementation)
+        || get_enclosing_exportedtype(implementation) != q->enclosing_type)
+    {
+        return false;
+    }
+
+    mdstringview_t view;
+    if (!md_get_column_value_as_utf8_view(row, mdtExportedType_TypeName, &view)
+        || !md_utf8_view_equals(&view, &q->type_name))
+    {
+        return false;
+    }
+
+    return md_get_column_value_as_utf8_view(row, mdtExportedType_TypeNamespace, &view)
+        && md_utf8_view_equals(&view, &q->type_namespace);
+}
+
+bool md_find_exportedtype(mdhandle_t handle, mdToken enclosing_type, char const* type_namespace, char const* type_name, mdcursor_t* exportedtype)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || type_namespace == NULL || type_name == NULL || exportedtype == NULL)
+        return false;
+
+    exportedtype_query_t query;
+    query.enclosing_type = get_enclosing_exportedtype(enclosing_type);
+    md_create_utf8_view(type_namespace, &query.type_namespace);
+    md_create_utf8_view(type_name, &query.type_name);
+
+    uint64_t hash = get_exportedtype_hash(query.enclosing_type, &query.type_namespace, &query.type_name);
+    return find_row_with_index(cxt, mdtid_ExportedType, get_exportedtype_key, is_exportedtype_match, hash, &query, exportedtype);
+}
+
+static bool get_manifestresource_key(mdcursor_t row, uint64_t* hash)
+{
+    mdstringview_t name;
+    if (!md_get_column_value_as_utf8_view(row, mdtManifestResource_Name, &name))
+        return false;
+
+    *hash = name.hash;
+    return true;
+}
+
+static bool is_manifestresource_match(mdcursor_t row, void const* query)
+{
+    mdstringview_t name;
+    return md_get_column_value_as_utf8_view(row, mdtManifestResource_Name, &name)
+        && md_utf8_view_equals(&name, (mdstringview_t const*)query);
+}
+
+bool md_find_manifestresource(mdhandle_t handle, char const* name, mdcursor_t* manifestresource)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || name == NULL || manifestresource == NULL)
+        return false;
+
+    mdstringview_t query;
+    md_create_utf8_view(name, &query);
+    return find_row_with_index(cxt, mdtid_ManifestResource, get_manifestresource_key, is_manifestresource_match, query.hash, &query, manifestresource);
+}
+
+static bool get_moduleref_key(mdcursor_t row, uint64_t* hash)
+{
+    mdstringview_t name;
+    if (!md_get_column_value_as_utf8_view(row, mdtModuleRef_Name, &name))
+        return false;
+
+    *hash = name.hash;
+    return true;
+}
+
+static bool is_moduleref_match(mdcursor_t row, void const* query)
+{
+    mdstringview_t name;
+    return md_get_column_value_as_utf8_view(row, mdtModuleRef_Name, &name)
+        && md_utf8_view_equals(&name, (mdstringview_t const*)query);
+}
+
+bool md_find_moduleref(mdhandle_t handle, char const* name, mdcursor_t* moduleref)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || name == NULL || moduleref == NULL)
+        return false;
+
+    mdstringview_t query;
+    md_create_utf8_view(name, &query);
+    return find_row_with_index(cxt, mdtid_ModuleRef, get_moduleref_key, is_moduleref_match, query.hash, &query, moduleref);
+}
+
+// TypeSpec and StandAloneSig rows are keyed by their signature alone.
+typedef struct signature_query__
+{
+    col_index_t col_idx;
+    uint8_t const* signature;
+    uint32_t signature_len;
+} signature_query_t;
+
+static bool get_signature_key(mdcursor_t row, col_index_t col_idx, uint64_t* hash)
+{
+    uint8_t const* signature;
+    uint32_t signature_len;
+    if (!md_get_column_value_as_blob(row, col_idx, &signature, &signature_len))
+        return false;
+
+    *hash = get_blob_hash(signature, signature_len);
+    return true;
+}
+
+static bool is_signature_match(mdcursor_t row, void const* query)
+{
+    signature_query_t const* q = (signature_query_t const*)query;
+    uint8_t const* signature;
+    uint32_t signature_len;
+    return md_get_column_value_as_blob(row, q->col_idx, &signature, &signature_len)
+        && signature_len == q->signature_len
+        && (signature_len == 0 || memcmp(signature, q->signature, signature_len) == 0);
+}
+
+static bool find_row_by_signature(mdhandle_t handle, mdtable_id_t table_id, col_index_t col_idx, row_key_fn_t get_key, uint8_t const* signature, uint32_t signature_len, mdcursor_t* found)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || (signature == NULL && signature_len != 0) || found == NULL)
+        return false;
+
+    signature_query_t query;
+    query.col_idx = col_idx;
+    query.signature = signature;
+    query.signature_len = signature_len;
+    return find_row_with_index(cxt, table_id, get_key, is_signature_match, get_blob_hash(signature, signature_len), &query, found);
+}
+
+static bool get_typespec_key(mdcursor_t row, uint64_t* hash)
+{
+    return get_signature_key(row, mdtTypeSpec_Signature, hash);
+}
+
+bool md_find_typespec(mdhandle_t handle, uint8_t const* signature, uint32_t signature_len, mdcursor_t* typespec)
+{
+    return find_row_by_signature(handle, mdtid_TypeSpec, mdtTypeSpec_Signature, get_typespec_key, signature, signature_len, typespec);
+}
+
+static bool get_standalonesig_key(mdcursor_t row, uint64_t* hash)
+{
+    return get_signature_key(row, mdtStandAloneSig_Signature, hash);
+}
+
+bool md_find_standalonesig(mdhandle_t handle, uint8_t const* signature, uint32_t signature_len, mdcursor_t* standalonesig)
+{
+    return find_row_by_signature(handle, mdtid_StandAloneSig, mdtStandAloneSig_Signature, get_standalonesig_key, signature, signature_len, standalonesig);
+}
+
+typedef struct methodspec_query__
+{
+    mdToken method;
+    uint8_t const* instantiation;
+    uint32_t instantiation_len;
+} methodspec_query_t;
+
+static uint64_t get_methodspec_hash(mdToken method, uint8_t const* instantiation, uint32_t instantiation_len)
+{
+    return combine_hash(method, get_blob_hash(instantiation, instantiation_len));
+}
+
+static bool get_methodspec_key(mdcursor_t row, uint64_t* hash)
+{
+    mdToken method;
+    uint8_t const* instantiation;
+    uint32_t instantiation_len;
+    if (!md_get_column_value_as_token(row, mdtMethodSpec_Method, &method)
+        || !md_get_column_value_as_blob(row, mdtMethodSpec_Instantiation, &instantiation, &instantiation_len))
+    {
+        return false;
+    }
+
+    *hash = get_methodspec_hash(method, instantiation, instantiation_len);
+    return true;
+}
+
+static bool is_methodspec_match(mdcursor_t row, void const* query)
+{
+    methodspec_query_t const* q = (methodspec_query_t const*)query;
+    mdToken method;
+    uint8_t const* instantiation;
+    uint32_t instantiation_len;
+    return md_get_column_value_as_token(row, mdtMethodSpec_Method, &method)
+        && method == q->method
+        && md_get_column_value_as_blob(row, mdtMethodSpec_Instantiation, &instantiation, &instantiation_len)
+        && instantiation_len == q->instantiation_len
+        && (instantiation_len == 0 || memcmp(instantiation, q->instantiation, instantiation_len) == 0);
+}
+
+bool md_find_methodspec(mdhandle_t handle, mdToken method, uint8_t const* instantiation, uint32_t instantiation_len, mdcursor_t* methodspec)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || (instantiation == NULL && instantiation_len != 0) || methodspec == NULL)
+        return false;
+
+    methodspec_query_t query;
+    query.method = method;
+    query.instantiation = instantiation;
+    query.instantiation_len = instantiation_len;
+
+    uint64_t hash = get_methodspec_hash(method, instantiation, instantiation_len);
+    return find_row_with_index(cxt, mdtid_MethodSpec, get_methodspec_key, is_methodspec_match, hash, &query, methodspec);
+}
+
+// Custom attribute type side tables record the type that declares each attribute's constructor
+// and the full name hash of that type, see get_full_type_name_hash(), along with a filter
+// of the hashes for each parent. A parent is found in an open addressed table, and a name hash
+// that doesn't match the parent's filter can't be the type of any of its attributes.
+typedef struct custom_attribute_types__
+{
+    uint32_t row_count;
+    uint32_t mask;
+    uint64_t* type_hashes; // 0 if the attribute type couldn't be resolved to a TypeDef or TypeRef
+    uint64_t* filters;
+    mdToken* types; // 0 if the constructor couldn't be read
+    mdToken* parents; // 0 if the slot is empty
+} custom_attribute_types_t;
+
+typedef struct attribute_type__
+{
+    uint64_t hash;
+    mdToken type;
+    bool resolved;
+} attribute_type_t;
+
+static uint32_t custom_attribute_parent_slot(custom_attribute_types_t const* types, mdToken parent)
+{
+    // Fibonacci hashing to spread sequential tokens across the table.
+    return (uint32_t)(((uint64_t)parent * 0x9e3779b97f4a7c15ull) >> 32) & types->mask;
+}
+
+static uint64_t get_type_name_filter_bits(uint64_t hash)
+{
+    return (1ull << (hash & 63)) | (1ull << ((hash >> 58) & 63));
+}
+
+static void drop_custom_attribute_types(mdcxt_t* cxt, mdtable_id_t table_id)
+{
+    // The attribute type is found through the constructor's owner or parent and,
+    // for generic attributes, the TypeSpec signature.
+    switch (table_id)
+    {
+    case mdtid_TypeDef:
+    case mdtid_TypeRef:
+    case mdtid_TypeSpec:
+    case mdtid_MethodPtr:
+    case mdtid_MethodDef:
+    case mdtid_MemberRef:
+    case mdtid_CustomAttribute:
+        drop_side_table(cxt, mdst_CustomAttributeTypes);
+        break;
+    default:
+        break;
+    }
+}
+
+static void drop_enum_underlying_types(mdcxt_t* cxt, mdtable_id_t table_id)
+{
+    // The underlying type is the type of the enum's first instance field.
+    switch (table_id)
+    {
+    case mdtid_TypeDef:
+    case mdtid_FieldPtr:
+    case mdtid_Field:
+        drop_side_table(cxt, mdst_EnumUnderlyingTypes);
+        break;
+    default:
+        break;
+    }
+}
+
+// The functions below report a failure to read a row with MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW,
+// a malformed type with MD_CUSTOM_ATTRIBUTE_INVALID_TYPE and success with MD_CUSTOM_ATTRIBUTE_FOUND.
+
+// Get the type that declares an attribute's constructor.
+static md_custom_attribute_result_t get_attribute_declaring_type(mdcursor_t ctor, mdcursor_t* type)
+{
+    bool success;
+    switch (CursorTable(&ctor)->table_id)
+    {
+    case mdtid_MethodDef:
+        success = md_find_cursor_of_range_element(ctor, type);
+        break;
+    case mdtid_MemberRef:
+        success = md_get_column_value_as_cursor(ctor, mdtMemberRef_Class, type);
+        break;
+    default:
+        return MD_CUSTOM_ATTRIBUTE_INVALID_TYPE;
+    }
+    return success ? MD_CUSTOM_ATTRIBUTE_FOUND : MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+}
+
+// Resolve a type to the TypeDef or TypeRef it names, looking through modifiers and generic instantiations.
+// Sets a NULL table cursor if the type doesn't name a TypeDef or TypeRef.
+static md_custom_attribute_result_t resolve_attribute_type(mdcursor_t type, mdcursor_t* resolved)
+{
+    mdtable_t* table = CursorTable(&type);
+    if (table == NULL)
+        return MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+
+    if (table->table_id != mdtid_TypeSpec)
+    {
+        *resolved = type;
+        return MD_CUSTOM_ATTRIBUTE_FOUND;
+    }
+
+    // See TypeSpec definition at II.23.2.14
+    uint8_t const* sig;
+    uint32_t sig_len;
+    if (!md_get_column_value_as_blob(type, mdtTypeSpec_Signature, &sig, &sig_len))
+        return MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+
+    size_t len = sig_len;
+    uint32_t element_type;
+    for (;;)
+    {
+        if (!decompress_u32(&sig, &len, &element_type))
+            return MD_CUSTOM_ATTRIBUTE_INVALID_TYPE;
+
+        if (element_type == ELEMENT_TYPE_CMOD_REQD || element_type == ELEMENT_TYPE_CMOD_OPT)
+        {
+            uint32_t modifier_type;
+            if (!decompress_u32(&sig, &len, &modifier_type))
+                return MD_CUSTOM_ATTRIBUTE_INVALID_TYPE;
+        }
+        else if (element_type != ELEMENT_TYPE_GENERICINST
+            && element_type != ELEMENT_TYPE_PTR
+            && element_type != ELEMENT_TYPE_BYREF
+            && (element_type & ELEMENT_TYPE_MODIFIER) == 0)
+        {
+            break;
+        }
+    }
+
+    if (element_type != ELEMENT_TYPE_CLASS && element_type != ELEMENT_TYPE_VALUETYPE)
+    {
+        *resolved = (mdcursor_t){ 0 };
+        return MD_CUSTOM_ATTRIBUTE_FOUND;
+    }
+
+    uint32_t cindex;
+    mdtable_id_t type_table;
+    uint32_t type_row;
+    if (!decompress_u32(&sig, &len, &cindex)
+        || !decompose_coded_index(cindex, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &type_table, &type_row)
+        || type_row == 0)
+    {
+        return MD_CUSTOM_ATTRIBUTE_INVALID_TYPE;
+    }
+
+    if (type_table == mdtid_TypeSpec)
+    {
+        *resolved = (mdcursor_t){ 0 };
+        return MD_CUSTOM_ATTRIBUTE_FOUND;
+    }
+
+    return md_token_to_cursor(md_extract_handle_from_cursor(type), CreateTokenType(type_table) | type_row, resolved)
+        ? MD_CUSTOM_ATTRIBUTE_FOUND
+        : MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+}
+
+// Get the namespace and name of an attribute's declaring type.
+// Sets 'has_name' to false if the type isn't a TypeDef or TypeRef.
+static md_custom_attribute_result_t get_attribute_type_name(mdcursor_t type, bool* has_name, mdstringview_t* type_namespace, mdstringview_t* type_name)
+{
+    *has_name = false;
+    md_custom_attribute_result_t result = resolve_attribute_type(type, &type);
+    if (result != MD_CUSTOM_ATTRIBUTE_FOUND)
+        return result;
+
+    mdtable_t* table = CursorTable(&type);
+    if (table == NULL)
+        return MD_CUSTOM_ATTRIBUTE_FOUND;
+
+    col_index_t namespace_col;
+    col_index_t name_col;
+    switch (table->table_id)
+    {
+    case mdtid_TypeDef:
+        namespace_col = mdtTypeDef_TypeNamespace;
+        name_col = mdtTypeDef_TypeName;
+        break;
+    case mdtid_TypeRef:
+        namespace_col = mdtTypeRef_TypeNamespace;
+        name_col = mdtTypeRef_TypeName;
+        break;
+    default:
+        return MD_CUSTOM_ATTRIBUTE_FOUND;
+    }
+
+    *has_name = true;
+    return md_get_column_value_as_utf8_view(type, namespace_col, type_namespace)
+        && md_get_column_value_as_utf8_view(type, name_col, type_name)
+        ? MD_CUSTOM_ATTRIBUTE_FOUND
+        : MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+}
+
+// Get the declaring type of an attribute's constructor and the full name hash of the type.
+// Types that can't be read or don't have a name have a hash of 0, and a nil type if the
+// constructor can't be read. Lookups check attributes with a hash of 0 directly.
+static void get_attribute_type(mdcursor_t ctor, attribute_type_t* attribute_type)
+{
+    attribute_type->hash = 0;
+    attribute_type->type = 0;
+    attribute_type->resolved = true;
+
+    mdcursor_t type;
+    if (get_attribute_declaring_type(ctor, &type) != MD_CUSTOM_ATTRIBUTE_FOUND
+        || !md_cursor_to_token(type, &attribute_type->type))
+    {
+        return;
+    }
+
+    bool has_name;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+    if (get_attribute_type_name(type, &has_name, &type_namespace, &type_name) == MD_CUSTOM_ATTRIBUTE_FOUND && has_name)
+        attribute_type->hash = get_full_type_name_hash(&type_namespace, &type_name);
+}
+
+static custom_attribute_types_t* build_custom_attribute_types(mdcxt_t* cxt, mdtable_t* table)
+{
+    assert(table != NULL && table->row_count > 0);
+    uint32_t row_count = table->row_count;
+
+    // Keep the load factor of the parent table at or below 50%.
+    uint64_t capacity = 16;
+    while (capacity < (uint64_t)row_count * 2)
+        capacity *= 2;
+    if (capacity > UINT32_MAX)
+        return NULL;
+
+    size_t hashes_size;
+    size_t filters_size;
+    size_t types_size;
+    size_t parents_size;
+    size_t alloc_size;
+    if (!safe_mul_size(row_count, sizeof(uint64_t), &hashes_size)
+        || !safe_mul_size((size_t)capacity, sizeof(uint64_t), &filters_size)
+        || !safe_mul_size(row_count, sizeof(mdToken), &types_size)
+        || !safe_mul_size((size_t)capacity, sizeof(mdToken), &parents_size)
+        || !safe_add_size(sizeof(custom_attribute_types_t), hashes_size, &alloc_size)
+        || !safe_add_size(alloc_size, filters_size, &alloc_size)
+        || !safe_add_size(alloc_size, types_size, &alloc_size)
+        || !safe_add_size(alloc_size, parents_size, &alloc_size))
+    {
+        return NULL;
+    }
+
+    // Attributes commonly share constructors, so each constructor's type is only resolved once while building.
+    mdtable_t* methoddef_table = &cxt->tables[mdtid_MethodDef];
+    mdtable_t* memberref_table = &cxt->tables[mdtid_MemberRef];
+    uint32_t methoddef_count = methoddef_table->cxt != NULL ? methoddef_table->row_count : 0;
+    uint32_t memberref_count = memberref_table->cxt != NULL ? memberref_table->row_count : 0;
+    size_t ctor_types_size;
+    if (!safe_mul_size((size_t)methoddef_count + memberref_count + 1, sizeof(attribute_type_t), &ctor_types_size))
+        return NULL;
+
+    // The hashes and filters are placed first so they're 8-byte aligned.
+    custom_attribute_types_t* types = (custom_attribute_types_t*)calloc(1, alloc_size);
+    attribute_type_t* ctor_types = (attribute_type_t*)calloc(1, ctor_types_size);
+    if (types == NULL || ctor_types == NULL)
+    {
+        free(types);
+        free(ctor_types);
+        return NULL;
+    }
+    types->row_count = row_count;
+    types->mask = (uint32_t)(capacity - 1);
+    types->type_hashes = (uint64_t*)(types + 1);
+    types->filters = types->type_hashes + row_count;
+    types->types = (mdToken*)(types->filters + capacity);
+    types->parents = types->types + row_count;
+
+    // Constructors that can't be read share the last entry.
+    attribute_type_t* unknown = &ctor_types[methoddef_count + memberref_count];
+    unknown->resolved = true;
+
+    for (uint32_t row = 1; row <= row_count; ++row)
+    {
+        mdcursor_t c = create_cursor(table, row);
+        mdToken parent;
+        mdcursor_t ctor;
+        attribute_type_t* ctor_type = unknown;
+        if (md_get_column_value_as_cursor(c, mdtCustomAttribute_Type, &ctor))
+        {
+            uint32_t ctor_row = CursorRow(&ctor);
+            if (CursorTable(&ctor) == methoddef_table && ctor_row != 0 && ctor_row <= methoddef_count)
+                ctor_type = &ctor_types[ctor_row - 1];
+            else if (CursorTable(&ctor) == memberref_table && ctor_row != 0 && ctor_row <= memberref_count)
+                ctor_type = &ctor_types[methoddef_count + ctor_row - 1];
+
+            if (!ctor_type->resolved)
+                get_attribute_type(ctor, ctor_type);
+        }
+
+        types->type_hashes[row - 1] = ctor_type->hash;
+        types->types[row - 1] = ctor_type->type;
+        if (!md_get_column_value_as_token(c, mdtCustomAttribute_Parent, &parent)
+            || parent == 0)
+        {
+            continue;
+        }
+
+        // An attribute without a hash may still match or fail to be read,
+        // so its parent's filter lets every name through.
+        uint32_t slot = custom_attribute_parent_slot(types, parent);
+        while (types->parents[slot] != 0 && types->parents[slot] != parent)
+            slot = (slot + 1) & types->mask;
+        types->parents[slot] = parent;
+        types->filters[slot] |= ctor_type->hash != 0
+            ? get_type_name_filter_bits(ctor_type->hash)
+            : UINT64_MAX;
+    }
+
+    free(ctor_types);
+    return types;
+}
+
+// Get the custom attribute type side table, building it if needed.
+// Returns NULL if the table is empty or the side table can't be built.
+static custom_attribute_types_t* get_custom_attribute_types(mdcxt_t* cxt)
+{
+    mdtable_t* table = &cxt->tables[mdtid_CustomAttribute];
+    if (table->cxt == NULL || table->row_count == 0)
+        return NULL;
+
+    custom_attribute_types_t* types = (custom_attribute_types_t*)get_side_table(cxt, mdst_CustomAttributeTypes);
+    if (types == NULL)
+    {
+        types = build_custom_attribute_types(cxt, table);
+        if (types != NULL)
+            types = (custom_attribute_types_t*)publish_side_table(cxt, mdst_CustomAttributeTypes, types);
+    }
+    return types;
+}
+
+// Check if a parent may have an attribute with a type name hash.
+static bool may_have_custom_attribute(custom_attribute_types_t const* types, mdToken parent, uint64_t hash)
+{
+    uint64_t bits = get_type_name_filter_bits(hash);
+    for (uint32_t slot = custom_attribute_parent_slot(types, parent); types->parents[slot] != 0; slot = (slot + 1) & types->mask)
+    {
+        if (types->parents[slot] == parent)
+            return (types->filters[slot] & bits) == bits;
+    }
+    return false;
+}
+
+static md_custom_attribute_result_t is_custom_attribute_type_match(mdcursor_t attribute, mdstringview_t const* full_name)
+{
+    mdcursor_t ctor;
+    if (!md_get_column_value_as_cursor(attribute, mdtCustomAttribute_Type, &ctor))
+        return MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+
+    mdcursor_t type;
+    md_custom_attribute_result_t result = get_attribute_declaring_type(ctor, &type);
+    if (result != MD_CUSTOM_ATTRIBUTE_FOUND)
+        return result;
+
+    bool has_name;
+    mdstringview_t type_namespace;
+    mdstringview_t type_name;
+    result = get_attribute_type_name(type, &has_name, &type_namespace, &type_name);
+    if (result != MD_CUSTOM_ATTRIBUTE_FOUND)
+        return result;
+    if (!has_name)
+        return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+
+    char const* curr = full_name->str;
+    uint32_t remaining = full_name->length;
+    if (type_namespace.length != 0)
+    {
+        if (remaining <= type_namespace.length
+            || memcmp(curr, type_namespace.str, type_namespace.length) != 0
+            || curr[type_namespace.length] != '.')
+        {
+            return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+        }
+        curr += type_namespace.length + 1;
+        remaining -= type_namespace.length + 1;
+    }
+
+    return remaining == type_name.length && memcmp(curr, type_name.str, type_name.length) == 0
+        ? MD_CUSTOM_ATTRIBUTE_FOUND
+        : MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+}
+
+// Check an attribute that may be on the parent, using the side table to skip attributes of other types.
+static md_custom_attribute_result_t check_custom_attribute(custom_attribute_types_t const* types, mdcursor_t attribute, mdstringview_t const* full_name)
+{
+    // Attributes without a hash can't be ruled out by hash and are checked directly.
+    uint32_t row = CursorRow(&attribute);
+    if (types != NULL)
+    {
+        assert(row <= types->row_count);
+        if (types->type_hashes[row - 1] != 0 && types->type_hashes[row - 1] != full_name->hash)
+            return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+    }
+
+    // Hashes can collide, so compare the type's name.
+    return is_custom_attribute_type_match(attribute, full_name);
+}
+
+md_custom_attribute_result_t md_find_custom_attribute_by_name(mdhandle_t handle, mdToken parent, char const* type_name, mdcursor_t* attribute)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || type_name == NULL || attribute == NULL)
+        return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+
+    mdtable_t* table = &cxt->tables[mdtid_CustomAttribute];
+    if (table->cxt == NULL || table->row_count == 0)
+        return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+
+    mdstringview_t full_name;
+    md_create_utf8_view(type_name, &full_name);
+
+    // Without the side table, fall back to resolving the type of each of the parent's attributes.
+    custom_attribute_types_t* types = get_custom_attribute_types(cxt);
+    if (types != NULL && !may_have_custom_attribute(types, parent, full_name.hash))
+        return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+
+    // Attributes are checked in row order, so an unreadable attribute is reported
+    // if it comes before the first match.
+    md_custom_attribute_result_t result;
+    uint32_t const* rows;
+    uint32_t count;
+    if (md_find_reverse_references(handle, mdtid_CustomAttribute, mdtCustomAttribute_Parent, parent, &rows, &count))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            mdcursor_t c = create_cursor(table, rows[i]);
+            result = check_custom_attribute(types, c, &full_name);
+            if (result == MD_CUSTOM_ATTRIBUTE_NOT_FOUND)
+                continue;
+
+            if (result == MD_CUSTOM_ATTRIBUTE_FOUND)
+                *attribute = c;
+            return result;
+        }
+        return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+    }
+
+    // If the reverse index can't be built, search every row.
+    mdToken row_parent;
+    for (uint32_t row = 1; row <= table->row_count; ++row)
+    {
+        mdcursor_t c = create_cursor(table, row);
+        if (!md_get_column_value_as_token(c, mdtCustomAttribute_Parent, &row_parent))
+            return MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW;
+        if (row_parent != parent)
+            continue;
+
+        result = check_custom_attribute(types, c, &full_name);
+        if (result == MD_CUSTOM_ATTRIBUTE_NOT_FOUND)
+            continue;
+
+        if (result == MD_CUSTOM_ATTRIBUTE_FOUND)
+            *attribute = c;
+        return result;
+    }
+    return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+}
+
+typedef struct custom_attribute_query__
+{
+    mdToken type; // Constructor or declaring type, 0 to match by name
+    mdstringview_t full_name;
+} custom_attribute_query_t;
+
+static md_custom_attribute_result_t is_custom_attribute_query_match(custom_attribute_types_t const* types, mdcursor_t attribute, custom_attribute_query_t const* query)
+{
+    uint32_t row = CursorRow(&attribute);
+    if (query->type != 0)
+    {
+        bool match;
+        mdToken ctor;
+        if (ExtractTokenType(query->type) == mdtid_MethodDef || ExtractTokenType(query->type) == mdtid_MemberRef)
+        {
+            match = md_get_column_value_as_token(attribute, mdtCustomAttribute_Type, &ctor) && ctor == query->type;
+        }
+        else if (types != NULL)
+        {
+            match = types->types[row - 1] == query->type;
+        }
+        else
+        {
+            mdcursor_t ctor_cursor;
+            attribute_type_t attribute_type;
+            if (!md_get_column_value_as_cursor(attribute, mdtCustomAttribute_Type, &ctor_cursor))
+                return MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+            get_attribute_type(ctor_cursor, &attribute_type);
+            match = attribute_type.type == query->type;
+        }
+        return match ? MD_CUSTOM_ATTRIBUTE_FOUND : MD_CUSTOM_ATTRIBUTE_NOT_FOUND;
+    }
+
+    return check_custom_attribute(types, attribute, &query->full_name);
+}
+
+static int32_t find_custom_attributes(mdcursor_t c, uint32_t row_count, custom_attribute_query_t const* query, uint32_t out_length, mdToken* attributes, mdToken* parents)
+{
+    mdtable_t* table = CursorTable(&c);
+    if (table == NULL || table->table_id != mdtid_CustomAttribute || attributes == NULL || parents == NULL)
+        return -1;
+
+    custom_attribute_types_t* types = get_custom_attribute_types(table->cxt);
+    assert(types == NULL || types->row_count == table->row_count);
+
+    uint32_t row = CursorRow(&c);
+    uint32_t end = row_count < table->row_count + 1 - row ? row + row_count : table->row_count + 1;
+    int32_t found = 0;
+    for (; row < end && (uint32_t)found < out_length; ++row)
+    {
+        mdcursor_t attribute = create_cursor(table, row);
+        md_custom_attribute_result_t result = is_custom_attribute_query_match(types, attribute, query);
+        if (result == MD_CUSTOM_ATTRIBUTE_NOT_FOUND)
+            continue;
+        if (result != MD_CUSTOM_ATTRIBUTE_FOUND)
+            return -1;
+
+        if (!md_get_column_value_as_token(attribute, mdtCustomAttribute_Parent, &parents[found]))
+            return -1;
+        attributes[found++] = TokenFromRid(row, CreateTokenType(mdtid_CustomAttribute));
+    }
+    return found;
+}
+
+int32_t md_find_custom_attributes_by_name(mdcursor_t c, uint32_t row_count, char const* type_name, uint32_t out_length, mdToken* attributes, mdToken* parents)
+{
+    if (type_name == NULL)
+        return -1;
+
+    custom_attribute_query_t query;
+    query.type = 0;
+    md_create_utf8_view(type_name, &query.full_name);
+    return find_custom_attributes(c, row_count, &query, out_length, attributes, parents);
+}
+
+int32_t md_find_custom_attributes_by_type(mdcursor_t c, uint32_t row_count, mdToken type, uint32_t out_length, mdToken* attributes, mdToken* parents)
+{
+    if (RidFromToken(type) == 0)
+        return -1;
+
+    custom_attribute_query_t query;
+    query.type = type;
+    return find_custom_attributes(c, row_count, &query, out_length, attributes, parents);
+}
@@ -49,6 +49,19 @@ static inline bool safe_mul_size(size_t a, size_t b, size_t* result)
 #define ASSERT_ASSUME(x) (void)(x)
 #endif
 
+// Hint that the memory at the address will be read soon.
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH_READ(p) __builtin_prefetch((p), 0)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define PREFETCH_READ(p) _mm_prefetch((char const*)(p), _MM_HINT_T0)
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+#include <intrin.h>
+#define PREFETCH_READ(p) __prefetch((void const*)(p))
+#else
+#define PREFETCH_READ(p) (void)(p)
+#endif
+
 // Mutable data
 typedef struct mddata__
 {
@@ -164,6 +177,38 @@ typedef struct mdmem__ mdmem_t;
 
 typedef struct mdeditor__ mdeditor_t;
 
+// Lazily built side tables - see get_side_table().
+typedef enum
+{
+    mdst_StringInfo, // Length and hash of referenced #Strings entries
+    mdst_TypeDefIndex, // TypeDef rows by namespace and name
+    mdst_TypeRefIndex, // TypeRef rows by resolution scope, namespace and name
+    mdst_MemberRefIndex, // MemberRef rows by parent and name
+    mdst_ExportedTypeIndex, // ExportedType rows by enclosing type, namespace and name
+    mdst_ManifestResourceIndex, // ManifestResource rows by name
+    mdst_ModuleRefIndex, // ModuleRef rows by name
+    mdst_TypeSpecIndex, // TypeSpec rows by signature
+    mdst_StandAloneSigIndex, // StandAloneSig rows by signature
+    mdst_MethodSpecIndex, // MethodSpec rows by method and instantiation
+    mdst_ReverseIndexes, // Rows by the value of an index column - see md_build_reverse_index()
+    mdst_CustomAttributeTypes, // Attribute type name hashes and filters by parent - see md_find_custom_attribute_by_name()
+    mdst_EnumUnderlyingTypes, // Underlying type of each enum TypeDef - see md_custom_attribute_iterator_init()
+    mdst_FieldOwners, // Owner of each row in a list - see try_get_list_owner()
+    mdst_MethodDefOwners,
+    mdst_ParamOwners,
+    mdst_EventOwners,
+    mdst_PropertyOwners,
+#ifdef DNMD_PORTABLE_PDB
+    mdst_LocalVariableOwners,
+    mdst_LocalConstantOwners,
+    mdst_SequencePoints, // Sorted sequence points of each method - see md_find_sequence_point()
+    mdst_DocumentPaths, // Paths of each Document row with hash chains - see md_find_documents()
+    mdst_LocalScopes, // Nested LocalScope rows of each method - see md_find_local_scopes()
+    mdst_CustomDebugInformation, // CustomDebugInformation rows by parent and interned kind - see md_find_custom_debug_information()
+#endif // DNMD_PORTABLE_PDB
+    mdst_Count,
+} mdsidetable_id_t;
+
 typedef struct mdcxt__
 {
     uint32_t magic; // mdlib magic
@@ -192,6 +237,12 @@ typedef struct mdcxt__
 
     // Additional memory used for dynamic operations
     mdmem_t* mem;
+
+    // Lazily built side tables
+    void* side_tables[mdst_Count];
+
+    // Number of edits to existing rows - see md_get_edit_count()
+    uint64_t edit_count;
 } mdcxt_t;
 
 // Extract a context from the mdhandle_t.
@@ -201,6 +252,26 @@ mdcxt_t* extract_mdcxt(mdhandle_t md);
 void* alloc_mdmem(mdcxt_t* cxt, size_t length);
 void free_mdmem(mdcxt_t* cxt, void* mem);
 
+// Load a pointer that may be concurrently published by another thread.
+void* load_published_pointer(void** slot);
+
+// Publish a pointer to a NULL slot.
+// Returns the supplied value, or the value another thread already published to the slot.
+void* publish_pointer(void** slot, void* value);
+
+// Get and publish lazily built side tables.
+// A side table is computed on first use and is only published once it is fully built,
+// so concurrent readers observe either no side table or a complete one.
+// If another thread published the side table first, the supplied table is freed
+// and the published one is returned.
+// Side tables are allocated with malloc() and owned by the context once published.
+void* get_side_table(mdcxt_t* cxt, mdsidetable_id_t id);
+void* publish_side_table(mdcxt_t* cxt, mdsidetable_id_t id, void* table);
+
+// Free a side table that is invalidated by an edit.
+// Edits are never concurrent with reads, so this doesn't need to synchronize with readers.
+void drop_side_table(mdcxt_t* cxt, mdsidetable_id_t id);
+
 // Merge the supplied delta into the context.
 bool merge_in_delta(mdcxt_t* cxt, mdcxt_t* delta);
 
@@ -213,6 +284,9 @@ mdcxt_flag_t get_large_heap_flag(mdtcol_t heap_id);
 
 // Strings heap, #Strings - II.24.2.3
 bool try_get_string(mdcxt_t* cxt, size_t offset, char const** str);
+void get_string_view(mdcxt_t* cxt, uint32_t offset, char const* str, mdstringview_t* view);
+// Hash of "Namespace.Name", or "Name" without a namespace, equal to the hash of a view of that string.
+uint64_t get_full_type_name_hash(mdstringview_t const* type_namespace, mdstringview_t const* type_name);
 bool validate_strings_heap(mdcxt_t* cxt);
 uint32_t add_to_string_heap(mdcxt_t* cxt, char const* str);
 
@@ -223,8 +297,13 @@ uint32_t add_to_user_string_heap(mdcxt_t* cxt, char16_t const* str);
 
 // Blob heap, #Blob - II.24.2.4
 bool try_get_blob(mdcxt_t* cxt, size_t offset, uint8_t const** blob, uint32_t* blob_len);
+// Hash of a blob's bytes, computed the same way as string view hashes.
+uint64_t get_blob_hash(uint8_t const* blob, uint32_t blob_len);
 bool validate_blob_heap(mdcxt_t* cxt);
 uint32_t add_to_blob_heap(mdcxt_t* cxt, uint8_t const* data, uint32_t length);
+// Reserve a blob of 'length' bytes at the end of the #Blob heap and write its length prefix.
+// Returns a pointer to the blob content, which is valid until the heap is next grown.
+uint8_t* reserve_blob_heap_slot(mdcxt_t* cxt, uint32_t length, uint32_t* heap_offset);
 
 // GUID heap, #GUID - II.24.2.5
 bool try_get_guid(mdcxt_t* cxt, size_t idx, mdguid_t* guid);
@@ -412,8 +491,7 @@ bool create_bulk_access_context(mdcursor_t* cursor, col_index_t col_idx, uint32_
 bool read_column_data_and_advance(bulk_access_cxt_t* acxt, uint32_t* data);
 bool next_row(bulk_access_cxt_t* acxt);
 
-// Internal functions used to read/write columns with minimal validation.
-bool get_column_value_as_heap_offset(mdcursor_t c, col_index_t col_idx, uint32_t* offset);
+// Internal functions used to write columns with minimal validation.
 bool set_column_value_as_heap_offset(mdcursor_t c, col_index_t col_idx, uint32_t offset);
 
 //
@@ -455,6 +533,7 @@ bool decompress_i32(uint8_t const** data, size_t* data_len, int32_t* o);
 // compressed_len is an in/out parameter. If compress_u32 returns true, then
 // compressed_len is set to the number of bytes written to compressed.
 bool compress_u32(uint32_t data, uint8_t* compressed, size_t* compressed_len);
+bool compress_i32(int32_t data, uint8_t* compressed, size_t* compressed_len);
 
 // Editing
 bool create_and_fill_indirect_table(mdcxt_t* cxt, mdtable_id_t original_table, mdtable_id_t indirect_table);
@@ -463,6 +542,31 @@ uint8_t* get_writable_table_data(mdtable_t* table, bool make_writable);
 bool initialize_new_table_details(mdcxt_t* cxt, mdtable_id_t id, mdtable_t* table);
 int32_t update_shifted_row_references(mdcursor_t* c, uint32_t count, uint8_t col_index, mdtable_id_t updated_table, uint32_t original_starting_table_index, uint32_t new_starting_table_index);
 bool insert_row_into_table(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t row_index, mdcursor_t* new_row);
+
+// Update the indexes over a table before the row is written or inserted.
+void update_table_indexes(mdcxt_t* cxt, mdtable_id_t table_id, uint32_t row);
+
+// Free the reverse indexes in the mdst_ReverseIndexes side table.
+void free_reverse_indexes(void* indexes);
+
+#ifdef DNMD_PORTABLE_PDB
+// Free the per-method sequence points in the mdst_SequencePoints side table.
+void free_sequence_point_index(void* index);
+
+// Free the path arena and hash chains in the mdst_DocumentPaths side table.
+void free_document_index(void* index);
+
+// Drop the Portable PDB side tables that are built from the table.
+void drop_pdb_indexes(mdcxt_t* cxt, mdtable_id_t table_id);
+#endif // DNMD_PORTABLE_PDB
+
+// Find the owner of a row in a list (e.g. the TypeDef of a Field) with a side table
+// mapping each row to its owner. The side table is built on first use.
+// Returns false if the owner isn't recorded, callers should search the owner table instead.
+bool try_get_list_owner(mdcursor_t element, mdcursor_t* owner);
+
+// Find a non-nested TypeDef by namespace and name with a side table index.
+bool find_toplevel_typedef(mdcxt_t* cxt, char const* type_namespace, char const* type_name, mdcursor_t* type_def);
 #ifdef DNMD_PORTABLE_PDB
 bool update_referenced_type_system_table_row_count(mdcxt_t* cxt, mdtable_id_t updated_table, uint32_t new_max_row_count);
 #endif // DNMD_PORTABLE_PDB
@@ -80,112 +80,27 @@ md_blob_parse_result_t md_parse_document_name(mdhandle_t handle, uint8_t const*
     return result;
 }
 
-// We only support up to UINT32_MAX - 1 sequence points per method.
-// Technically, the number of supported sequence points in the spec is unbounded.
-// However, the PE format that an ECMA-335 blob is commonly wrapped in
-// can only support up to 4GB files, so we can't possibly have UINT32_MAX - 1 entries
-// in any existing scenario anyway.
-static uint32_t get_num_sequence_points(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len)
-{
-    uint32_t num_records = 0;
-    uint32_t ignored;
-    if (!decompress_u32(&blob, &blob_len, &ignored)) // header LocalSignature
-        return UINT32_MAX;
-
-    mdcursor_t document;
-    if (!md_get_column_value_as_cursor(method_debug_information, mdtMethodDebugInformation_Document, &document))
-        return UINT32_MAX;
-
-    if (CursorNull(&document) && !decompress_u32(&blob, &blob_len, &ignored)) // header InitialDocument
-        return UINT32_MAX;
-
-    bool first_record = true;
-    while (blob_len > 0)
-    {
-        if (num_records == UINT32_MAX)
-            return UINT32_MAX;
-        num_records++;
-        uint32_t il_offset;
-        if (!decompress_u32(&blob, &blob_len, &il_offset)) // ILOffset
-            return UINT32_MAX;
-
-        // The first record cannot be a document record
-        if (!first_record && il_offset == 0)
-        {
-            uint32_t document_offset;
-            if (!decompress_u32(&blob, &blob_len, &document_offset)) // Document
-                return UINT32_MAX;
-        }
-        else
-        {
-            // We don't need to check if we need to do an unsigned or signed decompression
-            // as we will always read the same number of bytes and we don't care about the values here
-            // as we're only calculating the number of records.
-            uint32_t delta_lines;
-            if (!decompress_u32(&blob, &blob_len, &delta_lines)) // DeltaLines
-                return UINT32_MAX;
-
-            uint32_t delta_columns;
-            if (!decompress_u32(&blob, &blob_len, &delta_columns)) // DeltaColumns
-                return UINT32_MAX;
-            if (delta_lines != 0 || delta_columns != 0)
-            {
-                uint32_t start_line;
-                if (!decompress_u32(&blob, &blob_len, &start_line)) // StartLine
-                    return UINT32_MAX;
-                uint32_t start_column;
-                if (!decompress_u32(&blob, &blob_len, &start_column)) // StartColumn
-                    return UINT32_MAX;
-            }
-        }
-
-        first_record = false;
-    }
-
-    return num_records;
-}
-
-md_blob_parse_result_t md_parse_sequence_points(
-    mdcursor_t method_debug_information,
-    uint8_t const* blob,
-    size_t blob_len,
-    md_sequence_points_t* sequence_points,
-    size_t* buffer_len)
+md_blob_parse_result_t md_sequence_point_iterator_init(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len, md_sequence_point_iterator_t* iterator)
 {
     if (CursorNull(&method_debug_information) || CursorEnd(&method_debug_information))
         return mdbpr_InvalidArgument;
 
-    if (blob == NULL || buffer_len == NULL)
+    if (blob == NULL || iterator == NULL)
         return mdbpr_InvalidArgument;
 
-    uint32_t num_records = get_num_sequence_points(method_debug_information, blob, blob_len);
-
-    if (num_records == UINT32_MAX)
-        return mdbpr_InvalidBlob;
-
-    size_t records_size;
-    size_t required_size;
-    if (!safe_mul_size(num_records, sizeof(sequence_points->records[0]), &records_size)
-        || !safe_add_size(sizeof(md_sequence_points_t), records_size, &required_size))
-    {
-        return mdbpr_InvalidBlob;
-    }
-    if (sequence_points == NULL || *buffer_len < required_size)
-    {
-        *buffer_len = required_size;
-        return mdbpr_InsufficientBuffer;
-    }
+    mdhandle_t handle = md_extract_handle_from_cursor(method_debug_information);
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return mdbpr_InvalidArgument;
 
     // header LocalSignature
-    if (!decompress_u32(&blob, &blob_len, &sequence_points->signature))
+    if (!decompress_u32(&blob, &blob_len, &iterator->signature))
         return mdbpr_InvalidBlob;
 
     mdcursor_t document;
     if (!md_get_column_value_as_cursor(method_debug_information, mdtMethodDebugInformation_Document, &document))
         return mdbpr_InvalidBlob;
 
-    mdcxt_t* cxt = extract_mdcxt(md_extract_handle_from_cursor(method_debug_information));
-
     // header InitialDocument
     // Per the Portable PDB spec, the initial document is determined by
     // the Document column of the MethodDebugInformation row. When the
@@ -195,7 +110,7 @@ md_blob_parse_result_t md_parse_sequence_points(
     {
         if (CursorEnd(&document))
             return mdbpr_InvalidBlob;
-        sequence_points->document = document;
+        iterator->document = document;
     }
     else
     {
@@ -205,181 +120,299 @@ md_blob_parse_result_t md_parse_sequence_points(
 
         if (document_rid != 0)
         {
-            if (!md_token_to_cursor(cxt, CreateTokenType(mdtid_Document) | document_rid, &sequence_points->document))
+            if (!md_token_to_cursor(cxt, CreateTokenType(mdtid_Document) | document_rid, &iterator->document))
                 return mdbpr_InvalidBlob;
         }
         else
         {
             // No document — initialize to a null-like cursor.
-            sequence_points->document = create_cursor(&cxt->tables[mdtid_Document], 0);
+            iterator->document = create_cursor(&cxt->tables[mdtid_Document], 0);
         }
     }
 
-    // Accumulate delta-encoded values into running sums per the Portable PDB spec.
-    // The blob encodes ILOffset, StartLine, and StartColumn as deltas from
-    // the previous record (absolute for the first). The "rolling_" output
-    // fields provide the accumulated (absolute) values to the caller.
-    uint32_t running_il = 0;
-    int64_t running_line = 0;
-    int64_t running_col = 0;
-    bool seen_non_hidden_sequence_point = false;
-    for (uint32_t i = 0; blob_len > 0 && i < num_records; ++i)
-    {
-        uint32_t il_offset;
-        if (!decompress_u32(&blob, &blob_len, &il_offset)) // ILOffset
-            return mdbpr_InvalidBlob;
+    iterator->_handle = handle;
+    iterator->_blob = blob;
+    iterator->_blob_len = blob_len;
+    iterator->_result = mdbpr_Success;
+    iterator->_il_offset = 0;
+    iterator->_start_line = 0;
+    iterator->_start_column = 0;
+    iterator->_first_record = true;
+    iterator->_seen_sequence_point = false;
+    return mdbpr_Success;
+}
 
-        // Check if the method transitioned
-        // into a new source file.
-        if (i != 0 && il_offset == 0)
-        {
-            uint32_t document_row_id;
-            if (!decompress_u32(&blob, &blob_len, &document_row_id)) // Document
-                return mdbpr_InvalidBlob;
+static bool add_signed_delta(uint32_t value, int32_t delta, uint32_t* result)
+{
+    int64_t sum = (int64_t)value + delta;
+    if (sum < 0 || sum > UINT32_MAX)
+        return false;
+    *result = (uint32_t)sum;
+    return true;
+}
 
-            sequence_points->records[i].kind = mdsp_DocumentRecord;
-            if (!md_token_to_cursor(cxt, CreateTokenType(mdtid_Document) | document_row_id, &sequence_points->records[i].document.document))
-                return mdbpr_InvalidBlob;
+// Decode the next record.
+// Delta-encoded values are accumulated into running sums per the Portable PDB spec.
+// The blob encodes ILOffset, StartLine, and StartColumn as deltas from
+// the previous record (absolute for the first).
+static bool decode_next_sequence_point(md_sequence_point_iterator_t* iterator, md_sequence_point_t* sequence_point)
+{
+    uint8_t const** blob = &iterator->_blob;
+    size_t* blob_len = &iterator->_blob_len;
+
+    uint32_t il_offset;
+    if (!decompress_u32(blob, blob_len, &il_offset)) // ILOffset
+        return false;
+
+    // Check if the method transitioned
+    // into a new source file.
+    // The first record cannot be a document record.
+    bool first_record = iterator->_first_record;
+    iterator->_first_record = false;
+    if (!first_record && il_offset == 0)
+    {
+        uint32_t document_row_id;
+        if (!decompress_u32(blob, blob_len, &document_row_id)) // Document
+            return false;
 
-            continue;
-        }
+        if (!md_token_to_cursor(iterator->_handle, CreateTokenType(mdtid_Document) | document_row_id, &iterator->document))
+            return false;
 
-        if (il_offset > UINT32_MAX - running_il)
-            return mdbpr_InvalidBlob;
-        running_il += il_offset;
+        memset(sequence_point, 0, sizeof(*sequence_point));
+        sequence_point->kind = mdsp_DocumentRecord;
+        sequence_point->document = iterator->document;
+        return true;
+    }
 
-        uint32_t delta_lines;
-        if (!decompress_u32(&blob, &blob_len, &delta_lines)) // DeltaLines
-            return mdbpr_InvalidBlob;
+    if (il_offset > UINT32_MAX - iterator->_il_offset)
+        return false;
+    iterator->_il_offset += il_offset;
 
-        int64_t delta_columns;
-        if (delta_lines == 0)
-        {
-            uint32_t raw_delta_columns;
-            if (!decompress_u32(&blob, &blob_len, &raw_delta_columns)) // DeltaColumns
-                return mdbpr_InvalidBlob;
-            delta_columns = raw_delta_columns;
-        }
-        else
-        {
-            int32_t raw_delta_columns;
-            if (!decompress_i32(&blob, &blob_len, &raw_delta_columns)) // DeltaColumns
-                return mdbpr_InvalidBlob;
-            delta_columns = raw_delta_columns;
-        }
+    uint32_t delta_lines;
+    if (!decompress_u32(blob, blob_len, &delta_lines)) // DeltaLines
+        return false;
 
-        // Check for hidden point
-        if (delta_lines == 0 && delta_columns == 0)
-        {
-            sequence_points->records[i].kind = mdsp_HiddenSequencePointRecord;
-            sequence_points->records[i].hidden_sequence_point.rolling_il_offset = running_il;
-            continue;
-        }
+    int32_t delta_columns;
+    if (delta_lines == 0)
+    {
+        uint32_t raw_delta_columns;
+        if (!decompress_u32(blob, blob_len, &raw_delta_columns)) // DeltaColumns
+            return false;
+        if (raw_delta_columns > INT32_MAX)
+            return false;
+        delta_columns = (int32_t)raw_delta_columns;
+    }
+    else
+    {
+        if (!decompress_i32(blob, blob_len, &delta_columns)) // DeltaColumns
+            return false;
+    }
+
+    // Check for hidden point
+    if (delta_lines == 0 && delta_columns == 0)
+    {
+        memset(sequence_point, 0, sizeof(*sequence_point));
+        sequence_point->kind = mdsp_HiddenSequencePointRecord;
+        sequence_point->il_offset = iterator->_il_offset;
+        sequence_point->document = iterator->document;
+        return true;
+    }
 
-        if (!seen_non_hidden_sequence_point)
+    if (!iterator->_seen_sequence_point)
+    {
+        iterator->_seen_sequence_point = true;
+        if (!decompress_u32(blob, blob_len, &iterator->_start_line) // StartLine
+            || !decompress_u32(blob, blob_len, &iterator->_start_column)) // StartColumn
         {
-            seen_non_hidden_sequence_point = true;
-            uint32_t start_line_raw;
-            if (!decompress_u32(&blob, &blob_len, &start_line_raw)) // StartLine
-                return mdbpr_InvalidBlob;
-            uint32_t start_column_raw;
-            if (!decompress_u32(&blob, &blob_len, &start_column_raw)) // StartColumn
-                return mdbpr_InvalidBlob;
-            running_line = start_line_raw;
-            running_col = start_column_raw;
+            return false;
         }
-        else
+    }
+    else
+    {
+        // Subsequent non-hidden records encode signed deltas.
+        int32_t delta_start_line;
+        int32_t delta_start_column;
+        if (!decompress_i32(blob, blob_len, &delta_start_line) // DeltaStartLine
+            || !decompress_i32(blob, blob_len, &delta_start_column) // DeltaStartColumn
+            || !add_signed_delta(iterator->_start_line, delta_start_line, &iterator->_start_line)
+            || !add_signed_delta(iterator->_start_column, delta_start_column, &iterator->_start_column))
         {
-            // Subsequent non-hidden records encode signed deltas.
-            int32_t start_line_raw;
-            if (!decompress_i32(&blob, &blob_len, &start_line_raw)) // DeltaStartLine
-                return mdbpr_InvalidBlob;
-            int32_t start_column_raw;
-            if (!decompress_i32(&blob, &blob_len, &start_column_raw)) // DeltaStartColumn
-                return mdbpr_InvalidBlob;
-            running_line += start_line_raw;
-            running_col += start_column_raw;
+            return false;
         }
+    }
 
-        sequence_points->records[i].kind = mdsp_SequencePointRecord;
-        sequence_points->records[i].sequence_point.rolling_il_offset = running_il;
-        sequence_points->records[i].sequence_point.delta_lines = delta_lines;
-        sequence_points->records[i].sequence_point.delta_columns = delta_columns;
-        sequence_points->records[i].sequence_point.rolling_start_line = running_line;
-        sequence_points->records[i].sequence_point.rolling_start_column = running_col;
+    sequence_point->kind = mdsp_SequencePointRecord;
+    sequence_point->document = iterator->document;
+    sequence_point->il_offset = iterator->_il_offset;
+    sequence_point->start_line = iterator->_start_line;
+    sequence_point->start_column = iterator->_start_column;
+    if (delta_lines > UINT32_MAX - iterator->_start_line
+        || !add_signed_delta(iterator->_start_column, delta_columns, &sequence_point->end_column))
+    {
+        return false;
     }
+    sequence_point->end_line = iterator->_start_line + delta_lines;
+    return true;
+}
 
-    if (blob_len != 0)
-        return mdbpr_InvalidBlob;
+bool md_sequence_point_iterator_next(md_sequence_point_iterator_t* iterator, md_sequence_point_t* sequence_point)
+{
+    if (iterator == NULL || sequence_point == NULL)
+        return false;
 
-    sequence_points->record_count = num_records;
-    return mdbpr_Success;
+    if (iterator->_result != mdbpr_Success || iterator->_blob_len == 0)
+        return false;
+
+    if (!decode_next_sequence_point(iterator, sequence_point))
+    {
+        iterator->_result = mdbpr_InvalidBlob;
+        return false;
+    }
+    return true;
 }
 
-md_blob_parse_result_t md_parse_local_constant_sig(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_local_constant_sig_t* local_constant_sig, size_t* buffer_len)
+md_blob_parse_result_t md_sequence_point_iterator_result(md_sequence_point_iterator_t const* iterator)
 {
-    if (extract_mdcxt(handle) == NULL || blob == NULL || buffer_len == NULL)
+    if (iterator == NULL)
         return mdbpr_InvalidArgument;
+    return iterator->_result;
+}
 
-    // Walk the custom modifiers portion of the signature to calculate the required buffer space.
-    uint8_t const* custom_modifiers_blob = blob;
-    size_t custom_modifiers_blob_len = blob_len;
-    uint32_t num_custom_modifiers = 0;
-    for (; custom_modifiers_blob_len > 0; ++num_custom_modifiers)
+static void set_sequence_point_record(md_sequence_points_t* sequence_points, uint32_t i, md_sequence_point_t const* record)
+{
+    sequence_points->records[i].kind = record->kind;
+    switch (record->kind)
     {
-        uint32_t element_type;
-        if (!decompress_u32(&custom_modifiers_blob, &custom_modifiers_blob_len, &element_type))
-            return mdbpr_InvalidBlob;
-
-        if (element_type != ELEMENT_TYPE_CMOD_OPT && element_type != ELEMENT_TYPE_CMOD_REQD)
+        case mdsp_DocumentRecord:
+            sequence_points->records[i].document.document = record->document;
+            break;
+        case mdsp_HiddenSequencePointRecord:
+            sequence_points->records[i].hidden_sequence_point.rolling_il_offset = record->il_offset;
             break;
+        case mdsp_SequencePointRecord:
+            sequence_points->records[i].sequence_point.rolling_il_offset = record->il_offset;
+            sequence_points->records[i].sequence_point.delta_lines = record->end_line - record->start_line;
+            sequence_points->records[i].sequence_point.delta_columns = (int64_t)record->end_column - record->start_column;
+            sequence_points->records[i].sequence_point.rolling_start_line = record->start_line;
+            sequence_points->records[i].sequence_point.rolling_start_column = record->start_column;
+            break;
+    }
+}
 
-        uint32_t cindex;
-        if (!decompress_u32(&custom_modifiers_blob, &custom_modifiers_blob_len, &cindex))
+md_blob_parse_result_t md_parse_sequence_points(
+    mdcursor_t method_debug_information,
+    uint8_t const* blob,
+    size_t blob_len,
+    md_sequence_points_t* sequence_points,
+    size_t* buffer_len)
+{
+    if (buffer_len == NULL)
+        return mdbpr_InvalidArgument;
+
+    md_sequence_point_iterator_t iterator;
+    md_blob_parse_result_t result = md_sequence_point_iterator_init(method_debug_information, blob, blob_len, &iterator);
+    if (result != mdbpr_Success)
+        return result;
+
+    // Count the records to size the caller's buffer.
+    // We only support up to UINT32_MAX - 1 sequence points per method.
+    // Technically, the number of supported sequence points in the spec is unbounded.
+    // However, the PE format that an ECMA-335 blob is commonly wrapped in
+    // can only support up to 4GB files, so we can't possibly have UINT32_MAX - 1 entries
+    // in any existing scenario anyway.
+    md_sequence_point_iterator_t counter = iterator;
+    md_sequence_point_t record;
+    uint32_t num_records = 0;
+    while (md_sequence_point_iterator_next(&counter, &record))
+    {
+        if (++num_records == UINT32_MAX)
             return mdbpr_InvalidBlob;
     }
+    if (md_sequence_point_iterator_result(&counter) != mdbpr_Success)
+        return mdbpr_InvalidBlob;
 
-    size_t modifiers_size;
+    size_t records_size;
     size_t required_size;
-    if (!safe_mul_size(num_custom_modifiers, sizeof(local_constant_sig->custom_modifiers[0]), &modifiers_size)
-        || !safe_add_size(sizeof(md_local_constant_sig_t), modifiers_size, &required_size))
+    if (!safe_mul_size(num_records, sizeof(sequence_points->records[0]), &records_size)
+        || !safe_add_size(sizeof(md_sequence_points_t), records_size, &required_size))
     {
         return mdbpr_InvalidBlob;
     }
-    if (local_constant_sig == NULL || *buffer_len < required_size)
+    if (sequence_points == NULL || *buffer_len < required_size)
     {
         *buffer_len = required_size;
         return mdbpr_InsufficientBuffer;
     }
 
-    local_constant_sig->custom_modifier_count = num_custom_modifiers;
+    sequence_points->signature = iterator.signature;
+    sequence_points->document = iterator.document;
+    for (uint32_t i = 0; md_sequence_point_iterator_next(&iterator, &record); ++i)
+    {
+        assert(i < num_records);
+        set_sequence_point_record(sequence_points, i, &record);
+    }
 
-    for (uint32_t i = 0; i < num_custom_modifiers; ++i)
+    sequence_points->record_count = num_records;
+    return mdbpr_Success;
+}
+
+// Returns true if the next element of a signature is a custom modifier.
+static bool is_custom_modifier_next(uint8_t const* blob, size_t blob_len)
+{
+    uint32_t element_type;
+    return decompress_u32(&blob, &blob_len, &element_type)
+        && (element_type == ELEMENT_TYPE_CMOD_OPT || element_type == ELEMENT_TYPE_CMOD_REQD);
+}
+
+static bool count_custom_modifiers(uint8_t const* blob, size_t blob_len, uint32_t* count)
+{
+    uint32_t num_custom_modifiers = 0;
+    for (; blob_len > 0; ++num_custom_modifiers)
     {
         uint32_t element_type;
-        if (!decompress_u32(&custom_modifiers_blob, &custom_modifiers_blob_len, &element_type))
-            return mdbpr_InvalidBlob;
+        if (!decompress_u32(&blob, &blob_len, &element_type))
+            return false;
 
         if (element_type != ELEMENT_TYPE_CMOD_OPT && element_type != ELEMENT_TYPE_CMOD_REQD)
             break;
 
-        local_constant_sig->custom_modifiers[i].required = element_type == ELEMENT_TYPE_CMOD_REQD;
-
         uint32_t cindex;
-        if (!decompress_u32(&custom_modifiers_blob, &custom_modifiers_blob_len, &cindex))
-            return mdbpr_InvalidBlob;
-
-        mdtable_id_t table;
-        uint32_t row_id;
-        // Technically the spec defines this as a TypeDefOrRefOrSpecEncoded token,
-        // but the implementation of the TypeDefOrRef coded index has the same configuration as the
-        // TypeDefOrRefOrSpec encoding.
-        if (!decompose_coded_index(cindex, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
-            return mdbpr_InvalidBlob;
-
-        local_constant_sig->custom_modifiers[i].type = CreateTokenType(table) | row_id;
+        if (!decompress_u32(&blob, &blob_len, &cindex))
+            return false;
     }
+    *count = num_custom_modifiers;
+    return true;
+}
+
+// Read the custom modifier at the start of the blob.
+static bool read_custom_modifier(uint8_t const** blob, size_t* blob_len, bool* required, mdToken* type)
+{
+    uint32_t element_type;
+    if (!decompress_u32(blob, blob_len, &element_type))
+        return false;
+
+    assert(element_type == ELEMENT_TYPE_CMOD_OPT || element_type == ELEMENT_TYPE_CMOD_REQD);
+    *required = element_type == ELEMENT_TYPE_CMOD_REQD;
+
+    uint32_t cindex;
+    if (!decompress_u32(blob, blob_len, &cindex))
+        return false;
+
+    mdtable_id_t table;
+    uint32_t row_id;
+    // Technically the spec defines this as a TypeDefOrRefOrSpecEncoded token,
+    // but the implementation of the TypeDefOrRef coded index has the same configuration as the
+    // TypeDefOrRefOrSpec encoding.
+    if (!decompose_coded_index(cindex, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
+        return false;
+
+    *type = CreateTokenType(table) | row_id;
+    return true;
+}
 
+// Read the constant type and value that follow the custom modifiers of a LocalConstantSig blob.
+static md_blob_parse_result_t read_local_constant_value(uint8_t const* blob, size_t blob_len, md_local_constant_sig_t* local_constant_sig)
+{
     uint32_t type_code;
     if (!decompress_u32(&blob, &blob_len, &type_code))
         return mdbpr_InvalidBlob;
@@ -527,6 +560,41 @@ md_blob_parse_result_t md_parse_local_constant_sig(mdhandle_t handle, uint8_t co
     return mdbpr_Success;
 }
 
+md_blob_parse_result_t md_parse_local_constant_sig(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_local_constant_sig_t* local_constant_sig, size_t* buffer_len)
+{
+    if (extract_mdcxt(handle) == NULL || blob == NULL || buffer_len == NULL)
+        return mdbpr_InvalidArgument;
+
+    // Walk the custom modifiers portion of the signature to calculate the required buffer space.
+    uint32_t num_custom_modifiers;
+    if (!count_custom_modifiers(blob, blob_len, &num_custom_modifiers))
+        return mdbpr_InvalidBlob;
+
+    size_t modifiers_size;
+    size_t required_size;
+    if (!safe_mul_size(num_custom_modifiers, sizeof(local_constant_sig->custom_modifiers[0]), &modifiers_size)
+        || !safe_add_size(sizeof(md_local_constant_sig_t), modifiers_size, &required_size))
+    {
+        return mdbpr_InvalidBlob;
+    }
+    if (local_constant_sig == NULL || *buffer_len < required_size)
+    {
+        *buffer_len = required_size;
+        return mdbpr_InsufficientBuffer;
+    }
+
+    local_constant_sig->custom_modifier_count = num_custom_modifiers;
+
+    // Read the custom modifiers from the start of the signature, which leaves the blob at the type code.
+    for (uint32_t i = 0; i < num_custom_modifiers; ++i)
+    {
+        if (!read_custom_modifier(&blob, &blob_len, &local_constant_sig->custom_modifiers[i].required, &local_constant_sig->custom_modifiers[i].type))
+            return mdbpr_InvalidBlob;
+    }
+
+    return read_local_constant_value(blob, blob_len, local_constant_sig);
+}
+
 // We only support up to UINT32_MAX - 1 imports per Imports blob.
 // Technically, the number of supported imports in the spec is unbounded.
 // However, the PE format that an ECMA-335 blob is commonly wrapped in
@@ -596,6 +664,128 @@ static uint32_t get_num_imports(uint8_t const* blob, size_t blob_len)
     return num_imports;
 }
 
+// Read the import at the start of the blob into imports[i].
+static bool read_import(mdcxt_t* cxt, uint8_t const** blob, size_t* blob_len, md_imports_t* imports, uint32_t i)
+{
+    uint8_t kind;
+    if (!read_u8(blob, blob_len, &kind))
+        return false;
+
+    // Zero out this import entry.
+    memset(&imports->imports[i], 0, sizeof(imports->imports[i]));
+
+    imports->imports[i].kind = kind;
+    uint32_t raw;
+    switch (kind)
+    {
+        case mdidk_ImportNamespace:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
+                return false;
+            break;
+        case mdidk_ImportAssemblyNamespace:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
+
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
+                return false;
+            break;
+        case mdidk_ImportType:
+        {
+            mdtable_id_t table;
+            uint32_t row_id;
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!decompose_coded_index(raw, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
+                return false;
+
+            imports->imports[i].target_type = CreateTokenType(table) | row_id;
+            break;
+        }
+        case mdidk_AliasNamespace:
+        case mdidk_ImportXmlNamespace:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
+                return false;
+
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
+                return false;
+            break;
+        case mdidk_ImportAssemblyReferenceAlias:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
+                return false;
+            break;
+        case mdidk_AliasAssemblyReference:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
+                return false;
+
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
+            break;
+        case mdidk_AliasAssemblyNamespace:
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
+                return false;
+
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
+
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
+                return false;
+            break;
+        case mdidk_AliasType:
+        {
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
+                return false;
+
+            mdtable_id_t table;
+            uint32_t row_id;
+            if (!decompress_u32(blob, blob_len, &raw))
+                return false;
+
+            if (!decompose_coded_index(raw, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
+                return false;
+
+            imports->imports[i].target_type = CreateTokenType(table) | row_id;
+            break;
+        }
+        default:
+            return false;
+    }
+    return true;
+}
+
 md_blob_parse_result_t md_parse_imports(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_imports_t* imports, size_t* buffer_len)
 {
     mdcxt_t* cxt = extract_mdcxt(handle);
@@ -622,122 +812,823 @@ md_blob_parse_result_t md_parse_imports(mdhandle_t handle, uint8_t const* blob,
     imports->count = num_imports;
     for (uint32_t i = 0; i < num_imports; ++i)
     {
-        uint8_t kind;
-        if (!read_u8(&blob, &blob_len, &kind))
+        if (!read_import(cxt, &blob, &blob_len, imports, i))
             return mdbpr_InvalidBlob;
+    }
+    return mdbpr_Success;
+}
 
-        // Zero out this import entry.
-        memset(&imports->imports[i], 0, sizeof(imports->imports[i]));
+// Results in a parse arena are aligned for their largest members.
+#define PARSE_ARENA_ALIGNMENT sizeof(uint64_t)
 
-        imports->imports[i].kind = kind;
-        uint32_t raw;
-        switch (kind)
-        {
-            case mdidk_ImportNamespace:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+void md_init_parse_arena(md_parse_arena_t* arena, void* buffer, size_t capacity)
+{
+    assert(arena != NULL);
+    arena->buffer = (uint8_t*)buffer;
+    arena->capacity = buffer != NULL ? capacity : 0;
+    arena->used = 0;
+    arena->needed = 0;
+}
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
-                    return mdbpr_InvalidBlob;
-                break;
-            case mdidk_ImportAssemblyNamespace:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+void md_reset_parse_arena(md_parse_arena_t* arena)
+{
+    assert(arena != NULL);
+    arena->used = 0;
+    arena->needed = 0;
+}
 
-                imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
+// A flexible array result being appended to a parse arena.
+// The result grows in place one record at a time, so it is decoded in a single pass.
+// Once the arena is full, decoding continues without writing to measure the space the result needs.
+typedef struct arena_result__
+{
+    md_parse_arena_t* arena;
+    size_t start;
+    size_t size;
+    bool fits;
+    bool valid;
+} arena_result_t;
+
+static bool begin_arena_result(md_parse_arena_t* arena, size_t header_size, arena_result_t* result)
+{
+    if (arena == NULL || arena->used > arena->capacity)
+        return false;
+
+    size_t misalignment = ((uintptr_t)arena->buffer + arena->used) % PARSE_ARENA_ALIGNMENT;
+    result->arena = arena;
+    result->start = arena->used + (misalignment != 0 ? PARSE_ARENA_ALIGNMENT - misalignment : 0);
+    result->size = header_size;
+    result->fits = result->start <= arena->capacity && header_size <= arena->capacity - result->start;
+    result->valid = true;
+    return true;
+}
 
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+static void* get_arena_result(arena_result_t const* result)
+{
+    assert(result->fits);
+    return result->arena->buffer + result->start;
+}
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
-                    return mdbpr_InvalidBlob;
-                break;
-            case mdidk_ImportType:
-            {
-                mdtable_id_t table;
-                uint32_t row_id;
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+// Grow the result to hold 'record_count' records. Returns true if the records fit in the arena.
+static bool grow_arena_result(arena_result_t* result, size_t header_size, size_t record_size, size_t record_count)
+{
+    size_t records_size;
+    if (!safe_mul_size(record_count, record_size, &records_size)
+        || !safe_add_size(header_size, records_size, &result->size))
+    {
+        result->valid = false;
+        result->fits = false;
+        return false;
+    }
 
-                if (!decompose_coded_index(raw, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
-                    return mdbpr_InvalidBlob;
+    result->fits = result->fits && result->size <= result->arena->capacity - result->start;
+    return result->fits;
+}
 
-                imports->imports[i].target_type = CreateTokenType(table) | row_id;
-                break;
+// Commit the result to the arena, or record the space it needs if the arena is full.
+static md_blob_parse_result_t end_arena_result(arena_result_t const* result, md_blob_parse_result_t status)
+{
+    md_parse_arena_t* arena = result->arena;
+    if (status != mdbpr_Success)
+        return status;
+    if (!result->valid)
+        return mdbpr_InvalidBlob;
+
+    if (!result->fits)
+    {
+        size_t end;
+        if (!safe_add_size(result->start, result->size, &end))
+            return mdbpr_InvalidBlob;
+        arena->needed = end - arena->used;
+        return mdbpr_InsufficientBuffer;
+    }
+
+    arena->used = result->start + result->size;
+    arena->needed = 0;
+    return mdbpr_Success;
+}
+
+md_blob_parse_result_t md_parse_sequence_points_in_arena(
+    mdcursor_t method_debug_information,
+    uint8_t const* blob,
+    size_t blob_len,
+    md_parse_arena_t* arena,
+    md_sequence_points_t** sequence_points)
+{
+    if (sequence_points == NULL)
+        return mdbpr_InvalidArgument;
+
+    md_sequence_point_iterator_t iterator;
+    md_blob_parse_result_t result = md_sequence_point_iterator_init(method_debug_information, blob, blob_len, &iterator);
+    if (result != mdbpr_Success)
+        return result;
+
+    arena_result_t arena_result;
+    if (!begin_arena_result(arena, sizeof(md_sequence_points_t), &arena_result))
+        return mdbpr_InvalidArgument;
+
+    md_sequence_points_t* parsed = NULL;
+    if (arena_result.fits)
+    {
+        parsed = (md_sequence_points_t*)get_arena_result(&arena_result);
+        parsed->signature = iterator.signature;
+        parsed->document = iterator.document;
+    }
+
+    // See md_parse_sequence_points() for the record limit.
+    md_sequence_point_t record;
+    uint32_t num_records = 0;
+    while (md_sequence_point_iterator_next(&iterator, &record))
+    {
+        if (num_records == UINT32_MAX - 1)
+            return mdbpr_InvalidBlob;
+
+        if (grow_arena_result(&arena_result, sizeof(md_sequence_points_t), sizeof(parsed->records[0]), (size_t)num_records + 1))
+            set_sequence_point_record(parsed, num_records, &record);
+        num_records++;
+    }
+
+    result = end_arena_result(&arena_result, md_sequence_point_iterator_result(&iterator));
+    if (result != mdbpr_Success)
+        return result;
+
+    parsed->record_count = num_records;
+    *sequence_points = parsed;
+    return mdbpr_Success;
+}
+
+md_blob_parse_result_t md_parse_local_constant_sig_in_arena(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_parse_arena_t* arena, md_local_constant_sig_t** local_constant_sig)
+{
+    if (extract_mdcxt(handle) == NULL || blob == NULL || local_constant_sig == NULL)
+        return mdbpr_InvalidArgument;
+
+    arena_result_t arena_result;
+    if (!begin_arena_result(arena, sizeof(md_local_constant_sig_t), &arena_result))
+        return mdbpr_InvalidArgument;
+
+    md_local_constant_sig_t* parsed = arena_result.fits ? (md_local_constant_sig_t*)get_arena_result(&arena_result) : NULL;
+    uint32_t num_custom_modifiers = 0;
+    for (; is_custom_modifier_next(blob, blob_len); ++num_custom_modifiers)
+    {
+        bool required;
+        mdToken type;
+        if (!read_custom_modifier(&blob, &blob_len, &required, &type))
+            return mdbpr_InvalidBlob;
+
+        if (grow_arena_result(&arena_result, sizeof(md_local_constant_sig_t), sizeof(parsed->custom_modifiers[0]), (size_t)num_custom_modifiers + 1))
+        {
+            parsed->custom_modifiers[num_custom_modifiers].required = required;
+            parsed->custom_modifiers[num_custom_modifiers].type = type;
+        }
+    }
+
+    // A constant that doesn't fit is decoded into scratch space, so an invalid blob fails the same in a full arena.
+    md_local_constant_sig_t scratch;
+    md_blob_parse_result_t result;
+    if (arena_result.fits)
+    {
+        parsed->custom_modifier_count = num_custom_modifiers;
+        result = read_local_constant_value(blob, blob_len, parsed);
+    }
+    else
+    {
+        result = read_local_constant_value(blob, blob_len, &scratch);
+    }
+
+    result = end_arena_result(&arena_result, result);
+    if (result != mdbpr_Success)
+        return result;
+
+    *local_constant_sig = parsed;
+    return mdbpr_Success;
+}
+
+md_blob_parse_result_t md_parse_imports_in_arena(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_parse_arena_t* arena, md_imports_t** imports)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || blob == NULL || imports == NULL)
+        return mdbpr_InvalidArgument;
+
+    arena_result_t arena_result;
+    if (!begin_arena_result(arena, sizeof(md_imports_t), &arena_result))
+        return mdbpr_InvalidArgument;
+
+    md_imports_t* parsed = arena_result.fits ? (md_imports_t*)get_arena_result(&arena_result) : NULL;
+
+    // Once the arena is full, the rest of the imports are decoded into scratch space to validate them
+    // against the heaps while measuring, so an invalid blob fails the same in a full arena.
+    uint64_t scratch[(sizeof(md_imports_t) + sizeof(parsed->imports[0]) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    uint32_t num_imports = 0;
+    while (blob_len > 0)
+    {
+        // See get_num_imports() for the import limit.
+        if (num_imports == UINT32_MAX - 1)
+            return mdbpr_InvalidBlob;
+
+        bool fits = grow_arena_result(&arena_result, sizeof(md_imports_t), sizeof(parsed->imports[0]), (size_t)num_imports + 1);
+        if (!(fits
+            ? read_import(cxt, &blob, &blob_len, parsed, num_imports)
+            : read_import(cxt, &blob, &blob_len, (md_imports_t*)scratch, 0)))
+            return mdbpr_InvalidBlob;
+        num_imports++;
+    }
+
+    md_blob_parse_result_t result = end_arena_result(&arena_result, mdbpr_Success);
+    if (result != mdbpr_Success)
+        return result;
+
+    parsed->count = num_imports;
+    *imports = parsed;
+    return mdbpr_Success;
+}
+
+// Writer shared by the blob encoders.
+// A writer without a buffer only measures, so each encoder runs once to size its blob
+// and once more to write the blob into the space reserved for it in the #Blob heap.
+typedef struct blob_writer__
+{
+    uint8_t* ptr;
+    size_t capacity;
+    size_t len;
+    bool ok;
+} blob_writer_t;
+
+static void emit_bytes(blob_writer_t* writer, uint8_t const* data, size_t len)
+{
+    if (!writer->ok || len == 0)
+        return;
+
+    if (writer->ptr != NULL)
+    {
+        if (writer->capacity - writer->len < len)
+        {
+            writer->ok = false;
+            return;
+        }
+        memcpy(writer->ptr + writer->len, data, len);
+    }
+    writer->len += len;
+}
+
+static void emit_u8(blob_writer_t* writer, uint8_t value)
+{
+    emit_bytes(writer, &value, 1);
+}
+
+static void emit_compressed_u32(blob_writer_t* writer, uint32_t value)
+{
+    uint8_t compressed[4];
+    size_t compressed_len = ARRAY_SIZE(compressed);
+    if (!compress_u32(value, compressed, &compressed_len))
+        writer->ok = false;
+    emit_bytes(writer, compressed, compressed_len);
+}
+
+static void emit_compressed_i32(blob_writer_t* writer, int64_t value)
+{
+    uint8_t compressed[4];
+    size_t compressed_len = ARRAY_SIZE(compressed);
+    if (value < INT32_MIN || value > INT32_MAX || !compress_i32((int32_t)value, compressed, &compressed_len))
+        writer->ok = false;
+    emit_bytes(writer, compressed, compressed_len);
+}
+
+// TypeDefOrRefOrSpecEncoded - ECMA-335 II.23.2.8
+// The encoding has the same configuration as the TypeDefOrRef coded index.
+static void emit_type(blob_writer_t* writer, mdToken type)
+{
+    uint32_t coded_index;
+    if (!compose_coded_index(type, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &coded_index))
+    {
+        writer->ok = false;
+        return;
+    }
+    emit_compressed_u32(writer, coded_index);
+}
+
+// Reserve the blob measured by 'measured' in the #Blob heap.
+// Returns the heap offset of the blob, 0 for the empty blob, with 'writer' set up to fill it in.
+static bool reserve_encoded_blob(mdcxt_t* cxt, blob_writer_t const* measured, blob_writer_t* writer, uint32_t* heap_offset)
+{
+    if (!measured->ok || measured->len > UINT32_MAX)
+        return false;
+
+    *heap_offset = 0;
+    writer->ptr = NULL;
+    writer->capacity = 0;
+    writer->len = 0;
+    writer->ok = true;
+    if (measured->len == 0)
+        return true;
+
+    uint8_t* blob = reserve_blob_heap_slot(cxt, (uint32_t)measured->len, heap_offset);
+    if (blob == NULL)
+        return false;
+
+    writer->ptr = blob;
+    writer->capacity = measured->len;
+    return true;
+}
+
+// The values passed to the encoders can point into the #Blob heap of the same handle, e.g. when they were
+// parsed from another row. Adding to the heap can move it, so such pointers are rebased onto its current location.
+typedef struct blob_heap_view__
+{
+    uintptr_t start;
+    size_t size;
+} blob_heap_view_t;
+
+static blob_heap_view_t get_blob_heap_view(mdcxt_t* cxt)
+{
+    blob_heap_view_t view = { (uintptr_t)cxt->blob_heap.ptr, cxt->blob_heap.size };
+    return view;
+}
+
+static uint8_t const* rebase_blob_heap_pointer(mdcxt_t* cxt, blob_heap_view_t const* view, uint8_t const* ptr)
+{
+    uintptr_t address = (uintptr_t)ptr;
+    if (ptr == NULL || address < view->start || address - view->start >= view->size)
+        return ptr;
+    return cxt->blob_heap.ptr + (address - view->start);
+}
+
+static bool get_row_of_table(mdcursor_t cursor, mdtable_id_t table_id, uint32_t* row)
+{
+    mdToken tk;
+    if (!md_cursor_to_token(cursor, &tk)
+        || ExtractTokenType(tk) != table_id
+        || RidFromToken(tk) == 0)
+    {
+        return false;
+    }
+    *row = RidFromToken(tk);
+    return true;
+}
+
+static void emit_sequence_points(
+    blob_writer_t* writer,
+    uint32_t signature_row,
+    uint32_t initial_document_row,
+    bool emit_initial_document,
+    md_sequence_point_t const* sequence_points,
+    uint32_t count)
+{
+    emit_compressed_u32(writer, signature_row); // header LocalSignature
+    if (emit_initial_document)
+        emit_compressed_u32(writer, initial_document_row); // header InitialDocument
+
+    uint32_t document_row = initial_document_row;
+    bool first_record = true;
+    bool seen_sequence_point = false;
+    uint32_t il_offset = 0;
+    uint32_t start_line = 0;
+    uint32_t start_column = 0;
+    for (uint32_t i = 0; i < count && writer->ok; ++i)
+    {
+        md_sequence_point_t const* record = &sequence_points[i];
+        if (record->kind == mdsp_DocumentRecord)
+            continue;
+
+        if (record->kind != mdsp_SequencePointRecord && record->kind != mdsp_HiddenSequencePointRecord)
+        {
+            writer->ok = false;
+            return;
+        }
+
+        uint32_t record_document_row;
+        if (!get_row_of_table(record->document, mdtid_Document, &record_document_row))
+        {
+            writer->ok = false;
+            return;
+        }
+
+        // The first record is always in the initial document.
+        if (record_document_row != document_row)
+        {
+            assert(!first_record);
+            emit_compressed_u32(writer, 0); // ILOffset
+            emit_compressed_u32(writer, record_document_row); // Document
+            document_row = record_document_row;
+        }
+
+        // A zero IL offset delta marks a document record, so the IL offsets after the first record must increase.
+        if (first_record)
+        {
+            emit_compressed_u32(writer, record->il_offset); // ILOffset
+        }
+        else
+        {
+            if (record->il_offset <= il_offset)
+            {
+                writer->ok = false;
+                return;
             }
-            case mdidk_AliasNamespace:
-            case mdidk_ImportXmlNamespace:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+            emit_compressed_u32(writer, record->il_offset - il_offset); // ILOffset
+        }
+        first_record = false;
+        il_offset = record->il_offset;
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
-                    return mdbpr_InvalidBlob;
+        if (record->kind == mdsp_HiddenSequencePointRecord)
+        {
+            emit_compressed_u32(writer, 0); // DeltaLines
+            emit_compressed_u32(writer, 0); // DeltaColumns
+            continue;
+        }
 
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+        // A sequence point on a single line must span at least one column, otherwise it reads back as hidden.
+        int64_t delta_columns = (int64_t)record->end_column - record->start_column;
+        if (record->end_line < record->start_line
+            || (record->end_line == record->start_line && delta_columns <= 0))
+        {
+            writer->ok = false;
+            return;
+        }
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
-                    return mdbpr_InvalidBlob;
-                break;
-            case mdidk_ImportAssemblyReferenceAlias:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+        uint32_t delta_lines = record->end_line - record->start_line;
+        emit_compressed_u32(writer, delta_lines); // DeltaLines
+        if (delta_lines == 0)
+        {
+            emit_compressed_u32(writer, (uint32_t)delta_columns); // DeltaColumns
+        }
+        else
+        {
+            emit_compressed_i32(writer, delta_columns); // DeltaColumns
+        }
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
-                    return mdbpr_InvalidBlob;
-                break;
-            case mdidk_AliasAssemblyReference:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+        if (!seen_sequence_point)
+        {
+            seen_sequence_point = true;
+            emit_compressed_u32(writer, record->start_line); // StartLine
+            emit_compressed_u32(writer, record->start_column); // StartColumn
+        }
+        else
+        {
+            emit_compressed_i32(writer, (int64_t)record->start_line - start_line); // DeltaStartLine
+            emit_compressed_i32(writer, (int64_t)record->start_column - start_column); // DeltaStartColumn
+        }
+        start_line = record->start_line;
+        start_column = record->start_column;
+    }
+}
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
-                    return mdbpr_InvalidBlob;
+bool md_encode_sequence_points(mdcursor_t method_debug_information, mdToken local_signature, md_sequence_point_t const* sequence_points, uint32_t count)
+{
+    if (CursorNull(&method_debug_information) || CursorEnd(&method_debug_information))
+        return false;
 
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+    mdcxt_t* cxt = CursorTable(&method_debug_information)->cxt;
+    if (CursorTable(&method_debug_information)->table_id != mdtid_MethodDebugInformation)
+        return false;
 
-                imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
-                break;
-            case mdidk_AliasAssemblyNamespace:
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+    if (sequence_points == NULL && count != 0)
+        return false;
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
-                    return mdbpr_InvalidBlob;
+    uint32_t signature_row = RidFromToken(local_signature);
+    if (signature_row != 0 && ExtractTokenType(local_signature) != mdtid_StandAloneSig)
+        return false;
 
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+    // The Document column holds the document when all records are in a single document.
+    // Otherwise it is nil and the blob starts with the initial document.
+    uint32_t initial_document_row = 0;
+    bool single_document = true;
+    mdcursor_t initial_document = method_debug_information;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (sequence_points[i].kind == mdsp_DocumentRecord)
+            continue;
 
-                imports->imports[i].assembly = CreateTokenType(mdtid_AssemblyRef) | raw;
+        uint32_t document_row;
+        if (!get_row_of_table(sequence_points[i].document, mdtid_Document, &document_row))
+            return false;
 
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+        if (initial_document_row == 0)
+        {
+            initial_document_row = document_row;
+            initial_document = sequence_points[i].document;
+        }
+        else if (document_row != initial_document_row)
+        {
+            single_document = false;
+            break;
+        }
+    }
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].target_namespace, &imports->imports[i].target_namespace_len))
-                    return mdbpr_InvalidBlob;
-                break;
-            case mdidk_AliasType:
+    // A method without sequence points has a nil SequencePoints blob and Document.
+    if (initial_document_row == 0)
+    {
+        return md_set_column_value_as_token(method_debug_information, mdtMethodDebugInformation_Document, CreateTokenType(mdtid_Document))
+            && set_column_value_as_heap_offset(method_debug_information, mdtMethodDebugInformation_SequencePoints, 0);
+    }
+
+    blob_writer_t measured = { NULL, 0, 0, true };
+    emit_sequence_points(&measured, signature_row, initial_document_row, !single_document, sequence_points, count);
+
+    blob_writer_t writer;
+    uint32_t heap_offset;
+    if (!reserve_encoded_blob(cxt, &measured, &writer, &heap_offset))
+        return false;
+
+    emit_sequence_points(&writer, signature_row, initial_document_row, !single_document, sequence_points, count);
+    assert(writer.ok && writer.len == measured.len);
+
+    bool document_set = single_document
+        ? md_set_column_value_as_cursor(method_debug_information, mdtMethodDebugInformation_Document, initial_document)
+        : md_set_column_value_as_token(method_debug_information, mdtMethodDebugInformation_Document, CreateTokenType(mdtid_Document));
+
+    return document_set
+        && set_column_value_as_heap_offset(method_debug_information, mdtMethodDebugInformation_SequencePoints, heap_offset);
+}
+
+// Get the size of a primitive constant value, 0 for a variable sized value.
+// Returns false if the type code can't be a primitive constant.
+static bool get_primitive_constant_size(uint8_t type_code, size_t* size)
+{
+    switch (type_code)
+    {
+        case ELEMENT_TYPE_BOOLEAN:
+        case ELEMENT_TYPE_I1:
+        case ELEMENT_TYPE_U1:
+            *size = 1;
+            return true;
+        case ELEMENT_TYPE_CHAR:
+        case ELEMENT_TYPE_I2:
+        case ELEMENT_TYPE_U2:
+            *size = 2;
+            return true;
+        case ELEMENT_TYPE_I4:
+        case ELEMENT_TYPE_U4:
+        case ELEMENT_TYPE_R4:
+            *size = 4;
+            return true;
+        case ELEMENT_TYPE_I8:
+        case ELEMENT_TYPE_U8:
+        case ELEMENT_TYPE_R8:
+            *size = 8;
+            return true;
+        case ELEMENT_TYPE_STRING:
+            *size = 0;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void emit_local_constant_sig(blob_writer_t* writer, md_local_constant_sig_t const* local_constant_sig, uint8_t const* value_blob)
+{
+    for (uint32_t i = 0; i < local_constant_sig->custom_modifier_count; ++i)
+    {
+        emit_compressed_u32(writer, local_constant_sig->custom_modifiers[i].required ? ELEMENT_TYPE_CMOD_REQD : ELEMENT_TYPE_CMOD_OPT);
+        emit_type(writer, local_constant_sig->custom_modifiers[i].type);
+    }
+
+    size_t value_size;
+    switch (local_constant_sig->constant_kind)
+    {
+        case mdck_PrimitiveConstant:
+            if (!get_primitive_constant_size(local_constant_sig->primitive.type_code, &value_size)
+                || (value_size != 0 && value_size != local_constant_sig->value_len))
             {
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+                writer->ok = false;
+                return;
+            }
+            emit_compressed_u32(writer, local_constant_sig->primitive.type_code);
+            emit_bytes(writer, value_blob, local_constant_sig->value_len);
+            break;
+        case mdck_EnumConstant:
+            // Enums have an integral underlying type.
+            if (!get_primitive_constant_size(local_constant_sig->enum_constant.type_code, &value_size)
+                || value_size != local_constant_sig->value_len
+                || local_constant_sig->enum_constant.type_code == ELEMENT_TYPE_R4
+                || local_constant_sig->enum_constant.type_code == ELEMENT_TYPE_R8
+                || local_constant_sig->enum_constant.type_code == ELEMENT_TYPE_STRING)
+            {
+                writer->ok = false;
+                return;
+            }
+            emit_compressed_u32(writer, local_constant_sig->enum_constant.type_code);
+            emit_bytes(writer, value_blob, local_constant_sig->value_len);
+            emit_type(writer, local_constant_sig->enum_constant.enum_type);
+            break;
+        case mdck_GeneralConstant:
+            switch (local_constant_sig->general.kind)
+            {
+                case mdgc_Object:
+                    emit_compressed_u32(writer, ELEMENT_TYPE_OBJECT);
+                    break;
+                case mdgc_ValueType:
+                    emit_compressed_u32(writer, ELEMENT_TYPE_VALUETYPE);
+                    emit_type(writer, local_constant_sig->general.type);
+                    break;
+                case mdgc_Class:
+                    emit_compressed_u32(writer, ELEMENT_TYPE_CLASS);
+                    emit_type(writer, local_constant_sig->general.type);
+                    break;
+                default:
+                    writer->ok = false;
+                    return;
+            }
+            emit_bytes(writer, value_blob, local_constant_sig->value_len);
+            break;
+        default:
+            writer->ok = false;
+            return;
+    }
+}
 
-                if (!try_get_blob(cxt, raw, (uint8_t const**)&imports->imports[i].alias, &imports->imports[i].alias_len))
-                    return mdbpr_InvalidBlob;
+bool md_encode_local_constant_sig(mdcursor_t local_constant, md_local_constant_sig_t const* local_constant_sig)
+{
+    if (CursorNull(&local_constant) || CursorEnd(&local_constant) || local_constant_sig == NULL)
+        return false;
 
-                mdtable_id_t table;
-                uint32_t row_id;
-                if (!decompress_u32(&blob, &blob_len, &raw))
-                    return mdbpr_InvalidBlob;
+    if (CursorTable(&local_constant)->table_id != mdtid_LocalConstant)
+        return false;
 
-                if (!decompose_coded_index(raw, mdtc_idx_coded | InsertCodedIndex(mdci_TypeDefOrRef), &table, &row_id))
-                    return mdbpr_InvalidBlob;
+    if (local_constant_sig->value_blob == NULL && local_constant_sig->value_len != 0)
+        return false;
 
-                imports->imports[i].target_type = CreateTokenType(table) | row_id;
-                break;
+    mdcxt_t* cxt = CursorTable(&local_constant)->cxt;
+    blob_writer_t measured = { NULL, 0, 0, true };
+    emit_local_constant_sig(&measured, local_constant_sig, local_constant_sig->value_blob);
+
+    blob_heap_view_t view = get_blob_heap_view(cxt);
+    blob_writer_t writer;
+    uint32_t heap_offset;
+    if (!reserve_encoded_blob(cxt, &measured, &writer, &heap_offset))
+        return false;
+
+    emit_local_constant_sig(&writer, local_constant_sig, rebase_blob_heap_pointer(cxt, &view, local_constant_sig->value_blob));
+    assert(writer.ok && writer.len == measured.len);
+
+    return set_column_value_as_heap_offset(local_constant, mdtLocalConstant_Signature, heap_offset);
+}
+
+typedef enum
+{
+    import_alias = 0x1,
+    import_assembly = 0x2,
+    import_namespace = 0x4,
+    import_type = 0x8,
+} import_fields_t;
+
+// Get the fields of an import kind, which are encoded in this order.
+static bool get_import_fields(uint32_t kind, uint32_t* fields)
+{
+    switch (kind)
+    {
+        case mdidk_ImportNamespace:
+            *fields = import_namespace;
+            return true;
+        case mdidk_ImportAssemblyNamespace:
+            *fields = import_assembly | import_namespace;
+            return true;
+        case mdidk_ImportType:
+            *fields = import_type;
+            return true;
+        case mdidk_ImportXmlNamespace:
+        case mdidk_AliasNamespace:
+            *fields = import_alias | import_namespace;
+            return true;
+        case mdidk_ImportAssemblyReferenceAlias:
+            *fields = import_alias;
+            return true;
+        case mdidk_AliasAssemblyReference:
+            *fields = import_alias | import_assembly;
+            return true;
+        case mdidk_AliasAssemblyNamespace:
+            *fields = import_alias | import_assembly | import_namespace;
+            return true;
+        case mdidk_AliasType:
+            *fields = import_alias | import_type;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The aliases and namespaces are added to the #Blob heap back to back before the Imports blob is encoded,
+// so the offset of each one is recomputed from the offset of the first one instead of being kept in a buffer.
+static uint32_t next_string_blob_offset(uint32_t* next_offset, uint32_t len)
+{
+    if (len == 0)
+        return 0;
+
+    uint8_t compressed[4];
+    size_t compressed_len = ARRAY_SIZE(compressed);
+    (void)compress_u32(len, compressed, &compressed_len);
+
+    uint32_t offset = *next_offset;
+    *next_offset += (uint32_t)compressed_len + len;
+    return offset;
+}
+
+static void emit_imports(blob_writer_t* writer, md_imports_t const* imports, uint32_t first_string_offset)
+{
+    uint32_t next_offset = first_string_offset;
+    for (uint32_t i = 0; i < imports->count && writer->ok; ++i)
+    {
+        uint32_t fields;
+        if (!get_import_fields(imports->imports[i].kind, &fields))
+        {
+            writer->ok = false;
+            return;
+        }
+
+        emit_u8(writer, (uint8_t)imports->imports[i].kind);
+        if (fields & import_alias)
+            emit_compressed_u32(writer, next_string_blob_offset(&next_offset, imports->imports[i].alias_len));
+
+        if (fields & import_assembly)
+        {
+            if (ExtractTokenType(imports->imports[i].assembly) != mdtid_AssemblyRef)
+            {
+                writer->ok = false;
+                return;
             }
-            default:
-                return mdbpr_InvalidBlob;
+            emit_compressed_u32(writer, RidFromToken(imports->imports[i].assembly));
         }
+
+        if (fields & import_namespace)
+            emit_compressed_u32(writer, next_string_blob_offset(&next_offset, imports->imports[i].target_namespace_len));
+
+        if (fields & import_type)
+            emit_type(writer, imports->imports[i].target_type);
     }
-    return mdbpr_Success;
+}
+
+bool md_encode_imports(mdcursor_t import_scope, md_imports_t const* imports)
+{
+    if (CursorNull(&import_scope) || CursorEnd(&import_scope) || imports == NULL)
+        return false;
+
+    if (CursorTable(&import_scope)->table_id != mdtid_ImportScope)
+        return false;
+
+    mdcxt_t* cxt = CursorTable(&import_scope)->cxt;
+    blob_heap_view_t view = get_blob_heap_view(cxt);
+
+    // The heap can't shrink, so validate every import and measure the Imports blob before anything is added to it.
+    for (uint32_t i = 0; i < imports->count; ++i)
+    {
+        uint32_t fields;
+        if (!get_import_fields(imports->imports[i].kind, &fields))
+            return false;
+
+        if (((fields & import_alias) && imports->imports[i].alias_len != 0 && imports->imports[i].alias == NULL)
+            || ((fields & import_namespace) && imports->imports[i].target_namespace_len != 0 && imports->imports[i].target_namespace == NULL))
+        {
+            return false;
+        }
+    }
+
+    // The heap is only appended to, so the aliases and namespaces start at the current end of the heap.
+    // An empty heap starts with the empty blob.
+    uint32_t first_string_offset = cxt->blob_heap.ptr == NULL ? 1 : (uint32_t)cxt->blob_heap.size;
+    blob_writer_t measured = { NULL, 0, 0, true };
+    emit_imports(&measured, imports, first_string_offset);
+    if (!measured.ok || measured.len > UINT32_MAX)
+        return false;
+
+    // Add the aliases and namespaces in the order they are encoded.
+    uint32_t next_offset = first_string_offset;
+    for (uint32_t i = 0; i < imports->count; ++i)
+    {
+        uint32_t fields;
+        (void)get_import_fields(imports->imports[i].kind, &fields);
+
+        struct
+        {
+            char const* str;
+            uint32_t len;
+        } const strings[] =
+        {
+            { (fields & import_alias) ? imports->imports[i].alias : NULL, (fields & import_alias) ? imports->imports[i].alias_len : 0 },
+            { (fields & import_namespace) ? imports->imports[i].target_namespace : NULL, (fields & import_namespace) ? imports->imports[i].target_namespace_len : 0 },
+        };
+
+        for (size_t j = 0; j < ARRAY_SIZE(strings); ++j)
+        {
+            if (strings[j].len == 0)
+                continue;
+
+            uint32_t offset;
+            uint8_t* slot = reserve_blob_heap_slot(cxt, strings[j].len, &offset);
+            if (slot == NULL)
+                return false;
+            uint32_t expected_offset = next_string_blob_offset(&next_offset, strings[j].len);
+            assert(offset == expected_offset);
+            (void)expected_offset;
+
+            memcpy(slot, rebase_blob_heap_pointer(cxt, &view, (uint8_t const*)strings[j].str), strings[j].len);
+        }
+    }
+
+    blob_writer_t writer;
+    uint32_t heap_offset;
+    if (!reserve_encoded_blob(cxt, &measured, &writer, &heap_offset))
+        return false;
+
+    emit_imports(&writer, imports, first_string_offset);
+    assert(writer.ok && writer.len == measured.len);
+
+    return set_column_value_as_heap_offset(import_scope, mdtImportScope_Imports, heap_offset);
 }
@@ -0,0 +1,936 @@
+#include "internal.h"
+
+// Sequence point side tables hold the sequence points of each method sorted by IL offset.
+// The points of a method are decoded and published on first use, so methods can be
+// built from multiple threads and methods that are never queried cost one pointer.
+typedef struct sequence_point_entry__
+{
+    uint32_t il_offset;
+    uint32_t document; // Document row, 0 if the method has no document
+    uint32_t start_line; // 0 for hidden sequence points, StartLine is never 0 otherwise
+    uint32_t start_column;
+} sequence_point_entry_t;
+
+typedef struct method_sequence_points__
+{
+    uint32_t count;
+    sequence_point_entry_t entries[];
+} method_sequence_points_t;
+
+typedef struct sequence_point_index__
+{
+    uint32_t method_count;
+    void* methods[]; // method_sequence_points_t*, published with publish_pointer()
+} sequence_point_index_t;
+
+// Published for methods without sequence points so they don't need an allocation.
+static method_sequence_points_t empty_method_sequence_points = { 0 };
+
+void free_sequence_point_index(void* index)
+{
+    sequence_point_index_t* sequence_points = (sequence_point_index_t*)index;
+    for (uint32_t i = 0; i < sequence_points->method_count; ++i)
+    {
+        if (sequence_points->methods[i] != &empty_method_sequence_points)
+            free(sequence_points->methods[i]);
+    }
+}
+
+void drop_pdb_indexes(mdcxt_t* cxt, mdtable_id_t table_id)
+{
+    switch (table_id)
+    {
+    case mdtid_MethodDebugInformation:
+        drop_side_table(cxt, mdst_SequencePoints);
+        break;
+    case mdtid_Document:
+        drop_side_table(cxt, mdst_DocumentPaths);
+        break;
+    case mdtid_LocalScope:
+    case mdtid_LocalVariable:
+    case mdtid_LocalConstant:
+        drop_side_table(cxt, mdst_LocalScopes);
+        break;
+    case mdtid_CustomDebugInformation:
+        drop_side_table(cxt, mdst_CustomDebugInformation);
+        break;
+    default:
+        break;
+    }
+}
+
+static int compare_sequence_point_entries(void const* lhs, void const* rhs)
+{
+    uint32_t l = ((sequence_point_entry_t const*)lhs)->il_offset;
+    uint32_t r = ((sequence_point_entry_t const*)rhs)->il_offset;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+static method_sequence_points_t* build_method_sequence_points(mdcursor_t method_debug_information)
+{
+    uint8_t const* blob;
+    uint32_t blob_len;
+    if (!md_get_column_value_as_blob(method_debug_information, mdtMethodDebugInformation_SequencePoints, &blob, &blob_len))
+        return NULL;
+
+    if (blob_len == 0)
+        return &empty_method_sequence_points;
+
+    md_sequence_point_iterator_t iterator;
+    if (md_sequence_point_iterator_init(method_debug_information, blob, blob_len, &iterator) != mdbpr_Success)
+        return NULL;
+
+    // Every stored record takes at least three bytes of the blob, so this is enough space
+    // to decode the blob once. The allocation is trimmed afterwards.
+    size_t max_count = blob_len / 3 + 1;
+    method_sequence_points_t* points = (method_sequence_points_t*)malloc(sizeof(method_sequence_points_t) + max_count * sizeof(sequence_point_entry_t));
+    if (points == NULL)
+        return NULL;
+
+    uint32_t count = 0;
+    bool is_sorted = true;
+    md_sequence_point_t record;
+    while (md_sequence_point_iterator_next(&iterator, &record))
+    {
+        if (record.kind == mdsp_DocumentRecord)
+            continue;
+
+        assert(count < max_count);
+        sequence_point_entry_t* entry = &points->entries[count];
+        entry->il_offset = record.il_offset;
+        entry->document = CursorRow(&iterator.document);
+        entry->start_line = record.kind == mdsp_SequencePointRecord ? record.start_line : 0;
+        entry->start_column = record.kind == mdsp_SequencePointRecord ? record.start_column : 0;
+        if (count > 0 && points->entries[count - 1].il_offset > entry->il_offset)
+            is_sorted = false;
+        count++;
+    }
+
+    if (md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+    {
+        free(points);
+        return NULL;
+    }
+
+    // The spec requires increasing IL offsets, but don't rely on it for the binary search.
+    if (!is_sorted)
+        qsort(points->entries, count, sizeof(sequence_point_entry_t), compare_sequence_point_entries);
+
+    points->count = count;
+    method_sequence_points_t* trimmed = (method_sequence_points_t*)realloc(points, sizeof(method_sequence_points_t) + count * sizeof(sequence_point_entry_t));
+    return trimmed != NULL ? trimmed : points;
+}
+
+static sequence_point_index_t* get_sequence_point_index(mdcxt_t* cxt)
+{
+    sequence_point_index_t* index = (sequence_point_index_t*)get_side_table(cxt, mdst_SequencePoints);
+    if (index != NULL)
+        return index;
+
+    uint32_t method_count = cxt->tables[mdtid_MethodDebugInformation].row_count;
+    index = (sequence_point_index_t*)calloc(1, sizeof(sequence_point_index_t) + method_count * sizeof(void*));
+    if (index == NULL)
+        return NULL;
+    index->method_count = method_count;
+    return (sequence_point_index_t*)publish_side_table(cxt, mdst_SequencePoints, index);
+}
+
+static method_sequence_points_t* get_method_sequence_points(sequence_point_index_t* index, mdcursor_t method_debug_information)
+{
+    uint32_t row = CursorRow(&method_debug_information);
+    assert(row >= 1 && row <= index->method_count);
+    void** slot = &index->methods[row - 1];
+    method_sequence_points_t* existing = (method_sequence_points_t*)load_published_pointer(slot);
+    if (existing != NULL)
+        return existing;
+
+    method_sequence_points_t* built = build_method_sequence_points(method_debug_information);
+    if (built == NULL)
+        return NULL;
+
+    // Another thread may have built the same method.
+    existing = (method_sequence_points_t*)publish_pointer(slot, built);
+    if (existing != built && built != &empty_method_sequence_points)
+        free(built);
+    return existing;
+}
+
+bool md_build_sequence_point_index(mdhandle_t handle, uint32_t first_row, uint32_t row_count)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return false;
+
+    mdtable_t* table = &cxt->tables[mdtid_MethodDebugInformation];
+    if (first_row == 0 || first_row > table->row_count + 1 || row_count > table->row_count + 1 - first_row)
+        return false;
+
+    if (row_count == 0)
+        return true;
+
+    sequence_point_index_t* index = get_sequence_point_index(cxt);
+    if (index == NULL)
+        return false;
+
+    for (uint32_t row = first_row; row < first_row + row_count; ++row)
+    {
+        if (get_method_sequence_points(index, create_cursor(table, row)) == NULL)
+            return false;
+    }
+    return true;
+}
+
+bool md_find_sequence_point(mdcursor_t method_debug_information, uint32_t il_offset, md_source_location_t* location)
+{
+    mdtable_t* table = CursorTable(&method_debug_information);
+    if (table == NULL || table->table_id != mdtid_MethodDebugInformation
+        || CursorNull(&method_debug_information) || CursorEnd(&method_debug_information)
+        || location == NULL)
+    {
+        return false;
+    }
+
+    sequence_point_index_t* index = get_sequence_point_index(table->cxt);
+    if (index == NULL)
+        return false;
+
+    method_sequence_points_t* points = get_method_sequence_points(index, method_debug_information);
+    if (points == NULL)
+        return false;
+
+    // Find the last sequence point at or before the offset.
+    uint32_t lo = 0;
+    uint32_t hi = points->count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (points->entries[mid].il_offset <= il_offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0)
+        return false;
+
+    sequence_point_entry_t const* entry = &points->entries[lo - 1];
+    // Offsets covered by a hidden sequence point have no source location.
+    if (entry->start_line == 0)
+        return false;
+
+    location->document = create_cursor(&table->cxt->tables[mdtid_Document], entry->document);
+    location->il_offset = entry->il_offset;
+    location->start_line = entry->start_line;
+    location->start_column = entry->start_column;
+    return true;
+}
+
+size_t md_get_sequence_point_index_size(mdhandle_t handle)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL)
+        return 0;
+
+    sequence_point_index_t* index = (sequence_point_index_t*)get_side_table(cxt, mdst_SequencePoints);
+    if (index == NULL)
+        return 0;
+
+    size_t size = sizeof(sequence_point_index_t) + index->method_count * sizeof(void*);
+    for (uint32_t i = 0; i < index->method_count; ++i)
+    {
+        method_sequence_points_t* points = (method_sequence_points_t*)load_published_pointer(&index->methods[i]);
+        if (points != NULL && points != &empty_method_sequence_points)
+            size += sizeof(method_sequence_points_t) + points->count * sizeof(sequence_point_entry_t);
+    }
+    return size;
+}
+
+// Document side tables hold the reassembled path of every Document row in one arena,
+// along with hash chains for exact, case-insensitive and path suffix lookups.
+// Chains are in ascending row order.
+typedef enum document_chain__
+{
+    document_chain_exact,
+    document_chain_ignore_case,
+    document_chain_file_name, // Case-insensitive hash of the last path component
+    document_chain_count,
+} document_chain_t;
+
+typedef struct document_index__
+{
+    uint32_t row_count;
+    uint32_t mask;
+    char* paths; // Null-terminated paths
+    uint32_t* path_offsets;
+    uint32_t* path_lengths;
+    uint64_t* hashes[document_chain_count];
+    uint32_t* buckets[document_chain_count]; // First row with a hash in the bucket, 0 if none
+    uint32_t* next[document_chain_count]; // Next row in the same bucket, 0 if none
+} document_index_t;
+
+void free_document_index(void* index)
+{
+    document_index_t* documents = (document_index_t*)index;
+    free(documents->paths);
+    free(documents->path_offsets);
+    free(documents->path_lengths);
+    for (size_t i = 0; i < document_chain_count; ++i)
+    {
+        free(documents->hashes[i]);
+        free(documents->buckets[i]);
+        free(documents->next[i]);
+    }
+}
+
+static bool is_path_separator(char c)
+{
+    return c == '/' || c == '\\';
+}
+
+static char fold_path_char(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// FNV-1a of the path with ASCII letters folded to lower case.
+static uint64_t get_folded_path_hash(char const* path, uint32_t path_len)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t i = 0; i < path_len; ++i)
+    {
+        hash ^= (uint8_t)fold_path_char(path[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint32_t get_file_name_start(char const* path, uint32_t path_len)
+{
+    uint32_t start = path_len;
+    while (start > 0 && !is_path_separator(path[start - 1]))
+        start--;
+    return start;
+}
+
+static uint64_t get_document_hash(document_chain_t chain, char const* path, uint32_t path_len)
+{
+    switch (chain)
+    {
+    case document_chain_exact:
+        return get_blob_hash((uint8_t const*)path, path_len);
+    case document_chain_ignore_case:
+        return get_folded_path_hash(path, path_len);
+    default:
+    {
+        assert(chain == document_chain_file_name);
+        uint32_t start = get_file_name_start(path, path_len);
+        return get_folded_path_hash(path + start, path_len - start);
+    }
+    }
+}
+
+// Like md_parse_document_name(), but a nil name is an empty path.
+static md_blob_parse_result_t parse_document_path(mdcxt_t* cxt, uint8_t const* blob, uint32_t blob_len, char* path, size_t* path_len)
+{
+    if (blob_len != 0)
+        return md_parse_document_name(cxt, blob, blob_len, path, path_len);
+
+    size_t available = *path_len;
+    *path_len = 1;
+    if (available == 0)
+        return mdbpr_InsufficientBuffer;
+    path[0] = '\0';
+    return mdbpr_Success;
+}
+
+static document_index_t* build_document_index(mdcxt_t* cxt)
+{
+    mdtable_t* table = &cxt->tables[mdtid_Document];
+    uint32_t row_count = table->row_count;
+
+    uint32_t bucket_count = 1;
+    while (bucket_count < row_count)
+        bucket_count <<= 1;
+
+    document_index_t* index = (document_index_t*)calloc(1, sizeof(document_index_t));
+    if (index == NULL)
+        return NULL;
+
+    index->row_count = row_count;
+    index->mask = bucket_count - 1;
+    // Start with room for paths of a typical length, the arena grows as needed.
+    size_t paths_capacity = (size_t)row_count * 64 + 1;
+    index->paths = (char*)malloc(paths_capacity);
+    index->path_offsets = (uint32_t*)malloc(sizeof(uint32_t) * (row_count + 1));
+    index->path_lengths = (uint32_t*)malloc(sizeof(uint32_t) * (row_count + 1));
+    bool allocated = index->paths != NULL && index->path_offsets != NULL && index->path_lengths != NULL;
+    for (size_t i = 0; i < document_chain_count; ++i)
+    {
+        index->hashes[i] = (uint64_t*)malloc(sizeof(uint64_t) * (row_count + 1));
+        index->buckets[i] = (uint32_t*)calloc(bucket_count, sizeof(uint32_t));
+        index->next[i] = (uint32_t*)malloc(sizeof(uint32_t) * (row_count + 1));
+        allocated = allocated && index->hashes[i] != NULL && index->buckets[i] != NULL && index->next[i] != NULL;
+    }
+
+    if (!allocated)
+    {
+        free_document_index(index);
+        free(index);
+        return NULL;
+    }
+
+    size_t paths_used = 0;
+    for (uint32_t row = 1; row <= row_count; ++row)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        if (!md_get_column_value_as_blob(create_cursor(table, row), mdtDocument_Name, &blob, &blob_len))
+            goto fail;
+
+        // Reassemble the path directly into the arena, growing it if there isn't enough space left.
+        size_t path_len = paths_capacity - paths_used;
+        md_blob_parse_result_t result = parse_document_path(cxt, blob, blob_len, index->paths + paths_used, &path_len);
+        if (result == mdbpr_InsufficientBuffer)
+        {
+            size_t new_capacity = paths_capacity * 2 > paths_used + path_len ? paths_capacity * 2 : paths_used + path_len;
+            char* paths = (char*)realloc(index->paths, new_capacity);
+            if (paths == NULL)
+                goto fail;
+            index->paths = paths;
+            paths_capacity = new_capacity;
+            path_len = paths_capacity - paths_used;
+            result = parse_document_path(cxt, blob, blob_len, index->paths + paths_used, &path_len);
+        }
+
+        if (result != mdbpr_Success || paths_used > UINT32_MAX || path_len > UINT32_MAX)
+            goto fail;
+
+        // The returned length includes the null terminator.
+        index->path_offsets[row - 1] = (uint32_t)paths_used;
+        index->path_lengths[row - 1] = (uint32_t)(path_len - 1);
+        paths_used += path_len;
+    }
+
+    // Insert rows in descending order so each chain is in ascending row order.
+    for (uint32_t row = row_count; row >= 1; --row)
+    {
+        char const* path = index->paths + index->path_offsets[row - 1];
+        uint32_t path_len = index->path_lengths[row - 1];
+        for (size_t i = 0; i < document_chain_count; ++i)
+        {
+            uint64_t hash = get_document_hash((document_chain_t)i, path, path_len);
+            uint32_t bucket = (uint32_t)hash & index->mask;
+            index->hashes[i][row - 1] = hash;
+            index->next[i][row - 1] = index->buckets[i][bucket];
+            index->buckets[i][bucket] = row;
+        }
+    }
+    return index;
+
+fail:
+    free_document_index(index);
+    free(index);
+    return NULL;
+}
+
+static document_index_t* get_document_index(mdcxt_t* cxt)
+{
+    document_index_t* index = (document_index_t*)get_side_table(cxt, mdst_DocumentPaths);
+    if (index != NULL)
+        return index;
+
+    index = build_document_index(cxt);
+    if (index == NULL)
+        return NULL;
+    return (document_index_t*)publish_side_table(cxt, mdst_DocumentPaths, index);
+}
+
+bool md_get_document_path(mdcursor_t document, char const** path, uint32_t* path_len)
+{
+    mdtable_t* table = CursorTable(&document);
+    if (table == NULL || table->table_id != mdtid_Document
+        || CursorNull(&document) || CursorEnd(&document)
+        || path == NULL || path_len == NULL)
+    {
+        return false;
+    }
+
+    document_index_t* index = get_document_index(table->cxt);
+    if (index == NULL)
+        return false;
+
+    uint32_t row = CursorRow(&document);
+    *path = index->paths + index->path_offsets[row - 1];
+    *path_len = index->path_lengths[row - 1];
+    return true;
+}
+
+// Check if the document path ends with the query at a path component boundary,
+// ignoring ASCII case and treating both separators as equal.
+static bool is_path_suffix_match(char const* path, uint32_t path_len, char const* query, uint32_t query_len)
+{
+    if (query_len > path_len)
+        return false;
+
+    uint32_t start = path_len - query_len;
+    if (start > 0 && !is_path_separator(path[start - 1]) && !is_path_separator(query[0]))
+        return false;
+
+    for (uint32_t i = 0; i < query_len; ++i)
+    {
+        char p = path[start + i];
+        char q = query[i];
+        if (is_path_separator(p) && is_path_separator(q))
+            continue;
+        if (fold_path_char(p) != fold_path_char(q))
+            return false;
+    }
+    return true;
+}
+
+static bool is_document_match(md_document_match_t match, char const* path, uint32_t path_len, char const* query, uint32_t query_len)
+{
+    switch (match)
+    {
+    case mddm_Exact:
+        return path_len == query_len && memcmp(path, query, query_len) == 0;
+    case mddm_IgnoreCase:
+        if (path_len != query_len)
+            return false;
+        for (uint32_t i = 0; i < query_len; ++i)
+        {
+            if (fold_path_char(path[i]) != fold_path_char(query[i]))
+                return false;
+        }
+        return true;
+    case mddm_PathSuffix:
+        return is_path_suffix_match(path, path_len, query, query_len);
+    default:
+        return false;
+    }
+}
+
+int32_t md_find_documents(mdhandle_t handle, char const* path, md_document_match_t match, uint32_t out_length, mdcursor_t* documents)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || path == NULL || (documents == NULL && out_length != 0))
+        return -1;
+
+    document_chain_t chain;
+    switch (match)
+    {
+    case mddm_Exact:
+        chain = document_chain_exact;
+        break;
+    case mddm_IgnoreCase:
+        chain = document_chain_ignore_case;
+        break;
+    case mddm_PathSuffix:
+        chain = document_chain_file_name;
+        break;
+    default:
+        return -1;
+    }
+
+    size_t query_len = strlen(path);
+    if (query_len > UINT32_MAX)
+        return -1;
+
+    mdtable_t* table = &cxt->tables[mdtid_Document];
+    if (table->cxt == NULL || table->row_count == 0)
+        return 0;
+
+    document_index_t* index = get_document_index(cxt);
+    if (index == NULL)
+        return -1;
+
+    uint64_t hash = get_document_hash(chain, path, (uint32_t)query_len);
+    uint32_t count = 0;
+    for (uint32_t row = index->buckets[chain][(uint32_t)hash & index->mask]; row != 0; row = index->next[chain][row - 1])
+    {
+        if (index->hashes[chain][row - 1] != hash
+            || !is_document_match(match, index->paths + index->path_offsets[row - 1], index->path_lengths[row - 1], path, (uint32_t)query_len))
+        {
+            continue;
+        }
+
+        if (count < out_length)
+            documents[count] = create_cursor(table, row);
+        if (count == INT32_MAX)
+            return -1;
+        count++;
+    }
+    return (int32_t)count;
+}
+
+// Local scope side tables hold the LocalScope rows grouped by method and ordered by StartOffset
+// and then by decreasing Length, which is a pre-order walk of the nested scopes of each method.
+// Each scope links to its enclosing scope, so the scopes at an IL offset are the enclosing chain
+// of the last scope that starts at or before the offset.
+typedef struct local_scope_entry__
+{
+    uint32_t row;
+    uint32_t method;
+    uint32_t start_offset;
+    uint32_t length;
+    uint32_t parent; // Index of the enclosing scope + 1, 0 for the outermost scope
+    uint32_t variable_count;
+    uint32_t constant_count;
+    mdcursor_t variables;
+    mdcursor_t constants;
+} local_scope_entry_t;
+
+typedef struct method_local_scopes__
+{
+    uint32_t method;
+    uint32_t first; // Index of the first scope of the method
+    uint32_t count;
+} method_local_scopes_t;
+
+typedef struct local_scope_index__
+{
+    uint32_t method_count;
+    method_local_scopes_t* methods; // Sorted by method, allocated after the scopes
+    local_scope_entry_t scopes[];
+} local_scope_index_t;
+
+static int compare_local_scope_entries(void const* lhs, void const* rhs)
+{
+    local_scope_entry_t const* l = (local_scope_entry_t const*)lhs;
+    local_scope_entry_t const* r = (local_scope_entry_t const*)rhs;
+    if (l->method != r->method)
+        return l->method < r->method ? -1 : 1;
+    if (l->start_offset != r->start_offset)
+        return l->start_offset < r->start_offset ? -1 : 1;
+    if (l->length != r->length)
+        return l->length > r->length ? -1 : 1;
+    return l->row < r->row ? -1 : (l->row > r->row ? 1 : 0);
+}
+
+static bool is_in_local_scope(local_scope_entry_t const* scope, uint32_t il_offset)
+{
+    return il_offset >= scope->start_offset && il_offset - scope->start_offset < scope->length;
+}
+
+static bool is_nested_local_scope(local_scope_entry_t const* outer, local_scope_entry_t const* inner)
+{
+    return inner->start_offset >= outer->start_offset
+        && (uint64_t)inner->start_offset + inner->length <= (uint64_t)outer->start_offset + outer->length;
+}
+
+static local_scope_index_t* build_local_scope_index(mdcxt_t* cxt)
+{
+    mdtable_t* table = &cxt->tables[mdtid_LocalScope];
+    uint32_t scope_count = table->row_count;
+
+    // The methods are allocated after the scopes, there is at most one per scope.
+    local_scope_index_t* index = (local_scope_index_t*)malloc(sizeof(local_scope_index_t)
+        + scope_count * (sizeof(local_scope_entry_t) + sizeof(method_local_scopes_t)));
+    if (index == NULL)
+        return NULL;
+    index->methods = (method_local_scopes_t*)&index->scopes[scope_count];
+
+    bool is_sorted = true;
+    for (uint32_t i = 0; i < scope_count; ++i)
+    {
+        mdcursor_t c = create_cursor(table, i + 1);
+        local_scope_entry_t* scope = &index->scopes[i];
+        mdToken method;
+        scope->row = i + 1;
+        scope->parent = 0;
+        if (!md_get_column_value_as_token(c, mdtLocalScope_Method, &method)
+            || !md_get_column_value_as_constant(c, mdtLocalScope_StartOffset, &scope->start_offset)
+            || !md_get_column_value_as_constant(c, mdtLocalScope_Length, &scope->length)
+            || !md_get_column_value_as_range(c, mdtLocalScope_VariableList, &scope->variables, &scope->variable_count)
+            || !md_get_column_value_as_range(c, mdtLocalScope_ConstantList, &scope->constants, &scope->constant_count))
+        {
+            free(index);
+            return NULL;
+        }
+        scope->method = RidFromToken(method);
+        if (i > 0 && compare_local_scope_entries(&index->scopes[i - 1], scope) > 0)
+            is_sorted = false;
+    }
+
+    // The spec requires this order, but don't rely on it for the binary search.
+    if (!is_sorted)
+        qsort(index->scopes, scope_count, sizeof(local_scope_entry_t), compare_local_scope_entries);
+
+    // Group the scopes by method and link each scope to the closest preceding scope that contains it.
+    // Scopes that are enclosed by a scope have been visited by the time the scope is popped.
+    index->method_count = 0;
+    uint32_t parent = 0;
+    for (uint32_t i = 0; i < scope_count; ++i)
+    {
+        local_scope_entry_t* scope = &index->scopes[i];
+        if (index->method_count == 0 || index->methods[index->method_count - 1].method != scope->method)
+        {
+            method_local_scopes_t* method = &index->methods[index->method_count++];
+            method->method = scope->method;
+            method->first = i;
+            method->count = 0;
+            parent = 0;
+        }
+        index->methods[index->method_count - 1].count++;
+
+        while (parent != 0 && !is_nested_local_scope(&index->scopes[parent - 1], scope))
+            parent = index->scopes[parent - 1].parent;
+        scope->parent = parent;
+        parent = i + 1;
+    }
+    return index;
+}
+
+static local_scope_index_t* get_local_scope_index(mdcxt_t* cxt)
+{
+    local_scope_index_t* index = (local_scope_index_t*)get_side_table(cxt, mdst_LocalScopes);
+    if (index != NULL)
+        return index;
+
+    index = build_local_scope_index(cxt);
+    if (index == NULL)
+        return NULL;
+    return (local_scope_index_t*)publish_side_table(cxt, mdst_LocalScopes, index);
+}
+
+int32_t md_find_local_scopes(mdhandle_t handle, mdToken method, uint32_t il_offset, uint32_t out_length, md_local_scope_t* scopes)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || ExtractTokenType(method) != mdtid_MethodDef || (scopes == NULL && out_length != 0))
+        return -1;
+
+    mdtable_t* table = &cxt->tables[mdtid_LocalScope];
+    if (table->cxt == NULL || table->row_count == 0)
+        return 0;
+
+    local_scope_index_t* index = get_local_scope_index(cxt);
+    if (index == NULL)
+        return -1;
+
+    // Find the scopes of the method.
+    uint32_t method_row = RidFromToken(method);
+    uint32_t lo = 0;
+    uint32_t hi = index->method_count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index->methods[mid].method < method_row)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == index->method_count || index->methods[lo].method != method_row)
+        return 0;
+
+    // Find the last scope that starts at or before the offset.
+    method_local_scopes_t const* method_scopes = &index->methods[lo];
+    lo = method_scopes->first;
+    hi = method_scopes->first + method_scopes->count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index->scopes[mid].start_offset <= il_offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // The scopes at the offset are that scope, if it contains the offset, and the scopes enclosing it.
+    int32_t count = 0;
+    for (uint32_t i = lo > method_scopes->first ? lo : 0; i != 0; i = index->scopes[i - 1].parent)
+    {
+        local_scope_entry_t const* entry = &index->scopes[i - 1];
+        if (!is_in_local_scope(entry, il_offset))
+            continue;
+
+        if ((uint32_t)count < out_length)
+        {
+            md_local_scope_t* scope = &scopes[count];
+            scope->scope = create_cursor(table, entry->row);
+            scope->start_offset = entry->start_offset;
+            scope->length = entry->length;
+            scope->variables = entry->variables;
+            scope->variable_count = entry->variable_count;
+            scope->constants = entry->constants;
+            scope->constant_count = entry->constant_count;
+        }
+        count++;
+    }
+    return count;
+}
+
+// The CustomDebugInformation index holds the rows sorted by parent and kind.
+// Kind GUIDs are interned to small integers when the index is built, since a PDB only uses a handful of kinds,
+// so a lookup compares the query GUID against the interned kinds once and then binary searches integer keys.
+typedef struct custom_debug_information_entry__
+{
+    mdToken parent;
+    uint32_t kind; // Index of the kind GUID in the interned kinds
+    uint32_t row;
+    uint32_t value; // #Blob heap offset of the Value column
+} custom_debug_information_entry_t;
+
+typedef struct custom_debug_information_index__
+{
+    uint32_t kind_count;
+    mdguid_t* kinds; // Interned kind GUIDs, allocated after the entries
+    custom_debug_information_entry_t entries[];
+} custom_debug_information_index_t;
+
+static int compare_custom_debug_information_entries(void const* lhs, void const* rhs)
+{
+    custom_debug_information_entry_t const* l = (custom_debug_information_entry_t const*)lhs;
+    custom_debug_information_entry_t const* r = (custom_debug_information_entry_t const*)rhs;
+    if (l->parent != r->parent)
+        return l->parent < r->parent ? -1 : 1;
+    if (l->kind != r->kind)
+        return l->kind < r->kind ? -1 : 1;
+    return l->row < r->row ? -1 : (l->row > r->row ? 1 : 0);
+}
+
+static bool find_custom_debug_information_kind(custom_debug_information_index_t const* index, mdguid_t const* kind, uint32_t* kind_index)
+{
+    for (uint32_t i = 0; i < index->kind_count; ++i)
+    {
+        if (memcmp(&index->kinds[i], kind, sizeof(mdguid_t)) == 0)
+        {
+            *kind_index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static custom_debug_information_index_t* build_custom_debug_information_index(mdcxt_t* cxt)
+{
+    mdtable_t* table = &cxt->tables[mdtid_CustomDebugInformation];
+    uint32_t row_count = table->row_count;
+
+    // There can't be more kinds than rows, or than GUIDs and the zero GUID of a nil kind.
+    uint32_t max_kind_count = (uint32_t)(cxt->guid_heap.size / sizeof(mdguid_t)) + 1;
+    if (max_kind_count > row_count)
+        max_kind_count = row_count;
+
+    custom_debug_information_index_t* index = (custom_debug_information_index_t*)malloc(sizeof(custom_debug_information_index_t)
+        + row_count * sizeof(custom_debug_information_entry_t) + max_kind_count * sizeof(mdguid_t));
+    if (index == NULL)
+        return NULL;
+    index->kind_count = 0;
+    index->kinds = (mdguid_t*)&index->entries[row_count];
+
+    // Rows are usually grouped by kind, so remember the last #GUID heap index that was interned.
+    uint32_t last_guid_index = 0;
+    uint32_t last_kind = 0;
+    bool is_sorted = true;
+    for (uint32_t i = 0; i < row_count; ++i)
+    {
+        mdcursor_t c = create_cursor(table, i + 1);
+        custom_debug_information_entry_t* entry = &index->entries[i];
+        uint32_t guid_index;
+        if (!md_get_column_value_as_token(c, mdtCustomDebugInformation_Parent, &entry->parent)
+            || !md_get_column_value_as_heap_offset(c, mdtCustomDebugInformation_Kind, &guid_index)
+            || !md_get_column_value_as_heap_offset(c, mdtCustomDebugInformation_Value, &entry->value))
+        {
+            free(index);
+            return NULL;
+        }
+        entry->row = i + 1;
+
+        if (guid_index == 0 || guid_index != last_guid_index)
+        {
+            mdguid_t kind;
+            if (!md_get_column_value_as_guid(c, mdtCustomDebugInformation_Kind, &kind))
+            {
+                free(index);
+                return NULL;
+            }
+
+            if (!find_custom_debug_information_kind(index, &kind, &last_kind))
+            {
+                assert(index->kind_count < max_kind_count);
+                last_kind = index->kind_count++;
+                index->kinds[last_kind] = kind;
+            }
+            last_guid_index = guid_index;
+        }
+        entry->kind = last_kind;
+
+        if (i > 0 && compare_custom_debug_information_entries(&index->entries[i - 1], entry) > 0)
+            is_sorted = false;
+    }
+
+    // Rows are sorted by parent, but kinds are interned in order of first use so they may be out of order within a parent.
+    if (!is_sorted)
+        qsort(index->entries, row_count, sizeof(custom_debug_information_entry_t), compare_custom_debug_information_entries);
+    return index;
+}
+
+static custom_debug_information_index_t* get_custom_debug_information_index(mdcxt_t* cxt)
+{
+    custom_debug_information_index_t* index = (custom_debug_information_index_t*)get_side_table(cxt, mdst_CustomDebugInformation);
+    if (index != NULL)
+        return index;
+
+    index = build_custom_debug_information_index(cxt);
+    if (index == NULL)
+        return NULL;
+    return (custom_debug_information_index_t*)publish_side_table(cxt, mdst_CustomDebugInformation, index);
+}
+
+int32_t md_find_custom_debug_information(mdhandle_t handle, mdToken parent, mdguid_t kind, uint32_t out_length, md_custom_debug_information_t* values)
+{
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || (values == NULL && out_length != 0))
+        return -1;
+
+    mdtable_t* table = &cxt->tables[mdtid_CustomDebugInformation];
+    if (table->cxt == NULL || table->row_count == 0)
+        return 0;
+
+    custom_debug_information_index_t* index = get_custom_debug_information_index(cxt);
+    if (index == NULL)
+        return -1;
+
+    uint32_t kind_index;
+    if (!find_custom_debug_information_kind(index, &kind, &kind_index))
+        return 0;
+
+    // Find the first entry of the parent and kind.
+    custom_debug_information_entry_t key = { parent, kind_index, 0, 0 };
+    uint32_t lo = 0;
+    uint32_t hi = table->row_count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (compare_custom_debug_information_entries(&index->entries[mid], &key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    int32_t count = 0;
+    for (uint32_t i = lo; i < table->row_count; ++i)
+    {
+        custom_debug_information_entry_t const* entry = &index->entries[i];
+        if (entry->parent != parent || entry->kind != kind_index)
+            break;
+
+        if ((uint32_t)count < out_length)
+        {
+            md_custom_debug_information_t* value = &values[count];
+            value->custom_debug_information = create_cursor(table, entry->row);
+            if (entry->value == 0)
+            {
+                value->value = NULL;
+                value->value_len = 0;
+            }
+            else if (!try_get_blob(cxt, entry->value, &value->value, &value->value_len))
+            {
+                return -1;
+            }
+        }
+        count++;
+    }
+    return count;
+}
@@ -284,8 +284,7 @@ bool md_get_column_value_as_constant(mdcursor_t c, col_index_t col_idx, uint32_t
     return true;
 }
 
-// Set a column value as an existing offset into a heap.
-bool get_column_value_as_heap_offset(mdcursor_t c, col_index_t col_idx, uint32_t* offset)
+bool md_get_column_value_as_heap_offset(mdcursor_t c, col_index_t col_idx, uint32_t* offset)
 {
     assert(offset != NULL);
 
@@ -327,6 +326,31 @@ bool md_get_column_value_as_utf8(mdcursor_t c, col_index_t col_idx, char const**
     return true;
 }
 
+bool md_get_column_value_as_utf8_view(mdcursor_t c, col_index_t col_idx, mdstringview_t* view)
+{
+    assert(view != NULL);
+
+    access_cxt_t acxt;
+    if (!create_access_context(&c, col_idx, false, &acxt))
+        return false;
+
+    // If this isn't a heap index column, then fail.
+    if (!(acxt.col_details & mdtc_hstring))
+        return false;
+
+    uint32_t offset;
+    if (!read_column_data(&acxt, &offset))
+        return false;
+
+    mdcxt_t* cxt = CursorTable(&c)->cxt;
+    char const* str;
+    if (!try_get_string(cxt, offset, &str))
+        return false;
+
+    get_string_view(cxt, offset, str, view);
+    return true;
+}
+
 bool md_get_column_value_as_userstring(mdcursor_t c, col_index_t col_idx, mduserstring_t* string)
 {
     assert(string != NULL);
@@ -440,6 +464,170 @@ int32_t md_get_many_rows_column_value_as_token(mdcursor_t c, col_index_t col_idx
     return read_in;
 }
 
+// Number of elements ahead of the current one to prefetch in md_gather_column_values().
+#define GATHER_PREFETCH_DISTANCE 8
+
+static uint8_t const* get_gather_row(mdtable_t* table, mdToken tk)
+{
+    uint32_t row = RidFromToken(tk);
+    if (ExtractTokenType(tk) != table->table_id || row == 0 || row > table->row_count)
+        return NULL;
+    return table->data.ptr + (size_t)(row - 1) * table->row_size_bytes;
+}
+
+static uint8_t const* get_gather_heap_entry(mdcxt_t* cxt, mdtcol_t col_details, uint32_t offset)
+{
+    mdstream_t const* heap = get_heap_by_id(cxt, ExtractHeapType(col_details));
+    if (heap == NULL)
+        return NULL;
+
+    // #GUID heap indices are 1-based and count entries - see II.24.2.5.
+    size_t heap_offset = offset;
+    if (ExtractHeapType(col_details) == mdtc_hguid)
+    {
+        if (offset == 0)
+            return NULL;
+        heap_offset = (size_t)(offset - 1) * sizeof(mdguid_t);
+    }
+    return heap_offset < heap->size ? heap->ptr + heap_offset : NULL;
+}
+
+bool md_gather_column_values(mdhandle_t handle, col_index_t col_idx, mdToken const* tokens, uint32_t count, mdcolumnvalue_t* values)
+{
+    if (count == 0)
+        return true;
+
+    mdcxt_t* cxt = extract_mdcxt(handle);
+    if (cxt == NULL || tokens == NULL || values == NULL)
+        return false;
+
+    mdtable_id_t table_id = ExtractTokenType(tokens[0]);
+    if (table_id >= MDTABLE_MAX_COUNT)
+        return false;
+
+    mdtable_t* table = type_to_table(cxt, table_id);
+    if (table->cxt == NULL)
+        return false;
+
+    uint8_t idx = col_to_index(col_idx, table);
+    if (idx >= table->column_count)
+        return false;
+
+    mdtcol_t col_details = table->column_details[idx];
+    uint32_t col_offset = ExtractOffset(col_details);
+
+    // Read the raw value of each row, prefetching rows ahead of the one being read.
+    // The raw values are stored in the output until they are decoded below.
+    uint32_t prefetched = 0;
+    for (; prefetched < count && prefetched < GATHER_PREFETCH_DISTANCE; ++prefetched)
+    {
+        uint8_t const* row = get_gather_row(table, tokens[prefetched]);
+        if (row != NULL)
+            PREFETCH_READ(row + col_offset);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (prefetched < count)
+        {
+            uint8_t const* row = get_gather_row(table, tokens[prefetched++]);
+            if (row != NULL)
+                PREFETCH_READ(row + col_offset);
+        }
+
+        uint8_t const* row = get_gather_row(table, tokens[i]);
+        if (row == NULL)
+            return false;
+
+        access_cxt_t acxt;
+        acxt.table = table;
+        acxt.col_details = col_details;
+        acxt.data = row + col_offset;
+        acxt.writable_data = NULL;
+        if (!read_column_data(&acxt, &values[i].constant))
+            return false;
+    }
+
+    if (col_details & mdtc_constant)
+        return true;
+
+    if (col_details & (mdtc_idx_table | mdtc_idx_coded))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t raw = values[i].constant;
+            mdtable_id_t target_id;
+            uint32_t target_row;
+            if (col_details & mdtc_idx_table)
+            {
+                target_row = RidFromToken(raw);
+                target_id = ExtractTable(col_details);
+            }
+            else if (!decompose_coded_index(raw, col_details, &target_id, &target_row))
+            {
+                return false;
+            }
+
+            if (0 > target_id || target_id >= MDTABLE_MAX_COUNT)
+                return false;
+            values[i].token = CreateTokenType(target_id) | target_row;
+        }
+        return true;
+    }
+
+    assert(col_details & mdtc_idx_heap);
+
+    // Resolve the heap entries, prefetching entries ahead of the one being decoded.
+    prefetched = 0;
+    for (; prefetched < count && prefetched < GATHER_PREFETCH_DISTANCE; ++prefetched)
+    {
+        uint8_t const* entry = get_gather_heap_entry(cxt, col_details, values[prefetched].constant);
+        if (entry != NULL)
+            PREFETCH_READ(entry);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (prefetched < count)
+        {
+            uint8_t const* entry = get_gather_heap_entry(cxt, col_details, values[prefetched++].constant);
+            if (entry != NULL)
+                PREFETCH_READ(entry);
+        }
+
+        uint32_t offset = values[i].constant;
+        switch (ExtractHeapType(col_details))
+        {
+        case mdtc_hstring:
+            if (!try_get_string(cxt, offset, &values[i].str))
+                return false;
+            break;
+        case mdtc_hblob:
+        {
+            uint8_t const* blob;
+            uint32_t blob_len;
+            if (!try_get_blob(cxt, offset, &blob, &blob_len))
+                return false;
+            values[i].blob.ptr = blob;
+            values[i].blob.length = blob_len;
+            break;
+        }
+        case mdtc_hguid:
+        {
+            mdguid_t guid;
+            if (!try_get_guid(cxt, offset, &guid))
+                return false;
+            values[i].guid = guid;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool md_get_column_values_raw(mdcursor_t c, uint32_t values_length, bool* values_to_get, uint32_t* values_raw)
 {
     if (values_length > 0
@@ -744,6 +932,9 @@ static bool find_range_element(mdcursor_t element, mdcursor_t* tgt_cursor)
     if (table == NULL)
         return false;
 
+    if (try_get_list_owner(element, tgt_cursor))
+        return true;
+
     uint32_t row = CursorRow(&element);
     mdtable_id_t tgt_table_id;
     col_index_t tgt_col;
@@ -23,6 +23,228 @@ bool try_get_string(mdcxt_t* cxt, size_t offset, char const** str)
     return true;
 }
 
+// FNV-1a - The hash must only depend on the string so views from any source can be compared.
+#define STRING_HASH_OFFSET_BASIS 0xcbf29ce484222325ull
+#define STRING_HASH_PRIME 0x100000001b3ull
+
+static uint64_t hash_bytes(uint64_t hash, char const* str, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= (uint8_t)str[i];
+        hash *= STRING_HASH_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t hash_string(char const* str, size_t max_len, uint32_t* length)
+{
+    assert(str != NULL && length != NULL);
+    uint64_t hash = STRING_HASH_OFFSET_BASIS;
+    size_t i = 0;
+    for (; i < max_len && str[i] != '\0'; ++i)
+    {
+        hash ^= (uint8_t)str[i];
+        hash *= STRING_HASH_PRIME;
+    }
+    *length = (uint32_t)i;
+    return hash;
+}
+
+uint64_t get_full_type_name_hash(mdstringview_t const* type_namespace, mdstringview_t const* type_name)
+{
+    assert(type_namespace != NULL && type_name != NULL);
+    uint64_t hash = STRING_HASH_OFFSET_BASIS;
+    if (type_namespace->length != 0)
+    {
+        hash = hash_bytes(hash, type_namespace->str, type_namespace->length);
+        hash = hash_bytes(hash, ".", 1);
+    }
+    return hash_bytes(hash, type_name->str, type_name->length);
+}
+
+uint64_t get_blob_hash(uint8_t const* blob, uint32_t blob_len)
+{
+    assert(blob != NULL || blob_len == 0);
+    return hash_bytes(STRING_HASH_OFFSET_BASIS, (char const*)blob, blob_len);
+}
+
+void md_create_utf8_view(char const* str, mdstringview_t* view)
+{
+    assert(str != NULL && view != NULL);
+    view->str = str;
+    view->hash = hash_string(str, UINT32_MAX, &view->length);
+}
+
+bool md_utf8_view_equals(mdstringview_t const* a, mdstringview_t const* b)
+{
+    assert(a != NULL && b != NULL);
+    return a->length == b->length
+        && a->hash == b->hash
+        && memcmp(a->str, b->str, a->length) == 0;
+}
+
+// The string info side table is an open addressed hash table keyed by heap offset.
+// Offset 0 is always the empty string, so it is never recorded and marks an unused entry.
+typedef struct string_info__
+{
+    uint32_t offset;
+    uint32_t length;
+    uint64_t hash;
+} string_info_t;
+
+typedef struct string_info_table__
+{
+    uint32_t mask;
+    string_info_t entries[];
+} string_info_table_t;
+
+static uint32_t string_info_slot(string_info_table_t const* table, uint32_t offset)
+{
+    // Fibonacci hashing to spread sequential offsets across the table.
+    return (uint32_t)(((uint64_t)offset * 0x9e3779b97f4a7c15ull) >> 32) & table->mask;
+}
+
+static void add_string_info(mdcxt_t* cxt, string_info_table_t* table, uint32_t offset)
+{
+    for (uint32_t i = string_info_slot(table, offset);; i = (i + 1) & table->mask)
+    {
+        string_info_t* entry = &table->entries[i];
+        if (entry->offset == offset)
+            return;
+
+        if (entry->offset == 0)
+        {
+            mdstream_t* h = &cxt->strings_heap;
+            entry->offset = offset;
+            entry->hash = hash_string((char const*)(h->ptr + offset), h->size - offset, &entry->length);
+            return;
+        }
+    }
+}
+
+static string_info_t const* find_string_info(string_info_table_t const* table, uint32_t offset)
+{
+    for (uint32_t i = string_info_slot(table, offset);; i = (i + 1) & table->mask)
+    {
+        string_info_t const* entry = &table->entries[i];
+        if (entry->offset == offset)
+            return entry;
+        if (entry->offset == 0)
+            return NULL;
+    }
+}
+
+// Record the length and hash of every string referenced by a table row.
+// Returns NULL if the side table can't be built, callers should compute the values directly.
+static string_info_table_t* build_string_info_table(mdcxt_t* cxt)
+{
+    assert(cxt != NULL);
+    uint64_t cell_count = 0;
+    for (size_t i = 0; i < MDTABLE_MAX_COUNT; ++i)
+    {
+        mdtable_t* table = &cxt->tables[i];
+        if (table->cxt == NULL)
+            continue;
+
+        for (uint8_t j = 0; j < table->column_count; ++j)
+        {
+            if (table->column_details[j] & mdtc_hstring)
+                cell_count += table->row_count;
+        }
+    }
+
+    // Keep the load factor at or below 50%.
+    uint64_t capacity = 16;
+    while (capacity < cell_count * 2)
+        capacity *= 2;
+    if (capacity > UINT32_MAX)
+        return NULL;
+
+    size_t alloc_size;
+    if (!safe_mul_size((size_t)capacity, sizeof(string_info_t), &alloc_size)
+        || !safe_add_size(alloc_size, sizeof(string_info_table_t), &alloc_size))
+    {
+        return NULL;
+    }
+
+    string_info_table_t* info = (string_info_table_t*)calloc(1, alloc_size);
+    if (info == NULL)
+        return NULL;
+    info->mask = (uint32_t)(capacity - 1);
+
+    for (size_t i = 0; i < MDTABLE_MAX_COUNT; ++i)
+    {
+        mdtable_t* table = &cxt->tables[i];
+        if (table->cxt == NULL || table->row_count == 0)
+            continue;
+
+        for (uint8_t j = 0; j < table->column_count; ++j)
+        {
+            if (!(table->column_details[j] & mdtc_hstring))
+                continue;
+
+            mdcursor_t cursor = create_cursor(table, 1);
+            bulk_access_cxt_t acxt;
+            if (!create_bulk_access_context(&cursor, index_to_col(j, table->table_id), table->row_count, &acxt))
+            {
+                free(info);
+                return NULL;
+            }
+
+            uint32_t offset;
+            do
+            {
+                if (!read_column_data_and_advance(&acxt, &offset))
+                {
+                    free(info);
+                    return NULL;
+                }
+
+                // Invalid offsets are reported when the column is read.
+                if (offset != 0 && offset < cxt->strings_heap.size)
+                    add_string_info(cxt, info, offset);
+            } while (next_row(&acxt));
+        }
+    }
+
+    return info;
+}
+
+void get_string_view(mdcxt_t* cxt, uint32_t offset, char const* str, mdstringview_t* view)
+{
+    assert(cxt != NULL && str != NULL && view != NULL);
+    view->str = str;
+
+    mdstream_t* h = &cxt->strings_heap;
+    if (offset == 0 || h->size <= offset)
+    {
+        view->hash = hash_string(str, UINT32_MAX, &view->length);
+        return;
+    }
+
+    string_info_table_t* info = (string_info_table_t*)get_side_table(cxt, mdst_StringInfo);
+    if (info == NULL)
+    {
+        info = build_string_info_table(cxt);
+        if (info != NULL)
+            info = (string_info_table_t*)publish_side_table(cxt, mdst_StringInfo, info);
+    }
+
+    // Strings added after the side table was built aren't recorded.
+    // The heap is append-only, so every recorded offset remains valid.
+    string_info_t const* entry = info != NULL ? find_string_info(info, offset) : NULL;
+    if (entry != NULL)
+    {
+        view->length = entry->length;
+        view->hash = entry->hash;
+    }
+    else
+    {
+        view->hash = hash_string(str, h->size - offset, &view->length);
+    }
+}
+
 bool validate_strings_heap(mdcxt_t* cxt)
 {
     assert(cxt != NULL);
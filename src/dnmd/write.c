@@ -464,7 +464,7 @@ static bool copy_cursor_column(mdcursor_t dest, mdcursor_t src, col_index_t idx)
             return false;
         break;
     case mdtc_idx_heap:
-        if (!get_column_value_as_heap_offset(src, idx, &column_value))
+        if (!md_get_column_value_as_heap_offset(src, idx, &column_value))
             return false;
         break;
     default:
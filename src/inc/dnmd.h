@@ -68,6 +68,11 @@ bool md_dump_tables(mdhandle_t handle, int32_t table_id);
 
 char const* md_get_version_string(mdhandle_t handle);
 
+// Get the number of edits made to existing rows in the image.
+// Appending rows doesn't change the count, so data derived from the rows of an image
+// can be kept for as long as the count is unchanged.
+uint64_t md_get_edit_count(mdhandle_t handle);
+
 //
 // All tables possible in ECMA-335
 //
@@ -455,10 +460,65 @@ bool md_get_column_value_as_userstring(mdcursor_t c, col_index_t col_idx, mduser
 bool md_get_column_value_as_blob(mdcursor_t c, col_index_t col_idx, uint8_t const** blob, uint32_t* blob_len);
 bool md_get_column_value_as_guid(mdcursor_t c, col_index_t col_idx, mdguid_t* guid);
 
+// A string from the #Strings heap with its length and hash.
+typedef struct mdstringview__
+{
+    char const* str;
+    uint32_t length; // Length in bytes, excluding the null terminator.
+    uint64_t hash; // See md_create_utf8_view().
+} mdstringview_t;
+
+// Get a #Strings heap column value along with its length and hash.
+// Lengths and hashes are recorded in a side table the first time any view is requested
+// from the handle, so repeated lookups don't need to scan the string.
+bool md_get_column_value_as_utf8_view(mdcursor_t c, col_index_t col_idx, mdstringview_t* view);
+
+// Create a view for a null-terminated UTF-8 string.
+// The hash only depends on the string's bytes, so views from different handles,
+// or views created with this function, can be compared.
+void md_create_utf8_view(char const* str, mdstringview_t* view);
+
+// Compare two views for equality.
+// Views with different lengths or hashes are unequal without comparing the strings.
+bool md_utf8_view_equals(mdstringview_t const* a, mdstringview_t const* b);
+
+// Get the offset into the heap referenced by a heap index column.
+// Heaps are only appended to, so an offset refers to the same value for the lifetime
+// of the handle. This makes the offset a suitable key for caching data computed from the value.
+bool md_get_column_value_as_heap_offset(mdcursor_t c, col_index_t col_idx, uint32_t* offset);
+
 // Read a table or coded index column from multiple rows and return the values as an array of tokens.
 // The number of rows read is returned by the function. A '-1' return value indicates an error.
 int32_t md_get_many_rows_column_value_as_token(mdcursor_t c, col_index_t col_idx, uint32_t out_length, mdToken* tokens);
 
+// A decoded column value. The member that is set depends on the kind of column read.
+typedef union mdcolumnvalue__
+{
+    uint32_t constant; // Constant columns
+    mdToken token; // Table and coded index columns
+    char const* str; // #Strings heap columns
+    struct
+    {
+        uint8_t const* ptr;
+        uint32_t length;
+    } blob; // #Blob heap columns
+    mdguid_t guid; // #GUID heap columns
+} mdcolumnvalue_t;
+
+// Read a column from the rows identified by an array of tokens and decode the values.
+// The tokens can be in any order but must all refer to rows in the same table.
+// Rows and the heap entries they reference are prefetched a few elements ahead of being
+// decoded so the memory accesses for consecutive tokens overlap.
+// Returns false if any token doesn't refer to a row or a value can't be decoded.
+bool md_gather_column_values(mdhandle_t handle, col_index_t col_idx, mdToken const* tokens, uint32_t count, mdcolumnvalue_t* values);
+
+// Decode up to 'count' consecutive compressed integers - ECMA-335 II.23.2 - from a blob or signature,
+// advancing 'data' and 'data_len' past the decoded values.
+// Runs of single byte values, the common case, are widened 16 at a time with SSE2 or NEON where available.
+// Returns the number of values decoded, which is less than 'count' if the data ends or holds an invalid value.
+uint32_t md_decompress_u32_many(uint8_t const** data, size_t* data_len, uint32_t count, uint32_t* values);
+uint32_t md_decompress_i32_many(uint8_t const** data, size_t* data_len, uint32_t count, int32_t* values);
+
 // Return the raw column values for the row. Unlike the md_get_column_value_as_* APIs, the returned values
 // are in their raw form.
 // Callers should indicate ('true') using the 'values_to_get' collection which columns are desired.
@@ -498,6 +558,170 @@ bool md_find_cursor_of_range_element(mdcursor_t element, mdcursor_t* cursor);
 // Returns true if the cursor was not an indirect cursor or if the indirection was resolved, or false if the cursor pointed to an invalid indirection table entry.
 bool md_resolve_indirect_cursor(mdcursor_t c, mdcursor_t* target);
 
+// Find the first TypeRef row with the supplied resolution scope, namespace and name.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_typeref(mdhandle_t handle, mdToken resolution_scope, char const* type_namespace, char const* type_name, mdcursor_t* typeref);
+
+// Find the first MemberRef row with the supplied parent, name and signature.
+// If signature is NULL, any signature matches.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_memberref(mdhandle_t handle, mdToken parent, char const* name, uint8_t const* signature, uint32_t signature_len, mdcursor_t* memberref);
+
+// Find the first ExportedType row with the supplied namespace and name.
+// If enclosing_type is a non-nil ExportedType token, only types nested in it are considered,
+// otherwise only types that aren't nested are considered.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_exportedtype(mdhandle_t handle, mdToken enclosing_type, char const* type_namespace, char const* type_name, mdcursor_t* exportedtype);
+
+// Find the first ManifestResource row with the supplied name.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_manifestresource(mdhandle_t handle, char const* name, mdcursor_t* manifestresource);
+
+// Find the first ModuleRef row with the supplied name.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_moduleref(mdhandle_t handle, char const* name, mdcursor_t* moduleref);
+
+// Find the first TypeSpec or StandAloneSig row with a signature equal to the supplied bytes.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_typespec(mdhandle_t handle, uint8_t const* signature, uint32_t signature_len, mdcursor_t* typespec);
+bool md_find_standalonesig(mdhandle_t handle, uint8_t const* signature, uint32_t signature_len, mdcursor_t* standalonesig);
+
+// Find the first MethodSpec row with the supplied method and an instantiation equal to the supplied bytes.
+// Lookups use a hash index that is built on first use and kept consistent as rows are added or changed.
+bool md_find_methodspec(mdhandle_t handle, mdToken method, uint8_t const* instantiation, uint32_t instantiation_len, mdcursor_t* methodspec);
+
+// Build an index from the values of a table or coded index column back to the rows that contain them.
+// The index is built in one pass over the column and is owned by the handle.
+// Editing the table drops the index, the next lookup rebuilds it.
+// Building is optional, md_find_reverse_references() builds the index on first use.
+bool md_build_reverse_index(mdhandle_t handle, mdtable_id_t table_id, col_index_t col_idx);
+
+// Find the rows of a table whose table or coded index column refers to the supplied token.
+// The row IDs are returned in ascending order and remain valid until the table is edited.
+// Returns false if the column isn't a table or coded index column, or the index can't be built.
+bool md_find_reverse_references(mdhandle_t handle, mdtable_id_t table_id, col_index_t col_idx, mdToken tk, uint32_t const** rows, uint32_t* count);
+
+typedef enum
+{
+    MD_CUSTOM_ATTRIBUTE_FOUND = 0,
+    MD_CUSTOM_ATTRIBUTE_NOT_FOUND = 1,
+    MD_CUSTOM_ATTRIBUTE_CORRUPT_ROW = 2, // A row referenced by an attribute couldn't be read.
+    MD_CUSTOM_ATTRIBUTE_INVALID_TYPE = 3, // An attribute's type has an invalid TypeSpec signature or constructor.
+} md_custom_attribute_result_t;
+
+// Find the first custom attribute on the parent whose type has the supplied full name, e.g. "System.ObsoleteAttribute".
+// The attribute type is the type declaring the constructor, generic attribute types are matched by their generic type.
+// The type name hash of every attribute and a filter of the hashes on each parent are built on first use,
+// so a parent without a matching attribute is usually rejected without reading its attributes.
+// The parent's attributes are checked in row order, and the first one that matches or can't be read determines the result.
+md_custom_attribute_result_t md_find_custom_attribute_by_name(mdhandle_t handle, mdToken parent, char const* type_name, mdcursor_t* attribute);
+
+// Find the custom attributes of a given type in up to 'row_count' CustomAttribute rows starting at the cursor.
+// The token and parent of each match are written in row order, up to 'out_length' matches, and the number of
+// matches written is returned. A '-1' return value indicates an error, which for the _by_name variant includes
+// an attribute in the range whose type can't be read. Continue from the row after the last
+// match to find more. Disjoint row ranges can be searched from multiple threads.
+// The attribute types are resolved once per constructor and kept in the same side table as md_find_custom_attribute_by_name().
+//
+// The _by_name variant matches the full type name like md_find_custom_attribute_by_name().
+// The _by_type variant matches a MethodDef or MemberRef constructor token, or the TypeDef, TypeRef or TypeSpec
+// token that declares the constructor.
+int32_t md_find_custom_attributes_by_name(mdcursor_t c, uint32_t row_count, char const* type_name, uint32_t out_length, mdToken* attributes, mdToken* parents);
+int32_t md_find_custom_attributes_by_type(mdcursor_t c, uint32_t row_count, mdToken type, uint32_t out_length, mdToken* attributes, mdToken* parents);
+
+// Decode the Value blob of a CustomAttribute row - ECMA-335 II.23.3.
+// Resolve the underlying type of an enum that isn't defined in the handle. 'type' is the TypeRef or TypeDef of the enum
+// in the constructor signature, or nil for named and boxed arguments, which carry the serialized type name instead.
+// The type name isn't null-terminated. Returns false if the type can't be resolved, which stops the iteration.
+typedef bool (*md_resolve_enum_fn_t)(void* context, mdToken type, char const* type_name, uint32_t type_name_len, uint8_t* underlying_type);
+
+typedef enum md_custom_attribute_argument_kind__
+{
+    mdcaa_Fixed, // Argument of the constructor
+    mdcaa_NamedField,
+    mdcaa_NamedProperty,
+    mdcaa_ArrayElement, // Element of the closest preceding array argument that still has elements
+} md_custom_attribute_argument_kind_t;
+
+// An argument decoded by md_custom_attribute_iterator_next().
+typedef struct md_custom_attribute_argument__
+{
+    md_custom_attribute_argument_kind_t kind;
+    char const* name; // Named arguments, not null-terminated
+    uint32_t name_len;
+    // ELEMENT_TYPE_BOOLEAN to ELEMENT_TYPE_R8, ELEMENT_TYPE_STRING, ELEMENT_TYPE_SZARRAY or SERIALIZATION_TYPE_TYPE.
+    // Enum values have the underlying type of the enum and boxed values the type of the boxed value.
+    uint8_t type;
+    bool is_enum;
+    bool is_boxed; // Argument of type object, or element of an object array
+    // Enum values and arrays of enums: the TypeDef or TypeRef from the constructor signature, or nil and the serialized type name.
+    mdToken enum_type;
+    char const* enum_type_name;
+    uint32_t enum_type_name_len;
+    union
+    {
+        bool boolean;
+        uint16_t character;
+        int64_t i; // ELEMENT_TYPE_I1 to ELEMENT_TYPE_I8, sign-extended
+        uint64_t u; // ELEMENT_TYPE_U1 to ELEMENT_TYPE_U8
+        float r4;
+        double r8;
+        struct
+        {
+            char const* str; // NULL for a null string, otherwise not null-terminated
+            uint32_t len;
+        } string; // ELEMENT_TYPE_STRING and SERIALIZATION_TYPE_TYPE
+        struct
+        {
+            uint8_t element_type; // As 'type', or SERIALIZATION_TYPE_TAGGED_OBJECT for object arrays
+            uint32_t count; // UINT32_MAX for a null array
+        } array; // ELEMENT_TYPE_SZARRAY, the elements are returned next as mdcaa_ArrayElement arguments
+    } value;
+} md_custom_attribute_argument_t;
+
+// Pull iterator over the arguments of a custom attribute.
+// Arguments are decoded one at a time directly from the blob and nothing is allocated.
+// Strings and names point into the blob. The fields are private.
+typedef struct md_custom_attribute_iterator__
+{
+    mdhandle_t _handle;
+    md_resolve_enum_fn_t _resolve_enum;
+    void* _context;
+    uint8_t const* _blob;
+    size_t _blob_len;
+    uint8_t const* _signature;
+    size_t _signature_len;
+    uint8_t const* _type_args;
+    size_t _type_args_len;
+    uint32_t _type_arg_count;
+    uint32_t _fixed_remaining;
+    uint32_t _named_remaining;
+    bool _named_read;
+    bool _failed;
+    uint32_t _array_depth;
+    struct
+    {
+        uint32_t remaining;
+        uint8_t element_type;
+        uint8_t underlying_type;
+        mdToken enum_type;
+        char const* enum_type_name;
+        uint32_t enum_type_name_len;
+    } _arrays[4];
+} md_custom_attribute_iterator_t;
+
+// Read the constructor signature and blob prolog of a CustomAttribute row and position the iterator before the first argument.
+// Enums defined in the handle are resolved through their value__ field, other enums through the optional callback.
+// Parameters of generic attribute constructors ('!n') are resolved through the type arguments of the constructor's TypeSpec parent.
+bool md_custom_attribute_iterator_init(mdcursor_t custom_attribute, md_resolve_enum_fn_t resolve_enum, void* context, md_custom_attribute_iterator_t* iterator);
+
+// Decode the next argument, fixed arguments first and then named arguments. Returns false when there are no more
+// arguments or an argument can't be decoded, see md_custom_attribute_iterator_failed() to tell the two apart.
+bool md_custom_attribute_iterator_next(md_custom_attribute_iterator_t* iterator, md_custom_attribute_argument_t* argument);
+
+// Returns true if iteration stopped on an invalid blob, an unsupported argument type or an unresolved enum.
+bool md_custom_attribute_iterator_failed(md_custom_attribute_iterator_t const* iterator);
+
 // Set row's column values
 // The returned number represents the number of rows updated.
 bool md_set_column_value_as_token(mdcursor_t c, col_index_t col, mdToken tk);
@@ -546,6 +770,25 @@ void md_commit_row_add(mdcursor_t row);
 // Add a user string to the #US heap.
 mduserstringcursor_t md_add_userstring_to_heap(mdhandle_t handle, char16_t const* userstring);
 
+// Called with the original and new token of each row moved by md_remove_indirection_tables().
+typedef void (*md_token_remap_fn_t)(void* context, mdToken original_token, mdToken new_token);
+
+typedef enum
+{
+    MD_INDIRECTION_TABLES_REMOVED = 0, // Also returned when there are no indirection tables.
+    MD_INDIRECTION_TABLES_NOT_REMOVABLE = 1, // The image can't be reordered and is unchanged.
+    MD_INDIRECTION_TABLES_ERROR = 2, // The image may be partially updated.
+} md_remove_indirection_result_t;
+
+// Remove the *Ptr indirection tables by physically moving the rows of each target table into list order.
+// References to moved rows are updated and sorted tables whose keys change are sorted again,
+// so the image can be written with a compressed (#~) table heap.
+// Tokens of moved rows change, each change is reported once through the optional callback.
+// On error the rows already moved are still reported.
+// Images with EnC tables, minimal deltas, a row being added, or an indirection table that isn't
+// a permutation of its target table can't be reordered and are left with their indirection tables.
+md_remove_indirection_result_t md_remove_indirection_tables(mdhandle_t handle, md_token_remap_fn_t remap, void* context);
+
 // Write the metadata represented by the handle to the supplied buffer.
 // The metadata is always written with the v2.0 table schema.
 bool md_write_to_buffer(mdhandle_t handle, uint8_t* buffer, size_t* len);
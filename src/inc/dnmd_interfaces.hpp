@@ -5,6 +5,67 @@
 #define DNMD_EXPORT
 #endif // !DNMD_EXPORT
 
+// DNMD specific options for IMetaDataDispenserEx::SetOption() and GetOption().
+//
+//  MetaDataNameCacheSize - {1DC734CB-4227-4A6F-834B-39F3D73FD7D5}
+//      VT_UI4 - Number of UTF-16 names cached per scope for the Get*Props APIs.
+//      The default of 0 disables the cache.
+EXTERN_GUID(MetaDataNameCacheSize, 0x1dc734cb, 0x4227, 0x4a6f, 0x83, 0x4b, 0x39, 0xf3, 0xd7, 0x3f, 0xd7, 0xd5);
+//
+//  MetaDataRemoveIndirectionTables - {EA1B7C85-0546-47E8-841F-B55BE879EAFF}
+//      VT_UI4 - When non-zero, the *Ptr tables are removed before a scope is saved
+//      by moving rows into list order. Tokens of moved rows change and each change is
+//      reported to the IMapToken registered with IMetaDataEmit::SetHandler().
+//      The default of 0 keeps tokens stable and saves an uncompressed (#-) table heap.
+EXTERN_GUID(MetaDataRemoveIndirectionTables, 0xea1b7c85, 0x0546, 0x47e8, 0x84, 0x1f, 0xb5, 0x5b, 0xe8, 0x79, 0xea, 0xff);
+
+// DNMD specific interface for reading the properties of many rows in one call.
+// Available via QueryInterface() on any DNMD IMetaDataImport instance.
+//
+//  IDNMDImportBatch - {32B1FC87-1BFC-40EE-9345-BCF48ED3FEBB}
+//
+// Results are written to caller supplied parallel arrays. Every output array is
+// optional and, when non-null, must have room for cTokens elements. Names are
+// UTF-8 and point into the scope's string heap. For a read-only scope they remain
+// valid for the lifetime of the scope. For an editable scope any edit can move the
+// heap, so they are only valid until the scope is next edited. Every token is
+// validated before any output is written.
+EXTERN_GUID(IID_IDNMDImportBatch, 0x32b1fc87, 0x1bfc, 0x40ee, 0x93, 0x45, 0xbc, 0xf4, 0x8e, 0xd3, 0xfe, 0xbb);
+
+#undef  INTERFACE
+#define INTERFACE IDNMDImportBatch
+DECLARE_INTERFACE_(IDNMDImportBatch, IUnknown)
+{
+    STDMETHOD(GetTypeDefPropsBatch)(
+        mdTypeDef const rTypeDefs[],        // [IN] TypeDefs to read.
+        ULONG       cTokens,                // [IN] Number of TypeDefs.
+        DWORD       rFlags[],               // [OUT] TypeDef flags.
+        mdToken     rExtends[],             // [OUT] Base type, or mdTypeRefNil.
+        mdTypeDef   rEnclosingClasses[],    // [OUT] Enclosing class, or mdTypeDefNil.
+        char const* rNamespaces[],          // [OUT] Namespaces.
+        char const* rNames[]) PURE;         // [OUT] Names.
+
+    STDMETHOD(GetMethodPropsBatch)(
+        mdMethodDef const rMethods[],       // [IN] MethodDefs to read.
+        ULONG       cTokens,                // [IN] Number of MethodDefs.
+        mdTypeDef   rClasses[],             // [OUT] Declaring types.
+        DWORD       rFlags[],               // [OUT] Method flags.
+        DWORD       rImplFlags[],           // [OUT] Method impl flags.
+        ULONG       rCodeRVAs[],            // [OUT] Code RVAs.
+        char const* rNames[],               // [OUT] Names.
+        PCCOR_SIGNATURE rSigBlobs[],        // [OUT] Signature blobs.
+        ULONG       rSigBlobLengths[]) PURE; // [OUT] Signature blob lengths.
+
+    STDMETHOD(GetFieldPropsBatch)(
+        mdFieldDef const rFields[],         // [IN] FieldDefs to read.
+        ULONG       cTokens,                // [IN] Number of FieldDefs.
+        mdTypeDef   rClasses[],             // [OUT] Declaring types.
+        DWORD       rFlags[],               // [OUT] Field flags.
+        char const* rNames[],               // [OUT] Names.
+        PCCOR_SIGNATURE rSigBlobs[],        // [OUT] Signature blobs.
+        ULONG       rSigBlobLengths[]) PURE; // [OUT] Signature blob lengths.
+};
+
 // Create a metadata dispenser instance.
 //
 //  IMetaDataDispenser  - {809C652E-7396-11D2-9771-00A0C9B4D50C}
@@ -18,6 +18,10 @@ extern "C" {
 // Returns false if the handle does not contain a #Pdb stream or if the supplied buffer is too small to hold the PDB ID.
 bool md_get_pdb_id(mdhandle_t handle, size_t* pdb_id_len, uint8_t* pdb_id);
 
+// Get the entry point MethodDef token from the #Pdb stream of a Portable PDB, a nil token if there is no entry point.
+// Returns false if the handle does not contain a #Pdb stream.
+bool md_get_pdb_entry_point(mdhandle_t handle, mdToken* entry_point);
+
 // Methods to parse specialized blob formats defined in the Portable PDB spec.
 // https://github.com/dotnet/runtime/blob/main/docs/design/specs/PortablePdb-Metadata.md
 
@@ -32,6 +36,13 @@ typedef enum md_blob_parse_result__
 // Parse a DocumentName blob into a UTF-8 string.
 md_blob_parse_result_t md_parse_document_name(mdhandle_t handle, uint8_t const* blob, size_t blob_len, char const* name, size_t* name_len);
 
+typedef enum md_sequence_point_kind__
+{
+    mdsp_DocumentRecord,
+    mdsp_SequencePointRecord,
+    mdsp_HiddenSequencePointRecord,
+} md_sequence_point_kind_t;
+
 // Parse a SequencePoints blob.
 typedef struct md_sequence_points__
 {
@@ -40,12 +51,7 @@ typedef struct md_sequence_points__
     uint32_t record_count;
     struct
     {
-        enum
-        {
-            mdsp_DocumentRecord,
-            mdsp_SequencePointRecord,
-            mdsp_HiddenSequencePointRecord,
-        } kind;
+        md_sequence_point_kind_t kind;
         union
         {
             struct
@@ -69,6 +75,120 @@ typedef struct md_sequence_points__
 } md_sequence_points_t;
 md_blob_parse_result_t md_parse_sequence_points(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len, md_sequence_points_t* sequence_points, size_t* buffer_len);
 
+// Iterate a SequencePoints blob one record at a time.
+// Each record is decoded once, directly from the blob, and nothing is allocated.
+// The fields are private except for 'signature' and 'document', which is the document of the most recent record.
+typedef struct md_sequence_point_iterator__
+{
+    mdToken signature;
+    mdcursor_t document;
+
+    mdhandle_t _handle;
+    uint8_t const* _blob;
+    size_t _blob_len;
+    md_blob_parse_result_t _result;
+    uint32_t _il_offset;
+    uint32_t _start_line;
+    uint32_t _start_column;
+    bool _first_record;
+    bool _seen_sequence_point;
+} md_sequence_point_iterator_t;
+
+// A record decoded by md_sequence_point_iterator_next().
+// Offsets, lines and columns are absolute. Only 'kind' and 'document' are set for document records,
+// and only 'kind', 'document' and 'il_offset' are set for hidden sequence points.
+typedef struct md_sequence_point__
+{
+    md_sequence_point_kind_t kind;
+    mdcursor_t document;
+    uint32_t il_offset;
+    uint32_t start_line;
+    uint32_t start_column;
+    uint32_t end_line;
+    uint32_t end_column;
+} md_sequence_point_t;
+
+// Read the blob header and position the iterator before the first record.
+md_blob_parse_result_t md_sequence_point_iterator_init(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len, md_sequence_point_iterator_t* iterator);
+
+// Decode the next record. Returns false when there are no more records or the blob is invalid,
+// see md_sequence_point_iterator_result() to tell the two apart.
+bool md_sequence_point_iterator_next(md_sequence_point_iterator_t* iterator, md_sequence_point_t* sequence_point);
+
+// Returns mdbpr_InvalidBlob if iteration stopped on an invalid record, otherwise mdbpr_Success.
+md_blob_parse_result_t md_sequence_point_iterator_result(md_sequence_point_iterator_t const* iterator);
+
+// The source location of a sequence point.
+typedef struct md_source_location__
+{
+    mdcursor_t document;
+    uint32_t il_offset; // IL offset of the sequence point
+    uint32_t start_line;
+    uint32_t start_column;
+} md_source_location_t;
+
+// Find the sequence point that covers an IL offset of a method, i.e. the last sequence point at or before the offset.
+// Returns false if there is no such sequence point, or it is hidden.
+// The sequence points of a method are decoded once into an array sorted by IL offset, which is owned by the handle
+// and searched with a binary search. Editing the MethodDebugInformation table drops the arrays.
+bool md_find_sequence_point(mdcursor_t method_debug_information, uint32_t il_offset, md_source_location_t* location);
+
+// Build the sorted sequence point arrays of 'row_count' MethodDebugInformation rows starting at 'first_row' ahead of lookups.
+// Row ranges can be built from multiple threads. Building is optional, md_find_sequence_point() builds methods on first use.
+bool md_build_sequence_point_index(mdhandle_t handle, uint32_t first_row, uint32_t row_count);
+
+// Get the number of bytes used by the sequence point arrays built so far.
+size_t md_get_sequence_point_index_size(mdhandle_t handle);
+
+// Get the path of a Document row, reassembled from its DocumentName blob.
+// The paths of all documents are reassembled once into a buffer owned by the handle, which is
+// dropped when the Document table is edited. The returned path is null-terminated.
+bool md_get_document_path(mdcursor_t document, char const** path, uint32_t* path_len);
+
+typedef enum md_document_match__
+{
+    mddm_Exact, // Byte-wise equal paths
+    mddm_IgnoreCase, // Equal paths, ignoring ASCII case
+    mddm_PathSuffix, // Paths that end with the query at a path component boundary, ignoring ASCII case and '/' vs '\\'
+} md_document_match_t;
+
+// Find the Document rows with a matching path, using hash chains built alongside the paths.
+// Writes up to 'out_length' documents in row order and returns the total number of matches, or -1 on error.
+int32_t md_find_documents(mdhandle_t handle, char const* path, md_document_match_t match, uint32_t out_length, mdcursor_t* documents);
+
+// A LocalScope row with its resolved VariableList and ConstantList ranges.
+typedef struct md_local_scope__
+{
+    mdcursor_t scope;
+    uint32_t start_offset;
+    uint32_t length;
+    mdcursor_t variables;
+    uint32_t variable_count;
+    mdcursor_t constants;
+    uint32_t constant_count;
+} md_local_scope_t;
+
+// Find the local scopes of a MethodDef that contain an IL offset, from the innermost to the outermost scope.
+// Writes up to 'out_length' scopes and returns the total number of scopes, or -1 on error.
+// The LocalScope rows are grouped by method and linked to their enclosing scope once into a table owned by the handle,
+// so a lookup is two binary searches and a walk up the enclosing scopes. Editing the LocalScope, LocalVariable or
+// LocalConstant tables drops the table.
+int32_t md_find_local_scopes(mdhandle_t handle, mdToken method, uint32_t il_offset, uint32_t out_length, md_local_scope_t* scopes);
+
+// A CustomDebugInformation row with its Value blob.
+typedef struct md_custom_debug_information__
+{
+    mdcursor_t custom_debug_information;
+    uint8_t const* value;
+    uint32_t value_len;
+} md_custom_debug_information_t;
+
+// Find the CustomDebugInformation rows of a parent with a kind, e.g. the state machine hoisted local scopes of a method.
+// Writes up to 'out_length' rows in row order and returns the total number of rows, or -1 on error.
+// The rows are sorted by parent and interned kind once into a table owned by the handle, so a lookup is a
+// comparison against the few kinds in the PDB and a binary search. Editing the CustomDebugInformation table drops the table.
+int32_t md_find_custom_debug_information(mdhandle_t handle, mdToken parent, mdguid_t kind, uint32_t out_length, md_custom_debug_information_t* values);
+
 // Parse a LocalConstantSig blob.
 typedef struct md_local_constant_sig__
 {
@@ -142,6 +262,48 @@ typedef struct md_imports__
 } md_imports_t;
 md_blob_parse_result_t md_parse_imports(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_imports_t* imports, size_t* buffer_len);
 
+// A caller-owned bump arena for the blob parsers.
+// The _in_arena parsers decode a blob once and append the result to the arena instead of sizing a buffer first,
+// so the blobs of every row in a PDB can be parsed into one arena without allocating per blob.
+// Results are 8-byte aligned and remain valid until the arena is reset.
+typedef struct md_parse_arena__
+{
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used;
+    // Set when a parser returns mdbpr_InsufficientBuffer to the number of free bytes the result needs.
+    // The arena is left unchanged, so parsing can continue in a new arena of at least this size.
+    size_t needed;
+} md_parse_arena_t;
+
+void md_init_parse_arena(md_parse_arena_t* arena, void* buffer, size_t capacity);
+
+// Discard all results in the arena.
+void md_reset_parse_arena(md_parse_arena_t* arena);
+
+// Parse a blob into the arena. The result is set only when mdbpr_Success is returned.
+md_blob_parse_result_t md_parse_sequence_points_in_arena(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len, md_parse_arena_t* arena, md_sequence_points_t** sequence_points);
+md_blob_parse_result_t md_parse_local_constant_sig_in_arena(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_parse_arena_t* arena, md_local_constant_sig_t** local_constant_sig);
+md_blob_parse_result_t md_parse_imports_in_arena(mdhandle_t handle, uint8_t const* blob, size_t blob_len, md_parse_arena_t* arena, md_imports_t** imports);
+
+// Methods to encode the blob formats defined in the Portable PDB spec.
+// Each encoder sizes the blob, reserves it at the end of the #Blob heap and compresses the values
+// directly into the heap, so no intermediate buffer is allocated. The blob is then set on the row.
+// The inputs can point into the #Blob heap of the same handle, so parsed blobs can be re-encoded as-is.
+
+// Encode the SequencePoints blob of a MethodDebugInformation row and set its Document column.
+// The records are in IL offset order and 'document' is the document of each record. Document records
+// are emitted where the document changes, so records of kind mdsp_DocumentRecord in the input are skipped.
+// A sequence of records read with md_sequence_point_iterator_next() can be encoded as-is.
+bool md_encode_sequence_points(mdcursor_t method_debug_information, mdToken local_signature, md_sequence_point_t const* sequence_points, uint32_t count);
+
+// Encode a LocalConstantSig blob and set it as the Signature column of a LocalConstant row.
+bool md_encode_local_constant_sig(mdcursor_t local_constant, md_local_constant_sig_t const* local_constant_sig);
+
+// Encode an Imports blob and set it as the Imports column of an ImportScope row.
+// The aliases and namespaces are added to the #Blob heap as UTF-8 blobs.
+bool md_encode_imports(mdcursor_t import_scope, md_imports_t const* imports);
+
 #ifdef __cplusplus
 }
 #endif
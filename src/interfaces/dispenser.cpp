@@ -20,12 +20,15 @@ namespace
     class MDDispenser final : public TearOffBase<IMetaDataDispenserEx>
     {
         bool _threadSafe;
+        uint32_t _nameCacheSize = 0;
+        uint32_t _checkDuplicatesFor = MDNoDupChecks;
+        uint32_t _removeIndirectionTables = 0;
     private:
         dncp::com_ptr<ControllingIUnknown> CreateExposedObject(dncp::com_ptr<ControllingIUnknown> unknown, DNMDOwner* owner)
         {
             mdhandle_view handle_view{ owner };
-            MetadataEmit* emit = unknown->CreateAndAddTearOff<MetadataEmit>(handle_view);
-            MetadataImportRO* import = unknown->CreateAndAddTearOff<MetadataImportRO>(std::move(handle_view));
+            MetadataEmit* emit = unknown->CreateAndAddTearOff<MetadataEmit>(handle_view, _checkDuplicatesFor, _removeIndirectionTables != 0);
+            MetadataImportRO* import = unknown->CreateAndAddTearOff<MetadataImportRO>(std::move(handle_view), _nameCacheSize, true);
             if (!_threadSafe)
             {
                 return unknown;
@@ -161,7 +164,7 @@ namespace
                 if (dwOpenFlags & ofReadOnly)
                 {
                     // If we're read-only, then we don't need to deal with thread safety.
-                    (void)obj->CreateAndAddTearOff<MetadataImportRO>(std::move(handle_view));
+                    (void)obj->CreateAndAddTearOff<MetadataImportRO>(std::move(handle_view), _nameCacheSize);
                     return obj->QueryInterface(riid, (void**)ppIUnk);
                 }
                 
@@ -185,6 +188,27 @@ namespace
                 _threadSafe = V_UI4(value) == CorThreadSafetyOptions::MDThreadSafetyOn;
                 return S_OK;
             }
+            if (optionid == MetaDataNameCacheSize)
+            {
+                if (V_VT(value) != VT_UI4)
+                    return E_INVALIDARG;
+                _nameCacheSize = V_UI4(value);
+                return S_OK;
+            }
+            if (optionid == MetaDataCheckDuplicatesFor)
+            {
+                if (V_VT(value) != VT_UI4)
+                    return E_INVALIDARG;
+                _checkDuplicatesFor = V_UI4(value);
+                return S_OK;
+            }
+            if (optionid == MetaDataRemoveIndirectionTables)
+            {
+                if (V_VT(value) != VT_UI4)
+                    return E_INVALIDARG;
+                _removeIndirectionTables = V_UI4(value);
+                return S_OK;
+            }
             return E_INVALIDARG;
         }
 
@@ -197,6 +221,24 @@ namespace
                 V_UI4(pvalue) = _threadSafe ? CorThreadSafetyOptions::MDThreadSafetyOn : CorThreadSafetyOptions::MDThreadSafetyOff;
                 return S_OK;
             }
+            if (optionid == MetaDataNameCacheSize)
+            {
+                V_VT(pvalue) = VT_UI4;
+                V_UI4(pvalue) = _nameCacheSize;
+                return S_OK;
+            }
+            if (optionid == MetaDataCheckDuplicatesFor)
+            {
+                V_VT(pvalue) = VT_UI4;
+                V_UI4(pvalue) = _checkDuplicatesFor;
+                return S_OK;
+            }
+            if (optionid == MetaDataRemoveIndirectionTables)
+            {
+                V_VT(pvalue) = VT_UI4;
+                V_UI4(pvalue) = _removeIndirectionTables;
+                return S_OK;
+            }
             return E_INVALIDARG;
         }
 
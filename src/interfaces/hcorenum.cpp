@@ -25,6 +25,7 @@ HRESULT HCORENUMImpl::CreateTableEnum(_In_ uint32_t count, _Out_ HCORENUMImpl**
 
     enumImpl->_type = HCORENUMType::Table;
     enumImpl->_entrySpan = 1;
+    enumImpl->_source = nullptr;
     enumImpl->_curr = &enumImpl->_data;
     enumImpl->_last = enumImpl->_curr;
 
@@ -81,6 +82,7 @@ HRESULT HCORENUMImpl::CreateDynamicEnum(_Out_ HCORENUMImpl** impl, _In_ uint32_t
     // The page must be a multiple of the entrySpan for reading to be efficient.
     assert(ARRAY_SIZE(enumImpl->_data.Dynamic.Page) % entrySpan == 0);
     enumImpl->_entrySpan = entrySpan;
+    enumImpl->_source = nullptr;
     ::memset(&enumImpl->_data, 0, sizeof(enumImpl->_data));
     enumImpl->_curr = &enumImpl->_data;
     enumImpl->_last = enumImpl->_curr;
@@ -110,9 +112,41 @@ HRESULT HCORENUMImpl::AddToDynamicEnum(_Inout_ HCORENUMImpl& impl, uint32_t valu
     return S_OK;
 }
 
+HRESULT HCORENUMImpl::CreateLazyEnum(_In_ HCORENUMSource* source, _Out_ HCORENUMImpl** impl, _In_ uint32_t entrySpan) noexcept
+{
+    assert(source != nullptr);
+    HRESULT hr = CreateDynamicEnum(impl, entrySpan);
+    if (FAILED(hr))
+    {
+        delete source;
+        return hr;
+    }
+
+    (*impl)->_source = source;
+    return S_OK;
+}
+
+HRESULT HCORENUMImpl::CreateFilledEnum(_In_ HCORENUMSource* source, _Out_ HCORENUMImpl** impl, _In_ uint32_t entrySpan) noexcept
+{
+    HRESULT hr;
+    HCORENUMImpl* enumImpl;
+    RETURN_IF_FAILED(CreateLazyEnum(source, &enumImpl, entrySpan));
+
+    hr = enumImpl->FillAll();
+    if (FAILED(hr))
+    {
+        Destroy(enumImpl);
+        return hr;
+    }
+
+    *impl = enumImpl;
+    return S_OK;
+}
+
 void HCORENUMImpl::Destroy(_In_ HCORENUMImpl* impl) noexcept
 {
     assert(impl != nullptr);
+    delete impl->_source;
     if (impl->_type == HCORENUMType::Dynamic)
     {
         // Delete all allocated pages.
@@ -129,19 +163,61 @@ void HCORENUMImpl::Destroy(_In_ HCORENUMImpl* impl) noexcept
     ::free(impl);
 }
 
-uint32_t HCORENUMImpl::Count() const noexcept
+HRESULT HCORENUMImpl::Count(_Out_ uint32_t& count) noexcept
 {
+    HRESULT hr;
+    RETURN_IF_FAILED(FillAll());
+
     // Accumulate all tables in the enumerator
-    uint32_t count = 0;
+    uint32_t total = 0;
     EnumData const* curr = &_data;
     do
     {
-        count += curr->Total;
+        total += curr->Total;
         curr = curr->Next;
     }
     while (curr != nullptr);
 
-    return count / _entrySpan;
+    count = total / _entrySpan;
+    return S_OK;
+}
+
+HRESULT HCORENUMImpl::EnsureAvailable(_In_ uint32_t count) noexcept
+{
+    HRESULT hr;
+    while (_source != nullptr)
+    {
+        // Only the pages from the current one onward can have unread values.
+        uint32_t available = 0;
+        for (EnumData const* curr = _curr; curr != nullptr; curr = curr->Next)
+            available += curr->Total - curr->ReadIn;
+
+        if (available >= count)
+            break;
+
+        RETURN_IF_FAILED(_source->Fill(*this, count - available));
+        if (hr == S_FALSE)
+        {
+            delete _source;
+            _source = nullptr;
+        }
+    }
+    return S_OK;
+}
+
+HRESULT HCORENUMImpl::FillAll() noexcept
+{
+    HRESULT hr;
+    while (_source != nullptr)
+    {
+        RETURN_IF_FAILED(_source->Fill(*this, ARRAY_SIZE(_data.Dynamic.Page)));
+        if (hr == S_FALSE)
+        {
+            delete _source;
+            _source = nullptr;
+        }
+    }
+    return S_OK;
 }
 
 HRESULT HCORENUMImpl::ReadTokens(
@@ -151,6 +227,7 @@ HRESULT HCORENUMImpl::ReadTokens(
 {
     HRESULT hr;
     uint32_t tokenCount = 0;
+    RETURN_IF_FAILED(EnsureAvailable(cMax));
     if (cMax == 1)
     {
         hr = ReadOneToken(rTokens[0], tokenCount);
@@ -178,6 +255,9 @@ HRESULT HCORENUMImpl::ReadTokenPairs(
     assert(rTokens1 != nullptr && rTokens2 != nullptr && pcTokens != nullptr);
     assert(_entrySpan == 2);
 
+    HRESULT hr;
+    RETURN_IF_FAILED(EnsureAvailable(cMax > UINT32_MAX / _entrySpan ? UINT32_MAX : cMax * _entrySpan));
+
     EnumData* currData = _curr;
     if (currData == nullptr)
         return S_FALSE;
@@ -369,6 +449,28 @@ HRESULT HCORENUMImpl::ResetDynamicEnum(_In_ uint32_t position) noexcept
 {
     assert(_type == HCORENUMType::Dynamic);
 
+    // Lazy enumerators only need to be filled up to the position.
+    if (_source != nullptr)
+    {
+        HRESULT hr;
+        uint32_t total = 0;
+        for (EnumData const* curr = &_data; curr != nullptr; curr = curr->Next)
+            total += curr->Total;
+        while (_source != nullptr && total <= position)
+        {
+            RETURN_IF_FAILED(_source->Fill(*this, position - total + 1));
+            if (hr == S_FALSE)
+            {
+                delete _source;
+                _source = nullptr;
+            }
+
+            total = 0;
+            for (EnumData const* curr = &_data; curr != nullptr; curr = curr->Next)
+                total += curr->Total;
+        }
+    }
+
     uint32_t newReadIn;
     bool reset = false;
     EnumData* currData = &_data;
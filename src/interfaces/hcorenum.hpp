@@ -8,11 +8,25 @@ enum class HCORENUMType : uint32_t
     Table = 1, Dynamic
 };
 
+class HCORENUMImpl;
+
+// Produces the values of a lazy dynamic enumerator as they are read.
+class HCORENUMSource
+{
+public:
+    virtual ~HCORENUMSource() = default;
+
+    // Add at least 'count' values to the enumerator with HCORENUMImpl::AddToDynamicEnum(),
+    // or all remaining values if there are fewer. Returns S_FALSE once the source is exhausted.
+    virtual HRESULT Fill(_Inout_ HCORENUMImpl& impl, _In_ uint32_t count) noexcept = 0;
+};
+
 // Represents a singly linked list or dynamic uint32_t array enumerator
 class HCORENUMImpl final
 {
     HCORENUMType _type;
     uint32_t _entrySpan; // The number of entries equal to a single unit.
+    HCORENUMSource* _source; // Remaining values of a lazy dynamic enumerator, null once exhausted.
 
     struct EnumData final
     {
@@ -51,11 +65,21 @@ public: // static
     static HRESULT CreateDynamicEnum(_Out_ HCORENUMImpl** impl, _In_ uint32_t entrySpan = 1) noexcept;
     static HRESULT AddToDynamicEnum(_Inout_ HCORENUMImpl& impl, uint32_t value) noexcept;
 
+    // Create a dynamic enumerator that is filled from the source as values are read,
+    // so callers that stop early don't pay for the whole enumeration.
+    // The enumerator takes ownership of the source, including on failure.
+    static HRESULT CreateLazyEnum(_In_ HCORENUMSource* source, _Out_ HCORENUMImpl** impl, _In_ uint32_t entrySpan = 1) noexcept;
+
+    // Create a dynamic enumerator holding all of the source's values at the time of the call.
+    // The enumerator takes ownership of the source, including on failure.
+    static HRESULT CreateFilledEnum(_In_ HCORENUMSource* source, _Out_ HCORENUMImpl** impl, _In_ uint32_t entrySpan = 1) noexcept;
+
     static void Destroy(_In_ HCORENUMImpl* impl) noexcept;
 
 public: // instance
     // Get the total items for this enumeration
-    uint32_t Count() const noexcept;
+    // Lazy enumerators are filled to completion.
+    HRESULT Count(_Out_ uint32_t& count) noexcept;
 
     // Read in the tokens for this enumeration
     HRESULT ReadTokens(
@@ -73,6 +97,10 @@ public: // instance
     HRESULT Reset(_In_ ULONG position) noexcept;
 
 private:
+    // Ensure at least 'count' unread values are available, fewer if the enumeration has ended.
+    HRESULT EnsureAvailable(_In_ uint32_t count) noexcept;
+    HRESULT FillAll() noexcept;
+
     HRESULT ReadOneToken(mdToken& rToken, uint32_t& count) noexcept;
     HRESULT ReadTableTokens(
         mdToken rTokens[],
@@ -16,13 +16,28 @@ MIDL_DEFINE_GUID(IID_IMetaDataAssemblyImport,0xee62470b,0xe94b,0x424e,0x9b,0x7c,
 MIDL_DEFINE_GUID(IID_IMetaDataEmit, 0xba3fee4c, 0xecb9, 0x4e41, 0x83, 0xb7, 0x18, 0x3f, 0xa4, 0x1c, 0xd8, 0x59);
 MIDL_DEFINE_GUID(IID_IMetaDataEmit2, 0xf5dd9950, 0xf693, 0x42e6, 0x83, 0xe, 0x7b, 0x83, 0x3e, 0x81, 0x46, 0xa9);
 MIDL_DEFINE_GUID(IID_IMetaDataAssemblyEmit, 0x211ef15b, 0x5317, 0x4438, 0xb1, 0x96, 0xde, 0xc8, 0x7b, 0x88, 0x76, 0x93);
+MIDL_DEFINE_GUID(IID_IMapToken, 0x6a3ea8b, 0x225, 0x11d1, 0xbf, 0x72, 0x0, 0xc0, 0x4f, 0xc3, 0x1e, 0x12);
 
 // Define the ISymUnmanaged* IIDs here - corsym.h provides the declaration.
 MIDL_DEFINE_GUID(IID_ISymUnmanagedBinder, 0xaa544d42, 0x28cb, 0x11d3, 0xbd, 0x22, 0x00, 0x00, 0xf8, 0x08, 0x49, 0xbd);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedReader, 0xb4ce6286, 0x2a6b, 0x3712, 0xa3, 0xb7, 0x1e, 0xe1, 0xda, 0xd4, 0x67, 0xb5);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedDocument, 0x40de4037, 0x7c81, 0x3e1e, 0xb0, 0x22, 0xae, 0x1a, 0xbf, 0xf2, 0xca, 0x08);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedMethod, 0xb62b923c, 0xb500, 0x3158, 0xa5, 0x43, 0x24, 0xf3, 0x07, 0xa8, 0xb7, 0xe1);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedScope, 0x68005d0f, 0xb8e0, 0x3b01, 0x84, 0xd5, 0xa1, 0x1a, 0x94, 0x15, 0x49, 0x42);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedNamespace, 0x0dff7289, 0x54f8, 0x11d3, 0xbd, 0x28, 0x00, 0x00, 0xf8, 0x08, 0x49, 0xbd);
+MIDL_DEFINE_GUID(IID_ISymUnmanagedVariable, 0x9f60eebe, 0x2d9a, 0x3f7c, 0xbf, 0x58, 0x80, 0xbc, 0x99, 0x1c, 0x60, 0xbb);
 
 // Define option IIDs here - cor.h provides the declaration.
+MIDL_DEFINE_GUID(MetaDataCheckDuplicatesFor, 0x30fe7be8, 0xd7d9, 0x11d2, 0x9f, 0x80, 0x0, 0xc0, 0x4f, 0x79, 0xa0, 0xa3);
 MIDL_DEFINE_GUID(MetaDataThreadSafetyOptions, 0xf7559806, 0xf266, 0x42ea, 0x8c, 0x63, 0xa, 0xdb, 0x45, 0xe8, 0xb2, 0x34);
 MIDL_DEFINE_GUID(CLSID_CLR_v2_MetaData, 0xefea471a, 0x44fd, 0x4862, 0x92, 0x92, 0xc, 0x58, 0xd4, 0x6e, 0x1f, 0x3a);
 
+// Define our own option IIDs here - dnmd_interfaces.hpp provides the declaration.
+MIDL_DEFINE_GUID(MetaDataNameCacheSize, 0x1dc734cb, 0x4227, 0x4a6f, 0x83, 0x4b, 0x39, 0xf3, 0xd7, 0x3f, 0xd7, 0xd5);
+MIDL_DEFINE_GUID(MetaDataRemoveIndirectionTables, 0xea1b7c85, 0x0546, 0x47e8, 0x84, 0x1f, 0xb5, 0x5b, 0xe8, 0x79, 0xea, 0xff);
+
+// Define our own interface IIDs here - dnmd_interfaces.hpp provides the declaration.
+MIDL_DEFINE_GUID(IID_IDNMDImportBatch, 0x32b1fc87, 0x1bfc, 0x40ee, 0x93, 0x45, 0xbc, 0xf4, 0x8e, 0xd3, 0xfe, 0xbb);
+
 // Define an IID for our own marker interface
 MIDL_DEFINE_GUID(IID_IDNMDOwner, 0x250ebc02, 0x1a92, 0x4638, 0xaa, 0x6c, 0x3d, 0x0f, 0x98, 0xb3, 0xa6, 0xfb);
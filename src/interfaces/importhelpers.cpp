@@ -56,12 +56,6 @@ namespace
         return (CorTokenType)TypeFromToken(token);
     }
 
-    // The strong name token is the last 8 bytes of the SHA1 hash of the public key.
-    // See II.6.3
-    constexpr size_t StrongNameTokenSize = 8;
-
-    using StrongNameToken = std::array<uint8_t, StrongNameTokenSize>;
-
     namespace StrongNameKeys
     {
         // The byte values of the real public keys and their corresponding tokens
@@ -201,7 +195,7 @@ namespace
         uint8_t  PublicKey[];
     };
 
-    HRESULT StrongNameTokenFromPublicKey(span<uint8_t const> publicKeyBlob, StrongNameToken& strongNameTokenBuffer)
+    HRESULT StrongNameTokenFromPublicKey(ImportCache& cache, span<uint8_t const> publicKeyBlob, StrongNameToken& strongNameTokenBuffer)
     {
         if (publicKeyBlob.size() < sizeof(PublicKeyBlob))
             return CORSEC_E_INVALID_PUBLICKEY;
@@ -236,6 +230,9 @@ namespace
         if (StrongNameKeys::GetTokenForWellKnownKey(publicKey->PublicKey, publicKey->PublicKeyLength, &strongNameTokenBuffer))
             return S_OK;
 
+        if (cache.TryGetStrongNameToken(publicKeyBlob, strongNameTokenBuffer))
+            return S_OK;
+
         std::array<uint8_t, pal::SHA1_HASH_SIZE> hash;
         if (!pal::ComputeSha1Hash(publicKeyBlob, hash))
             return CORSEC_E_INVALID_PUBLICKEY;
@@ -246,10 +243,213 @@ namespace
         // The byte order of the strong name token is not specified in ECMA-335, but is what CLR, CoreCLR, and Mono Desktop have always done.
         std::reverse_copy(hash.begin() + pal::SHA1_HASH_SIZE - StrongNameTokenSize, hash.end(), strongNameTokenBuffer.begin());
 
+        cache.AddStrongNameToken(publicKeyBlob, strongNameTokenBuffer);
         return S_OK;
     }
 }
 
+HRESULT ImportCache::GetImportedTokens(
+    mdhandle_t sourceAssembly,
+    mdhandle_t sourceModule,
+    mdhandle_t targetAssembly,
+    mdhandle_t targetModule,
+    TokenMap** tokens) noexcept
+{
+    HRESULT hr;
+    ImportScopes scopes =
+    {
+        sourceAssembly,
+        sourceModule,
+        targetAssembly,
+        targetModule,
+        {},
+        {},
+        md_get_edit_count(sourceAssembly),
+        md_get_edit_count(sourceModule),
+        md_get_edit_count(targetAssembly),
+        md_get_edit_count(targetModule)
+    };
+    RETURN_IF_FAILED(GetMvid(sourceModule, &scopes.SourceModuleMvid));
+    RETURN_IF_FAILED(GetMvid(targetModule, &scopes.TargetModuleMvid));
+
+    for (std::unique_ptr<ImportedTokens>& imported : _importedTokens)
+    {
+        ImportScopes const& existing = imported->Scopes;
+        if (existing.SourceAssembly == sourceAssembly
+            && existing.SourceModule == sourceModule
+            && existing.TargetAssembly == targetAssembly
+            && existing.TargetModule == targetModule)
+        {
+            // If the handles were reused for different scopes or existing rows
+            // in any of the scopes were edited, the imported tokens are stale.
+            if (std::memcmp(&existing.SourceModuleMvid, &scopes.SourceModuleMvid, sizeof(mdguid_t)) != 0
+                || std::memcmp(&existing.TargetModuleMvid, &scopes.TargetModuleMvid, sizeof(mdguid_t)) != 0
+                || existing.SourceAssemblyEdits != scopes.SourceAssemblyEdits
+                || existing.SourceModuleEdits != scopes.SourceModuleEdits
+                || existing.TargetAssemblyEdits != scopes.TargetAssemblyEdits
+                || existing.TargetModuleEdits != scopes.TargetModuleEdits)
+            {
+                imported->Scopes = scopes;
+                imported->Tokens.clear();
+            }
+
+            *tokens = &imported->Tokens;
+            return S_OK;
+        }
+    }
+
+    try
+    {
+        std::unique_ptr<ImportedTokens> imported{ new ImportedTokens{ scopes, {} } };
+        _importedTokens.push_back(std::move(imported));
+    }
+    catch (std::bad_alloc const&)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    *tokens = &_importedTokens.back()->Tokens;
+    return S_OK;
+}
+
+HRESULT ImportCache::GetRefIndex(mdhandle_t image, RefIndex** index)
+{
+    HRESULT hr;
+    mdguid_t mvid;
+    RETURN_IF_FAILED(GetMvid(image, &mvid));
+
+    // An empty table has no cursor.
+    mdcursor_t c;
+    uint32_t assemblyRefCount;
+    if (!md_create_cursor(image, mdtid_AssemblyRef, &c, &assemblyRefCount))
+        assemblyRefCount = 0;
+
+    uint32_t moduleRefCount;
+    if (!md_create_cursor(image, mdtid_ModuleRef, &c, &moduleRefCount))
+        moduleRefCount = 0;
+
+    RefIndex& refIndex = _refIndexes[image];
+
+    // An index with a different MVID is for a scope that previously used the same handle.
+    // If existing rows were edited, the indexed names may have changed.
+    uint64_t edits = md_get_edit_count(image);
+    if (std::memcmp(&refIndex.Mvid, &mvid, sizeof(mdguid_t)) != 0
+        || refIndex.Edits != edits)
+    {
+        refIndex = {};
+        refIndex.Mvid = mvid;
+        refIndex.Edits = edits;
+    }
+
+    // Index the rows added since the index was last used.
+    char const* name;
+    for (uint32_t row = refIndex.AssemblyRefCount + 1; row <= assemblyRefCount; ++row)
+    {
+        if (!md_token_to_cursor(image, TokenFromRid(row, mdtAssemblyRef), &c)
+            || !md_get_column_value_as_utf8(c, mdtAssemblyRef_Name, &name))
+        {
+            return CLDB_E_FILE_CORRUPT;
+        }
+
+        refIndex.AssemblyRefs[name].push_back(row);
+        refIndex.AssemblyRefCount = row;
+    }
+
+    for (uint32_t row = refIndex.ModuleRefCount + 1; row <= moduleRefCount; ++row)
+    {
+        if (!md_token_to_cursor(image, TokenFromRid(row, mdtModuleRef), &c)
+            || !md_get_column_value_as_utf8(c, mdtModuleRef_Name, &name))
+        {
+            return CLDB_E_FILE_CORRUPT;
+        }
+
+        // Keep the first row with the name.
+        (void)refIndex.ModuleRefs.emplace(name, row);
+        refIndex.ModuleRefCount = row;
+    }
+
+    *index = &refIndex;
+    return S_OK;
+}
+
+HRESULT ImportCache::FindAssemblyRefRows(mdhandle_t image, char const* name, std::vector<uint32_t> const** rows) noexcept
+{
+    HRESULT hr;
+    try
+    {
+        RefIndex* index;
+        RETURN_IF_FAILED(GetRefIndex(image, &index));
+
+        auto found = index->AssemblyRefs.find(name);
+        if (found == index->AssemblyRefs.end())
+        {
+            *rows = nullptr;
+            return S_FALSE;
+        }
+
+        *rows = &found->second;
+        return S_OK;
+    }
+    catch (std::bad_alloc const&)
+    {
+        // The index may be partially updated, rebuild it on the next use.
+        _refIndexes.erase(image);
+        return E_OUTOFMEMORY;
+    }
+}
+
+HRESULT ImportCache::FindModuleRefRow(mdhandle_t image, char const* name, uint32_t* row) noexcept
+{
+    HRESULT hr;
+    try
+    {
+        RefIndex* index;
+        RETURN_IF_FAILED(GetRefIndex(image, &index));
+
+        auto found = index->ModuleRefs.find(name);
+        if (found == index->ModuleRefs.end())
+            return S_FALSE;
+
+        *row = found->second;
+        return S_OK;
+    }
+    catch (std::bad_alloc const&)
+    {
+        // The index may be partially updated, rebuild it on the next use.
+        _refIndexes.erase(image);
+        return E_OUTOFMEMORY;
+    }
+}
+
+bool ImportCache::TryGetStrongNameToken(span<uint8_t const> publicKeyBlob, StrongNameToken& token) const noexcept
+{
+    try
+    {
+        auto found = _strongNameTokens.find(std::string{ (char const*)(uint8_t const*)publicKeyBlob, publicKeyBlob.size() });
+        if (found == _strongNameTokens.end())
+            return false;
+
+        token = found->second;
+        return true;
+    }
+    catch (std::bad_alloc const&)
+    {
+        return false;
+    }
+}
+
+void ImportCache::AddStrongNameToken(span<uint8_t const> publicKeyBlob, StrongNameToken const& token) noexcept
+{
+    try
+    {
+        _strongNameTokens.emplace(std::string{ (char const*)(uint8_t const*)publicKeyBlob, publicKeyBlob.size() }, token);
+    }
+    catch (std::bad_alloc const&)
+    {
+        // The token will be computed again.
+    }
+}
+
 namespace
 {
     struct AssemblyVersionMatcher
@@ -356,6 +556,7 @@ namespace
     }
 
     HRESULT FindAssemblyRef(
+        ImportCache& cache,
         mdhandle_t targetModule,
         uint32_t majorVersion,
         uint32_t minorVersion,
@@ -377,33 +578,42 @@ namespace
             calculatedPublicKeyToken = true;
         }
 
-        // Search the assembly ref table for a matching row.
-        mdcursor_t c;
-        uint32_t count;
-        if (!md_create_cursor(targetModule, mdtid_AssemblyRef, &c, &count))
-            return E_FAIL;
+        // Search the assembly ref rows with a matching name.
+        std::vector<uint32_t> const* rows;
+        RETURN_IF_FAILED(cache.FindAssemblyRefRows(targetModule, name, &rows));
+        if (hr == S_FALSE)
+            return S_FALSE;
 
         AssemblyVersionMatcher const& matcher = GetAssemblyVersionMatcher(name);
 
-        for (uint32_t i = 0; i < count; i++, md_cursor_next(&c))
+        mdstringview_t nameView;
+        mdstringview_t cultureView;
+        md_create_utf8_view(name, &nameView);
+        md_create_utf8_view(culture, &cultureView);
+
+        for (uint32_t row : *rows)
         {
-            // Search the table linearly by manually reading the columns.
+            mdcursor_t c;
+            if (!md_token_to_cursor(targetModule, TokenFromRid(row, mdtAssemblyRef), &c))
+                return CLDB_E_FILE_CORRUPT;
+
+            // Check the remaining columns of the row.
             hr = matcher.Match(c, majorVersion, minorVersion, buildNumber, revisionNumber);
             RETURN_IF_FAILED(hr);
             if (hr == S_FALSE)
                 continue;
 
-            char const* tempString;
-            if (!md_get_column_value_as_utf8(c, mdtAssemblyRef_Name, &tempString))
+            mdstringview_t tempString;
+            if (!md_get_column_value_as_utf8_view(c, mdtAssemblyRef_Name, &tempString))
                 return CLDB_E_FILE_CORRUPT;
 
-            if (std::strcmp(tempString, name) != 0)
+            if (!md_utf8_view_equals(&tempString, &nameView))
                 continue;
 
-            if (!md_get_column_value_as_utf8(c, mdtAssemblyRef_Culture, &tempString))
+            if (!md_get_column_value_as_utf8_view(c, mdtAssemblyRef_Culture, &tempString))
                 return CLDB_E_FILE_CORRUPT;
 
-            if (std::strcmp(tempString, culture) != 0)
+            if (!md_utf8_view_equals(&tempString, &cultureView))
                 continue;
 
             uint8_t const* tempBlob;
@@ -435,7 +645,7 @@ namespace
                 {
                     // This AssemblyRef row has a full public key and our source has a token.
                     // We need to get the token from the key.
-                    RETURN_IF_FAILED(StrongNameTokenFromPublicKey({ tempBlob, tempBlobLength }, refPublicKeyToken));
+                    RETURN_IF_FAILED(StrongNameTokenFromPublicKey(cache, { tempBlob, tempBlobLength }, refPublicKeyToken));
                 }
                 else
                 {
@@ -443,7 +653,7 @@ namespace
                     // We need to get the token from the key.
                     if (!calculatedPublicKeyToken)
                     {
-                        RETURN_IF_FAILED(StrongNameTokenFromPublicKey(publicKeyOrToken, publicKeyToken));
+                        RETURN_IF_FAILED(StrongNameTokenFromPublicKey(cache, publicKeyOrToken, publicKeyToken));
                         calculatedPublicKeyToken = true;
                     }
                 }
@@ -470,6 +680,7 @@ namespace
         mdcursor_t sourceAssemblyRef,
         mdhandle_t targetModule,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* targetAssembly
     )
     {
@@ -508,6 +719,7 @@ namespace
             return E_FAIL;
 
         RETURN_IF_FAILED(FindAssemblyRef(
+            cache,
             targetModule,
             majorVersion,
             minorVersion,
@@ -539,7 +751,7 @@ namespace
         if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_BuildNumber, buildNumber))
             return E_FAIL;
 
-        if (md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_RevisionNumber, revisionNumber))
+        if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_RevisionNumber, revisionNumber))
             return E_FAIL;
 
         if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_Flags, flags))
@@ -566,12 +778,13 @@ namespace
         mdhandle_t targetModule,
         mdhandle_t targetAssembly,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* assemblyRefInTargetModule)
     {
         HRESULT hr;
 
         // Add a reference to the assembly in the target module.
-        RETURN_IF_FAILED(ImportReferenceToAssemblyRef(sourceAssemblyRef, targetModule, onRowAdded, assemblyRefInTargetModule));
+        RETURN_IF_FAILED(ImportReferenceToAssemblyRef(sourceAssemblyRef, targetModule, onRowAdded, cache, assemblyRefInTargetModule));
 
         // Also add a reference to the assembly in the target assembly.
         // In most cases, the target module will be the same as the target assembly, so this will be a no-op.
@@ -580,7 +793,7 @@ namespace
         if (targetModule != targetAssembly)
         {
             mdcursor_t ignored;
-            RETURN_IF_FAILED(ImportReferenceToAssemblyRef(sourceAssemblyRef, targetAssembly, onRowAdded, &ignored));
+            RETURN_IF_FAILED(ImportReferenceToAssemblyRef(sourceAssemblyRef, targetAssembly, onRowAdded, cache, &ignored));
         }
 
         return S_OK;
@@ -591,6 +804,7 @@ namespace
         span<const uint8_t> sourceAssemblyHash,
         mdhandle_t targetModule,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* targetAssembly)
     {
         HRESULT hr;
@@ -609,7 +823,7 @@ namespace
         {
             assert(IsAfPublicKey(flags));
             flags &= ~afPublicKey;
-            RETURN_IF_FAILED(StrongNameTokenFromPublicKey({ publicKey, publicKeyLength }, publicKeyToken));
+            RETURN_IF_FAILED(StrongNameTokenFromPublicKey(cache, { publicKey, publicKeyLength }, publicKeyToken));
             publicKeyTokenSpan = { publicKeyToken.data(), publicKeyToken.size() };
         }
         else
@@ -642,6 +856,7 @@ namespace
             return E_FAIL;
 
         RETURN_IF_FAILED(FindAssemblyRef(
+            cache,
             targetModule,
             majorVersion,
             minorVersion,
@@ -673,7 +888,7 @@ namespace
         if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_BuildNumber, buildNumber))
             return E_FAIL;
 
-        if (md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_RevisionNumber, revisionNumber))
+        if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_RevisionNumber, revisionNumber))
             return E_FAIL;
 
         if (!md_set_column_value_as_constant(assemblyRef, mdtAssemblyRef_Flags, flags))
@@ -708,6 +923,7 @@ namespace
         mdhandle_t targetModule,
         mdhandle_t targetAssembly,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* assemblyRefInTargetModule)
     {
         HRESULT hr;
@@ -716,7 +932,7 @@ namespace
             return E_FAIL;
 
         // Add a reference to the assembly in the target module.
-        RETURN_IF_FAILED(ImportReferenceToAssembly(importAssembly, sourceAssemblyHash, targetModule, onRowAdded, assemblyRefInTargetModule));
+        RETURN_IF_FAILED(ImportReferenceToAssembly(importAssembly, sourceAssemblyHash, targetModule, onRowAdded, cache, assemblyRefInTargetModule));
 
         // Also add a reference to the assembly in the target assembly.
         // In most cases, the target module will be the same as the target assembly, so this will be a no-op.
@@ -725,7 +941,7 @@ namespace
         if (targetModule != targetAssembly)
         {
             mdcursor_t ignored;
-            RETURN_IF_FAILED(ImportReferenceToAssembly(importAssembly, sourceAssemblyHash, targetAssembly, onRowAdded, &ignored));
+            RETURN_IF_FAILED(ImportReferenceToAssembly(importAssembly, sourceAssemblyHash, targetAssembly, onRowAdded, cache, &ignored));
         }
 
         return S_OK;
@@ -740,6 +956,7 @@ HRESULT ImportReferenceToTypeDef(
     mdhandle_t targetModule,
     bool alwaysImport,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     mdcursor_t* targetTypeDef)
 {
     HRESULT hr;
@@ -809,7 +1026,7 @@ HRESULT ImportReferenceToTypeDef(
     }
     else
     {
-        RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, &resolutionScope));
+        RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, cache, &resolutionScope));
     }
 
     try
@@ -880,27 +1097,13 @@ HRESULT ImportReferenceToTypeDef(
 
 namespace
 {
-    bool FindModuleRef(mdhandle_t image, char const* moduleName, mdcursor_t* existingModuleRef)
+    bool FindModuleRef(ImportCache& cache, mdhandle_t image, char const* moduleName, mdcursor_t* existingModuleRef)
     {
-        mdcursor_t c;
-        uint32_t count;
-        if (!md_create_cursor(image, mdtid_ModuleRef, &c, &count))
+        uint32_t row;
+        if (cache.FindModuleRefRow(image, moduleName, &row) != S_OK)
             return false;
 
-        for (uint32_t i = 0; i < count; i++, md_cursor_next(&c))
-        {
-            char const* name;
-            if (!md_get_column_value_as_utf8(c, mdtModuleRef_Name, &name))
-                return false;
-
-            if (std::strcmp(name, moduleName) == 0)
-            {
-                *existingModuleRef = c;
-                return true;
-            }
-        }
-
-        return false;
+        return md_token_to_cursor(image, TokenFromRid(row, mdtModuleRef), existingModuleRef);
     }
 
     // Given a type name and type namespace for a type in a (possibly multi-module) assembly,
@@ -912,9 +1115,16 @@ namespace
         mdhandle_t module,
         mdhandle_t assembly,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* importedScope
     )
     {
+        // Compare names through views so most mismatches are rejected by length and hash.
+        mdstringview_t typeNameView;
+        mdstringview_t typeNamespaceView;
+        md_create_utf8_view(typeName, &typeNameView);
+        md_create_utf8_view(typeNamespace, &typeNamespaceView);
+
         // Search the ExportedType table in the targetAssembly for a type with the given name or namespace.
         // An empty ExportedType table is okay.
         mdcursor_t exportedType;
@@ -924,15 +1134,15 @@ namespace
         {
             for (uint32_t i = 0; i < count; ++i, md_cursor_next(&exportedType))
             {
-                char const* exportedTypeName;
-                if (!md_get_column_value_as_utf8(exportedType, mdtExportedType_TypeName, &exportedTypeName))
+                mdstringview_t exportedTypeName;
+                if (!md_get_column_value_as_utf8_view(exportedType, mdtExportedType_TypeName, &exportedTypeName))
                     return E_FAIL;
 
-                char const* exportedTypeNamespace;
-                if (!md_get_column_value_as_utf8(exportedType, mdtExportedType_TypeNamespace, &exportedTypeNamespace))
+                mdstringview_t exportedTypeNamespace;
+                if (!md_get_column_value_as_utf8_view(exportedType, mdtExportedType_TypeNamespace, &exportedTypeNamespace))
                     return E_FAIL;
 
-                if (std::strcmp(typeName, exportedTypeName) == 0 && std::strcmp(typeNamespace, exportedTypeNamespace) == 0)
+                if (md_utf8_view_equals(&typeNameView, &exportedTypeName) && md_utf8_view_equals(&typeNamespaceView, &exportedTypeNamespace))
                 {
                     foundExportedType = true;
                     break;
@@ -973,7 +1183,7 @@ namespace
                     }
                     else
                     {
-                        if (!FindModuleRef(module, fileName, importedScope))
+                        if (!FindModuleRef(cache, module, fileName, importedScope))
                         {
                             md_added_row_t moduleRef;
                             if (!md_append_row(module, mdtid_ModuleRef, &moduleRef))
@@ -991,7 +1201,7 @@ namespace
                 // If the ExportedType.Implementation is an AssemblyRef, then we'll use that as the imported scope.
                 // COMPAT-BREAK: CoreCLR does not support this case (it assumes that this ExportedType entry is never a type forwarder).
                 case mdtAssemblyRef:
-                    return ImportReferenceToAssemblyRef(implementation, module, assembly, onRowAdded, importedScope);
+                    return ImportReferenceToAssemblyRef(implementation, module, assembly, onRowAdded, cache, importedScope);
 
                 // If the ExportedType.Implementation is an ExportedType, then we're in an error scenario.
                 case mdtExportedType:
@@ -1010,15 +1220,15 @@ namespace
 
         for (uint32_t i = 0; i < count; ++i, md_cursor_next(&typeDef))
         {
-            char const* typeDefName;
-            if (!md_get_column_value_as_utf8(typeDef, mdtTypeDef_TypeName, &typeDefName))
+            mdstringview_t typeDefName;
+            if (!md_get_column_value_as_utf8_view(typeDef, mdtTypeDef_TypeName, &typeDefName))
                 return E_FAIL;
 
-            char const* typeDefNamespace;
-            if (!md_get_column_value_as_utf8(typeDef, mdtTypeDef_TypeNamespace, &typeDefNamespace))
+            mdstringview_t typeDefNamespace;
+            if (!md_get_column_value_as_utf8_view(typeDef, mdtTypeDef_TypeNamespace, &typeDefNamespace))
                 return E_FAIL;
 
-            if (std::strcmp(typeName, typeDefName) == 0 && std::strcmp(typeNamespace, typeDefNamespace) == 0)
+            if (md_utf8_view_equals(&typeNameView, &typeDefName) && md_utf8_view_equals(&typeNamespaceView, &typeDefNamespace))
             {
                 // Make sure that this type is not nested.
                 // For this to be the same type, it must not be a nested type.
@@ -1061,7 +1271,7 @@ namespace
                     // assume that the assembly manifest module is the same module as the current module.
                     *importedScope = moduleCursor;
                 }
-                else if (!FindModuleRef(module, assemblyModuleName, importedScope))
+                else if (!FindModuleRef(cache, module, assemblyModuleName, importedScope))
                 {
                     md_added_row_t moduleRef;
                     if (!md_append_row(module, mdtid_ModuleRef, &moduleRef))
@@ -1080,6 +1290,7 @@ namespace
     }
 
     HRESULT AssemblyRefPointsToAssembly(
+        ImportCache& cache,
         mdcursor_t assemblyRef,
         mdcursor_t assembly)
     {
@@ -1180,7 +1391,7 @@ namespace
             }
 
             StrongNameToken asmPublicKeyToken;
-            RETURN_IF_FAILED(StrongNameTokenFromPublicKey({ publicKey, publicKeyLength }, asmPublicKeyToken));
+            RETURN_IF_FAILED(StrongNameTokenFromPublicKey(cache, { publicKey, publicKeyLength }, asmPublicKeyToken));
 
             if (refPublicKeyOrTokenLength != asmPublicKeyToken.size() || !std::equal(asmPublicKeyToken.begin(), asmPublicKeyToken.end(), refPublicKeyOrToken))
                 return S_FALSE;
@@ -1197,6 +1408,7 @@ namespace
         mdhandle_t targetAssembly,
         mdhandle_t targetModule,
         std::function<void(mdcursor_t)> onRowAdded,
+        ImportCache& cache,
         mdcursor_t* targetTypeRef)
     {
         assert(sourceAssembly != nullptr && targetAssembly != nullptr && targetModule != nullptr);
@@ -1212,7 +1424,9 @@ namespace
             if (!md_get_column_value_as_cursor(scope, mdtTypeRef_ResolutionScope, &resolutionScope))
                 return E_FAIL;
 
-            typesForTypeRefs.push(resolutionScope);
+            // Only the TypeRefs need to be imported, the outermost scope is resolved separately.
+            if (GetTokenTypeFromCursor(resolutionScope) == mdtTypeRef)
+                typesForTypeRefs.push(resolutionScope);
             scope = resolutionScope;
         }
 
@@ -1269,7 +1483,7 @@ namespace
                 if (!md_get_column_value_as_utf8(scope, mdtModule_Name, &moduleName))
                     return CLDB_E_FILE_CORRUPT;
 
-                if (!FindModuleRef(targetModule, moduleName, &targetOutermostScope))
+                if (!FindModuleRef(cache, targetModule, moduleName, &targetOutermostScope))
                 {
                     md_added_row_t moduleRef;
                     if (!md_append_row(targetModule, mdtid_ModuleRef, &moduleRef))
@@ -1304,7 +1518,7 @@ namespace
                 {
                     targetOutermostScope = targetModuleCursor;
                 }
-                else if (!FindModuleRef(targetModule, moduleName, &targetOutermostScope))
+                else if (!FindModuleRef(cache, targetModule, moduleName, &targetOutermostScope))
                 {
                     md_added_row_t moduleRef;
                     if (!md_append_row(targetModule, mdtid_ModuleRef, &moduleRef))
@@ -1320,7 +1534,7 @@ namespace
             else if (TypeFromToken(scopeToken) == mdtAssemblyRef)
             {
                 // Copy the AssemblyRef from the source module to the target module.
-                RETURN_IF_FAILED(ImportReferenceToAssemblyRef(scope, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                RETURN_IF_FAILED(ImportReferenceToAssemblyRef(scope, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
             }
             else
             {
@@ -1345,26 +1559,26 @@ namespace
                 if (md_create_cursor(sourceAssembly, mdtid_ExportedType, &exportedType, &count))
                 {
                     mdcursor_t outermostTypeRef = typesForTypeRefs.top();
-                    char const* typeName;
-                    if (!md_get_column_value_as_utf8(outermostTypeRef, mdtTypeRef_TypeName, &typeName))
+                    mdstringview_t typeName;
+                    if (!md_get_column_value_as_utf8_view(outermostTypeRef, mdtTypeRef_TypeName, &typeName))
                         return E_FAIL;
 
-                    char const* typeNamespace;
-                    if (!md_get_column_value_as_utf8(outermostTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
+                    mdstringview_t typeNamespace;
+                    if (!md_get_column_value_as_utf8_view(outermostTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
                         return E_FAIL;
 
                     // If we can't find an ExportedType entry for this type, we'll just move over the TypeRef with a Nil ResolutionScope.
                     for (uint32_t i = 0; i < count; ++i, md_cursor_next(&exportedType))
                     {
-                        char const* exportedTypeName;
-                        if (!md_get_column_value_as_utf8(exportedType, mdtExportedType_TypeName, &exportedTypeName))
+                        mdstringview_t exportedTypeName;
+                        if (!md_get_column_value_as_utf8_view(exportedType, mdtExportedType_TypeName, &exportedTypeName))
                             return E_FAIL;
 
-                        char const* exportedTypeNamespace;
-                        if (!md_get_column_value_as_utf8(exportedType, mdtExportedType_TypeNamespace, &exportedTypeNamespace))
+                        mdstringview_t exportedTypeNamespace;
+                        if (!md_get_column_value_as_utf8_view(exportedType, mdtExportedType_TypeNamespace, &exportedTypeNamespace))
                             return E_FAIL;
 
-                        if (std::strcmp(typeName, exportedTypeName) == 0 && std::strcmp(typeNamespace, exportedTypeNamespace) == 0)
+                        if (md_utf8_view_equals(&typeName, &exportedTypeName) && md_utf8_view_equals(&typeNamespace, &exportedTypeNamespace))
                         {
                             if (!md_get_column_value_as_cursor(exportedType, mdtExportedType_Implementation, &implementation))
                                 return E_FAIL;
@@ -1382,7 +1596,7 @@ namespace
                         case mdtFile:
                         {
                             // This type is from a file in the source assembly, so we need to create an AssemblyRef to the source assembly.
-                            RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                            RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
                         }
                         case mdtAssemblyRef:
                         {
@@ -1424,26 +1638,26 @@ namespace
                         return E_FAIL;
 
                     mdcursor_t outermostTypeRef = typesForTypeRefs.top();
-                    char const* typeName;
-                    if (!md_get_column_value_as_utf8(outermostTypeRef, mdtTypeRef_TypeName, &typeName))
+                    mdstringview_t typeName;
+                    if (!md_get_column_value_as_utf8_view(outermostTypeRef, mdtTypeRef_TypeName, &typeName))
                         return E_FAIL;
 
-                    char const* typeNamespace;
-                    if (!md_get_column_value_as_utf8(outermostTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
+                    mdstringview_t typeNamespace;
+                    if (!md_get_column_value_as_utf8_view(outermostTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
                         return E_FAIL;
 
                     bool found = false;
                     for (uint32_t i = 0; i < sourceAssemblyTypeDefCount; ++i, md_cursor_next(&sourceAssemblyTypeDef))
                     {
-                        char const* sourceAssemblyTypeDefName;
-                        if (!md_get_column_value_as_utf8(sourceAssemblyTypeDef, mdtTypeDef_TypeName, &sourceAssemblyTypeDefName))
+                        mdstringview_t sourceAssemblyTypeDefName;
+                        if (!md_get_column_value_as_utf8_view(sourceAssemblyTypeDef, mdtTypeDef_TypeName, &sourceAssemblyTypeDefName))
                             return E_FAIL;
 
-                        char const* sourceAssemblyTypeDefNamespace;
-                        if (!md_get_column_value_as_utf8(sourceAssemblyTypeDef, mdtTypeDef_TypeNamespace, &sourceAssemblyTypeDefNamespace))
+                        mdstringview_t sourceAssemblyTypeDefNamespace;
+                        if (!md_get_column_value_as_utf8_view(sourceAssemblyTypeDef, mdtTypeDef_TypeNamespace, &sourceAssemblyTypeDefNamespace))
                             return E_FAIL;
 
-                        if (std::strcmp(typeName, sourceAssemblyTypeDefName) != 0 && std::strcmp(typeNamespace, sourceAssemblyTypeDefNamespace) != 0)
+                        if (!md_utf8_view_equals(&typeName, &sourceAssemblyTypeDefName) && !md_utf8_view_equals(&typeNamespace, &sourceAssemblyTypeDefNamespace))
                             continue;
 
                         mdcursor_t sourceAssemblyTypeDefEnclosingClass;
@@ -1461,7 +1675,7 @@ namespace
                             return E_FAIL;
 
                         // Add a reference to the assembly in the target module and assembly.
-                        RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                        RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
                         found = true;
                         break;
                     }
@@ -1473,7 +1687,7 @@ namespace
             else if (TypeFromToken(scopeToken) == mdtModule)
             {
                 // Create an AssemblyRef from the destination assembly to the source assembly.
-                RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
             }
 
             // The IsNilToken case can resolve to an ExportedType entry whose scope is an AssemblyRef.
@@ -1486,7 +1700,7 @@ namespace
                 if (!md_create_cursor(targetModule, mdtid_Assembly, &targetAssemblyCursor, &count))
                     return E_FAIL;
 
-                RETURN_IF_FAILED(AssemblyRefPointsToAssembly(scope, targetAssemblyCursor));
+                RETURN_IF_FAILED(AssemblyRefPointsToAssembly(cache, scope, targetAssemblyCursor));
                 if (hr == S_OK)
                 {
                     // The type is defined in the target assembly, so we need to correctly define its scope.
@@ -1505,13 +1719,14 @@ namespace
                         targetModule,
                         targetAssembly,
                         onRowAdded,
+                        cache,
                         &targetOutermostScope));
                 }
                 else
                 {
                     // The type is defined in another assembly. We need to create an AssemblyRef to that assembly.
                     assert(hr == S_FALSE);
-                    RETURN_IF_FAILED(ImportReferenceToAssemblyRef(scope, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                    RETURN_IF_FAILED(ImportReferenceToAssemblyRef(scope, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
                 }
             }
             else if (TypeFromToken(scopeToken) == mdtModuleRef)
@@ -1520,7 +1735,7 @@ namespace
                 // Since the source assembly and target assembly are different, we can't make a module reference to the type's module
                 // as module references are only within assembly boundaries.
                 // Make an AssemblyRef to the source assembly from the target assembly.
-                RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, &targetOutermostScope));
+                RETURN_IF_FAILED(ImportReferenceToAssembly(sourceAssembly, sourceAssemblyHash, targetModule, targetAssembly, onRowAdded, cache, &targetOutermostScope));
             }
             else
             {
@@ -1549,12 +1764,12 @@ namespace
             {
                 mdcursor_t sourceEnclosingTypeRef = typesForTypeRefs.top();
 
-                char const* typeName;
-                if (!md_get_column_value_as_utf8(sourceEnclosingTypeRef, mdtTypeRef_TypeName, &typeName))
+                mdstringview_t typeName;
+                if (!md_get_column_value_as_utf8_view(sourceEnclosingTypeRef, mdtTypeRef_TypeName, &typeName))
                     return E_FAIL;
 
-                char const* typeNamespace;
-                if (!md_get_column_value_as_utf8(sourceEnclosingTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
+                mdstringview_t typeNamespace;
+                if (!md_get_column_value_as_utf8_view(sourceEnclosingTypeRef, mdtTypeRef_TypeNamespace, &typeNamespace))
                     return E_FAIL;
 
                 mdToken enclosingScopeToken;
@@ -1568,16 +1783,16 @@ namespace
                 bool found = false;
                 do
                 {
-                    char const* targetTypeName;
-                    if (!md_get_column_value_as_utf8(targetTypeDef, mdtTypeDef_TypeName, &targetTypeName))
+                    mdstringview_t targetTypeName;
+                    if (!md_get_column_value_as_utf8_view(targetTypeDef, mdtTypeDef_TypeName, &targetTypeName))
                         return E_FAIL;
 
-                    char const* targetTypeNamespace;
-                    if (!md_get_column_value_as_utf8(targetTypeDef, mdtTypeDef_TypeNamespace, &targetTypeNamespace))
+                    mdstringview_t targetTypeNamespace;
+                    if (!md_get_column_value_as_utf8_view(targetTypeDef, mdtTypeDef_TypeNamespace, &targetTypeNamespace))
                         return E_FAIL;
 
                     // Check the name of the type.
-                    if (std::strcmp(typeName, targetTypeName) != 0 || std::strcmp(typeNamespace, targetTypeNamespace) != 0)
+                    if (!md_utf8_view_equals(&typeName, &targetTypeName) || !md_utf8_view_equals(&typeNamespace, &targetTypeNamespace))
                         continue;
 
                     // Now that we've validated that the target TypeDef has an enclosing type,
@@ -1662,6 +1877,7 @@ HRESULT ImportReferenceToTypeDefOrRefOrSpec(
     mdhandle_t targetAssembly,
     mdhandle_t targetModule,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     mdToken* importedToken)
 {
     HRESULT hr;
@@ -1669,24 +1885,49 @@ HRESULT ImportReferenceToTypeDefOrRefOrSpec(
     if (!md_token_to_cursor(sourceModule, *importedToken, &sourceCursor))
         return CLDB_E_FILE_CORRUPT;
 
+    ImportCache::TokenMap* importedTokens;
+    RETURN_IF_FAILED(cache.GetImportedTokens(sourceAssembly, sourceModule, targetAssembly, targetModule, &importedTokens));
+
+    auto existing = importedTokens->find(*importedToken);
+    if (existing != importedTokens->end())
+    {
+        *importedToken = existing->second;
+        return S_OK;
+    }
+
+    mdToken sourceToken = *importedToken;
+    auto recordImportedToken = [&]()
+    {
+        try
+        {
+            importedTokens->emplace(sourceToken, *importedToken);
+        }
+        catch (std::bad_alloc const&)
+        {
+            // The token will be imported again if it is requested again.
+        }
+    };
+
     switch (GetTokenTypeFromCursor(sourceCursor))
     {
         case mdtTypeDef:
         {
             mdcursor_t targetCursor;
-            RETURN_IF_FAILED(ImportReferenceToTypeDef(sourceCursor, sourceAssembly, sourceAssemblyHash, targetAssembly, targetModule, true, onRowAdded, &targetCursor));
+            RETURN_IF_FAILED(ImportReferenceToTypeDef(sourceCursor, sourceAssembly, sourceAssemblyHash, targetAssembly, targetModule, true, onRowAdded, cache, &targetCursor));
             if (!md_cursor_to_token(targetCursor, importedToken))
                 return E_FAIL;
 
+            recordImportedToken();
             return S_OK;
         }
         case mdtTypeRef:
         {
             mdcursor_t targetCursor;
-            RETURN_IF_FAILED(ImportReferenceToTypeRef(sourceCursor, sourceAssembly, sourceAssemblyHash, targetAssembly, targetModule, onRowAdded, &targetCursor));
+            RETURN_IF_FAILED(ImportReferenceToTypeRef(sourceCursor, sourceAssembly, sourceAssemblyHash, targetAssembly, targetModule, onRowAdded, cache, &targetCursor));
             if (!md_cursor_to_token(targetCursor, importedToken))
                 return E_FAIL;
 
+            recordImportedToken();
             return S_OK;
         }
         case mdtTypeSpec:
@@ -1697,7 +1938,7 @@ HRESULT ImportReferenceToTypeDefOrRefOrSpec(
                 return E_FAIL;
 
             inline_span<uint8_t> importedSignature;
-            RETURN_IF_FAILED(ImportTypeSpecBlob(sourceAssembly, sourceModule, sourceAssemblyHash, targetAssembly, targetModule, {signature, signatureLength}, onRowAdded, importedSignature));
+            RETURN_IF_FAILED(ImportTypeSpecBlob(sourceAssembly, sourceModule, sourceAssemblyHash, targetAssembly, targetModule, {signature, signatureLength}, onRowAdded, cache, importedSignature));
 
             md_added_row_t typeSpec;
             if (!md_append_row(targetModule, mdtid_TypeSpec, &typeSpec))
@@ -1711,6 +1952,7 @@ HRESULT ImportReferenceToTypeDefOrRefOrSpec(
             if (!md_cursor_to_token(typeSpec, importedToken))
                 return E_FAIL;
 
+            recordImportedToken();
             return S_OK;
         }
         default:
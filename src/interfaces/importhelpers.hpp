@@ -4,6 +4,96 @@
 #include <internal/dnmd_platform.hpp>
 #include <internal/span.hpp>
 #include <functional>
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The strong name token is the last 8 bytes of the SHA1 hash of the public key.
+// See II.6.3
+constexpr size_t StrongNameTokenSize = 8;
+
+using StrongNameToken = std::array<uint8_t, StrongNameTokenSize>;
+
+// Results of importing references from one scope into another.
+//
+// Imported tokens are recorded for each source and target scope pair, so importing
+// the same reference again returns the existing token instead of adding rows.
+// AssemblyRef and ModuleRef rows in target scopes are indexed by name and strong name
+// tokens are recorded by public key.
+//
+// Entries are keyed by scope and record the edit count of each scope (see md_get_edit_count()).
+// Appending rows doesn't change the edit count, so recorded tokens remain valid and the
+// indexes pick up rows that are appended after they are built. Any other edit to a scope,
+// including edits made through another emitter, drops the entries for that scope.
+//
+// The cache isn't thread-safe.
+class ImportCache final
+{
+public:
+    using TokenMap = std::unordered_map<mdToken, mdToken>;
+
+private:
+    struct ImportScopes final
+    {
+        mdhandle_t SourceAssembly;
+        mdhandle_t SourceModule;
+        mdhandle_t TargetAssembly;
+        mdhandle_t TargetModule;
+        // A handle may be reused after a scope is released.
+        mdguid_t SourceModuleMvid;
+        mdguid_t TargetModuleMvid;
+        uint64_t SourceAssemblyEdits;
+        uint64_t SourceModuleEdits;
+        uint64_t TargetAssemblyEdits;
+        uint64_t TargetModuleEdits;
+    };
+
+    struct ImportedTokens final
+    {
+        ImportScopes Scopes;
+        TokenMap Tokens;
+    };
+
+    struct RefIndex final
+    {
+        mdguid_t Mvid;
+        uint64_t Edits;
+        uint32_t AssemblyRefCount;
+        std::unordered_map<std::string, std::vector<uint32_t>> AssemblyRefs;
+        uint32_t ModuleRefCount;
+        std::unordered_map<std::string, uint32_t> ModuleRefs;
+    };
+
+    std::vector<std::unique_ptr<ImportedTokens>> _importedTokens;
+    std::unordered_map<mdhandle_t, RefIndex> _refIndexes;
+    std::unordered_map<std::string, StrongNameToken> _strongNameTokens;
+
+    HRESULT GetRefIndex(mdhandle_t image, RefIndex** index);
+
+public:
+    // Get the tokens imported from the source scope into the target scope.
+    HRESULT GetImportedTokens(
+        mdhandle_t sourceAssembly,
+        mdhandle_t sourceModule,
+        mdhandle_t targetAssembly,
+        mdhandle_t targetModule,
+        TokenMap** tokens) noexcept;
+
+    // Get the AssemblyRef rows in the image with the supplied name in table order.
+    // Returns S_FALSE and sets rows to nullptr if there are none.
+    HRESULT FindAssemblyRefRows(mdhandle_t image, char const* name, std::vector<uint32_t> const** rows) noexcept;
+
+    // Find the first ModuleRef row in the image with the supplied name.
+    // Returns S_FALSE if there is none.
+    HRESULT FindModuleRefRow(mdhandle_t image, char const* name, uint32_t* row) noexcept;
+
+    bool TryGetStrongNameToken(span<uint8_t const> publicKeyBlob, StrongNameToken& token) const noexcept;
+
+    // Record the token for a public key. Failing to record the token is not an error.
+    void AddStrongNameToken(span<uint8_t const> publicKeyBlob, StrongNameToken const& token) noexcept;
+};
 
 // Import a reference to a TypeDef row from one module and assembly pair to another.
 HRESULT ImportReferenceToTypeDef(
@@ -14,10 +104,12 @@ HRESULT ImportReferenceToTypeDef(
     mdhandle_t targetModule,
     bool alwaysImport, // Always import a reference to the TypeDef, even if the source and destination modules are the same.
     std::function<void(mdcursor_t row)> onRowEdited,
+    ImportCache& cache,
     mdcursor_t* targetTypeDef);
 
 // Import a reference to a TypeDef, TypeRef, or TypeSpec row from one module and assembly pair to another, and return a TypeDef or TypeRef or TypeSpec token
 // that can be used to refer to the imported type.
+// Tokens that were previously imported through the cache are not imported again.
 HRESULT ImportReferenceToTypeDefOrRefOrSpec(
     mdhandle_t sourceAssembly,
     mdhandle_t sourceModule,
@@ -25,6 +117,7 @@ HRESULT ImportReferenceToTypeDefOrRefOrSpec(
     mdhandle_t targetAssembly,
     mdhandle_t targetModule,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     mdToken* importedToken);
 
 // Import a reference to a MemberRef row from one module and assembly pair to another.
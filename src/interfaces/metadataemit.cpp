@@ -93,10 +93,33 @@ HRESULT MetadataEmit::SetModuleProps(
     return S_OK;
 }
 
+namespace
+{
+    void ReportTokenRemap(void* context, mdToken originalToken, mdToken newToken)
+    {
+        // IMapToken has no way to stop the remap, so failures are ignored like in the CLR.
+        (void)static_cast<IMapToken*>(context)->Map(originalToken, newToken);
+    }
+}
+
+HRESULT MetadataEmit::PrepareForSave()
+{
+    if (!_removeIndirectionTables)
+        return S_OK;
+
+    // Removing the indirection tables is an optimization, so an image that can't be
+    // reordered is saved with its indirection tables.
+    IMapToken* mapToken = _mapToken.get();
+    if (md_remove_indirection_tables(MetaData(), mapToken != nullptr ? ReportTokenRemap : nullptr, mapToken) == MD_INDIRECTION_TABLES_ERROR)
+        return E_FAIL;
+    return S_OK;
+}
+
 HRESULT MetadataEmit::Save(
         LPCWSTR     szFile,
         DWORD       dwSaveFlags)
 {
+    HRESULT hr;
     if (dwSaveFlags != 0)
         return E_INVALIDARG;
 
@@ -104,6 +127,8 @@ HRESULT MetadataEmit::Save(
     if (!cvt.Success())
         return E_INVALIDARG;
 
+    RETURN_IF_FAILED(PrepareForSave());
+
     size_t saveSize;
     md_write_to_buffer(MetaData(), nullptr, &saveSize);
     std::unique_ptr<uint8_t[]> buffer { new uint8_t[saveSize] };
@@ -143,6 +168,8 @@ HRESULT MetadataEmit::SaveToStream(
     if (dwSaveFlags != 0)
         return E_INVALIDARG;
 
+    RETURN_IF_FAILED(PrepareForSave());
+
     size_t saveSize;
     md_write_to_buffer(MetaData(), nullptr, &saveSize);
     std::unique_ptr<uint8_t[]> buffer { new uint8_t[saveSize] };
@@ -166,6 +193,10 @@ HRESULT MetadataEmit::GetSaveSize(
     // TODO: Do we want to support different save modes (as specified through dispenser options)?
     // If so, we'll need to handle that here in addition to the ::Save* methods.
     UNREFERENCED_PARAMETER(fSave);
+    HRESULT hr;
+    // The indirection tables are removed here as well so the size matches what is saved.
+    RETURN_IF_FAILED(PrepareForSave());
+
     size_t saveSize;
     md_write_to_buffer(MetaData(), nullptr, &saveSize);
     if (saveSize > std::numeric_limits<DWORD>::max())
@@ -298,10 +329,11 @@ HRESULT MetadataEmit::DefineNestedType(
 HRESULT MetadataEmit::SetHandler(
         IUnknown    *pUnk)
 {
-    // The this implementation of MetadataEmit doesn't ever remap tokens,
-    // so this method (which is for registering a callback for when tokens are remapped)
-    // is a no-op.
-    UNREFERENCED_PARAMETER(pUnk);
+    // Tokens are only remapped when the indirection tables are removed on save.
+    // Handlers that don't implement IMapToken are accepted and ignored.
+    _mapToken.Release();
+    if (pUnk != nullptr)
+        (void)pUnk->QueryInterface(IID_IMapToken, (void**)&_mapToken);
     return S_OK;
 }
 
@@ -382,13 +414,6 @@ HRESULT MetadataEmit::DefineTypeRefByName(
         LPCWSTR     szName,
         mdTypeRef   *ptr)
 {
-    md_added_row_t c;
-    if (!md_append_row(MetaData(), mdtid_TypeRef, &c))
-        return E_FAIL;
-
-    if (!md_set_column_value_as_token(c, mdtTypeRef_ResolutionScope, tkResolutionScope))
-        return E_FAIL;
-
     pal::StringConvert<WCHAR, char> cv(szName);
 
     if (!cv.Success())
@@ -398,6 +423,20 @@ HRESULT MetadataEmit::DefineTypeRefByName(
     char const* name;
     SplitTypeName(cv, &ns, &name);
 
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupTypeRef)
+        && md_find_typeref(MetaData(), tkResolutionScope, ns, name, &existing))
+    {
+        return md_cursor_to_token(existing, ptr) ? S_OK : E_FAIL;
+    }
+
+    md_added_row_t c;
+    if (!md_append_row(MetaData(), mdtid_TypeRef, &c))
+        return E_FAIL;
+
+    if (!md_set_column_value_as_token(c, mdtTypeRef_ResolutionScope, tkResolutionScope))
+        return E_FAIL;
+
     if (!md_set_column_value_as_utf8(c, mdtTypeRef_TypeNamespace, ns))
         return E_FAIL;
     if (!md_set_column_value_as_utf8(c, mdtTypeRef_TypeName, name))
@@ -449,6 +488,7 @@ HRESULT MetadataEmit::DefineImportType(
         MetaData(),
         false,
         [](mdcursor_t){},
+        _importCache,
         &importedTypeDef
     ));
 
@@ -473,7 +513,15 @@ HRESULT MetadataEmit::DefineMemberRef(
         return E_INVALIDARG;
     char const* name = cvt;
 
-    // TODO: Check for duplicates
+    uint8_t const* sig = (uint8_t const*)pvSigBlob;
+    uint32_t sigLength = cbSigBlob;
+
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupMemberRef)
+        && md_find_memberref(MetaData(), tkImport, name, sig != nullptr ? sig : (uint8_t const*)"", sigLength, &existing))
+    {
+        return md_cursor_to_token(existing, pmr) ? S_OK : E_FAIL;
+    }
 
     md_added_row_t c;
     if (!md_append_row(MetaData(), mdtid_MemberRef, &c))
@@ -485,8 +533,6 @@ HRESULT MetadataEmit::DefineMemberRef(
     if (!md_set_column_value_as_utf8(c, mdtMemberRef_Name, name))
         return E_FAIL;
 
-    uint8_t const* sig = (uint8_t const*)pvSigBlob;
-    uint32_t sigLength = cbSigBlob;
     if (!md_set_column_value_as_blob(c, mdtMemberRef_Signature, sig, sigLength))
         return E_FAIL;
 
@@ -920,11 +966,18 @@ HRESULT MetadataEmit::GetTokenFromSig(
         ULONG       cbSig,
         mdSignature *pmsig)
 {
+    uint32_t sigLength = cbSig;
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupSignature)
+        && md_find_standalonesig(MetaData(), pvSig, sigLength, &existing))
+    {
+        return md_cursor_to_token(existing, pmsig) ? S_OK : CLDB_E_FILE_CORRUPT;
+    }
+
     md_added_row_t c;
     if (!md_append_row(MetaData(), mdtid_StandAloneSig, &c))
         return E_FAIL;
 
-    uint32_t sigLength = cbSig;
     if (!md_set_column_value_as_blob(c, mdtStandAloneSig_Signature, pvSig, sigLength))
         return E_FAIL;
 
@@ -939,13 +992,20 @@ HRESULT MetadataEmit::DefineModuleRef(
         LPCWSTR     szName,
         mdModuleRef *pmur)
 {
+    pal::StringConvert<WCHAR, char> cvt(szName);
+    char const* name = cvt;
+
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupModuleRef)
+        && md_find_moduleref(MetaData(), name, &existing))
+    {
+        return md_cursor_to_token(existing, pmur) ? S_OK : CLDB_E_FILE_CORRUPT;
+    }
+
     md_added_row_t c;
     if (!md_append_row(MetaData(), mdtid_ModuleRef, &c))
         return E_FAIL;
 
-    pal::StringConvert<WCHAR, char> cvt(szName);
-    char const* name = cvt;
-
     if (!md_set_column_value_as_utf8(c, mdtModuleRef_Name, name))
         return E_FAIL;
 
@@ -977,11 +1037,18 @@ HRESULT MetadataEmit::GetTokenFromTypeSpec(
         ULONG       cbSig,
         mdTypeSpec *ptypespec)
 {
+    uint32_t sigLength = cbSig;
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupTypeSpec)
+        && md_find_typespec(MetaData(), pvSig, sigLength, &existing))
+    {
+        return md_cursor_to_token(existing, ptypespec) ? S_OK : CLDB_E_FILE_CORRUPT;
+    }
+
     md_added_row_t c;
     if (!md_append_row(MetaData(), mdtid_TypeSpec, &c))
         return E_FAIL;
 
-    uint32_t sigLength = cbSig;
     if (!md_set_column_value_as_blob(c, mdtTypeSpec_Signature, pvSig, sigLength))
         return E_FAIL;
 
@@ -996,6 +1063,9 @@ HRESULT MetadataEmit::SaveToMemory(
         void        *pbData,
         ULONG       cbData)
 {
+    HRESULT hr;
+    RETURN_IF_FAILED(PrepareForSave());
+
     size_t saveSize = cbData;
     return md_write_to_buffer(MetaData(), (uint8_t*)pbData, &saveSize) ? S_OK : E_OUTOFMEMORY;
 }
@@ -2228,6 +2298,7 @@ HRESULT MetadataEmit::TranslateSigWithScope(
         moduleEmit->MetaData(),
         { pbSigBlob, cbSigBlob },
         [](mdcursor_t){},
+        _importCache,
         translatedSig));
 
     std::copy_n(translatedSig.begin(), std::min(translatedSig.size(), (size_t)cbTranslatedSigMax), (uint8_t*)pvTranslatedSig);
@@ -2315,6 +2386,14 @@ HRESULT MetadataEmit::DefineMethodSpec(
     if (cbSigBlob == 0 || pvSigBlob == nullptr || pmi == nullptr)
         return META_E_BAD_INPUT_PARAMETER;
 
+    uint32_t sigLength = cbSigBlob;
+    mdcursor_t existing;
+    if ((_checkDuplicatesFor & MDDupMethodSpec)
+        && md_find_methodspec(MetaData(), tkParent, pvSigBlob, sigLength, &existing))
+    {
+        return md_cursor_to_token(existing, pmi) ? S_OK : CLDB_E_FILE_CORRUPT;
+    }
+
     md_added_row_t c;
     if (!md_append_row(MetaData(), mdtid_MethodSpec, &c))
         return E_FAIL;
@@ -2322,7 +2401,6 @@ HRESULT MetadataEmit::DefineMethodSpec(
     if (!md_set_column_value_as_token(c, mdtMethodSpec_Method, tkParent))
         return E_FAIL;
 
-    uint32_t sigLength = cbSigBlob;
     if (!md_set_column_value_as_blob(c, mdtMethodSpec_Instantiation, pvSigBlob, sigLength))
         return E_FAIL;
 
@@ -5,6 +5,7 @@
 #include "tearoffbase.hpp"
 #include "controllingiunknown.hpp"
 #include "dnmdowner.hpp"
+#include "importhelpers.hpp"
 
 #include <external/cor.h>
 #include <external/corhdr.h>
@@ -15,11 +16,18 @@
 class MetadataEmit final : public TearOffBase<IMetaDataEmit2, IMetaDataAssemblyEmit>
 {
     mdhandle_view _md_ptr;
+    ImportCache _importCache;
+    uint32_t _checkDuplicatesFor; // CorCheckDuplicatesFor
+    bool _removeIndirectionTables;
+    dncp::com_ptr<IMapToken> _mapToken;
+
+    // Prepare the image to be saved and report any token remaps.
+    HRESULT PrepareForSave();
 
 protected:
     bool TryGetInterfaceOnThis(REFIID riid, void** ppvObject) override
     {
-        if (riid == IID_IMetaDataEmit || riid == IID_IMetaDataEmit)
+        if (riid == IID_IMetaDataEmit || riid == IID_IMetaDataEmit2)
         {
             *ppvObject = static_cast<IMetaDataEmit2*>(this);
             return true;
@@ -33,9 +41,11 @@ protected:
     }
 
 public:
-    MetadataEmit(IUnknown* controllingUnknown, mdhandle_view md_ptr)
+    MetadataEmit(IUnknown* controllingUnknown, mdhandle_view md_ptr, uint32_t checkDuplicatesFor = MDNoDupChecks, bool removeIndirectionTables = false)
         : TearOffBase(controllingUnknown)
         , _md_ptr{ std::move(md_ptr) }
+        , _checkDuplicatesFor{ checkDuplicatesFor }
+        , _removeIndirectionTables{ removeIndirectionTables }
     { }
 
     virtual ~MetadataEmit() = default;
@@ -4,7 +4,10 @@
 #include "metadataimportro.hpp"
 #include "hcorenum.hpp"
 #include "signatures.hpp"
+#include <algorithm>
 #include <cstring>
+#include <new>
+#include <string>
 
 #define MD_MODULE_TOKEN TokenFromRid(1, mdtModule)
 #define MD_GLOBAL_PARENT_TOKEN TokenFromRid(1, mdtTypeDef)
@@ -38,10 +41,16 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::CountEnum(HCORENUM hEnum, ULONG* pul
         return E_INVALIDARG;
 
     HCORENUMImpl* enumImpl = ToHCORENUMImpl(hEnum);
-    *pulCount = enumImpl == nullptr
-        ? 0
-        : enumImpl->Count();
-    return S_OK;
+    if (enumImpl == nullptr)
+    {
+        *pulCount = 0;
+        return S_OK;
+    }
+
+    uint32_t count;
+    HRESULT hr = enumImpl->Count(count);
+    *pulCount = SUCCEEDED(hr) ? count : 0;
+    return hr;
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::ResetEnum(HCORENUM hEnum, ULONG ulPos)
@@ -72,6 +81,178 @@ namespace
         return S_OK;
     }
 
+    // Rows and strings added to an editable scope would show up in a lazy enumerator,
+    // so enumerators over an editable scope are filled when they are created.
+    HRESULT CreateSourceEnum(bool editable, HCORENUMSource* source, HCORENUMImpl** pEnumImpl)
+    {
+        return editable
+            ? HCORENUMImpl::CreateFilledEnum(source, pEnumImpl)
+            : HCORENUMImpl::CreateLazyEnum(source, pEnumImpl);
+    }
+
+    // Lazily matches the names of the rows in up to two list ranges, see EnumMembersWithName().
+    class NamedRangeSource final : public HCORENUMSource
+    {
+        struct Range final
+        {
+            mdcursor_t Current;
+            uint32_t Remaining;
+            col_index_t NameColumn;
+        };
+
+        std::string _name;
+        mdstringview_t _nameView;
+        Range _ranges[2];
+        uint32_t _rangeCount;
+
+    public:
+        NamedRangeSource(std::string name)
+            : _name{ std::move(name) }
+            , _nameView{}
+            , _ranges{}
+            , _rangeCount{ 0 }
+        {
+            // Compare names through views so most mismatches are rejected by length and hash.
+            md_create_utf8_view(_name.c_str(), &_nameView);
+        }
+
+        void AddRange(mdcursor_t begin, uint32_t count, col_index_t nameColumn) noexcept
+        {
+            assert(_rangeCount < ARRAY_SIZE(_ranges));
+            _ranges[_rangeCount++] = { begin, count, nameColumn };
+        }
+
+        HRESULT Fill(HCORENUMImpl& impl, uint32_t count) noexcept override
+        {
+            HRESULT hr;
+            uint32_t added = 0;
+            for (uint32_t i = 0; i < _rangeCount; ++i)
+            {
+                Range& range = _ranges[i];
+                for (; range.Remaining > 0 && added < count; --range.Remaining)
+                {
+                    mdcursor_t target;
+                    mdstringview_t toMatch;
+                    if (!md_resolve_indirect_cursor(range.Current, &target)
+                        || !md_get_column_value_as_utf8_view(target, range.NameColumn, &toMatch))
+                    {
+                        return CLDB_E_FILE_CORRUPT;
+                    }
+                    (void)md_cursor_next(&range.Current);
+
+                    if (md_utf8_view_equals(&toMatch, &_nameView))
+                    {
+                        mdToken matchedTk;
+                        (void)md_cursor_to_token(target, &matchedTk);
+                        RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(impl, matchedTk));
+                        added++;
+                    }
+                }
+            }
+            return added < count ? S_FALSE : S_OK;
+        }
+    };
+
+    HRESULT CreateNamedRangeSource(LPCWSTR name, NamedRangeSource** source)
+    {
+        pal::StringConvert<WCHAR, char> cvt{ name };
+        if (!cvt.Success())
+            return E_INVALIDARG;
+
+        try
+        {
+            *source = new (std::nothrow) NamedRangeSource{ std::string{ (char const*)cvt } };
+        }
+        catch (std::bad_alloc const&)
+        {
+            return E_OUTOFMEMORY;
+        }
+        return *source != nullptr ? S_OK : E_OUTOFMEMORY;
+    }
+
+    // Lazily finds the custom attributes of a type, optionally limited to a parent,
+    // in a range of CustomAttribute rows, see EnumCustomAttributes().
+    class CustomAttributeSource final : public HCORENUMSource
+    {
+        mdhandle_t _handle;
+        mdToken _parent;
+        mdToken _type;
+        uint32_t _row;
+        uint32_t _end;
+
+    public:
+        CustomAttributeSource(mdhandle_t handle, mdToken parent, mdToken type, uint32_t row, uint32_t count) noexcept
+            : _handle{ handle }
+            , _parent{ parent }
+            , _type{ type }
+            , _row{ row }
+            , _end{ row + count }
+        { }
+
+        HRESULT Fill(HCORENUMImpl& impl, uint32_t count) noexcept override
+        {
+            HRESULT hr;
+            mdToken matched[64];
+            mdToken parents[ARRAY_SIZE(matched)];
+            uint32_t added = 0;
+            while (_row < _end && added < count)
+            {
+                mdcursor_t cursor;
+                if (!md_token_to_cursor(_handle, TokenFromRid(_row, mdtCustomAttribute), &cursor))
+                    return CLDB_E_FILE_CORRUPT;
+
+                int32_t found = md_find_custom_attributes_by_type(cursor, _end - _row, _type, ARRAY_SIZE(matched), matched, parents);
+                if (found < 0)
+                    return CLDB_E_FILE_CORRUPT;
+
+                // A partially filled buffer means the rest of the range was searched.
+                _row = found < (int32_t)ARRAY_SIZE(matched) ? _end : RidFromToken(matched[found - 1]) + 1;
+                for (int32_t i = 0; i < found; ++i)
+                {
+                    if (!IsNilToken(_parent) && parents[i] != _parent)
+                        continue;
+                    RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(impl, matched[i]));
+                    added++;
+                }
+            }
+            return _row < _end ? S_OK : S_FALSE;
+        }
+    };
+
+    // Lazily walks the #US heap, see EnumUserStrings().
+    class UserStringSource final : public HCORENUMSource
+    {
+        mdhandle_t _handle;
+        mduserstringcursor_t _cursor;
+
+    public:
+        UserStringSource(mdhandle_t handle) noexcept
+            : _handle{ handle }
+            , _cursor{ 0 }
+        { }
+
+        HRESULT Fill(HCORENUMImpl& impl, uint32_t count) noexcept override
+        {
+            HRESULT hr;
+            mduserstring_t us;
+            uint32_t offset;
+            for (uint32_t added = 0; added < count;)
+            {
+                if (!md_walk_user_string_heap(_handle, &_cursor, &us, &offset))
+                    return S_FALSE;
+
+                // Ignore strings that are of zero length.
+                if (us.str_bytes == 0)
+                    continue;
+
+                // Add mdtString token types to the enumeration.
+                RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(impl, RidToToken(offset, mdtString)));
+                added++;
+            }
+            return S_OK;
+        }
+    };
+
     struct TokenRangeFilter final
     {
         col_index_t FilterColumn;
@@ -80,6 +261,7 @@ namespace
 
     HRESULT CreateEnumTokenRange(
         mdhandle_t mdhandle,
+        bool editable,
         mdToken token,
         col_index_t column,
         _In_opt_ TokenRangeFilter const* filter,
@@ -104,34 +286,10 @@ namespace
         else
         {
             assert(filter != nullptr && filter->Value != nullptr);
-            pal::StringConvert<WCHAR, char> cvt{ filter->Value };
-            if (!cvt.Success())
-                return E_INVALIDARG;
-
-            char const* toMatch;
-            mdToken matchedTk;
-            RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
-
-            HCORENUMImpl_ptr cleanup{ enumImpl };
-
-            mdcursor_t curr = begin;
-            for (uint32_t i = 0; i < count; ++i)
-            {
-                mdcursor_t target;
-                if (!md_resolve_indirect_cursor(curr, &target))
-                    return CLDB_E_FILE_CORRUPT;
-                if (!md_get_column_value_as_utf8(target, filter->FilterColumn, &toMatch))
-                    return CLDB_E_FILE_CORRUPT;
-
-                if (0 == ::strcmp(toMatch, cvt))
-                {
-                    (void)md_cursor_to_token(target, &matchedTk);
-                    RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-                }
-                (void)md_cursor_next(&curr);
-            }
-
-            enumImpl = cleanup.release();
+            NamedRangeSource* source;
+            RETURN_IF_FAILED(CreateNamedRangeSource(filter->Value, &source));
+            source->AddRange(begin, count, filter->FilterColumn);
+            RETURN_IF_FAILED(CreateSourceEnum(editable, source, &enumImpl));
         }
 
         *pEnumImpl = enumImpl;
@@ -169,36 +327,17 @@ namespace
         }
         else
         {
-            // Unsorted so we need to search across the entire table
+            // Unsorted so look up the rows in a reverse index over the key column.
+            uint32_t const* rows;
+            uint32_t rowCount;
+            if (!md_find_reverse_references(mdhandle, table, keyColumn, token, &rows, &rowCount))
+                return CLDB_E_FILE_CORRUPT;
+
             HCORENUMImpl* enumImpl;
             RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
             HCORENUMImpl_ptr cleanup{ enumImpl };
-            mdcursor_t curr = cursor;
-            uint32_t currCount = tableCount;
-
-            // Read in for matching in bulk
-            mdToken matchedGroup[64];
-            uint32_t i = 0;
-            while (i < currCount)
-            {
-                int32_t read = md_get_many_rows_column_value_as_token(curr, keyColumn, ARRAY_SIZE(matchedGroup), matchedGroup);
-                if (read == 0)
-                    break;
-
-                assert(read > 0);
-                for (int32_t j = 0; j < read; ++j)
-                {
-                    if (matchedGroup[j] == token)
-                    {
-                        mdToken matchedTk;
-                        if (!md_cursor_to_token(curr, &matchedTk))
-                            return CLDB_E_FILE_CORRUPT;
-                        RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-                    }
-                    (void)md_cursor_next(&curr);
-                }
-                i += read;
-            }
+            for (uint32_t i = 0; i < rowCount; ++i)
+                RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, TokenFromRid(rows[i], (CorTokenType)(table << 24))));
 
             *pEnumImpl = cleanup.release();
             return S_OK;
@@ -237,6 +376,34 @@ namespace
         return S_OK;
     }
 
+    // Return the UTF-16 form of a #Strings heap column value, using the name cache when available.
+    HRESULT ReturnNameColumnOutput(
+        Utf16NameCache* cache,
+        mdcursor_t cursor,
+        col_index_t nameColumn,
+        _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+            WCHAR* szBuffer,
+        ULONG cchBuffer,
+        ULONG* pchBuffer)
+    {
+        HRESULT hr;
+        uint32_t offset = 0;
+        if (cache != nullptr && !md_get_column_value_as_heap_offset(cursor, nameColumn, &offset))
+            return CLDB_E_FILE_CORRUPT;
+
+        if (cache != nullptr && cache->TryGetName(Utf16NameCache::Key(offset), szBuffer, cchBuffer, pchBuffer, hr))
+            return hr;
+
+        char const* name;
+        if (!md_get_column_value_as_utf8(cursor, nameColumn, &name))
+            return CLDB_E_FILE_CORRUPT;
+
+        if (cache != nullptr && name[0] != '\0')
+            return cache->AddName(Utf16NameCache::Key(offset), name, szBuffer, cchBuffer, pchBuffer);
+
+        return ConvertAndReturnStringOutput(name, szBuffer, cchBuffer, pchBuffer);
+    }
+
     HRESULT ConstructTypeName(
         char const* nspace,
         char const* name,
@@ -476,8 +643,14 @@ namespace
         if (!md_create_cursor(importer->MetaData(), mdtid_TypeDef, &cursor, &count))
             return CLDB_E_RECORD_NOTFOUND;
 
+        // Compare names through views so most mismatches are rejected by length and hash.
+        mdstringview_t nspaceView;
+        mdstringview_t nameView;
+        md_create_utf8_view(nspace, &nspaceView);
+        md_create_utf8_view(name, &nameView);
+
         uint32_t flags;
-        char const* str;
+        mdstringview_t str;
         mdToken tk;
         mdToken tmpTk;
         for (uint32_t i = 0; i < count; (void)md_cursor_next(&cursor), ++i)
@@ -505,16 +678,16 @@ namespace
                     continue;
             }
 
-            if (!md_get_column_value_as_utf8(cursor, mdtTypeDef_TypeNamespace, &str))
+            if (!md_get_column_value_as_utf8_view(cursor, mdtTypeDef_TypeNamespace, &str))
                 return CLDB_E_FILE_CORRUPT;
 
-            if (0 != ::strcmp(nspace, str))
+            if (!md_utf8_view_equals(&nspaceView, &str))
                 continue;
 
-            if (!md_get_column_value_as_utf8(cursor, mdtTypeDef_TypeName, &str))
+            if (!md_get_column_value_as_utf8_view(cursor, mdtTypeDef_TypeName, &str))
                 return CLDB_E_FILE_CORRUPT;
 
-            if (0 == ::strcmp(name, str))
+            if (md_utf8_view_equals(&nameView, &str))
             {
                 (void)md_cursor_to_token(cursor, ptd);
                 return S_OK;
@@ -616,6 +789,23 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetTypeDefProps(
         ? mdTypeRefNil
         : extends;
 
+    HRESULT hr;
+    uint64_t cacheKey = 0;
+    if (_nameCache != nullptr)
+    {
+        uint32_t nameOffset;
+        uint32_t nspaceOffset;
+        if (!md_get_column_value_as_heap_offset(cursor, mdtTypeDef_TypeName, &nameOffset)
+            || !md_get_column_value_as_heap_offset(cursor, mdtTypeDef_TypeNamespace, &nspaceOffset))
+        {
+            return CLDB_E_FILE_CORRUPT;
+        }
+
+        cacheKey = Utf16NameCache::Key(nameOffset, nspaceOffset);
+        if (_nameCache->TryGetName(cacheKey, szTypeDef, cchTypeDef, pchTypeDef, hr))
+            return hr;
+    }
+
     char const* name;
     char const* nspace;
     if (!md_get_column_value_as_utf8(cursor, mdtTypeDef_TypeName, &name)
@@ -624,9 +814,10 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetTypeDefProps(
         return CLDB_E_FILE_CORRUPT;
     }
 
-    HRESULT hr;
     malloc_ptr<char> mem;
     RETURN_IF_FAILED(ConstructTypeName(nspace, name, mem));
+    if (_nameCache != nullptr && mem.get()[0] != '\0')
+        return _nameCache->AddName(cacheKey, mem.get(), szTypeDef, cchTypeDef, pchTypeDef);
     return ConvertAndReturnStringOutput(mem.get(), szTypeDef, cchTypeDef, pchTypeDef);
 }
 
@@ -770,51 +961,14 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumMembersWithName(
         }
 
         assert(szName != nullptr);
-        pal::StringConvert<WCHAR, char> cvt{ szName };
-        if (!cvt.Success())
-            return E_INVALIDARG;
-
-        char const* toMatch;
-        mdToken matchedTk;
-        RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
-
-        HCORENUMImpl_ptr cleanup{ enumImpl };
-
-        // Iterate the Type's methods
-        for (uint32_t i = 0; i < methodListCount; ++i)
-        {
-            mdcursor_t methodCursor;
-            if (!md_resolve_indirect_cursor(methodList, &methodCursor))
-                return CLDB_E_FILE_CORRUPT;
-            if (!md_get_column_value_as_utf8(methodCursor, mdtMethodDef_Name, &toMatch))
-                return CLDB_E_FILE_CORRUPT;
-
-            if (0 == ::strcmp(toMatch, cvt))
-            {
-                (void)md_cursor_to_token(methodCursor, &matchedTk);
-                RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-            }
-            (void)md_cursor_next(&methodList);
-        }
-
-        // Iterate the Type's fields
-        for (uint32_t i = 0; i < fieldListCount; ++i)
-        {
-            mdcursor_t fieldCursor;
-            if (!md_resolve_indirect_cursor(fieldList, &fieldCursor))
-                return CLDB_E_FILE_CORRUPT;
-            if (!md_get_column_value_as_utf8(fieldCursor, mdtField_Name, &toMatch))
-                return CLDB_E_FILE_CORRUPT;
-
-            if (0 == ::strcmp(toMatch, cvt))
-            {
-                (void)md_cursor_to_token(fieldCursor, &matchedTk);
-                RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-            }
-            (void)md_cursor_next(&fieldList);
-        }
+        NamedRangeSource* source;
+        RETURN_IF_FAILED(CreateNamedRangeSource(szName, &source));
 
-        *phEnum = cleanup.release();
+        // Methods are enumerated before fields.
+        source->AddRange(methodList, methodListCount, mdtMethodDef_Name);
+        source->AddRange(fieldList, fieldListCount, mdtField_Name);
+        RETURN_IF_FAILED(CreateSourceEnum(_editable, source, &enumImpl));
+        *phEnum = enumImpl;
     }
     return enumImpl->ReadTokens(rMembers, cMax, pcTokens);
 }
@@ -845,7 +999,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumMethodsWithName(
             return E_INVALIDARG;
 
         TokenRangeFilter filter{ mdtMethodDef_Name, szName };
-        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), cl, mdtTypeDef_MethodList, &filter, &enumImpl));
+        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), _editable, cl, mdtTypeDef_MethodList, &filter, &enumImpl));
         *phEnum = enumImpl;
     }
     return enumImpl->ReadTokens(rMethods, cMax, pcTokens);
@@ -877,7 +1031,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumFieldsWithName(
             return E_INVALIDARG;
 
         TokenRangeFilter filter{ mdtField_Name, szName };
-        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), cl, mdtTypeDef_FieldList, &filter, &enumImpl));
+        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), _editable, cl, mdtTypeDef_FieldList, &filter, &enumImpl));
         *phEnum = enumImpl;
     }
     return enumImpl->ReadTokens(rFields, cMax, pcTokens);
@@ -897,7 +1051,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumParams(
         if (TypeFromToken(mb) != mdtMethodDef)
             return E_INVALIDARG;
 
-        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), mb, mdtMethodDef_ParamList, nullptr, &enumImpl));
+        RETURN_IF_FAILED(CreateEnumTokenRange(_md_ptr.get(), _editable, mb, mdtMethodDef_ParamList, nullptr, &enumImpl));
         *phEnum = enumImpl;
     }
     return enumImpl->ReadTokens(rParams, cMax, pcTokens);
@@ -919,32 +1073,15 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumMemberRefs(
         if (!md_create_cursor(_md_ptr.get(), mdtid_MemberRef, &cursor, &count))
             return CLDB_E_RECORD_NOTFOUND;
 
+        uint32_t const* rows;
+        if (!md_find_reverse_references(_md_ptr.get(), mdtid_MemberRef, mdtMemberRef_Class, tkParent, &rows, &count))
+            return CLDB_E_FILE_CORRUPT;
+
         RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
 
         HCORENUMImpl_ptr cleanup{ enumImpl };
-
-        // Read in for matching in bulk
-        mdToken toMatch[64];
-        mdToken matchedTk;
-        uint32_t i = 0;
-        while (i < count)
-        {
-            int32_t read = md_get_many_rows_column_value_as_token(cursor, mdtMemberRef_Class, ARRAY_SIZE(toMatch), toMatch);
-            if (read == 0)
-                break;
-
-            assert(read > 0);
-            for (int32_t j = 0; j < read; ++j)
-            {
-                if (toMatch[j] == tkParent)
-                {
-                    (void)md_cursor_to_token(cursor, &matchedTk);
-                    RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-                }
-                (void)md_cursor_next(&cursor);
-            }
-            i += read;
-        }
+        for (uint32_t i = 0; i < count; ++i)
+            RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, TokenFromRid(rows[i], mdtMemberRef)));
         *phEnum = cleanup.release();
     }
     return enumImpl->ReadTokens(rMemberRefs, cMax, pcTokens);
@@ -1252,49 +1389,17 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindMemberRef(
     if (IsNilToken(td))
         td = MD_GLOBAL_PARENT_TOKEN;
 
-    mdcursor_t cursor;
-    uint32_t count;
-    if (!md_create_cursor(_md_ptr.get(), mdtid_MemberRef, &cursor, &count))
-        return CLDB_E_FILE_CORRUPT;
-
-    for (uint32_t i = 0; i < count; (void)md_cursor_next(&cursor), ++i)
-    {
-        mdToken refParent;
-        if (!md_get_column_value_as_token(cursor, mdtMemberRef_Class, &refParent))
-            return CLDB_E_FILE_CORRUPT;
-
-        if (refParent != td)
-            continue;
+    pal::StringConvert<WCHAR, char> cvt{ szName };
+    if (!cvt.Success())
+        return E_INVALIDARG;
 
-        if (szName != nullptr)
-        {
-            char const* name;
-            if (!md_get_column_value_as_utf8(cursor, mdtMemberRef_Name, &name))
-                return CLDB_E_FILE_CORRUPT;
-            pal::StringConvert<WCHAR, char> cvt{ szName };
-            if (!cvt.Success())
-                return E_INVALIDARG;
-            if (::strncmp(name, cvt, cvt.Length()) != 0)
-                continue;
-        }
+    mdcursor_t cursor;
+    if (!md_find_memberref(_md_ptr.get(), td, cvt, (uint8_t const*)pvSigBlob, cbSigBlob, &cursor))
+        return CLDB_E_RECORD_NOTFOUND;
 
-        if (pvSigBlob != nullptr)
-        {
-            uint8_t const* sig;
-            uint32_t sigLen;
-            if (!md_get_column_value_as_blob(cursor, mdtMemberRef_Signature, &sig, &sigLen))
-                return CLDB_E_FILE_CORRUPT;
-            if (cbSigBlob != sigLen
-                || ::memcmp(pvSigBlob, sig, sigLen) != 0)
-            {
-                continue;
-            }
-        }
-        if (!md_cursor_to_token(cursor, pmr))
-            return CLDB_E_FILE_CORRUPT;
-        return S_OK;
-    }
-    return CLDB_E_RECORD_NOTFOUND;
+    if (!md_cursor_to_token(cursor, pmr))
+        return CLDB_E_FILE_CORRUPT;
+    return S_OK;
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMethodProps(
@@ -1344,10 +1449,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMethodProps(
     *ppvSigBlob = sig;
     *pcbSigBlob = sigLen;
 
-    char const* name;
-    if (!md_get_column_value_as_utf8(cursor, mdtMethodDef_Name, &name))
-        return CLDB_E_FILE_CORRUPT;
-    return ConvertAndReturnStringOutput(name, szMethod, cchMethod, pchMethod);
+    return ReturnNameColumnOutput(_nameCache.get(), cursor, mdtMethodDef_Name, szMethod, cchMethod, pchMethod);
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMemberRefProps(
@@ -1381,10 +1483,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMemberRefProps(
     *ppvSigBlob = sig;
     *pbSig = sigLen;
 
-    char const* name;
-    if (!md_get_column_value_as_utf8(cursor, mdtMemberRef_Name, &name))
-        return CLDB_E_FILE_CORRUPT;
-    return ConvertAndReturnStringOutput(name, szMember, cchMember, pchMember);
+    return ReturnNameColumnOutput(_nameCache.get(), cursor, mdtMemberRef_Name, szMember, cchMember, pchMember);
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumProperties(
@@ -1578,37 +1677,28 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumMethodSemantics(
         if (TypeFromToken(mb) != mdtMethodDef)
             return E_INVALIDARG;
 
-        mdcursor_t cursor;
+        mdcursor_t begin;
         uint32_t count;
-        if (!md_create_cursor(_md_ptr.get(), mdtid_MethodSemantics, &cursor, &count))
+        if (!md_create_cursor(_md_ptr.get(), mdtid_MethodSemantics, &begin, &count))
             return CLDB_E_RECORD_NOTFOUND;
 
+        uint32_t const* rows;
+        if (!md_find_reverse_references(_md_ptr.get(), mdtid_MethodSemantics, mdtMethodSemantics_Method, mb, &rows, &count))
+            return CLDB_E_FILE_CORRUPT;
+
         RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
 
         HCORENUMImpl_ptr cleanup{ enumImpl };
-
-        // Read in for matching in bulk
-        mdToken toMatch[64];
-        mdToken matchedTk;
-        uint32_t i = 0;
-        while (i < count)
+        for (uint32_t i = 0; i < count; ++i)
         {
-            int32_t read = md_get_many_rows_column_value_as_token(cursor, mdtMethodSemantics_Method, ARRAY_SIZE(toMatch), toMatch);
-            if (read == 0)
-                break;
-
-            assert(read > 0);
-            for (int32_t j = 0; j < read; ++j)
+            mdcursor_t cursor = begin;
+            mdToken association;
+            if (!md_cursor_move(&cursor, (int32_t)rows[i] - 1)
+                || !md_get_column_value_as_token(cursor, mdtMethodSemantics_Association, &association))
             {
-                if (toMatch[j] == mb)
-                {
-                    if (!md_get_column_value_as_token(cursor, mdtMethodSemantics_Association, &matchedTk))
-                        return CLDB_E_FILE_CORRUPT;
-                    RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-                }
-                (void)md_cursor_next(&cursor);
+                return CLDB_E_FILE_CORRUPT;
             }
-            i += read;
+            RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, association));
         }
         *phEnum = cleanup.release();
     }
@@ -2109,26 +2199,12 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumUserStrings(
     HCORENUMImpl* enumImpl = ToHCORENUMImpl(*phEnum);
     if (enumImpl == nullptr)
     {
-        RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
-
-        HCORENUMImpl_ptr cleanup{ enumImpl };
-        mduserstring_t us;
-        uint32_t offset;
-        mduserstringcursor_t cursor = 0;
-        for (;;)
-        {
-            if (!md_walk_user_string_heap(_md_ptr.get(), &cursor, &us, &offset))
-                break;
-
-            // Ignore strings that are of zero length.
-            if (us.str_bytes == 0)
-                continue;
-
-            // Add mdtString token types to the enumeration.
-            RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, RidToToken(offset, mdtString)));
-        }
+        UserStringSource* source = new (std::nothrow) UserStringSource{ _md_ptr.get() };
+        if (source == nullptr)
+            return E_OUTOFMEMORY;
 
-        *phEnum = cleanup.release();
+        RETURN_IF_FAILED(CreateSourceEnum(_editable, source, &enumImpl));
+        *phEnum = enumImpl;
     }
     return enumImpl->ReadTokens(rStrings, cMax, pcStrings);
 }
@@ -2193,66 +2269,44 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::EnumCustomAttributes(
         if (!md_create_cursor(_md_ptr.get(), mdtid_CustomAttribute, &cursor, &count))
             return CLDB_E_RECORD_NOTFOUND;
 
-        mdcursor_t curr;
-        uint32_t currCount;
-        if (IsNilToken(tk))
+        if (IsNilToken(tk) && IsNilToken(tkType))
         {
             // Caller is looking across all attributes
-            assert(IsNilToken(tkType)); // Ignoring type filter
             RETURN_IF_FAILED(HCORENUMImpl::CreateTableEnum(1, &enumImpl));
             HCORENUMImpl::InitTableEnum(*enumImpl, 0, cursor, count);
         }
+        else if (IsNilToken(tkType))
+        {
+            // Caller is looking for all associated attributes.
+            RETURN_IF_FAILED(CreateEnumTokenRangeForSortedTableKey(_md_ptr.get(), mdtid_CustomAttribute, mdtCustomAttribute_Parent, tk, &enumImpl));
+        }
         else
         {
-            md_range_result_t result = md_find_range_from_cursor(cursor, mdtCustomAttribute_Parent, tk, &curr, &currCount);
-            if (IsNilToken(tkType) && result != MD_RANGE_NOT_SUPPORTED)
+            // Caller is looking for attributes of a type, on one parent or across all attributes.
+            // Matches are found as they are read, limited to the parent's range if the table is sorted.
+            uint32_t row = 1;
+            if (!IsNilToken(tk))
             {
-                // Caller is looking for all associated attributes and we got a table range.
-                if (result == MD_RANGE_FOUND)
+                mdcursor_t curr;
+                uint32_t currCount;
+                md_range_result_t result = md_find_range_from_cursor(cursor, mdtCustomAttribute_Parent, tk, &curr, &currCount);
+                if (result == MD_RANGE_NOT_FOUND)
                 {
-                    RETURN_IF_FAILED(HCORENUMImpl::CreateTableEnum(1, &enumImpl));
-                    HCORENUMImpl::InitTableEnum(*enumImpl, 0, curr, currCount);
+                    count = 0;
                 }
-                else if (result == MD_RANGE_NOT_FOUND)
+                else if (result == MD_RANGE_FOUND)
                 {
-                    // If there are no tokens found, create an empty enumeration.
-                    RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
+                    mdToken first;
+                    (void)md_cursor_to_token(curr, &first);
+                    row = RidFromToken(first);
+                    count = currCount;
                 }
             }
-            else
-            {
-                RETURN_IF_FAILED(HCORENUMImpl::CreateDynamicEnum(&enumImpl));
-
-                HCORENUMImpl_ptr cleanup{ enumImpl };
 
-                // We need to search across the entire table as we couldn't get a range.
-                curr = cursor;
-                currCount = count;
-
-                // Read in for matching in bulk
-                mdToken toMatch[64];
-                mdToken matchedTk;
-                uint32_t i = 0;
-                while (i < currCount)
-                {
-                    int32_t read = md_get_many_rows_column_value_as_token(curr, mdtCustomAttribute_Parent, ARRAY_SIZE(toMatch), toMatch);
-                    if (read == 0)
-                        break;
-
-                    assert(read > 0);
-                    for (int32_t j = 0; j < read; ++j)
-                    {
-                        if (toMatch[j] == tkType)
-                        {
-                            (void)md_cursor_to_token(curr, &matchedTk);
-                            RETURN_IF_FAILED(HCORENUMImpl::AddToDynamicEnum(*enumImpl, matchedTk));
-                        }
-                        (void)md_cursor_next(&curr);
-                    }
-                    i += read;
-                }
-                enumImpl = cleanup.release();
-            }
+            CustomAttributeSource* source = new (std::nothrow) CustomAttributeSource{ _md_ptr.get(), tk, tkType, row, count };
+            if (source == nullptr)
+                return E_OUTOFMEMORY;
+            RETURN_IF_FAILED(CreateSourceEnum(_editable, source, &enumImpl));
         }
         *phEnum = enumImpl;
     }
@@ -2298,11 +2352,6 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindTypeRef(
     LPCWSTR     szName,
     mdTypeRef* ptr)
 {
-    mdcursor_t cursor;
-    uint32_t count;
-    if (!md_create_cursor(_md_ptr.get(), mdtid_TypeRef, &cursor, &count))
-        return CLDB_E_RECORD_NOTFOUND;
-
     pal::StringConvert<WCHAR, char> cvt{ szName };
     if (!cvt.Success())
         return E_INVALIDARG;
@@ -2311,39 +2360,12 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindTypeRef(
     char const* name;
     SplitTypeName(cvt, &nspace, &name);
 
-    bool scopeIsSet = !IsNilToken(tkResolutionScope);
-    mdToken resMaybe;
-    char const* str;
-    for (uint32_t i = 0; i < count; (void)md_cursor_next(&cursor), ++i)
-    {
-        if (!md_get_column_value_as_token(cursor, mdtTypeRef_ResolutionScope, &resMaybe))
-            return CLDB_E_FILE_CORRUPT;
-
-        // See if the Resolution scopes match.
-        if ((IsNilToken(resMaybe) && scopeIsSet)    // User didn't state scope.
-            || resMaybe != tkResolutionScope)       // Match user scope.
-        {
-            continue;
-        }
-
-        if (!md_get_column_value_as_utf8(cursor, mdtTypeRef_TypeNamespace, &str))
-            return CLDB_E_FILE_CORRUPT;
-
-        if (0 != ::strcmp(nspace, str))
-            continue;
-
-        if (!md_get_column_value_as_utf8(cursor, mdtTypeRef_TypeName, &str))
-            return CLDB_E_FILE_CORRUPT;
-
-        if (0 == ::strcmp(name, str))
-        {
-            (void)md_cursor_to_token(cursor, ptr);
-            return S_OK;
-        }
-    }
+    mdcursor_t cursor;
+    if (!md_find_typeref(_md_ptr.get(), tkResolutionScope, nspace, name, &cursor))
+        return CLDB_E_RECORD_NOTFOUND;
 
-    // Not found.
-    return CLDB_E_RECORD_NOTFOUND;
+    (void)md_cursor_to_token(cursor, ptr);
+    return S_OK;
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMemberProps(
@@ -2478,10 +2500,7 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetFieldProps(
     HRESULT hr;
     RETURN_IF_FAILED(FindConstant(_md_ptr, mb, *pdwCPlusTypeFlag, *ppValue, *pcchValue));
 
-    char const* name;
-    if (!md_get_column_value_as_utf8(cursor, mdtField_Name, &name))
-        return CLDB_E_FILE_CORRUPT;
-    return ConvertAndReturnStringOutput(name, szField, cchField, pchField);
+    return ReturnNameColumnOutput(_nameCache.get(), cursor, mdtField_Name, szField, cchField, pchField);
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::GetPropertyProps(
@@ -2633,87 +2652,6 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetParamProps(
     return ConvertAndReturnStringOutput(name, szName, cchName, pchName);
 }
 
-namespace
-{
-    // See TypeSpec definition at II.23.2.14
-    HRESULT ExtractTypeDefRefFromSpec(uint8_t const* specBlob, uint32_t specBlobLen, mdToken& tk)
-    {
-        assert(specBlob != nullptr);
-        if (specBlobLen == 0)
-            return COR_E_BADIMAGEFORMAT;
-
-        PCCOR_SIGNATURE sig = specBlob;
-        PCCOR_SIGNATURE sigEnd = specBlob + specBlobLen;
-
-        ULONG data;
-        sig += CorSigUncompressData(sig, &data);
-
-        while (sig < sigEnd
-            && (CorIsModifierElementType((CorElementType)data)
-                || data == ELEMENT_TYPE_GENERICINST))
-        {
-            sig += CorSigUncompressData(sig, &data);
-        }
-
-        if (sig >= sigEnd)
-            return COR_E_BADIMAGEFORMAT;
-
-        if (data == ELEMENT_TYPE_VALUETYPE || data == ELEMENT_TYPE_CLASS)
-        {
-            if (mdTokenNil == CorSigUncompressToken(sig, &tk))
-                return COR_E_BADIMAGEFORMAT;
-            return S_OK;
-        }
-
-        tk = mdTokenNil;
-        return S_FALSE;
-    }
-
-    HRESULT ResolveTypeDefRefSpecToName(mdcursor_t cursor, char const** nspace, char const** name)
-    {
-        assert(nspace != nullptr && name != nullptr);
-
-        HRESULT hr;
-        mdToken typeTk;
-        if (!md_cursor_to_token(cursor, &typeTk))
-            return E_FAIL;
-
-        uint8_t const* specBlob;
-        uint32_t specBlobLen;
-        uint32_t tokenType = TypeFromToken(typeTk);
-        while (tokenType == mdtTypeSpec)
-        {
-            if (!md_get_column_value_as_blob(cursor, mdtTypeSpec_Signature, &specBlob, &specBlobLen))
-                return CLDB_E_FILE_CORRUPT;
-
-            RETURN_IF_FAILED(ExtractTypeDefRefFromSpec(specBlob, specBlobLen, typeTk));
-            if (typeTk == mdTokenNil)
-                return S_FALSE;
-
-            if (!md_token_to_cursor(md_extract_handle_from_cursor(cursor), typeTk, &cursor))
-                return CLDB_E_FILE_CORRUPT;
-            tokenType = TypeFromToken(typeTk);
-        }
-
-        switch (tokenType)
-        {
-        case mdtTypeDef:
-            return (md_get_column_value_as_utf8(cursor, mdtTypeDef_TypeNamespace, nspace)
-                && md_get_column_value_as_utf8(cursor, mdtTypeDef_TypeName, name))
-                ? S_OK
-                : CLDB_E_FILE_CORRUPT;
-        case mdtTypeRef:
-            return (md_get_column_value_as_utf8(cursor, mdtTypeRef_TypeNamespace, nspace)
-                && md_get_column_value_as_utf8(cursor, mdtTypeRef_TypeName, name))
-                ? S_OK
-                : CLDB_E_FILE_CORRUPT;
-        default:
-            assert(!"Unexpected token in ResolveTypeDefRefSpecToName");
-            return E_FAIL;
-        }
-    }
-}
-
 HRESULT STDMETHODCALLTYPE MetadataImportRO::GetCustomAttributeByName(
     mdToken     tkObj,
     LPCWSTR     szName,
@@ -2723,116 +2661,37 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::GetCustomAttributeByName(
     if (szName == nullptr || ppData == nullptr || pcbData == nullptr)
         return E_INVALIDARG;
 
-    mdcursor_t cursor;
-    uint32_t count;
-    if (!md_create_cursor(_md_ptr.get(), mdtid_CustomAttribute, &cursor, &count))
-        return S_FALSE; // If no custom attributes are defined, treat it the same as if the attribute is not found.
+    *ppData = nullptr;
+    *pcbData = 0;
 
     char buffer[1024];
     pal::StringConvert<WCHAR, char> cvt{ szName, buffer };
     if (!cvt.Success())
         return E_INVALIDARG;
 
-    struct
+    // A missing attribute, including a scope with no CustomAttribute table, is S_FALSE.
+    // An attribute type with an invalid signature is a bad image format; an unreadable row is corrupt metadata.
+    mdcursor_t custAttr;
+    switch (md_find_custom_attribute_by_name(_md_ptr.get(), tkObj, cvt, &custAttr))
     {
-        HRESULT hr;
-        void const** ppData;
-        ULONG* pcbData;
-        pal::StringConvert<WCHAR, char> const& cvt;
-
-        bool operator()(mdcursor_t custAttrCurr)
-        {
-            char const* nspace;
-            char const* name;
-
-            mdcursor_t type;
-            mdcursor_t tgtType;
-            mdToken typeTk;
-            size_t len;
-            char const* curr;
-
-            if (!md_get_column_value_as_cursor(custAttrCurr, mdtCustomAttribute_Type, &type))
-            {
-                hr = CLDB_E_FILE_CORRUPT;
-                return true;
-            }
-
-            // Cursor was returned so must be valid.
-            (void)md_cursor_to_token(type, &typeTk);
-
-            // Resolve the cursor based on its type.
-            switch (TypeFromToken(typeTk))
-            {
-            case mdtMethodDef:
-                if (!md_find_cursor_of_range_element(type, &tgtType))
-                {
-                    hr = CLDB_E_FILE_CORRUPT;
-                    return true;
-                }
-                break;
-            case mdtMemberRef:
-                if (!md_get_column_value_as_cursor(type, mdtMemberRef_Class, &tgtType))
-                {
-                    hr = CLDB_E_FILE_CORRUPT;
-                    return true;
-                }
-                break;
-            default:
-                assert(!"Unexpected token in GetCustomAttributeByName");
-                {
-                    hr = COR_E_BADIMAGEFORMAT;
-                    return true;
-                }
-            }
-
-            if (FAILED(hr = ResolveTypeDefRefSpecToName(tgtType, &nspace, &name)))
-            {
-                return true;
-            }
-            else
-            {
-                hr = S_FALSE;
-                curr = cvt;
-                if (nspace[0] != '\0')
-                {
-                    len = ::strlen(nspace);
-                    if (0 != ::strncmp(cvt, nspace, len))
-                        return false;
-                    curr += len;
-
-                    // Check for overrun and next character
-                    if (cvt.Length() <= len || curr[0] != '.')
-                        return false;
-                    curr += 1;
-                }
-
-                if (0 == ::strcmp(curr, name))
-                {
-                    uint8_t const* data;
-                    uint32_t dataLen;
-                    if (!md_get_column_value_as_blob(custAttrCurr, mdtCustomAttribute_Value, &data, &dataLen))
-                    {
-                        hr = CLDB_E_FILE_CORRUPT;
-                        return true;
-                    }
-                    *ppData = data;
-                    *pcbData = dataLen;
-                    hr = S_OK;
-                    return true;
-                }
-            }
-            return false;
-        }
-    } finder {S_FALSE, ppData, pcbData, cvt};
+    case MD_CUSTOM_ATTRIBUTE_FOUND:
+        break;
+    case MD_CUSTOM_ATTRIBUTE_NOT_FOUND:
+        return S_FALSE;
+    case MD_CUSTOM_ATTRIBUTE_INVALID_TYPE:
+        return COR_E_BADIMAGEFORMAT;
+    default:
+        return CLDB_E_FILE_CORRUPT;
+    }
 
-    EnumTableRange(cursor, count, mdtCustomAttribute_Parent, tkObj, finder);
+    uint8_t const* data;
+    uint32_t dataLen;
+    if (!md_get_column_value_as_blob(custAttr, mdtCustomAttribute_Value, &data, &dataLen))
+        return CLDB_E_FILE_CORRUPT;
 
-    if (finder.hr != S_OK)
-    {
-        *ppData = nullptr;
-        *pcbData = 0;
-    }
-    return finder.hr;
+    *ppData = data;
+    *pcbData = dataLen;
+    return S_OK;
 }
 
 BOOL STDMETHODCALLTYPE MetadataImportRO::IsValidToken(
@@ -3841,11 +3700,6 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindExportedTypeByName(
     if (szName == nullptr)
         return E_INVALIDARG;
 
-    mdcursor_t cursor;
-    uint32_t count;
-    if (!md_create_cursor(_md_ptr.get(), mdtid_ExportedType, &cursor, &count))
-        return CLDB_E_RECORD_NOTFOUND;
-
     pal::StringConvert<WCHAR, char> cvt{ szName };
     if (!cvt.Success())
         return E_INVALIDARG;
@@ -3853,46 +3707,14 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindExportedTypeByName(
     char const* name;
     SplitTypeName(cvt, &nspace, &name);
 
-    for (uint32_t i = 0; i < count; md_cursor_next(&cursor), i++)
-    {
-        mdToken implementation;
-        if (!md_get_column_value_as_token(cursor, mdtExportedType_Implementation, &implementation))
-            return CLDB_E_FILE_CORRUPT;
-
-        // Handle the case of nested vs. non-nested classes
-        if (TypeFromToken(implementation) == CorTokenType::mdtExportedType && !IsNilToken(implementation))
-        {
-            // Current ExportedType being looked at is a nested type, so
-            // comparing the implementation token.
-            if (implementation != mdtExportedType)
-                continue;
-        }
-        else if (TypeFromToken(mdtExportedType) == mdtExportedType
-                && !IsNilToken(mdtExportedType))
-        {
-            // ExportedType passed in is nested but the current ExportedType is not.
-            continue;
-        }
-
-        char const* recordNspace;
-        if (!md_get_column_value_as_utf8(cursor, mdtExportedType_TypeNamespace, &recordNspace))
-            return CLDB_E_FILE_CORRUPT;
-
-        if (::strcmp(nspace, recordNspace) != 0)
-            continue;
-
-        char const* recordName;
-        if (!md_get_column_value_as_utf8(cursor, mdtExportedType_TypeName, &recordName))
-            return CLDB_E_FILE_CORRUPT;
-
-        if (::strcmp(name, recordName) != 0)
-            continue;
+    // Only a non-nil ExportedType token restricts the search to nested types.
+    mdcursor_t cursor;
+    if (!md_find_exportedtype(_md_ptr.get(), mdtExportedType, nspace, name, &cursor))
+        return CLDB_E_RECORD_NOTFOUND;
 
-        if (!md_cursor_to_token(cursor, ptkExportedType))
-            return CLDB_E_FILE_CORRUPT;
-        return S_OK;
-    }
-    return CLDB_E_RECORD_NOTFOUND;
+    if (!md_cursor_to_token(cursor, ptkExportedType))
+        return CLDB_E_FILE_CORRUPT;
+    return S_OK;
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::FindManifestResourceByName(
@@ -3902,32 +3724,17 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindManifestResourceByName(
     if (szName == nullptr)
         return E_INVALIDARG;
 
-    mdcursor_t cursor;
-    uint32_t count;
-    if (!md_create_cursor(_md_ptr.get(), mdtid_ManifestResource, &cursor, &count))
-        return CLDB_E_RECORD_NOTFOUND;
-
     pal::StringConvert<WCHAR, char> cvt{ szName };
     if (!cvt.Success())
         return E_INVALIDARG;
 
-    for (uint32_t i = 0; i < count; md_cursor_next(&cursor), i++)
-    {
-        mdManifestResource token;
-        if (!md_cursor_to_token(cursor, &token))
-            return CLDB_E_FILE_CORRUPT;
-
-        char const* name;
-        if (!md_get_column_value_as_utf8(cursor, mdtManifestResource_Name, &name))
-            return CLDB_E_FILE_CORRUPT;
+    mdcursor_t cursor;
+    if (!md_find_manifestresource(_md_ptr.get(), cvt, &cursor))
+        return CLDB_E_RECORD_NOTFOUND;
 
-        if (::strncmp(name, cvt, cvt.Length()) == 0)
-        {
-            *ptkManifestResource = token;
-            return S_OK;
-        }
-    }
-    return CLDB_E_RECORD_NOTFOUND;
+    if (!md_cursor_to_token(cursor, ptkManifestResource))
+        return CLDB_E_FILE_CORRUPT;
+    return S_OK;
 }
 
 HRESULT STDMETHODCALLTYPE MetadataImportRO::FindAssembliesByName(
@@ -3947,3 +3754,227 @@ HRESULT STDMETHODCALLTYPE MetadataImportRO::FindAssembliesByName(
     // Requires VM knowledge and is only supported in .NET Framework.
     return E_NOTIMPL;
 }
+
+namespace
+{
+    // Check every token in a batch refers to a row in the table before any output is written.
+    HRESULT ValidateBatchTokens(mdhandle_t handle, CorTokenType tokenType, mdToken const* tokens, ULONG count)
+    {
+        if (tokens == nullptr && count != 0)
+            return E_INVALIDARG;
+
+        mdcursor_t cursor;
+        uint32_t rowCount;
+        if (!md_create_cursor(handle, (mdtable_id_t)(tokenType >> 24), &cursor, &rowCount))
+            rowCount = 0;
+
+        for (ULONG i = 0; i < count; ++i)
+        {
+            if (TypeFromToken(tokens[i]) != tokenType)
+                return E_INVALIDARG;
+            if (IsNilToken(tokens[i]) || RidFromToken(tokens[i]) > rowCount)
+                return CLDB_E_RECORD_NOTFOUND;
+        }
+        return S_OK;
+    }
+
+    // Read a column for a batch of tokens with md_gather_column_values(),
+    // passing each decoded value and its index in the batch to the callback.
+    template<typename TCallback>
+    HRESULT GatherBatchColumn(mdhandle_t handle, col_index_t col, mdToken const* tokens, ULONG count, TCallback callback)
+    {
+        mdcolumnvalue_t values[64];
+        for (ULONG i = 0; i < count; i += (ULONG)ARRAY_SIZE(values))
+        {
+            uint32_t chunk = std::min(count - i, (ULONG)ARRAY_SIZE(values));
+            if (!md_gather_column_values(handle, col, tokens + i, chunk, values))
+                return CLDB_E_FILE_CORRUPT;
+
+            for (uint32_t j = 0; j < chunk; ++j)
+                callback(i + j, values[j]);
+        }
+        return S_OK;
+    }
+
+    HRESULT GatherBatchOwners(mdhandle_t handle, mdToken const* tokens, ULONG count, mdTypeDef* owners)
+    {
+        for (ULONG i = 0; i < count; ++i)
+        {
+            mdcursor_t cursor;
+            if (!md_token_to_cursor(handle, tokens[i], &cursor)
+                || !md_find_token_of_range_element(cursor, &owners[i]))
+            {
+                return CLDB_E_RECORD_NOTFOUND;
+            }
+        }
+        return S_OK;
+    }
+}
+
+HRESULT STDMETHODCALLTYPE MetadataImportRO::GetTypeDefPropsBatch(
+    mdTypeDef const rTypeDefs[],
+    ULONG       cTokens,
+    DWORD       rFlags[],
+    mdToken     rExtends[],
+    mdTypeDef   rEnclosingClasses[],
+    char const* rNamespaces[],
+    char const* rNames[])
+{
+    HRESULT hr;
+    mdhandle_t handle = _md_ptr.get();
+    RETURN_IF_FAILED(ValidateBatchTokens(handle, mdtTypeDef, rTypeDefs, cTokens));
+
+    if (rFlags != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtTypeDef_Flags, rTypeDefs, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rFlags[i] = value.constant; }));
+    }
+
+    if (rExtends != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtTypeDef_Extends, rTypeDefs, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value)
+            {
+                rExtends[i] = value.token == mdTypeDefNil
+                    ? mdTypeRefNil
+                    : value.token;
+            }));
+    }
+
+    if (rNamespaces != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtTypeDef_TypeNamespace, rTypeDefs, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rNamespaces[i] = value.str; }));
+    }
+
+    if (rNames != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtTypeDef_TypeName, rTypeDefs, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rNames[i] = value.str; }));
+    }
+
+    if (rEnclosingClasses != nullptr)
+    {
+        // The NestedClass table is sorted by the nested type so each lookup is a binary search.
+        // Create the cursor once for the whole batch.
+        mdcursor_t nestedClasses;
+        uint32_t nestedClassCount;
+        if (!md_create_cursor(handle, mdtid_NestedClass, &nestedClasses, &nestedClassCount))
+            nestedClassCount = 0;
+
+        for (ULONG i = 0; i < cTokens; ++i)
+        {
+            mdTypeDef enclosing = mdTypeDefNil;
+            mdcursor_t nestedClassRow;
+            if (nestedClassCount != 0
+                && md_find_row_from_cursor(nestedClasses, mdtNestedClass_NestedClass, RidFromToken(rTypeDefs[i]), &nestedClassRow)
+                && !md_get_column_value_as_token(nestedClassRow, mdtNestedClass_EnclosingClass, &enclosing))
+            {
+                return CLDB_E_FILE_CORRUPT;
+            }
+            rEnclosingClasses[i] = enclosing;
+        }
+    }
+
+    return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MetadataImportRO::GetMethodPropsBatch(
+    mdMethodDef const rMethods[],
+    ULONG       cTokens,
+    mdTypeDef   rClasses[],
+    DWORD       rFlags[],
+    DWORD       rImplFlags[],
+    ULONG       rCodeRVAs[],
+    char const* rNames[],
+    PCCOR_SIGNATURE rSigBlobs[],
+    ULONG       rSigBlobLengths[])
+{
+    HRESULT hr;
+    mdhandle_t handle = _md_ptr.get();
+    RETURN_IF_FAILED(ValidateBatchTokens(handle, mdtMethodDef, rMethods, cTokens));
+
+    if (rClasses != nullptr)
+        RETURN_IF_FAILED(GatherBatchOwners(handle, rMethods, cTokens, rClasses));
+
+    if (rFlags != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtMethodDef_Flags, rMethods, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rFlags[i] = value.constant; }));
+    }
+
+    if (rImplFlags != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtMethodDef_ImplFlags, rMethods, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rImplFlags[i] = value.constant; }));
+    }
+
+    if (rCodeRVAs != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtMethodDef_Rva, rMethods, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rCodeRVAs[i] = value.constant; }));
+    }
+
+    if (rNames != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtMethodDef_Name, rMethods, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rNames[i] = value.str; }));
+    }
+
+    if (rSigBlobs != nullptr || rSigBlobLengths != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtMethodDef_Signature, rMethods, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value)
+            {
+                if (rSigBlobs != nullptr)
+                    rSigBlobs[i] = value.blob.ptr;
+                if (rSigBlobLengths != nullptr)
+                    rSigBlobLengths[i] = value.blob.length;
+            }));
+    }
+
+    return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MetadataImportRO::GetFieldPropsBatch(
+    mdFieldDef const rFields[],
+    ULONG       cTokens,
+    mdTypeDef   rClasses[],
+    DWORD       rFlags[],
+    char const* rNames[],
+    PCCOR_SIGNATURE rSigBlobs[],
+    ULONG       rSigBlobLengths[])
+{
+    HRESULT hr;
+    mdhandle_t handle = _md_ptr.get();
+    RETURN_IF_FAILED(ValidateBatchTokens(handle, mdtFieldDef, rFields, cTokens));
+
+    if (rClasses != nullptr)
+        RETURN_IF_FAILED(GatherBatchOwners(handle, rFields, cTokens, rClasses));
+
+    if (rFlags != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtField_Flags, rFields, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rFlags[i] = value.constant; }));
+    }
+
+    if (rNames != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtField_Name, rFields, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value) { rNames[i] = value.str; }));
+    }
+
+    if (rSigBlobs != nullptr || rSigBlobLengths != nullptr)
+    {
+        RETURN_IF_FAILED(GatherBatchColumn(handle, mdtField_Signature, rFields, cTokens,
+            [&](ULONG i, mdcolumnvalue_t const& value)
+            {
+                if (rSigBlobs != nullptr)
+                    rSigBlobs[i] = value.blob.ptr;
+                if (rSigBlobLengths != nullptr)
+                    rSigBlobLengths[i] = value.blob.length;
+            }));
+    }
+
+    return S_OK;
+}
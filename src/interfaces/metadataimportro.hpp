@@ -5,15 +5,19 @@
 #include "tearoffbase.hpp"
 #include "controllingiunknown.hpp"
 #include "dnmdowner.hpp"
+#include "namecache.hpp"
 
 #include <external/cor.h>
 #include <external/corhdr.h>
+#include <dnmd_interfaces.hpp>
 
 #include <cstdint>
 
-class MetadataImportRO final : public TearOffBase<IMetaDataImport2, IMetaDataAssemblyImport>
+class MetadataImportRO final : public TearOffBase<IMetaDataImport2, IMetaDataAssemblyImport, IDNMDImportBatch>
 {
     mdhandle_view _md_ptr;
+    std::unique_ptr<Utf16NameCache> _nameCache;
+    bool _editable;
 
 protected:
     virtual bool TryGetInterfaceOnThis(REFIID riid, void** ppvObject) override
@@ -29,13 +33,21 @@ protected:
             *ppvObject = static_cast<IMetaDataAssemblyImport*>(this);
             return true;
         }
+        if (riid == IID_IDNMDImportBatch)
+        {
+            *ppvObject = static_cast<IDNMDImportBatch*>(this);
+            return true;
+        }
         return false;
     }
 
 public:
-    MetadataImportRO(IUnknown* controllingUnknown, mdhandle_view md_ptr)
+    // Enumerators over an editable scope take their values when they are created, so they don't see later edits.
+    MetadataImportRO(IUnknown* controllingUnknown, mdhandle_view md_ptr, uint32_t nameCacheSize = 0, bool editable = false)
         : TearOffBase(controllingUnknown)
         , _md_ptr{ md_ptr }
+        , _nameCache{ nameCacheSize == 0 ? nullptr : std::make_unique<Utf16NameCache>(nameCacheSize) }
+        , _editable{ editable }
     { }
 
     virtual ~MetadataImportRO() = default;
@@ -608,6 +620,36 @@ public: // IMetaDataAssemblyImport
         IUnknown* ppIUnk[],
         ULONG    cMax,
         ULONG* pcAssemblies) override;
+
+public: // IDNMDImportBatch
+    STDMETHOD(GetTypeDefPropsBatch)(
+        mdTypeDef const rTypeDefs[],
+        ULONG       cTokens,
+        DWORD       rFlags[],
+        mdToken     rExtends[],
+        mdTypeDef   rEnclosingClasses[],
+        char const* rNamespaces[],
+        char const* rNames[]) override;
+
+    STDMETHOD(GetMethodPropsBatch)(
+        mdMethodDef const rMethods[],
+        ULONG       cTokens,
+        mdTypeDef   rClasses[],
+        DWORD       rFlags[],
+        DWORD       rImplFlags[],
+        ULONG       rCodeRVAs[],
+        char const* rNames[],
+        PCCOR_SIGNATURE rSigBlobs[],
+        ULONG       rSigBlobLengths[]) override;
+
+    STDMETHOD(GetFieldPropsBatch)(
+        mdFieldDef const rFields[],
+        ULONG       cTokens,
+        mdTypeDef   rClasses[],
+        DWORD       rFlags[],
+        char const* rNames[],
+        PCCOR_SIGNATURE rSigBlobs[],
+        ULONG       rSigBlobLengths[]) override;
 };
 
 #endif // _SRC_INTERFACES_METADATAIMPORTRO_HPP_
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "namecache.hpp"
+#include "pal.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    HRESULT CopyNameToOutput(
+        WCHAR const* name,
+        uint32_t length,
+        _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+            WCHAR* szBuffer,
+        ULONG cchBuffer,
+        ULONG* pchBuffer)
+    {
+        assert(length > 0);
+        if (pchBuffer != nullptr)
+            *pchBuffer = length;
+
+        // A zero length buffer is a request for the needed length.
+        if (szBuffer == nullptr || cchBuffer == 0)
+            return S_OK;
+
+        if (cchBuffer >= length)
+        {
+            ::memcpy(szBuffer, name, length * sizeof(*name));
+            return S_OK;
+        }
+
+        // Truncate without splitting a surrogate pair.
+        uint32_t toCopy = cchBuffer - 1;
+        if (toCopy > 0 && name[toCopy - 1] >= 0xd800 && name[toCopy - 1] <= 0xdbff)
+            toCopy--;
+        ::memcpy(szBuffer, name, toCopy * sizeof(*name));
+        ::memset(&szBuffer[toCopy], 0, (cchBuffer - toCopy) * sizeof(*szBuffer));
+        return CLDB_S_TRUNCATION;
+    }
+}
+
+void Utf16NameCache::EntryDeleter::operator()(std::atomic<Entry*>* slots) const noexcept
+{
+    for (uint32_t i = 0; i < Count; ++i)
+        ::free(slots[i].load(std::memory_order_relaxed));
+    delete[] slots;
+}
+
+Utf16NameCache::Utf16NameCache(uint32_t size)
+    : _slots{}
+    , _mask{}
+{
+    assert(size > 0);
+    uint32_t slots = 1;
+    while (slots < size && slots < MaxSize)
+        slots <<= 1;
+
+    _slots = std::unique_ptr<std::atomic<Entry*>[], EntryDeleter>{ new std::atomic<Entry*>[slots](), EntryDeleter{ slots } };
+    _mask = slots - 1;
+}
+
+std::atomic<Utf16NameCache::Entry*>& Utf16NameCache::GetSlot(uint64_t key) noexcept
+{
+    // Fibonacci hashing to spread the sequential offsets of neighboring rows.
+    uint64_t hash = key * UINT64_C(0x9e3779b97f4a7c15);
+    return _slots[(uint32_t)(hash >> 32) & _mask];
+}
+
+bool Utf16NameCache::TryGetName(
+    uint64_t key,
+    _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+        WCHAR* szBuffer,
+    ULONG cchBuffer,
+    ULONG* pchBuffer,
+    HRESULT& hr) noexcept
+{
+    Entry* entry = GetSlot(key).load(std::memory_order_acquire);
+    if (entry == nullptr || entry->Key != key)
+        return false;
+
+    hr = CopyNameToOutput(entry->Name(), entry->Length, szBuffer, cchBuffer, pchBuffer);
+    return true;
+}
+
+HRESULT Utf16NameCache::AddName(
+    uint64_t key,
+    char const* str,
+    _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+        WCHAR* szBuffer,
+    ULONG cchBuffer,
+    ULONG* pchBuffer) noexcept
+{
+    assert(str != nullptr && str[0] != '\0');
+
+    // A UTF-8 string never needs more UTF-16 code units than it has UTF-8 code units.
+    size_t strLength = ::strlen(str);
+    if (strLength >= (UINT32_MAX - sizeof(Entry)) / sizeof(WCHAR))
+        return E_INVALIDARG;
+
+    malloc_ptr<Entry> entry{ (Entry*)::malloc(sizeof(Entry) + (strLength + 1) * sizeof(WCHAR)) };
+    if (entry == nullptr)
+        return E_OUTOFMEMORY;
+
+    uint32_t length;
+    if (FAILED(pal::ConvertUtf8ToUtf16(str, entry->Name(), (uint32_t)strLength + 1, &length)))
+        return E_INVALIDARG;
+
+    entry->Key = key;
+    entry->Length = length;
+    HRESULT hr = CopyNameToOutput(entry->Name(), length, szBuffer, cchBuffer, pchBuffer);
+
+    // Publish the entry if the slot is free. Otherwise another name (or another
+    // thread's copy of this name) already owns the slot and this entry is dropped.
+    Entry* expected = nullptr;
+    if (GetSlot(key).compare_exchange_strong(expected, entry.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+        (void)entry.release();
+    return hr;
+}
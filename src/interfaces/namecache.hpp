@@ -0,0 +1,79 @@
+#ifndef _SRC_INTERFACES_NAMECACHE_HPP_
+#define _SRC_INTERFACES_NAMECACHE_HPP_
+
+#include <internal/dnmd_platform.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// A bounded cache of UTF-16 names keyed by #Strings heap offsets.
+//
+// The cache belongs to a single scope. The #Strings heap is append-only, so the
+// string at an offset never changes when the heap is edited and entries never
+// need to be invalidated.
+//
+// The cache is direct-mapped and lock-free. Each slot is published at most once,
+// in the same way as the side tables in the core library, so a published entry
+// is immutable and lives until the cache is destroyed. A name whose slot is
+// already taken is converted but not cached.
+class Utf16NameCache final
+{
+    struct Entry final
+    {
+        uint64_t Key;
+        uint32_t Length; // Includes null terminator.
+
+        // The name is stored immediately after the entry.
+        WCHAR* Name() noexcept
+        {
+            return reinterpret_cast<WCHAR*>(this + 1);
+        }
+    };
+
+    struct EntryDeleter final
+    {
+        void operator()(std::atomic<Entry*>* slots) const noexcept;
+        uint32_t Count;
+    };
+
+    std::unique_ptr<std::atomic<Entry*>[], EntryDeleter> _slots;
+    uint32_t _mask;
+
+    std::atomic<Entry*>& GetSlot(uint64_t key) noexcept;
+
+public:
+    // The number of slots is rounded up to a power of 2 and capped at MaxSize.
+    static constexpr uint32_t MaxSize = 1 << 16;
+
+    explicit Utf16NameCache(uint32_t size);
+
+    // Create a key from one or two #Strings heap offsets.
+    // A second offset is used for names composed from two strings (for example, namespace and name).
+    static uint64_t Key(uint32_t offset, uint32_t secondOffset = 0) noexcept
+    {
+        return ((uint64_t)secondOffset << 32) | offset;
+    }
+
+    // Copy the cached name for the key to the output.
+    // Output semantics match the IMetaDataImport string output conventions.
+    // Returns false if the name isn't cached.
+    bool TryGetName(
+        uint64_t key,
+        _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+            WCHAR* szBuffer,
+        ULONG cchBuffer,
+        ULONG* pchBuffer,
+        HRESULT& hr) noexcept;
+
+    // Convert the non-empty UTF-8 name, cache it for the key if its slot is free, and copy it to the output.
+    HRESULT AddName(
+        uint64_t key,
+        char const* str,
+        _Out_writes_to_opt_(cchBuffer, *pchBuffer)
+            WCHAR* szBuffer,
+        ULONG cchBuffer,
+        ULONG* pchBuffer) noexcept;
+};
+
+#endif // _SRC_INTERFACES_NAMECACHE_HPP_
@@ -3,8 +3,12 @@
 #include <cassert>
 #include <functional>
 
-#if defined(BUILD_MACOS) || defined(BUILD_UNIX)
-#include <unicode/ustring.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSCODE_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define TRANSCODE_NEON
+#include <arm_neon.h>
 #endif
 
 #if defined(BUILD_WINDOWS)
@@ -19,123 +23,417 @@
 #include <windows.h>
 #else
 #include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 // String conversion functions
-HRESULT pal::ConvertUtf16ToUtf8(
-    WCHAR const* str,
-    char* buffer,
-    uint32_t bufferLength,
-    _Out_opt_ uint32_t* writtenOrNeeded)
+//
+// The transcoders below are built-in so non-Windows platforms don't depend on ICU.
+// Ill-formed input (unpaired surrogates, invalid UTF-8 sequences) is replaced with
+// U+FFFD, which matches the behavior of the Win32 conversion APIs.
+// Runs of ASCII, the common case for metadata names, are converted 16 code units
+// at a time.
+namespace
 {
-    assert(str != nullptr);
+    constexpr uint32_t ReplacementCharacter = 0xFFFD;
+    constexpr size_t AsciiBlockLength = 16;
 
-    int32_t length;
-#ifdef BUILD_WINDOWS
-    length = ::WideCharToMultiByte(CP_UTF8, 0, str, -1, buffer, bufferLength, nullptr, nullptr);
-    if (length <= 0)
+    // Check if the block of UTF-8 code units is all ASCII and, if so, widen it into the destination.
+    bool TryWidenAsciiBlock(uint8_t const* src, WCHAR* dest)
     {
-        if (::GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+#if defined(TRANSCODE_SSE2)
+        __m128i block = _mm_loadu_si128((__m128i const*)src);
+        if (_mm_movemask_epi8(block) != 0)
+            return false;
+
+        if (dest != nullptr)
         {
-            if (writtenOrNeeded != nullptr)
-                *writtenOrNeeded = ::WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
-            return E_NOT_SUFFICIENT_BUFFER;
+            __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i*)dest, _mm_unpacklo_epi8(block, zero));
+            _mm_storeu_si128((__m128i*)(dest + 8), _mm_unpackhi_epi8(block, zero));
+        }
+        return true;
+#elif defined(TRANSCODE_NEON)
+        uint8x16_t block = vld1q_u8(src);
+        if (vmaxvq_u8(block) >= 0x80)
+            return false;
+
+        if (dest != nullptr)
+        {
+            vst1q_u16((uint16_t*)dest, vmovl_u8(vget_low_u8(block)));
+            vst1q_u16((uint16_t*)(dest + 8), vmovl_high_u8(block));
         }
-        return E_FAIL;
+        return true;
+#else
+        uint64_t lo;
+        uint64_t hi;
+        ::memcpy(&lo, src, sizeof(lo));
+        ::memcpy(&hi, src + sizeof(lo), sizeof(hi));
+        if (((lo | hi) & UINT64_C(0x8080808080808080)) != 0)
+            return false;
+
+        if (dest != nullptr)
+        {
+            for (size_t i = 0; i < AsciiBlockLength; ++i)
+                dest[i] = (WCHAR)src[i];
+        }
+        return true;
+#endif
     }
-#elif defined(BUILD_MACOS) || defined(BUILD_UNIX)
-    // Buffer lengths assume null terminator
-    if (bufferLength > 0)
-        bufferLength -= 1;
-
-    UErrorCode err = U_ZERO_ERROR;
-    (void)::u_strToUTF8(buffer, bufferLength, &length, (UChar const*)str, -1, &err);
-    if (U_FAILURE(err))
+
+    // Check if the block of UTF-16 code units is all ASCII and, if so, narrow it into the destination.
+    bool TryNarrowAsciiBlock(WCHAR const* src, char* dest)
     {
-        if (err != U_BUFFER_OVERFLOW_ERROR)
-            return E_FAIL;
+#if defined(TRANSCODE_SSE2)
+        __m128i lo = _mm_loadu_si128((__m128i const*)src);
+        __m128i hi = _mm_loadu_si128((__m128i const*)(src + 8));
+        __m128i nonAscii = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16((short)0xff80));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) != 0xffff)
+            return false;
+
+        if (dest != nullptr)
+            _mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(lo, hi));
+        return true;
+#elif defined(TRANSCODE_NEON)
+        uint16x8_t lo = vld1q_u16((uint16_t const*)src);
+        uint16x8_t hi = vld1q_u16((uint16_t const*)(src + 8));
+        if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+            return false;
+
+        if (dest != nullptr)
+            vst1q_u8((uint8_t*)dest, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        return true;
+#else
+        uint64_t blocks[4];
+        ::memcpy(blocks, src, sizeof(blocks));
+        if (((blocks[0] | blocks[1] | blocks[2] | blocks[3]) & UINT64_C(0xff80ff80ff80ff80)) != 0)
+            return false;
 
-        if (bufferLength != 0)
+        if (dest != nullptr)
         {
-            if (writtenOrNeeded != nullptr)
-                *writtenOrNeeded = (uint32_t)length + 1; // Add null terminator
-            return E_NOT_SUFFICIENT_BUFFER;
+            for (size_t i = 0; i < AsciiBlockLength; ++i)
+                dest[i] = (char)src[i];
         }
+        return true;
+#endif
     }
-    if (buffer != nullptr)
-        buffer[length] = '\0';
-    length += 1; // Add null terminator
-#else
-#error Missing implementation
-#endif // !BUILD_WINDOWS
 
-    if (writtenOrNeeded != nullptr)
-        *writtenOrNeeded = (uint32_t)length;
-    return S_OK;
-}
+    // Output for a conversion.
+    // Code units are written while they fit in the buffer and counted after that,
+    // so a single pass both converts and computes the needed length.
+    template<typename T>
+    struct TranscodeOutput final
+    {
+        T* Buffer;
+        size_t Capacity; // Excludes the null terminator.
+        size_t Written;
+        size_t Needed;
+
+        TranscodeOutput(T* buffer, uint32_t bufferLength)
+            : Buffer{ buffer }
+            , Capacity{ (buffer != nullptr && bufferLength > 0) ? bufferLength - 1 : 0 }
+            , Written{ 0 }
+            , Needed{ 0 }
+        { }
+
+        // Get the destination for the code units or null if they don't fit.
+        T* Available(size_t count) const
+        {
+            return (Needed + count <= Capacity) ? Buffer + Needed : nullptr;
+        }
 
-HRESULT pal::ConvertUtf8ToUtf16(
-    char const* str,
-    WCHAR* buffer,
-    uint32_t bufferLength,
-    _Out_opt_ uint32_t* writtenOrNeeded)
-{
-    assert(str != nullptr);
+        // Reserve space for the code units. Returns the destination or null if they don't fit.
+        T* Reserve(size_t count)
+        {
+            T* dest = Available(count);
+            Needed += count;
+            if (dest != nullptr)
+                Written = Needed;
+            return dest;
+        }
 
-    int32_t length;
-#ifdef BUILD_WINDOWS
-    length = ::MultiByteToWideChar(CP_UTF8, 0, str, -1, buffer, bufferLength);
-    if (length <= 0)
-    {
-        if (::GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+        // Null terminate the written string and report the needed length.
+        HRESULT Complete(uint32_t bufferLength, uint32_t* writtenOrNeeded)
         {
+            if (Buffer != nullptr && bufferLength > 0)
+                Buffer[Written] = (T)0;
+
+            // Add null terminator
+            size_t needed = Needed + 1;
+            if (needed > UINT32_MAX)
+                return E_FAIL;
+
             if (writtenOrNeeded != nullptr)
-                *writtenOrNeeded = ::MultiByteToWideChar(CP_UTF8, 0, str, -1, nullptr, 0);
-            return E_NOT_SUFFICIENT_BUFFER;
+                *writtenOrNeeded = (uint32_t)needed;
+
+            // A zero length buffer is a request for the needed length.
+            if (bufferLength != 0 && needed > bufferLength)
+                return E_NOT_SUFFICIENT_BUFFER;
+            return S_OK;
+        }
+    };
+
+    void AppendCodePoint(TranscodeOutput<WCHAR>& output, uint32_t codePoint)
+    {
+        if (codePoint < 0x10000)
+        {
+            WCHAR* dest = output.Reserve(1);
+            if (dest != nullptr)
+                dest[0] = (WCHAR)codePoint;
+        }
+        else
+        {
+            WCHAR* dest = output.Reserve(2);
+            if (dest != nullptr)
+            {
+                codePoint -= 0x10000;
+                dest[0] = (WCHAR)(0xd800 + (codePoint >> 10));
+                dest[1] = (WCHAR)(0xdc00 + (codePoint & 0x3ff));
+            }
         }
-        return E_FAIL;
     }
-#elif defined(BUILD_MACOS) || defined(BUILD_UNIX)
-    // Buffer lengths assume null terminator
-    if (bufferLength > 0)
-        bufferLength -= 1;
-
-    UErrorCode err = U_ZERO_ERROR;
-    (void)::u_strFromUTF8((UChar*)buffer, bufferLength, &length, str, -1, &err);
-    if (U_FAILURE(err))
+
+    void AppendCodePoint(TranscodeOutput<char>& output, uint32_t codePoint)
     {
-        if (err != U_BUFFER_OVERFLOW_ERROR)
-            return E_FAIL;
+        if (codePoint < 0x80)
+        {
+            char* dest = output.Reserve(1);
+            if (dest != nullptr)
+                dest[0] = (char)codePoint;
+        }
+        else if (codePoint < 0x800)
+        {
+            char* dest = output.Reserve(2);
+            if (dest != nullptr)
+            {
+                dest[0] = (char)(0xc0 | (codePoint >> 6));
+                dest[1] = (char)(0x80 | (codePoint & 0x3f));
+            }
+        }
+        else if (codePoint < 0x10000)
+        {
+            char* dest = output.Reserve(3);
+            if (dest != nullptr)
+            {
+                dest[0] = (char)(0xe0 | (codePoint >> 12));
+                dest[1] = (char)(0x80 | ((codePoint >> 6) & 0x3f));
+                dest[2] = (char)(0x80 | (codePoint & 0x3f));
+            }
+        }
+        else
+        {
+            char* dest = output.Reserve(4);
+            if (dest != nullptr)
+            {
+                dest[0] = (char)(0xf0 | (codePoint >> 18));
+                dest[1] = (char)(0x80 | ((codePoint >> 12) & 0x3f));
+                dest[2] = (char)(0x80 | ((codePoint >> 6) & 0x3f));
+                dest[3] = (char)(0x80 | (codePoint & 0x3f));
+            }
+        }
+    }
 
-        if (bufferLength != 0)
+    size_t Utf16Length(WCHAR const* str)
+    {
+        WCHAR const* end = str;
+        while (*end != W('\0'))
+            ++end;
+        return (size_t)(end - str);
+    }
+
+    void TranscodeUtf8ToUtf16(char const* str, size_t length, TranscodeOutput<WCHAR>& output)
+    {
+        uint8_t const* src = (uint8_t const*)str;
+        uint8_t const* end = src + length;
+        while (src < end)
         {
-            if (writtenOrNeeded != nullptr)
-                *writtenOrNeeded = (uint32_t)length + 1; // Add null terminator
-            return E_NOT_SUFFICIENT_BUFFER;
+            if ((size_t)(end - src) >= AsciiBlockLength)
+            {
+                // Only widen into the buffer if the entire block fits.
+                if (TryWidenAsciiBlock(src, output.Available(AsciiBlockLength)))
+                {
+                    (void)output.Reserve(AsciiBlockLength);
+                    src += AsciiBlockLength;
+                    continue;
+                }
+            }
+
+            uint8_t lead = *src;
+            if (lead < 0x80)
+            {
+                AppendCodePoint(output, lead);
+                src++;
+                continue;
+            }
+
+            // Determine the sequence length and the valid range of the second byte.
+            // See Table 3-7 in the Unicode Standard, "Well-Formed UTF-8 Byte Sequences".
+            size_t trailCount;
+            uint32_t codePoint;
+            uint8_t lowerBound = 0x80;
+            uint8_t upperBound = 0xbf;
+            if (lead >= 0xc2 && lead <= 0xdf)
+            {
+                trailCount = 1;
+                codePoint = lead & 0x1f;
+            }
+            else if (lead >= 0xe0 && lead <= 0xef)
+            {
+                trailCount = 2;
+                codePoint = lead & 0x0f;
+                if (lead == 0xe0)
+                    lowerBound = 0xa0; // Overlong
+                else if (lead == 0xed)
+                    upperBound = 0x9f; // Surrogates
+            }
+            else if (lead >= 0xf0 && lead <= 0xf4)
+            {
+                trailCount = 3;
+                codePoint = lead & 0x07;
+                if (lead == 0xf0)
+                    lowerBound = 0x90; // Overlong
+                else if (lead == 0xf4)
+                    upperBound = 0x8f; // Greater than U+10FFFF
+            }
+            else
+            {
+                AppendCodePoint(output, ReplacementCharacter);
+                src++;
+                continue;
+            }
+
+            size_t consumed = 1;
+            for (; consumed <= trailCount && src + consumed < end; ++consumed)
+            {
+                uint8_t trail = src[consumed];
+                if (trail < lowerBound || trail > upperBound)
+                    break;
+                lowerBound = 0x80;
+                upperBound = 0xbf;
+                codePoint = (codePoint << 6) | (trail & 0x3f);
+            }
+
+            // Replace the maximal subpart of an ill-formed sequence with a single replacement character.
+            AppendCodePoint(output, consumed > trailCount ? codePoint : ReplacementCharacter);
+            src += consumed;
         }
     }
-    if (buffer != nullptr)
-        buffer[length] = W('\0');
-    length += 1; // Add null terminator
-#else
-#error Missing implementation
-#endif // !BUILD_WINDOWS
 
-    if (writtenOrNeeded != nullptr)
-        *writtenOrNeeded = (uint32_t)length;
-    return S_OK;
+    void TranscodeUtf16ToUtf8(WCHAR const* str, size_t length, TranscodeOutput<char>& output)
+    {
+        WCHAR const* src = str;
+        WCHAR const* end = src + length;
+        while (src < end)
+        {
+            if ((size_t)(end - src) >= AsciiBlockLength)
+            {
+                // Only narrow into the buffer if the entire block fits.
+                if (TryNarrowAsciiBlock(src, output.Available(AsciiBlockLength)))
+                {
+                    (void)output.Reserve(AsciiBlockLength);
+                    src += AsciiBlockLength;
+                    continue;
+                }
+            }
+
+            uint32_t codePoint = (uint16_t)*src++;
+            if (codePoint >= 0xd800 && codePoint <= 0xdfff)
+            {
+                if (codePoint <= 0xdbff
+                    && src < end
+                    && (uint16_t)*src >= 0xdc00
+                    && (uint16_t)*src <= 0xdfff)
+                {
+                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + ((uint16_t)*src - 0xdc00);
+                    src++;
+                }
+                else
+                {
+                    codePoint = ReplacementCharacter;
+                }
+            }
+            AppendCodePoint(output, codePoint);
+        }
+    }
+}
+
+HRESULT pal::ConvertUtf16ToUtf8(
+    WCHAR const* str,
+    char* buffer,
+    uint32_t bufferLength,
+    _Out_opt_ uint32_t* writtenOrNeeded)
+{
+    assert(str != nullptr);
+
+    TranscodeOutput<char> output{ buffer, bufferLength };
+    TranscodeUtf16ToUtf8(str, Utf16Length(str), output);
+    return output.Complete(bufferLength, writtenOrNeeded);
+}
+
+HRESULT pal::ConvertUtf8ToUtf16(
+    char const* str,
+    WCHAR* buffer,
+    uint32_t bufferLength,
+    _Out_opt_ uint32_t* writtenOrNeeded)
+{
+    assert(str != nullptr);
+
+    TranscodeOutput<WCHAR> output{ buffer, bufferLength };
+    TranscodeUtf8ToUtf16(str, ::strlen(str), output);
+    return output.Complete(bufferLength, writtenOrNeeded);
 }
 
 template<>
-HRESULT pal::StringConvert<WCHAR, char>::ConvertWorker(WCHAR const* c, char* buffer, uint32_t& bufferLength)
+HRESULT pal::StringConvert<WCHAR, char>::ConvertWorker(WCHAR const* c, char* buffer, uint32_t bufferLength, uint32_t& writtenOrNeeded)
 {
-    return ConvertUtf16ToUtf8(c, buffer, bufferLength, &bufferLength);
+    size_t length = Utf16Length(c);
+    if (buffer == nullptr)
+    {
+        // Allocate for the worst case, 3 UTF-8 code units per UTF-16 code unit,
+        // so the string is only transcoded once.
+        if (length > (UINT32_MAX - 1) / 3)
+            return E_OUTOFMEMORY;
+        bufferLength = (uint32_t)(length * 3 + 1);
+        buffer = (char*)::malloc(bufferLength);
+        if (buffer == nullptr)
+            return E_OUTOFMEMORY;
+        _owner.reset(buffer);
+    }
+
+    TranscodeOutput<char> output{ buffer, bufferLength };
+    TranscodeUtf16ToUtf8(c, length, output);
+    HRESULT hr = output.Complete(bufferLength, &writtenOrNeeded);
+    if (hr == S_OK)
+        _ptr = buffer;
+    return hr;
 }
 
 template<>
-HRESULT pal::StringConvert<char, WCHAR>::ConvertWorker(char const* c, WCHAR* buffer, uint32_t& bufferLength)
+HRESULT pal::StringConvert<char, WCHAR>::ConvertWorker(char const* c, WCHAR* buffer, uint32_t bufferLength, uint32_t& writtenOrNeeded)
 {
-    return ConvertUtf8ToUtf16(c, buffer, bufferLength, &bufferLength);
+    size_t length = ::strlen(c);
+    if (buffer == nullptr)
+    {
+        // A UTF-8 string never needs more UTF-16 code units than it has
+        // UTF-8 code units, so the string is only transcoded once.
+        if (length > UINT32_MAX - 1)
+            return E_OUTOFMEMORY;
+        bufferLength = (uint32_t)(length + 1);
+        buffer = (WCHAR*)::malloc(sizeof(*buffer) * bufferLength);
+        if (buffer == nullptr)
+            return E_OUTOFMEMORY;
+        _owner.reset(buffer);
+    }
+
+    TranscodeOutput<WCHAR> output{ buffer, bufferLength };
+    TranscodeUtf8ToUtf16(c, length, output);
+    HRESULT hr = output.Complete(bufferLength, &writtenOrNeeded);
+    if (hr == S_OK)
+        _ptr = buffer;
+    return hr;
 }
 
 #if !defined(__STDC_LIB_EXT1__) && !defined(BUILD_WINDOWS)
@@ -147,6 +445,82 @@ int strcat_s(char* dest, rsize_t destsz, char const* src)
 }
 #endif // !defined(__STDC_LIB_EXT1__) && !defined(BUILD_WINDOWS)
 
+// Memory mapped file implementation
+pal::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _view{ other._view }
+    , _size{ other._size }
+{
+    other._view = nullptr;
+    other._size = 0;
+}
+
+#if defined(BUILD_WINDOWS)
+bool pal::MappedFile::Open(WCHAR const* path) noexcept
+{
+    assert(_view == nullptr && path != nullptr);
+    HANDLE file = ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (::GetFileSizeEx(file, &size) && size.QuadPart > 0 && (uint64_t)size.QuadPart <= SIZE_MAX)
+        mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    // The view keeps the file mapped after the handles are closed.
+    void* view = nullptr;
+    if (mapping != nullptr)
+    {
+        view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+    }
+    ::CloseHandle(file);
+
+    if (view == nullptr)
+        return false;
+    _view = view;
+    _size = (size_t)size.QuadPart;
+    return true;
+}
+
+pal::MappedFile::~MappedFile()
+{
+    if (_view != nullptr)
+        ::UnmapViewOfFile(_view);
+}
+#else
+bool pal::MappedFile::Open(WCHAR const* path) noexcept
+{
+    assert(_view == nullptr && path != nullptr);
+    pal::StringConvert<WCHAR, char> cvt(path);
+    if (!cvt.Success())
+        return false;
+
+    int fd = ::open(cvt, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    // The mapping keeps the file mapped after the descriptor is closed.
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= SIZE_MAX)
+        view = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    (void)::close(fd);
+
+    if (view == MAP_FAILED)
+        return false;
+    _view = view;
+    _size = (size_t)st.st_size;
+    return true;
+}
+
+pal::MappedFile::~MappedFile()
+{
+    if (_view != nullptr)
+        (void)::munmap(_view, _size);
+}
+#endif // defined(BUILD_WINDOWS)
+
 // SHA1 implementation
 #if defined(BUILD_WINDOWS)
 namespace
@@ -28,6 +28,8 @@ namespace pal
         _Out_opt_ uint32_t* writtenOrNeeded);
 
     // Template class for conversion UTF-8 <=> UTF-16
+    // If a buffer is supplied and it is too small, the conversion fails
+    // and Length() returns the needed length.
     template<typename A, typename B>
     class StringConvert
     {
@@ -35,41 +37,19 @@ namespace pal
         malloc_ptr<void> _owner;
         uint32_t _charLength;
         bool _converted;
-        HRESULT ConvertWorker(A const* c, B* buffer, uint32_t& bufferLength);
+
+        // Convert in a single pass. If no buffer is supplied, one is allocated.
+        HRESULT ConvertWorker(A const* c, B* buffer, uint32_t bufferLength, uint32_t& writtenOrNeeded);
 
     public:
         StringConvert(A const* c, B* buffer, uint32_t bufferLength) noexcept
-            : _owner{}
+            : _ptr{}
+            , _owner{}
             , _charLength{}
             , _converted{}
         {
-            uint32_t neededLength = bufferLength;
-            // Compute needed size for conversion and/or rely on the user supplied buffer.
-            HRESULT hr = ConvertWorker(c, buffer, neededLength);
-            if (hr == S_OK)
-            {
-                if (bufferLength < neededLength)
-                {
-                    buffer = (B*)::malloc(sizeof(*buffer) * neededLength);
-                    _owner.reset(buffer);
-                    bufferLength = neededLength;
-                }
-
-                // Do conversion
-                hr = ConvertWorker(c, buffer, bufferLength);
-                _converted = SUCCEEDED(hr);
-                if (_converted)
-                {
-                    _ptr = buffer;
-                    _charLength = bufferLength;
-                }
-            }
-            else if (neededLength != bufferLength)
-            {
-                // Failed to convert. If the needed length was updated
-                // then set that so the caller can possibly use it.
-                _charLength = neededLength;
-            }
+            HRESULT hr = ConvertWorker(c, buffer, bufferLength, _charLength);
+            _converted = hr == S_OK;
         }
 
         explicit StringConvert(A const* c) noexcept
@@ -110,6 +90,38 @@ namespace pal
         }
     };
 
+    // A read-only memory mapping of a whole file.
+    class MappedFile final
+    {
+        void* _view;
+        size_t _size;
+    public:
+        MappedFile() noexcept
+            : _view{}
+            , _size{}
+        { }
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        MappedFile& operator=(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        // Map the file. Returns false if the file can't be opened, is empty or can't be mapped.
+        bool Open(WCHAR const* path) noexcept;
+
+        uint8_t const* Data() const noexcept
+        {
+            return (uint8_t const*)_view;
+        }
+
+        size_t Size() const noexcept
+        {
+            return _size;
+        }
+    };
+
     constexpr size_t SHA1_HASH_SIZE = 20;
 
     bool ComputeSha1Hash(span<uint8_t const> data, std::array<uint8_t, SHA1_HASH_SIZE>& hashDestination);
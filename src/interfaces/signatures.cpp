@@ -284,6 +284,37 @@ void GetMethodDefSigFromMethodRefSig(span<uint8_t> methodRefSig, inline_span<uin
     return;
 }
 
+HRESULT GetLocalVarSigType(span<uint8_t const> localVarSig, uint32_t index, span<uint8_t const>& localType)
+{
+    try
+    {
+        span<uint8_t const> signature = localVarSig;
+        if (signature[0] != IMAGE_CEE_CS_CALLCONV_LOCAL_SIG)
+            return META_E_BAD_SIGNATURE;
+        signature = slice(signature, 1);
+
+        uint32_t localCount;
+        std::tie(localCount, signature) = read_compressed_uint(signature);
+        if (index >= localCount)
+            return E_INVALIDARG;
+
+        // Each local is a single element, as custom modifiers and constraints wrap the type that follows them.
+        for (uint32_t i = 0; i < index; i++)
+        {
+            signature = WalkSignatureElement(signature, [](std::intmax_t, signature_element_part_tag) { });
+        }
+
+        span<uint8_t const> rest = WalkSignatureElement(signature, [](std::intmax_t, signature_element_part_tag) { });
+        localType = { signature.begin(), signature.size() - rest.size() };
+        return S_OK;
+    }
+    catch (std::exception const&)
+    {
+        // Walking past the end of the signature or an unknown element type.
+        return META_E_BAD_SIGNATURE;
+    }
+}
+
 // Define a function object that enables us to combine multiple lambdas into a single overload set.
 namespace
 {
@@ -335,9 +366,10 @@ HRESULT ImportSignatureIntoModule(
     mdhandle_t destinationModule,
     span<const uint8_t> signature,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     inline_span<uint8_t>& importedSignature)
 {
-    HRESULT hr;
+    HRESULT hr = S_OK;
     // We are going to copy over the signature and replace the tokens from the source module in the signature
     // with equivalent tokens in the destination module, creating them if needed.
     std::vector<uint8_t> importedSignatureBuffer;
@@ -361,7 +393,7 @@ HRESULT ImportSignatureIntoModule(
             ULONG compressedSize = CorSigCompressSignedInt(value, buffer);
             importedSignatureBuffer.insert(importedSignatureBuffer.end(), buffer, buffer + compressedSize);
         },
-        [=, &importedSignatureBuffer, &hr](mdToken token, token_tag)
+        [=, &importedSignatureBuffer, &cache, &hr](mdToken token, token_tag)
         {
             HRESULT localHR = ImportReferenceToTypeDefOrRefOrSpec(
                 sourceAssembly,
@@ -370,6 +402,7 @@ HRESULT ImportSignatureIntoModule(
                 destinationAssembly,
                 destinationModule,
                 onRowAdded,
+                cache,
                 &token);
 
             // We can safely continue walking the signature even if we failed to import the token.
@@ -436,7 +469,7 @@ HRESULT ImportSignatureIntoModule(
 
     try
     {
-        importedSignature.resize(importedSignature.size());
+        importedSignature.resize(importedSignatureBuffer.size());
     }
     catch (std::bad_alloc const&)
     {
@@ -456,6 +489,7 @@ HRESULT ImportTypeSpecBlob(
     mdhandle_t destinationModule,
     span<const uint8_t> typeSpecBlob,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     inline_span<uint8_t>& importedTypeSpecBlob)
 {
     std::vector<uint8_t> importedTypeSpecBlobBuffer;
@@ -482,7 +516,7 @@ HRESULT ImportTypeSpecBlob(
             ULONG compressedSize = CorSigCompressSignedInt(value, buffer);
             importedTypeSpecBlobBuffer.insert(importedTypeSpecBlobBuffer.end(), buffer, buffer + compressedSize);
         },
-        [=, &importedTypeSpecBlobBuffer, &hr](mdToken token, token_tag)
+        [=, &importedTypeSpecBlobBuffer, &cache, &hr](mdToken token, token_tag)
         {
             HRESULT localHR = ImportReferenceToTypeDefOrRefOrSpec(
                 sourceAssembly,
@@ -491,6 +525,7 @@ HRESULT ImportTypeSpecBlob(
                 destinationAssembly,
                 destinationModule,
                 onRowAdded,
+                cache,
                 &token);
 
             // We can safely continue walking the signature even if we failed to import the token.
@@ -11,6 +11,8 @@
 #include <functional>
 #include <cassert>
 
+class ImportCache;
+
 /// @brief A span that that supports owning a specified number of elements in itself.
 /// @tparam T The type of the elements in the span.
 /// @tparam NumInlineElements The number of elements to store in the span itself.
@@ -124,6 +126,10 @@ using inline_span = base_inline_span<T, 64 / sizeof(T)>;
 
 void GetMethodDefSigFromMethodRefSig(span<uint8_t> methodRefSig, inline_span<uint8_t>& methodDefSig);
 
+// Get the type of a local in a LocalVarSig (II.23.2.6), including its custom modifiers and the BYREF and PINNED constraints.
+// Returns META_E_BAD_SIGNATURE if the signature is malformed, or E_INVALIDARG if there is no local at the index.
+HRESULT GetLocalVarSigType(span<uint8_t const> localVarSig, uint32_t index, span<uint8_t const>& localType);
+
 // Import a signature from one set of module and assembly metadata into another set of module and assembly metadata.
 // The module and assembly metadata for source or destination can be the same metadata.
 // The supported signature kinds are:
@@ -134,6 +140,7 @@ void GetMethodDefSigFromMethodRefSig(span<uint8_t> methodRefSig, inline_span<uin
 // - PropertySig (II.23.2.5)
 // - LocalVarSig (II.23.2.6)
 // - MethodSpec (II.23.2.15)
+// Type references are imported through the cache, see ImportReferenceToTypeDefOrRefOrSpec.
 HRESULT ImportSignatureIntoModule(
     mdhandle_t sourceAssembly,
     mdhandle_t sourceModule,
@@ -142,6 +149,7 @@ HRESULT ImportSignatureIntoModule(
     mdhandle_t destinationModule,
     span<const uint8_t> signature,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     inline_span<uint8_t>& importedSignature);
 
 // Import a TypeSpecBlob (II.23.2.14) from one set of module and assembly metadata into another set of module and assembly metadata.
@@ -153,6 +161,7 @@ HRESULT ImportTypeSpecBlob(
     mdhandle_t destinationModule,
     span<const uint8_t> typeSpecBlob,
     std::function<void(mdcursor_t)> onRowAdded,
+    ImportCache& cache,
     inline_span<uint8_t>& importedTypeSpecBlob);
 
 #endif // _SRC_INTERFACES_SIGNATURES_HPP_
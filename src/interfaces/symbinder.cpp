@@ -13,6 +13,12 @@
 #include <external/corhdr.h>
 #include <external/corsym.h>
 
+#include "symreader.hpp"
+
+#include <cstring>
+#include <memory>
+#include <new>
+
 EXTERN_GUID(IID_ISymUnmanagedBinder, 0xaa544d42, 0x28cb, 0x11d3, 0xbd, 0x22, 0x00, 0x00, 0xf8, 0x08, 0x49, 0xbd);
 
 namespace
@@ -26,11 +32,33 @@ namespace
             /* [in] */ __RPC__in WCHAR const *searchPath,
             /* [retval][out] */ __RPC__deref_out_opt ISymUnmanagedReader **pRetVal)
         {
-            UNREFERENCED_PARAMETER(importer);
-            UNREFERENCED_PARAMETER(fileName);
+            // Only the Portable PDB next to the module is considered.
             UNREFERENCED_PARAMETER(searchPath);
-            UNREFERENCED_PARAMETER(pRetVal);
-            return E_NOTIMPL;
+            if (fileName == nullptr || pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            // Replace the extension of the file name, if any, with ".pdb".
+            size_t length = 0;
+            size_t extension = SIZE_MAX;
+            for (; fileName[length] != 0; ++length)
+            {
+                if (fileName[length] == '.')
+                    extension = length;
+                else if (fileName[length] == '/' || fileName[length] == '\\')
+                    extension = SIZE_MAX;
+            }
+
+            if (extension == SIZE_MAX)
+                extension = length;
+
+            static WCHAR const PdbExtension[] = { '.', 'p', 'd', 'b', 0 };
+            std::unique_ptr<WCHAR[]> pdbPath{ new (std::nothrow) WCHAR[extension + ARRAY_SIZE(PdbExtension)] };
+            if (pdbPath == nullptr)
+                return E_OUTOFMEMORY;
+
+            std::memcpy(pdbPath.get(), fileName, extension * sizeof(WCHAR));
+            std::memcpy(pdbPath.get() + extension, PdbExtension, sizeof(PdbExtension));
+            return CreateSymReaderForFile(importer, pdbPath.get(), pRetVal);
         }
 
         STDMETHOD(GetReaderFromStream)(
@@ -38,10 +66,7 @@ namespace
             /* [in] */ __RPC__in_opt IStream *pstream,
             /* [retval][out] */ __RPC__deref_out_opt ISymUnmanagedReader **pRetVal)
         {
-            UNREFERENCED_PARAMETER(importer);
-            UNREFERENCED_PARAMETER(pstream);
-            UNREFERENCED_PARAMETER(pRetVal);
-            return E_NOTIMPL;
+            return CreateSymReaderFromStream(importer, pstream, pRetVal);
         }
 
     public: // IUnknown
@@ -0,0 +1,1981 @@
+#include "symreader.hpp"
+#include "pal.hpp"
+#include "signatures.hpp"
+
+#include <dnmd.hpp>
+#include <dnmd_pdb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define RETURN_IF_FAILED(exp) \
+{ \
+    hr = (exp); \
+    if (FAILED(hr)) \
+    { \
+        return hr; \
+    } \
+}
+
+namespace
+{
+    // {5A869D0B-6611-11D3-BD2A-0000F80849BD}
+    constexpr GUID DocumentTypeText = { 0x5a869d0b, 0x6611, 0x11d3, { 0xbd, 0x2a, 0x00, 0x00, 0xf8, 0x08, 0x49, 0xbd } };
+
+    // {994B45C4-E6E9-11D2-903F-00C04FA302A1}
+    constexpr GUID LanguageVendorMicrosoft = { 0x994b45c4, 0xe6e9, 0x11d2, { 0x90, 0x3f, 0x00, 0xc0, 0x4f, 0xa3, 0x02, 0xa1 } };
+
+    // {0E8A571B-6926-466E-B4AD-8AB04611F5FE}
+    constexpr mdguid_t EmbeddedSourceKind = { 0x0e8a571b, 0x6926, 0x466e, { 0xb4, 0xad, 0x8a, 0xb0, 0x46, 0x11, 0xf5, 0xfe } };
+
+    // The line reported for hidden sequence points.
+    constexpr ULONG32 HiddenSequencePointLine = 0xfeefee;
+
+    // The end of the range that selects the whole document in GetSourceRange.
+    constexpr ULONG32 DocumentEnd = INT32_MAX;
+
+    // The import kinds are declared in an unnamed struct, which C++ can only name through the member.
+    using ImportEntry = std::remove_reference<decltype(std::declval<md_imports_t&>().imports[0])>::type;
+
+    uint32_t GetRow(mdcursor_t cursor)
+    {
+        mdToken token;
+        return md_cursor_to_token(cursor, &token) ? RidFromToken(token) : 0;
+    }
+
+    HRESULT ReturnUtf16Output(
+        char const* str,
+        ULONG32 cchBuffer,
+        ULONG32* pcchBuffer,
+        WCHAR* szBuffer)
+    {
+        if (pcchBuffer == nullptr && szBuffer == nullptr)
+            return E_INVALIDARG;
+
+        uint32_t writtenOrNeeded;
+        HRESULT hr = pal::ConvertUtf8ToUtf16(str, szBuffer, szBuffer != nullptr ? cchBuffer : 0, &writtenOrNeeded);
+        if (pcchBuffer != nullptr)
+            *pcchBuffer = writtenOrNeeded;
+        return hr;
+    }
+
+    HRESULT ReturnGuidColumn(mdcursor_t cursor, col_index_t column, GUID* pRetVal)
+    {
+        if (pRetVal == nullptr)
+            return E_INVALIDARG;
+
+        mdguid_t guid;
+        if (!md_get_column_value_as_guid(cursor, column, &guid))
+            return CLDB_E_FILE_CORRUPT;
+
+        static_assert(sizeof(guid) == sizeof(*pRetVal), "mdguid_t must match GUID");
+        std::memcpy(pRetVal, &guid, sizeof(guid));
+        return S_OK;
+    }
+
+    // The symbol objects are independent COM objects. Each one keeps the objects it was
+    // created from alive, so the reader and the mapped PDB outlive every object handed out.
+    template<typename T, IID const& TIid>
+    class SymObject : public T
+    {
+        std::atomic<int32_t> _refCount{ 1 };
+
+    public:
+        virtual ~SymObject() = default;
+
+    public: // IUnknown
+        STDMETHOD(QueryInterface)(
+            /* [in] */ REFIID riid,
+            /* [iid_is][out] */ _COM_Outptr_ void __RPC_FAR* __RPC_FAR* ppvObject) override
+        {
+            if (ppvObject == nullptr)
+                return E_POINTER;
+
+            if (riid == IID_IUnknown || riid == TIid)
+            {
+                *ppvObject = static_cast<T*>(this);
+            }
+            else
+            {
+                *ppvObject = nullptr;
+                return E_NOINTERFACE;
+            }
+
+            (void)AddRef();
+            return S_OK;
+        }
+
+        STDMETHOD_(ULONG, AddRef)() override
+        {
+            return ++_refCount;
+        }
+
+        STDMETHOD_(ULONG, Release)() override
+        {
+            uint32_t c = --_refCount;
+            if (c == 0)
+                delete this;
+            return c;
+        }
+    };
+
+    template<typename T, typename TInterface, typename... Ts>
+    HRESULT CreateSymObject(TInterface** ppObj, Ts&&... args)
+    {
+        T* obj = new (std::nothrow) T(std::forward<Ts>(args)...);
+        if (obj == nullptr)
+            return E_OUTOFMEMORY;
+
+        // The object is created with a reference count of one, which is handed to the caller.
+        *ppObj = obj;
+        return S_OK;
+    }
+
+    // Portable PDBs only record namespace names, so namespaces have no nested namespaces or variables.
+    class SymNamespace final : public SymObject<ISymUnmanagedNamespace, IID_ISymUnmanagedNamespace>
+    {
+        std::string _name;
+
+    public:
+        explicit SymNamespace(std::string name)
+            : _name{ std::move(name) }
+        { }
+
+    public: // ISymUnmanagedNamespace
+        STDMETHOD(GetName)(
+            ULONG32 cchName,
+            ULONG32 *pcchName,
+            WCHAR szName[]) override
+        {
+            return ReturnUtf16Output(_name.c_str(), cchName, pcchName, szName);
+        }
+
+        STDMETHOD(GetNamespaces)(
+            ULONG32 cNameSpaces,
+            ULONG32 *pcNameSpaces,
+            ISymUnmanagedNamespace *namespaces[]) override
+        {
+            UNREFERENCED_PARAMETER(cNameSpaces);
+            UNREFERENCED_PARAMETER(namespaces);
+            if (pcNameSpaces == nullptr)
+                return E_INVALIDARG;
+            *pcNameSpaces = 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetVariables)(
+            ULONG32 cVars,
+            ULONG32 *pcVars,
+            ISymUnmanagedVariable *pVars[]) override
+        {
+            UNREFERENCED_PARAMETER(cVars);
+            UNREFERENCED_PARAMETER(pVars);
+            if (pcVars == nullptr)
+                return E_INVALIDARG;
+            *pcVars = 0;
+            return S_OK;
+        }
+    };
+
+    HRESULT ReturnNamespaces(
+        std::vector<std::string> const& names,
+        ULONG32 cNameSpaces,
+        ULONG32 *pcNameSpaces,
+        ISymUnmanagedNamespace *namespaces[])
+    {
+        if (pcNameSpaces == nullptr)
+            return E_INVALIDARG;
+
+        if (namespaces == nullptr || cNameSpaces == 0)
+        {
+            *pcNameSpaces = (uint32_t)names.size();
+            return S_OK;
+        }
+
+        HRESULT hr;
+        uint32_t returned = std::min<uint32_t>(cNameSpaces, (uint32_t)names.size());
+        for (uint32_t i = 0; i < returned; ++i)
+        {
+            hr = CreateSymObject<SymNamespace>(&namespaces[i], names[i]);
+            if (FAILED(hr))
+            {
+                for (uint32_t j = 0; j < i; ++j)
+                    (void)namespaces[j]->Release();
+                return hr;
+            }
+        }
+        *pcNameSpaces = returned;
+        return S_OK;
+    }
+
+    class SymReader;
+    class SymMethod;
+
+    class SymDocument final : public SymObject<ISymUnmanagedDocument, IID_ISymUnmanagedDocument>
+    {
+        dncp::com_ptr<SymReader> _reader;
+        mdcursor_t _document;
+
+    public:
+        SymDocument(dncp::com_ptr<SymReader> reader, mdcursor_t document)
+            : _reader{ std::move(reader) }
+            , _document{ document }
+        { }
+
+    public: // ISymUnmanagedDocument
+        STDMETHOD(GetURL)(
+            ULONG32 cchUrl,
+            ULONG32 *pcchUrl,
+            WCHAR szUrl[]) override
+        {
+            char const* path;
+            uint32_t pathLength;
+            if (!md_get_document_path(_document, &path, &pathLength))
+                return CLDB_E_FILE_CORRUPT;
+            return ReturnUtf16Output(path, cchUrl, pcchUrl, szUrl);
+        }
+
+        STDMETHOD(GetDocumentType)(GUID *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = DocumentTypeText;
+            return S_OK;
+        }
+
+        STDMETHOD(GetLanguage)(GUID *pRetVal) override
+        {
+            return ReturnGuidColumn(_document, mdtDocument_Language, pRetVal);
+        }
+
+        STDMETHOD(GetLanguageVendor)(GUID *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = LanguageVendorMicrosoft;
+            return S_OK;
+        }
+
+        STDMETHOD(GetCheckSumAlgorithmId)(GUID *pRetVal) override
+        {
+            return ReturnGuidColumn(_document, mdtDocument_HashAlgorithm, pRetVal);
+        }
+
+        STDMETHOD(GetCheckSum)(
+            ULONG32 cData,
+            ULONG32 *pcData,
+            BYTE data[]) override
+        {
+            if (pcData == nullptr)
+                return E_INVALIDARG;
+
+            uint8_t const* hash;
+            uint32_t hashLength;
+            if (!md_get_column_value_as_blob(_document, mdtDocument_Hash, &hash, &hashLength))
+                return CLDB_E_FILE_CORRUPT;
+
+            *pcData = hashLength;
+            if (data == nullptr || cData == 0)
+                return S_OK;
+
+            if (cData < hashLength)
+                return E_NOT_SUFFICIENT_BUFFER;
+
+            std::memcpy(data, hash, hashLength);
+            return S_OK;
+        }
+
+        STDMETHOD(FindClosestLine)(
+            ULONG32 line,
+            ULONG32 *pRetVal) override;
+
+        STDMETHOD(HasEmbeddedSource)(BOOL *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            md_custom_debug_information_t source;
+            RETURN_IF_FAILED(FindEmbeddedSource(&source));
+            *pRetVal = hr == S_OK ? TRUE : FALSE;
+            return S_OK;
+        }
+
+        STDMETHOD(GetSourceLength)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            md_custom_debug_information_t source;
+            RETURN_IF_FAILED(FindEmbeddedSource(&source));
+            *pRetVal = hr == S_OK ? source.value_len : 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetSourceRange)(
+            ULONG32 startLine,
+            ULONG32 startColumn,
+            ULONG32 endLine,
+            ULONG32 endColumn,
+            ULONG32 cSourceBytes,
+            ULONG32 *pcSourceBytes,
+            BYTE source[]) override
+        {
+            if (pcSourceBytes == nullptr)
+                return E_INVALIDARG;
+
+            // The embedded source is returned as stored, a format header followed by the raw or
+            // deflated text, so only the whole document can be requested.
+            if (startLine != 0 || startColumn != 0 || endLine < DocumentEnd || endColumn < DocumentEnd)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            md_custom_debug_information_t embeddedSource;
+            RETURN_IF_FAILED(FindEmbeddedSource(&embeddedSource));
+            uint32_t length = hr == S_OK ? embeddedSource.value_len : 0;
+
+            *pcSourceBytes = length;
+            if (source == nullptr || cSourceBytes == 0 || length == 0)
+                return S_OK;
+
+            if (cSourceBytes < length)
+                return E_NOT_SUFFICIENT_BUFFER;
+
+            std::memcpy(source, embeddedSource.value, length);
+            return S_OK;
+        }
+
+    private:
+        // Returns S_FALSE if the document doesn't have embedded source.
+        HRESULT FindEmbeddedSource(md_custom_debug_information_t* source);
+    };
+
+    class SymVariable final : public SymObject<ISymUnmanagedVariable, IID_ISymUnmanagedVariable>
+    {
+        dncp::com_ptr<SymReader> _reader;
+        mdcursor_t _variable;
+        mdSignature _localSignature;
+        uint32_t _startOffset;
+        uint32_t _endOffset;
+
+    public:
+        SymVariable(dncp::com_ptr<SymReader> reader, mdcursor_t variable, mdSignature localSignature, uint32_t startOffset, uint32_t endOffset)
+            : _reader{ std::move(reader) }
+            , _variable{ variable }
+            , _localSignature{ localSignature }
+            , _startOffset{ startOffset }
+            , _endOffset{ endOffset }
+        { }
+
+    public: // ISymUnmanagedVariable
+        STDMETHOD(GetName)(
+            ULONG32 cchName,
+            ULONG32 *pcchName,
+            WCHAR szName[]) override
+        {
+            char const* name;
+            if (!md_get_column_value_as_utf8(_variable, mdtLocalVariable_Name, &name))
+                return CLDB_E_FILE_CORRUPT;
+            return ReturnUtf16Output(name, cchName, pcchName, szName);
+        }
+
+        STDMETHOD(GetAttributes)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            uint32_t attributes;
+            if (!md_get_column_value_as_constant(_variable, mdtLocalVariable_Attributes, &attributes))
+                return CLDB_E_FILE_CORRUPT;
+
+            // The DebuggerHidden attribute is the only defined attribute and matches VAR_IS_COMP_GEN.
+            *pRetVal = attributes;
+            return S_OK;
+        }
+
+        STDMETHOD(GetSignature)(
+            ULONG32 cSig,
+            ULONG32 *pcSig,
+            BYTE sig[]) override;
+
+        STDMETHOD(GetAddressKind)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = ADDR_IL_OFFSET;
+            return S_OK;
+        }
+
+        STDMETHOD(GetAddressField1)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            // The local variable slot.
+            uint32_t index;
+            if (!md_get_column_value_as_constant(_variable, mdtLocalVariable_Index, &index))
+                return CLDB_E_FILE_CORRUPT;
+
+            *pRetVal = index;
+            return S_OK;
+        }
+
+        STDMETHOD(GetAddressField2)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetAddressField3)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetStartOffset)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = _startOffset;
+            return S_OK;
+        }
+
+        STDMETHOD(GetEndOffset)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = _endOffset;
+            return S_OK;
+        }
+    };
+
+    // The lines of a sequence point of a method.
+    struct SourceLine final
+    {
+        uint32_t document;
+        uint32_t startLine;
+        uint32_t endLine;
+        mdMethodDef method;
+    };
+
+    // The lines of a document covered by the sequence points of a method.
+    struct MethodExtent final
+    {
+        uint32_t document;
+        mdMethodDef method;
+        uint32_t startLine;
+        uint32_t endLine;
+    };
+
+    // Get the entries of a document from entries sorted by document.
+    template<typename T>
+    std::pair<typename std::vector<T>::const_iterator, typename std::vector<T>::const_iterator> GetDocumentEntries(std::vector<T> const& entries, uint32_t document)
+    {
+        auto begin = std::lower_bound(entries.begin(), entries.end(), document, [](T const& entry, uint32_t d) { return entry.document < d; });
+        auto end = std::upper_bound(begin, entries.end(), document, [](uint32_t d, T const& entry) { return d < entry.document; });
+        return { begin, end };
+    }
+
+    class SymReader final : public SymObject<ISymUnmanagedReader, IID_ISymUnmanagedReader>
+    {
+        // The handle is declared last so it is destroyed before the memory it reads.
+        dncp::com_ptr<IMetaDataImport> _importer;
+        pal::MappedFile _file;
+        malloc_ptr<void> _copy;
+        std::vector<WCHAR> _fileName;
+        mdhandle_ptr _handle;
+
+        // The lines of every sequence point are read on the first position lookup.
+        std::once_flag _linesLoaded;
+        HRESULT _linesResult;
+        std::vector<SourceLine> _lines; // Sorted by document and start line
+        std::vector<MethodExtent> _extents; // Sorted by document and method
+
+        HRESULT ReadLines();
+
+        dncp::com_ptr<SymReader> This()
+        {
+            (void)AddRef();
+            dncp::com_ptr<SymReader> reader;
+            reader.Attach(this);
+            return reader;
+        }
+
+    public:
+        SymReader(dncp::com_ptr<IMetaDataImport> importer, pal::MappedFile file, malloc_ptr<void> copy, std::vector<WCHAR> fileName, mdhandle_ptr handle)
+            : _importer{ std::move(importer) }
+            , _file{ std::move(file) }
+            , _copy{ std::move(copy) }
+            , _fileName{ std::move(fileName) }
+            , _handle{ std::move(handle) }
+            , _linesResult{ S_OK }
+        { }
+
+        mdhandle_t MetaData() const
+        {
+            return _handle.get();
+        }
+
+        // The module's metadata, null if the reader wasn't given an importer.
+        IMetaDataImport* Importer() const
+        {
+            return _importer.get();
+        }
+
+        std::vector<SourceLine> const& Lines() const
+        {
+            return _lines;
+        }
+
+        HRESULT LoadLines();
+
+        // Find the Document row of a document by its URL, documents of other readers are accepted.
+        HRESULT FindDocumentRow(ISymUnmanagedDocument* document, uint32_t* row);
+
+        // Append the namespaces imported by an ImportScope and the scopes enclosing it, innermost first.
+        HRESULT GetImportedNamespaces(mdToken importScope, std::vector<std::string>& names);
+
+    public: // ISymUnmanagedReader
+        STDMETHOD(GetDocument)(
+            WCHAR *url,
+            GUID language,
+            GUID languageVendor,
+            GUID documentType,
+            ISymUnmanagedDocument **pRetVal) override
+        {
+            UNREFERENCED_PARAMETER(language);
+            UNREFERENCED_PARAMETER(languageVendor);
+            UNREFERENCED_PARAMETER(documentType);
+            if (url == nullptr || pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            *pRetVal = nullptr;
+            pal::StringConvert<WCHAR, char> cvt(url);
+            if (!cvt.Success())
+                return E_INVALIDARG;
+
+            // Prefer an exact match, but paths are commonly compared without case.
+            mdcursor_t document;
+            int32_t count = md_find_documents(MetaData(), cvt, mddm_Exact, 1, &document);
+            if (count == 0)
+                count = md_find_documents(MetaData(), cvt, mddm_IgnoreCase, 1, &document);
+
+            if (count < 0)
+                return CLDB_E_FILE_CORRUPT;
+            if (count == 0)
+                return S_FALSE;
+
+            return CreateSymObject<SymDocument>(pRetVal, This(), document);
+        }
+
+        STDMETHOD(GetDocuments)(
+            ULONG32 cDocs,
+            ULONG32 *pcDocs,
+            ISymUnmanagedDocument *pDocs[]) override
+        {
+            if (pcDocs == nullptr)
+                return E_INVALIDARG;
+
+            mdcursor_t document;
+            uint32_t count;
+            if (!md_create_cursor(MetaData(), mdtid_Document, &document, &count))
+                count = 0;
+
+            if (pDocs == nullptr || cDocs == 0)
+            {
+                *pcDocs = count;
+                return S_OK;
+            }
+
+            HRESULT hr;
+            uint32_t returned = std::min<uint32_t>(cDocs, count);
+            for (uint32_t i = 0; i < returned; ++i)
+            {
+                hr = CreateSymObject<SymDocument>(&pDocs[i], This(), document);
+                if (FAILED(hr))
+                {
+                    for (uint32_t j = 0; j < i; ++j)
+                        (void)pDocs[j]->Release();
+                    return hr;
+                }
+                (void)md_cursor_next(&document);
+            }
+            *pcDocs = returned;
+            return S_OK;
+        }
+
+        STDMETHOD(GetUserEntryPoint)(mdMethodDef *pToken) override
+        {
+            if (pToken == nullptr)
+                return E_INVALIDARG;
+
+            mdToken entryPoint;
+            if (!md_get_pdb_entry_point(MetaData(), &entryPoint))
+                return CLDB_E_FILE_CORRUPT;
+
+            if (IsNilToken(entryPoint))
+                return E_FAIL;
+
+            *pToken = entryPoint;
+            return S_OK;
+        }
+
+        STDMETHOD(GetMethod)(
+            mdMethodDef token,
+            ISymUnmanagedMethod **pRetVal) override;
+
+        STDMETHOD(GetMethodByVersion)(
+            mdMethodDef token,
+            int version,
+            ISymUnmanagedMethod **pRetVal) override
+        {
+            // Portable PDBs only have the one version.
+            if (version != 1)
+                return E_INVALIDARG;
+            return GetMethod(token, pRetVal);
+        }
+
+        STDMETHOD(GetVariables)(
+            mdToken parent,
+            ULONG32 cVars,
+            ULONG32 *pcVars,
+            ISymUnmanagedVariable *pVars[]) override
+        {
+            // Portable PDBs only have variables in local scopes.
+            UNREFERENCED_PARAMETER(parent);
+            UNREFERENCED_PARAMETER(cVars);
+            UNREFERENCED_PARAMETER(pVars);
+            if (pcVars == nullptr)
+                return E_INVALIDARG;
+            *pcVars = 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetGlobalVariables)(
+            ULONG32 cVars,
+            ULONG32 *pcVars,
+            ISymUnmanagedVariable *pVars[]) override
+        {
+            UNREFERENCED_PARAMETER(cVars);
+            UNREFERENCED_PARAMETER(pVars);
+            if (pcVars == nullptr)
+                return E_INVALIDARG;
+            *pcVars = 0;
+            return S_OK;
+        }
+
+        STDMETHOD(GetMethodFromDocumentPosition)(
+            ISymUnmanagedDocument *document,
+            ULONG32 line,
+            ULONG32 column,
+            ISymUnmanagedMethod **pRetVal) override;
+
+        STDMETHOD(GetSymAttribute)(
+            mdToken parent,
+            WCHAR *name,
+            ULONG32 cBuffer,
+            ULONG32 *pcBuffer,
+            BYTE buffer[]) override
+        {
+            // Portable PDBs record custom debug information instead of symbol attributes.
+            UNREFERENCED_PARAMETER(parent);
+            UNREFERENCED_PARAMETER(name);
+            UNREFERENCED_PARAMETER(cBuffer);
+            UNREFERENCED_PARAMETER(buffer);
+            if (pcBuffer == nullptr)
+                return E_INVALIDARG;
+            *pcBuffer = 0;
+            return S_FALSE;
+        }
+
+        STDMETHOD(GetNamespaces)(
+            ULONG32 cNameSpaces,
+            ULONG32 *pcNameSpaces,
+            ISymUnmanagedNamespace *namespaces[]) override
+        {
+            if (pcNameSpaces == nullptr)
+                return E_INVALIDARG;
+
+            // The global namespaces are the imports of the root import scopes, e.g. project level imports in VB.
+            HRESULT hr;
+            std::vector<std::string> names;
+            mdcursor_t importScope;
+            uint32_t count;
+            if (!md_create_cursor(MetaData(), mdtid_ImportScope, &importScope, &count))
+                count = 0;
+
+            for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&importScope))
+            {
+                mdToken parent;
+                mdToken token;
+                if (!md_get_column_value_as_token(importScope, mdtImportScope_Parent, &parent)
+                    || !md_cursor_to_token(importScope, &token))
+                {
+                    return CLDB_E_FILE_CORRUPT;
+                }
+
+                if (IsNilToken(parent))
+                    RETURN_IF_FAILED(GetImportedNamespaces(token, names));
+            }
+            return ReturnNamespaces(names, cNameSpaces, pcNameSpaces, namespaces);
+        }
+
+        STDMETHOD(Initialize)(
+            IUnknown *importer,
+            const WCHAR *filename,
+            const WCHAR *searchPath,
+            IStream *pIStream) override
+        {
+            // Readers are initialized by the binder.
+            UNREFERENCED_PARAMETER(importer);
+            UNREFERENCED_PARAMETER(filename);
+            UNREFERENCED_PARAMETER(searchPath);
+            UNREFERENCED_PARAMETER(pIStream);
+            return E_NOTIMPL;
+        }
+
+        STDMETHOD(UpdateSymbolStore)(
+            const WCHAR *filename,
+            IStream *pIStream) override
+        {
+            // Portable PDBs don't have delta symbol stores, Edit and Continue updates are read from the image.
+            UNREFERENCED_PARAMETER(filename);
+            UNREFERENCED_PARAMETER(pIStream);
+            return E_NOTIMPL;
+        }
+
+        STDMETHOD(ReplaceSymbolStore)(
+            const WCHAR *filename,
+            IStream *pIStream) override
+        {
+            UNREFERENCED_PARAMETER(filename);
+            UNREFERENCED_PARAMETER(pIStream);
+            return E_NOTIMPL;
+        }
+
+        STDMETHOD(GetSymbolStoreFileName)(
+            ULONG32 cchName,
+            ULONG32 *pcchName,
+            WCHAR szName[]) override
+        {
+            if (pcchName == nullptr && szName == nullptr)
+                return E_INVALIDARG;
+
+            // Readers over a stream don't have a file name.
+            if (_fileName.empty())
+                return E_FAIL;
+
+            uint32_t length = (uint32_t)_fileName.size();
+            if (pcchName != nullptr)
+                *pcchName = length;
+
+            if (szName == nullptr || cchName == 0)
+                return S_OK;
+
+            if (cchName < length)
+                return E_NOT_SUFFICIENT_BUFFER;
+
+            std::memcpy(szName, _fileName.data(), length * sizeof(WCHAR));
+            return S_OK;
+        }
+
+        STDMETHOD(GetMethodsFromDocumentPosition)(
+            ISymUnmanagedDocument *document,
+            ULONG32 line,
+            ULONG32 column,
+            ULONG32 cMethod,
+            ULONG32 *pcMethod,
+            ISymUnmanagedMethod *pRetVal[]) override;
+
+        STDMETHOD(GetDocumentVersion)(
+            ISymUnmanagedDocument *pDoc,
+            int *version,
+            BOOL *pbCurrent) override
+        {
+            if (pDoc == nullptr || version == nullptr || pbCurrent == nullptr)
+                return E_INVALIDARG;
+            *version = 1;
+            *pbCurrent = TRUE;
+            return S_OK;
+        }
+
+        STDMETHOD(GetMethodVersion)(
+            ISymUnmanagedMethod *pMethod,
+            int *version) override
+        {
+            if (pMethod == nullptr || version == nullptr)
+                return E_INVALIDARG;
+            *version = 1;
+            return S_OK;
+        }
+    };
+
+    // A LocalScope row of a method and the index of its enclosing scope.
+    struct ScopeInfo final
+    {
+        mdcursor_t scope;
+        uint32_t startOffset;
+        uint32_t endOffset;
+        uint32_t parent; // Index of the enclosing scope + 1, 0 for the root scope
+    };
+
+    class SymMethod final : public SymObject<ISymUnmanagedMethod, IID_ISymUnmanagedMethod>
+    {
+        dncp::com_ptr<SymReader> _reader;
+        mdcursor_t _methodDebugInformation;
+        mdMethodDef _token;
+
+        // The scopes are read on first use, in the nested order of the LocalScope table.
+        std::once_flag _scopesLoaded;
+        HRESULT _scopesResult;
+        std::vector<ScopeInfo> _scopes;
+
+        HRESULT LoadScopes();
+
+        HRESULT InitSequencePointIterator(md_sequence_point_iterator_t* iterator, bool* hasSequencePoints)
+        {
+            uint8_t const* blob;
+            uint32_t blobLength;
+            if (!md_get_column_value_as_blob(_methodDebugInformation, mdtMethodDebugInformation_SequencePoints, &blob, &blobLength))
+                return CLDB_E_FILE_CORRUPT;
+
+            *hasSequencePoints = blobLength != 0;
+            if (blobLength == 0)
+                return S_OK;
+
+            if (md_sequence_point_iterator_init(_methodDebugInformation, blob, blobLength, iterator) != mdbpr_Success)
+                return CLDB_E_FILE_CORRUPT;
+            return S_OK;
+        }
+
+        dncp::com_ptr<SymMethod> This()
+        {
+            (void)AddRef();
+            dncp::com_ptr<SymMethod> method;
+            method.Attach(this);
+            return method;
+        }
+
+    public:
+        SymMethod(dncp::com_ptr<SymReader> reader, mdcursor_t methodDebugInformation, mdMethodDef token)
+            : _reader{ std::move(reader) }
+            , _methodDebugInformation{ methodDebugInformation }
+            , _token{ token }
+            , _scopesResult{ S_OK }
+        { }
+
+        dncp::com_ptr<SymReader> const& Reader() const
+        {
+            return _reader;
+        }
+
+        std::vector<ScopeInfo> const& Scopes() const
+        {
+            return _scopes;
+        }
+
+        // The StandAloneSig of the locals, which is recorded in the header of the sequence points blob.
+        mdSignature LocalSignature()
+        {
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            if (FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints)) || !hasSequencePoints)
+                return mdSignatureNil;
+            return TokenFromRid(iterator.signature, mdtSignature);
+        }
+
+        HRESULT CreateScope(uint32_t index, ISymUnmanagedScope** ppScope);
+
+    public: // ISymUnmanagedMethod
+        STDMETHOD(GetToken)(mdMethodDef *pToken) override
+        {
+            if (pToken == nullptr)
+                return E_INVALIDARG;
+            *pToken = _token;
+            return S_OK;
+        }
+
+        STDMETHOD(GetSequencePointCount)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            RETURN_IF_FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints));
+
+            uint32_t count = 0;
+            md_sequence_point_t sequencePoint;
+            while (hasSequencePoints && md_sequence_point_iterator_next(&iterator, &sequencePoint))
+            {
+                if (sequencePoint.kind != mdsp_DocumentRecord)
+                    count++;
+            }
+
+            if (hasSequencePoints && md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+                return CLDB_E_FILE_CORRUPT;
+
+            *pRetVal = count;
+            return S_OK;
+        }
+
+        STDMETHOD(GetRootScope)(ISymUnmanagedScope **pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            *pRetVal = nullptr;
+            HRESULT hr;
+            RETURN_IF_FAILED(LoadScopes());
+            if (_scopes.empty())
+                return E_FAIL;
+            return CreateScope(0, pRetVal);
+        }
+
+        STDMETHOD(GetScopeFromOffset)(
+            ULONG32 offset,
+            ISymUnmanagedScope **pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            *pRetVal = nullptr;
+            HRESULT hr;
+            RETURN_IF_FAILED(LoadScopes());
+            if (_scopes.empty())
+                return E_FAIL;
+
+            // Use the local scope index to find the innermost scope at the offset.
+            md_local_scope_t innermost;
+            int32_t count = md_find_local_scopes(_reader->MetaData(), _token, offset, 1, &innermost);
+            if (count < 0)
+                return CLDB_E_FILE_CORRUPT;
+
+            // Offsets outside of every scope map to the root scope.
+            uint32_t index = 0;
+            mdToken innermostToken;
+            if (count > 0 && md_cursor_to_token(innermost.scope, &innermostToken))
+            {
+                for (uint32_t i = 0; i < (uint32_t)_scopes.size(); ++i)
+                {
+                    mdToken scopeToken;
+                    if (md_cursor_to_token(_scopes[i].scope, &scopeToken) && scopeToken == innermostToken)
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+            }
+            return CreateScope(index, pRetVal);
+        }
+
+        STDMETHOD(GetOffset)(
+            ISymUnmanagedDocument *document,
+            ULONG32 line,
+            ULONG32 column,
+            ULONG32 *pRetVal) override
+        {
+            // Columns are ignored, the first sequence point on the line is used.
+            UNREFERENCED_PARAMETER(column);
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            uint32_t documentRow;
+            RETURN_IF_FAILED(_reader->FindDocumentRow(document, &documentRow));
+
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            RETURN_IF_FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints));
+
+            md_sequence_point_t sequencePoint;
+            while (hasSequencePoints && md_sequence_point_iterator_next(&iterator, &sequencePoint))
+            {
+                if (sequencePoint.kind == mdsp_SequencePointRecord
+                    && GetRow(sequencePoint.document) == documentRow
+                    && sequencePoint.start_line <= line && line <= sequencePoint.end_line)
+                {
+                    *pRetVal = sequencePoint.il_offset;
+                    return S_OK;
+                }
+            }
+
+            if (hasSequencePoints && md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+                return CLDB_E_FILE_CORRUPT;
+            return E_FAIL;
+        }
+
+        STDMETHOD(GetRanges)(
+            ISymUnmanagedDocument *document,
+            ULONG32 line,
+            ULONG32 column,
+            ULONG32 cRanges,
+            ULONG32 *pcRanges,
+            ULONG32 ranges[]) override
+        {
+            UNREFERENCED_PARAMETER(column);
+            if (pcRanges == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            uint32_t documentRow;
+            RETURN_IF_FAILED(_reader->FindDocumentRow(document, &documentRow));
+
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            RETURN_IF_FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints));
+
+            // Each sequence point on the line covers the IL up to the next sequence point, or the end of the method.
+            // The ranges are written as start and end offset pairs, a zero count only counts the offsets.
+            bool countOnly = ranges == nullptr || cRanges == 0;
+            uint32_t capacity = countOnly ? UINT32_MAX : cRanges / 2;
+            uint32_t count = 0;
+            bool inRange = false;
+            md_sequence_point_t sequencePoint;
+            while (hasSequencePoints && count < capacity && md_sequence_point_iterator_next(&iterator, &sequencePoint))
+            {
+                if (sequencePoint.kind == mdsp_DocumentRecord)
+                    continue;
+
+                if (inRange)
+                {
+                    if (!countOnly)
+                        ranges[count * 2 + 1] = sequencePoint.il_offset;
+                    count++;
+                    inRange = false;
+                }
+
+                if (count < capacity
+                    && sequencePoint.kind == mdsp_SequencePointRecord
+                    && GetRow(sequencePoint.document) == documentRow
+                    && sequencePoint.start_line <= line && line <= sequencePoint.end_line)
+                {
+                    if (!countOnly)
+                        ranges[count * 2] = sequencePoint.il_offset;
+                    inRange = true;
+                }
+            }
+
+            if (hasSequencePoints && md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+                return CLDB_E_FILE_CORRUPT;
+
+            if (inRange)
+            {
+                // The root scope covers the whole method body.
+                RETURN_IF_FAILED(LoadScopes());
+                if (!countOnly)
+                    ranges[count * 2 + 1] = _scopes.empty() ? UINT32_MAX : _scopes[0].endOffset;
+                count++;
+            }
+
+            *pcRanges = count * 2;
+            return S_OK;
+        }
+
+        STDMETHOD(GetParameters)(
+            ULONG32 cParams,
+            ULONG32 *pcParams,
+            ISymUnmanagedVariable *params[]) override
+        {
+            // Parameter names live in the image, not the Portable PDB.
+            UNREFERENCED_PARAMETER(cParams);
+            UNREFERENCED_PARAMETER(pcParams);
+            UNREFERENCED_PARAMETER(params);
+            return E_NOTIMPL;
+        }
+
+        STDMETHOD(GetNamespace)(ISymUnmanagedNamespace **pRetVal) override;
+
+        STDMETHOD(GetSourceStartEnd)(
+            ISymUnmanagedDocument *docs[2],
+            ULONG32 lines[2],
+            ULONG32 columns[2],
+            BOOL *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            *pRetVal = FALSE;
+            HRESULT hr;
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            RETURN_IF_FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints));
+
+            // The source of the method spans from the first to the last visible sequence point.
+            bool found = false;
+            md_sequence_point_t first;
+            md_sequence_point_t last;
+            md_sequence_point_t sequencePoint;
+            while (hasSequencePoints && md_sequence_point_iterator_next(&iterator, &sequencePoint))
+            {
+                if (sequencePoint.kind != mdsp_SequencePointRecord)
+                    continue;
+
+                if (!found)
+                    first = sequencePoint;
+                last = sequencePoint;
+                found = true;
+            }
+
+            if (hasSequencePoints && md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+                return CLDB_E_FILE_CORRUPT;
+
+            if (!found)
+                return S_OK;
+
+            if (docs != nullptr)
+            {
+                RETURN_IF_FAILED(CreateSymObject<SymDocument>(&docs[0], _reader, first.document));
+                hr = CreateSymObject<SymDocument>(&docs[1], _reader, last.document);
+                if (FAILED(hr))
+                {
+                    (void)docs[0]->Release();
+                    docs[0] = nullptr;
+                    return hr;
+                }
+            }
+
+            if (lines != nullptr)
+            {
+                lines[0] = first.start_line;
+                lines[1] = last.end_line;
+            }
+
+            if (columns != nullptr)
+            {
+                columns[0] = first.start_column;
+                columns[1] = last.end_column;
+            }
+
+            *pRetVal = TRUE;
+            return S_OK;
+        }
+
+        STDMETHOD(GetSequencePoints)(
+            ULONG32 cPoints,
+            ULONG32 *pcPoints,
+            ULONG32 offsets[],
+            ISymUnmanagedDocument *documents[],
+            ULONG32 lines[],
+            ULONG32 columns[],
+            ULONG32 endLines[],
+            ULONG32 endColumns[]) override
+        {
+            if (pcPoints == nullptr)
+                return E_INVALIDARG;
+
+            HRESULT hr;
+            md_sequence_point_iterator_t iterator;
+            bool hasSequencePoints;
+            RETURN_IF_FAILED(InitSequencePointIterator(&iterator, &hasSequencePoints));
+
+            // Decode the records straight into the caller's arrays, a zero count only counts the points.
+            uint32_t count = 0;
+            md_sequence_point_t sequencePoint;
+            while (hasSequencePoints && md_sequence_point_iterator_next(&iterator, &sequencePoint))
+            {
+                if (sequencePoint.kind == mdsp_DocumentRecord)
+                    continue;
+
+                if (count < cPoints)
+                {
+                    bool hidden = sequencePoint.kind == mdsp_HiddenSequencePointRecord;
+                    if (offsets != nullptr)
+                        offsets[count] = sequencePoint.il_offset;
+                    if (lines != nullptr)
+                        lines[count] = hidden ? HiddenSequencePointLine : sequencePoint.start_line;
+                    if (columns != nullptr)
+                        columns[count] = hidden ? 0 : sequencePoint.start_column;
+                    if (endLines != nullptr)
+                        endLines[count] = hidden ? HiddenSequencePointLine : sequencePoint.end_line;
+                    if (endColumns != nullptr)
+                        endColumns[count] = hidden ? 0 : sequencePoint.end_column;
+                    if (documents != nullptr)
+                    {
+                        hr = CreateSymObject<SymDocument>(&documents[count], _reader, iterator.document);
+                        if (FAILED(hr))
+                        {
+                            for (uint32_t i = 0; i < count; ++i)
+                                (void)documents[i]->Release();
+                            return hr;
+                        }
+                    }
+                }
+                else if (cPoints != 0)
+                {
+                    break;
+                }
+                count++;
+            }
+
+            if (hasSequencePoints && md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+            {
+                if (documents != nullptr)
+                {
+                    for (uint32_t i = 0; i < std::min<uint32_t>(count, cPoints); ++i)
+                        (void)documents[i]->Release();
+                }
+                return CLDB_E_FILE_CORRUPT;
+            }
+
+            *pcPoints = count;
+            return S_OK;
+        }
+    };
+
+    class SymScope final : public SymObject<ISymUnmanagedScope, IID_ISymUnmanagedScope>
+    {
+        dncp::com_ptr<SymMethod> _method;
+        uint32_t _index;
+
+        ScopeInfo const& Info() const
+        {
+            return _method->Scopes()[_index];
+        }
+
+    public:
+        SymScope(dncp::com_ptr<SymMethod> method, uint32_t index)
+            : _method{ std::move(method) }
+            , _index{ index }
+        { }
+
+    public: // ISymUnmanagedScope
+        STDMETHOD(GetMethod)(ISymUnmanagedMethod **pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            (void)_method->AddRef();
+            *pRetVal = _method.get();
+            return S_OK;
+        }
+
+        STDMETHOD(GetParent)(ISymUnmanagedScope **pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            *pRetVal = nullptr;
+            uint32_t parent = Info().parent;
+            if (parent == 0)
+                return S_FALSE;
+            return _method->CreateScope(parent - 1, pRetVal);
+        }
+
+        STDMETHOD(GetChildren)(
+            ULONG32 cChildren,
+            ULONG32 *pcChildren,
+            ISymUnmanagedScope *children[]) override
+        {
+            if (pcChildren == nullptr)
+                return E_INVALIDARG;
+
+            // Children directly follow their parent in the nested order.
+            HRESULT hr;
+            std::vector<ScopeInfo> const& scopes = _method->Scopes();
+            uint32_t count = 0;
+            for (uint32_t i = _index + 1; i < (uint32_t)scopes.size() && scopes[i].parent >= _index + 1; ++i)
+            {
+                if (scopes[i].parent != _index + 1)
+                    continue;
+
+                if (children != nullptr && count < cChildren)
+                {
+                    hr = _method->CreateScope(i, &children[count]);
+                    if (FAILED(hr))
+                    {
+                        for (uint32_t j = 0; j < count; ++j)
+                            (void)children[j]->Release();
+                        return hr;
+                    }
+                }
+                else if (children != nullptr && cChildren != 0)
+                {
+                    break;
+                }
+                count++;
+            }
+            *pcChildren = count;
+            return S_OK;
+        }
+
+        STDMETHOD(GetStartOffset)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = Info().startOffset;
+            return S_OK;
+        }
+
+        STDMETHOD(GetEndOffset)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+            *pRetVal = Info().endOffset;
+            return S_OK;
+        }
+
+        STDMETHOD(GetLocalCount)(ULONG32 *pRetVal) override
+        {
+            if (pRetVal == nullptr)
+                return E_INVALIDARG;
+
+            mdcursor_t variables;
+            uint32_t count;
+            if (!md_get_column_value_as_range(Info().scope, mdtLocalScope_VariableList, &variables, &count))
+                return CLDB_E_FILE_CORRUPT;
+
+            *pRetVal = count;
+            return S_OK;
+        }
+
+        STDMETHOD(GetLocals)(
+            ULONG32 cLocals,
+            ULONG32 *pcLocals,
+            ISymUnmanagedVariable *locals[]) override
+        {
+            if (pcLocals == nullptr)
+                return E_INVALIDARG;
+
+            mdcursor_t variables;
+            uint32_t count;
+            if (!md_get_column_value_as_range(Info().scope, mdtLocalScope_VariableList, &variables, &count))
+                return CLDB_E_FILE_CORRUPT;
+
+            if (locals == nullptr || cLocals == 0)
+            {
+                *pcLocals = count;
+                return S_OK;
+            }
+
+            HRESULT hr;
+            uint32_t returned = std::min<uint32_t>(cLocals, count);
+            for (uint32_t i = 0; i < returned; ++i)
+            {
+                mdcursor_t variable;
+                hr = md_resolve_indirect_cursor(variables, &variable)
+                    ? CreateSymObject<SymVariable>(&locals[i], _method->Reader(), variable, _method->LocalSignature(), Info().startOffset, Info().endOffset)
+                    : CLDB_E_FILE_CORRUPT;
+                if (FAILED(hr))
+                {
+                    for (uint32_t j = 0; j < i; ++j)
+                        (void)locals[j]->Release();
+                    return hr;
+                }
+                (void)md_cursor_next(&variables);
+            }
+            *pcLocals = returned;
+            return S_OK;
+        }
+
+        STDMETHOD(GetNamespaces)(
+            ULONG32 cNameSpaces,
+            ULONG32 *pcNameSpaces,
+            ISymUnmanagedNamespace *namespaces[]) override
+        {
+            if (pcNameSpaces == nullptr)
+                return E_INVALIDARG;
+
+            mdToken importScope;
+            if (!md_get_column_value_as_token(Info().scope, mdtLocalScope_ImportScope, &importScope))
+                return CLDB_E_FILE_CORRUPT;
+
+            HRESULT hr;
+            std::vector<std::string> names;
+            RETURN_IF_FAILED(_method->Reader()->GetImportedNamespaces(importScope, names));
+            return ReturnNamespaces(names, cNameSpaces, pcNameSpaces, namespaces);
+        }
+    };
+
+    HRESULT SymReader::GetMethod(
+        mdMethodDef token,
+        ISymUnmanagedMethod **pRetVal)
+    {
+        if (pRetVal == nullptr || TypeFromToken(token) != mdtMethodDef || IsNilToken(token))
+            return E_INVALIDARG;
+
+        *pRetVal = nullptr;
+
+        // MethodDebugInformation rows match MethodDef rows one to one.
+        mdcursor_t methodDebugInformation;
+        uint32_t count;
+        if (!md_create_cursor(MetaData(), mdtid_MethodDebugInformation, &methodDebugInformation, &count)
+            || RidFromToken(token) > count
+            || !md_cursor_move(&methodDebugInformation, (int32_t)RidFromToken(token) - 1))
+        {
+            return E_FAIL;
+        }
+
+        return CreateSymObject<SymMethod>(pRetVal, This(), methodDebugInformation, token);
+    }
+
+    HRESULT SymMethod::LoadScopes()
+    {
+        std::call_once(_scopesLoaded, [&]()
+        {
+            mdcursor_t begin;
+            uint32_t tableCount;
+            if (!md_create_cursor(_reader->MetaData(), mdtid_LocalScope, &begin, &tableCount))
+                return;
+
+            // LocalScope is sorted by method, but fall back to a scan if the range can't be found.
+            mdcursor_t scope;
+            uint32_t count;
+            md_range_result_t result = md_find_range_from_cursor(begin, mdtLocalScope_Method, RidFromToken(_token), &scope, &count);
+            if (result == MD_RANGE_NOT_FOUND)
+                return;
+            bool scan = result == MD_RANGE_NOT_SUPPORTED;
+            if (scan)
+            {
+                scope = begin;
+                count = tableCount;
+            }
+
+            for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&scope))
+            {
+                mdToken method;
+                uint32_t startOffset;
+                uint32_t length;
+                if (!md_get_column_value_as_token(scope, mdtLocalScope_Method, &method)
+                    || !md_get_column_value_as_constant(scope, mdtLocalScope_StartOffset, &startOffset)
+                    || !md_get_column_value_as_constant(scope, mdtLocalScope_Length, &length))
+                {
+                    _scopesResult = CLDB_E_FILE_CORRUPT;
+                    return;
+                }
+
+                if (method != _token)
+                    continue;
+
+                try
+                {
+                    _scopes.push_back({ scope, startOffset, startOffset + length, 0 });
+                }
+                catch (std::bad_alloc const&)
+                {
+                    _scopes.clear();
+                    _scopesResult = E_OUTOFMEMORY;
+                    return;
+                }
+            }
+
+            // Order the scopes so each scope follows the scopes that enclose it.
+            std::stable_sort(_scopes.begin(), _scopes.end(), [](ScopeInfo const& l, ScopeInfo const& r)
+            {
+                if (l.startOffset != r.startOffset)
+                    return l.startOffset < r.startOffset;
+                return l.endOffset > r.endOffset;
+            });
+
+            uint32_t parent = 0;
+            for (uint32_t i = 0; i < (uint32_t)_scopes.size(); ++i)
+            {
+                ScopeInfo& info = _scopes[i];
+                while (parent != 0
+                    && (info.startOffset < _scopes[parent - 1].startOffset || info.endOffset > _scopes[parent - 1].endOffset))
+                {
+                    parent = _scopes[parent - 1].parent;
+                }
+                info.parent = parent;
+                parent = i + 1;
+            }
+        });
+        return _scopesResult;
+    }
+
+    HRESULT SymMethod::CreateScope(uint32_t index, ISymUnmanagedScope** ppScope)
+    {
+        assert(index < _scopes.size());
+        return CreateSymObject<SymScope>(ppScope, This(), index);
+    }
+
+    HRESULT SymReader::LoadLines()
+    {
+        std::call_once(_linesLoaded, [&]()
+        {
+            _linesResult = ReadLines();
+            if (FAILED(_linesResult))
+            {
+                _lines.clear();
+                _extents.clear();
+            }
+        });
+        return _linesResult;
+    }
+
+    HRESULT SymReader::ReadLines()
+    {
+        mdcursor_t methodDebugInformation;
+        uint32_t count;
+        if (!md_create_cursor(MetaData(), mdtid_MethodDebugInformation, &methodDebugInformation, &count))
+            return S_OK;
+
+        try
+        {
+            for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&methodDebugInformation))
+            {
+                uint8_t const* blob;
+                uint32_t blobLength;
+                if (!md_get_column_value_as_blob(methodDebugInformation, mdtMethodDebugInformation_SequencePoints, &blob, &blobLength))
+                    return CLDB_E_FILE_CORRUPT;
+
+                if (blobLength == 0)
+                    continue;
+
+                md_sequence_point_iterator_t iterator;
+                if (md_sequence_point_iterator_init(methodDebugInformation, blob, blobLength, &iterator) != mdbpr_Success)
+                    return CLDB_E_FILE_CORRUPT;
+
+                // MethodDebugInformation rows match MethodDef rows one to one.
+                mdMethodDef method = TokenFromRid(i + 1, mdtMethodDef);
+                size_t firstExtent = _extents.size();
+                md_sequence_point_t sequencePoint;
+                while (md_sequence_point_iterator_next(&iterator, &sequencePoint))
+                {
+                    if (sequencePoint.kind != mdsp_SequencePointRecord)
+                        continue;
+
+                    uint32_t document = GetRow(sequencePoint.document);
+                    _lines.push_back({ document, sequencePoint.start_line, sequencePoint.end_line, method });
+
+                    // Merge the lines into the extent of the method in the document.
+                    auto extent = std::find_if(_extents.begin() + firstExtent, _extents.end(), [&](MethodExtent const& e) { return e.document == document; });
+                    if (extent == _extents.end())
+                    {
+                        _extents.push_back({ document, method, sequencePoint.start_line, sequencePoint.end_line });
+                    }
+                    else
+                    {
+                        extent->startLine = std::min(extent->startLine, sequencePoint.start_line);
+                        extent->endLine = std::max(extent->endLine, sequencePoint.end_line);
+                    }
+                }
+
+                if (md_sequence_point_iterator_result(&iterator) != mdbpr_Success)
+                    return CLDB_E_FILE_CORRUPT;
+            }
+        }
+        catch (std::bad_alloc const&)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        std::sort(_lines.begin(), _lines.end(), [](SourceLine const& l, SourceLine const& r)
+        {
+            if (l.document != r.document)
+                return l.document < r.document;
+            return l.startLine < r.startLine;
+        });
+
+        // The extents are added in method order, which is kept within each document.
+        std::stable_sort(_extents.begin(), _extents.end(), [](MethodExtent const& l, MethodExtent const& r)
+        {
+            return l.document < r.document;
+        });
+        return S_OK;
+    }
+
+    HRESULT SymReader::FindDocumentRow(ISymUnmanagedDocument* document, uint32_t* row)
+    {
+        if (document == nullptr)
+            return E_INVALIDARG;
+
+        HRESULT hr;
+        ULONG32 length;
+        RETURN_IF_FAILED(document->GetURL(0, &length, nullptr));
+
+        std::vector<WCHAR> url;
+        try
+        {
+            url.resize(length + 1);
+        }
+        catch (std::bad_alloc const&)
+        {
+            return E_OUTOFMEMORY;
+        }
+        RETURN_IF_FAILED(document->GetURL((ULONG32)url.size(), &length, url.data()));
+
+        pal::StringConvert<WCHAR, char> cvt(url.data());
+        if (!cvt.Success())
+            return E_INVALIDARG;
+
+        mdcursor_t found;
+        int32_t count = md_find_documents(MetaData(), cvt, mddm_Exact, 1, &found);
+        if (count < 0)
+            return CLDB_E_FILE_CORRUPT;
+        if (count == 0)
+            return E_INVALIDARG;
+
+        *row = GetRow(found);
+        return S_OK;
+    }
+
+    HRESULT SymReader::GetImportedNamespaces(mdToken importScope, std::vector<std::string>& names)
+    {
+        mdcursor_t scope;
+        uint32_t scopeCount;
+        if (!md_create_cursor(MetaData(), mdtid_ImportScope, &scope, &scopeCount))
+            scopeCount = 0;
+
+        try
+        {
+            std::vector<uint8_t> buffer;
+            for (uint32_t depth = 0; RidFromToken(importScope) != 0; ++depth)
+            {
+                // The parents of a valid scope can't form a cycle.
+                if (depth >= scopeCount || !md_token_to_cursor(MetaData(), importScope, &scope))
+                    return CLDB_E_FILE_CORRUPT;
+
+                uint8_t const* blob;
+                uint32_t blobLength;
+                if (!md_get_column_value_as_blob(scope, mdtImportScope_Imports, &blob, &blobLength)
+                    || !md_get_column_value_as_token(scope, mdtImportScope_Parent, &importScope))
+                {
+                    return CLDB_E_FILE_CORRUPT;
+                }
+
+                size_t bufferLength = buffer.size();
+                md_blob_parse_result_t result = md_parse_imports(MetaData(), blob, blobLength, (md_imports_t*)buffer.data(), &bufferLength);
+                if (result == mdbpr_InsufficientBuffer)
+                {
+                    buffer.resize(bufferLength);
+                    result = md_parse_imports(MetaData(), blob, blobLength, (md_imports_t*)buffer.data(), &bufferLength);
+                }
+
+                if (result != mdbpr_Success)
+                    return CLDB_E_FILE_CORRUPT;
+
+                md_imports_t const* imports = (md_imports_t const*)buffer.data();
+                for (uint32_t i = 0; i < imports->count; ++i)
+                {
+                    if (imports->imports[i].kind == ImportEntry::mdidk_ImportNamespace
+                        || imports->imports[i].kind == ImportEntry::mdidk_ImportAssemblyNamespace)
+                    {
+                        names.emplace_back(imports->imports[i].target_namespace, imports->imports[i].target_namespace_len);
+                    }
+                }
+            }
+        }
+        catch (std::bad_alloc const&)
+        {
+            return E_OUTOFMEMORY;
+        }
+        return S_OK;
+    }
+
+    HRESULT SymReader::GetMethodFromDocumentPosition(
+        ISymUnmanagedDocument *document,
+        ULONG32 line,
+        ULONG32 column,
+        ISymUnmanagedMethod **pRetVal)
+    {
+        // Columns are ignored, the innermost method that spans the line is returned.
+        UNREFERENCED_PARAMETER(column);
+        if (pRetVal == nullptr)
+            return E_INVALIDARG;
+
+        *pRetVal = nullptr;
+        HRESULT hr;
+        uint32_t documentRow;
+        RETURN_IF_FAILED(FindDocumentRow(document, &documentRow));
+        RETURN_IF_FAILED(LoadLines());
+
+        MethodExtent const* closest = nullptr;
+        auto entries = GetDocumentEntries(_extents, documentRow);
+        for (auto extent = entries.first; extent != entries.second; ++extent)
+        {
+            if (extent->startLine <= line && line <= extent->endLine
+                && (closest == nullptr || extent->endLine - extent->startLine < closest->endLine - closest->startLine))
+            {
+                closest = &*extent;
+            }
+        }
+
+        if (closest == nullptr)
+            return E_FAIL;
+
+        return GetMethod(closest->method, pRetVal);
+    }
+
+    HRESULT SymReader::GetMethodsFromDocumentPosition(
+        ISymUnmanagedDocument *document,
+        ULONG32 line,
+        ULONG32 column,
+        ULONG32 cMethod,
+        ULONG32 *pcMethod,
+        ISymUnmanagedMethod *pRetVal[])
+    {
+        UNREFERENCED_PARAMETER(column);
+        if (pcMethod == nullptr)
+            return E_INVALIDARG;
+
+        HRESULT hr;
+        uint32_t documentRow;
+        RETURN_IF_FAILED(FindDocumentRow(document, &documentRow));
+        RETURN_IF_FAILED(LoadLines());
+
+        auto entries = GetDocumentEntries(_extents, documentRow);
+        auto contains = [&](MethodExtent const& extent) { return extent.startLine <= line && line <= extent.endLine; };
+        if (pRetVal == nullptr || cMethod == 0)
+        {
+            *pcMethod = (uint32_t)std::count_if(entries.first, entries.second, contains);
+            return S_OK;
+        }
+
+        uint32_t returned = 0;
+        for (auto extent = entries.first; extent != entries.second && returned < cMethod; ++extent)
+        {
+            if (!contains(*extent))
+                continue;
+
+            hr = GetMethod(extent->method, &pRetVal[returned]);
+            if (FAILED(hr))
+            {
+                for (uint32_t j = 0; j < returned; ++j)
+                    (void)pRetVal[j]->Release();
+                return hr;
+            }
+            returned++;
+        }
+        *pcMethod = returned;
+        return S_OK;
+    }
+
+    HRESULT SymDocument::FindClosestLine(
+        ULONG32 line,
+        ULONG32 *pRetVal)
+    {
+        if (pRetVal == nullptr)
+            return E_INVALIDARG;
+
+        // The closest line is the first line at or after the line that starts a sequence point.
+        HRESULT hr;
+        RETURN_IF_FAILED(_reader->LoadLines());
+        auto entries = GetDocumentEntries(_reader->Lines(), GetRow(_document));
+        auto closest = std::lower_bound(entries.first, entries.second, line, [](SourceLine const& l, uint32_t value) { return l.startLine < value; });
+        if (closest == entries.second)
+            return E_FAIL;
+
+        *pRetVal = closest->startLine;
+        return S_OK;
+    }
+
+    HRESULT SymDocument::FindEmbeddedSource(md_custom_debug_information_t* source)
+    {
+        mdToken document;
+        if (!md_cursor_to_token(_document, &document))
+            return CLDB_E_FILE_CORRUPT;
+
+        int32_t count = md_find_custom_debug_information(_reader->MetaData(), document, EmbeddedSourceKind, 1, source);
+        if (count < 0)
+            return CLDB_E_FILE_CORRUPT;
+        return count != 0 ? S_OK : S_FALSE;
+    }
+
+    HRESULT SymVariable::GetSignature(
+        ULONG32 cSig,
+        ULONG32 *pcSig,
+        BYTE sig[])
+    {
+        if (pcSig == nullptr)
+            return E_INVALIDARG;
+
+        // The type of the local is in the method's local signature in the image.
+        IMetaDataImport* importer = _reader->Importer();
+        if (importer == nullptr || IsNilToken(_localSignature))
+            return E_FAIL;
+
+        uint32_t index;
+        if (!md_get_column_value_as_constant(_variable, mdtLocalVariable_Index, &index))
+            return CLDB_E_FILE_CORRUPT;
+
+        HRESULT hr;
+        PCCOR_SIGNATURE localVarSig;
+        ULONG localVarSigLength;
+        RETURN_IF_FAILED(importer->GetSigFromToken(_localSignature, &localVarSig, &localVarSigLength));
+
+        span<uint8_t const> localType;
+        RETURN_IF_FAILED(GetLocalVarSigType({ localVarSig, localVarSigLength }, index, localType));
+
+        *pcSig = (uint32_t)localType.size();
+        if (sig == nullptr || cSig == 0)
+            return S_OK;
+
+        if (cSig < localType.size())
+            return E_NOT_SUFFICIENT_BUFFER;
+
+        std::memcpy(sig, (uint8_t const*)localType, localType.size());
+        return S_OK;
+    }
+
+    HRESULT SymMethod::GetNamespace(ISymUnmanagedNamespace **pRetVal)
+    {
+        if (pRetVal == nullptr)
+            return E_INVALIDARG;
+
+        *pRetVal = nullptr;
+
+        // Portable PDBs don't record the namespace of a method, it is the namespace of its outermost type in the image.
+        IMetaDataImport* importer = _reader->Importer();
+        if (importer == nullptr)
+            return E_FAIL;
+
+        // The out parameters aren't optional in every importer.
+        HRESULT hr;
+        mdTypeDef type;
+        ULONG length;
+        DWORD flags;
+        PCCOR_SIGNATURE signature;
+        ULONG signatureLength;
+        ULONG rva;
+        DWORD implFlags;
+        RETURN_IF_FAILED(importer->GetMethodProps(_token, &type, nullptr, 0, &length, &flags, &signature, &signatureLength, &rva, &implFlags));
+
+        // A TypeDef row id has 24 bits, so deeper nesting can only be a cycle.
+        for (uint32_t depth = 0; ; ++depth)
+        {
+            mdTypeDef enclosing;
+            hr = importer->GetNestedClassProps(type, &enclosing);
+            if (hr == CLDB_E_RECORD_NOTFOUND)
+                break;
+            RETURN_IF_FAILED(hr);
+            if (depth > 0x00ffffff)
+                return CLDB_E_FILE_CORRUPT;
+            type = enclosing;
+        }
+
+        mdToken extends;
+        RETURN_IF_FAILED(importer->GetTypeDefProps(type, nullptr, 0, &length, &flags, &extends));
+
+        std::string name;
+        try
+        {
+            std::vector<WCHAR> typeName(length + 1);
+            RETURN_IF_FAILED(importer->GetTypeDefProps(type, typeName.data(), (ULONG)typeName.size(), &length, &flags, &extends));
+
+            pal::StringConvert<WCHAR, char> cvt(typeName.data());
+            if (!cvt.Success())
+                return CLDB_E_FILE_CORRUPT;
+            name = (char const*)cvt;
+        }
+        catch (std::bad_alloc const&)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        size_t separator = name.rfind('.');
+        if (separator == std::string::npos)
+            return S_FALSE;
+
+        name.resize(separator);
+        return CreateSymObject<SymNamespace>(pRetVal, std::move(name));
+    }
+
+    HRESULT CreateSymReader(
+        IUnknown* importer,
+        pal::MappedFile file,
+        malloc_ptr<void> copy,
+        std::vector<WCHAR> fileName,
+        void const* pdb,
+        size_t pdbSize,
+        ISymUnmanagedReader** ppReader)
+    {
+        mdhandle_t handle;
+        if (!md_create_handle(pdb, pdbSize, &handle))
+            return CLDB_E_FILE_CORRUPT;
+
+        mdhandle_ptr handlePtr{ handle };
+
+        // Only Portable PDBs have a #Pdb stream.
+        mdToken entryPoint;
+        if (!md_get_pdb_entry_point(handle, &entryPoint))
+            return CLDB_E_FILE_CORRUPT;
+
+        // Without an importer only the signatures and namespaces from the image are unavailable.
+        dncp::com_ptr<IMetaDataImport> metadataImport;
+        if (importer != nullptr)
+            (void)importer->QueryInterface(IID_IMetaDataImport, (void**)&metadataImport);
+
+        return CreateSymObject<SymReader>(ppReader, std::move(metadataImport), std::move(file), std::move(copy), std::move(fileName), std::move(handlePtr));
+    }
+}
+
+HRESULT CreateSymReaderForFile(
+    IUnknown* importer,
+    WCHAR const* pdbPath,
+    ISymUnmanagedReader** ppReader)
+{
+    if (pdbPath == nullptr || ppReader == nullptr)
+        return E_INVALIDARG;
+
+    *ppReader = nullptr;
+    pal::MappedFile file;
+    if (!file.Open(pdbPath))
+        return E_FAIL;
+
+    std::vector<WCHAR> fileName;
+    try
+    {
+        size_t length = 0;
+        while (pdbPath[length] != 0)
+            length++;
+        fileName.assign(pdbPath, pdbPath + length + 1);
+    }
+    catch (std::bad_alloc const&)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    void const* pdb = file.Data();
+    size_t pdbSize = file.Size();
+    return CreateSymReader(importer, std::move(file), nullptr, std::move(fileName), pdb, pdbSize, ppReader);
+}
+
+HRESULT CreateSymReaderFromStream(
+    IUnknown* importer,
+    IStream* pStream,
+    ISymUnmanagedReader** ppReader)
+{
+    if (pStream == nullptr || ppReader == nullptr)
+        return E_INVALIDARG;
+
+    *ppReader = nullptr;
+    HRESULT hr;
+    STATSTG stat;
+    RETURN_IF_FAILED(pStream->Stat(&stat, STATFLAG_NONAME));
+    if (stat.cbSize.QuadPart == 0 || stat.cbSize.QuadPart > UINT32_MAX)
+        return E_INVALIDARG;
+
+    // Streams can't be mapped, so the reader owns a copy.
+    ULONG size = (ULONG)stat.cbSize.QuadPart;
+    malloc_ptr<void> copy{ ::malloc(size) };
+    if (copy == nullptr)
+        return E_OUTOFMEMORY;
+
+    ULONG totalRead = 0;
+    while (totalRead < size)
+    {
+        ULONG read = 0;
+        RETURN_IF_FAILED(pStream->Read((uint8_t*)copy.get() + totalRead, size - totalRead, &read));
+        if (read == 0)
+            return E_FAIL;
+        totalRead += read;
+    }
+
+    void const* pdb = copy.get();
+    return CreateSymReader(importer, pal::MappedFile{}, std::move(copy), {}, pdb, size, ppReader);
+}
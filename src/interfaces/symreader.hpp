@@ -0,0 +1,25 @@
+#ifndef _SRC_INTERFACES_SYMREADER_HPP_
+#define _SRC_INTERFACES_SYMREADER_HPP_
+
+#include <internal/dnmd_platform.hpp>
+
+#include <external/cor.h>
+#include <external/corsym.h>
+
+// Create an ISymUnmanagedReader over a memory mapped Portable PDB.
+// Opening only maps the file and reads the metadata header, documents, methods,
+// scopes and sequence points are decoded when they are first queried.
+// The optional importer is the IMetaDataImport of the module, which is needed for
+// local signatures and method namespaces since those live in the image.
+HRESULT CreateSymReaderForFile(
+    IUnknown* importer,
+    WCHAR const* pdbPath,
+    ISymUnmanagedReader** ppReader);
+
+// Create an ISymUnmanagedReader over a copy of the Portable PDB in the stream.
+HRESULT CreateSymReaderFromStream(
+    IUnknown* importer,
+    IStream* pStream,
+    ISymUnmanagedReader** ppReader);
+
+#endif // _SRC_INTERFACES_SYMREADER_HPP_
@@ -10,6 +10,7 @@
 
 #include <external/cor.h>
 #include <external/corhdr.h>
+#include <dnmd_interfaces.hpp>
 
 #include <cstdint>
 #include <mutex>
@@ -45,7 +46,7 @@ public:
 };
 
 template<typename TImport, typename TEmit>
-class ThreadSafeImportEmit : public TearOffBase<IMetaDataImport2, IMetaDataEmit2, IMetaDataAssemblyImport, IMetaDataAssemblyEmit>
+class ThreadSafeImportEmit : public TearOffBase<IMetaDataImport2, IMetaDataEmit2, IMetaDataAssemblyImport, IMetaDataAssemblyEmit, IDNMDImportBatch>
 {
     pal::ReadWriteLock _lock;
     // owning reference to the thread-unsafe object that provides the underlying implementation.
@@ -78,6 +79,11 @@ protected:
             *ppvObject = static_cast<IMetaDataAssemblyEmit*>(this);
             return true;
         }
+        if (riid == IID_IDNMDImportBatch)
+        {
+            *ppvObject = static_cast<IDNMDImportBatch*>(this);
+            return true;
+        }
         return false;
     }
 
@@ -1690,6 +1696,48 @@ public: // IMetaDataAssemblyEmit
         std::lock_guard<pal::WriteLock> lock { this->_lock.GetWriteLock() };
         return _emit->SetManifestResourceProps(mr, tkImplementation, dwOffset, dwResourceFlags);
     }
+
+public: // IDNMDImportBatch
+    STDMETHOD(GetTypeDefPropsBatch)(
+        mdTypeDef const rTypeDefs[],
+        ULONG       cTokens,
+        DWORD       rFlags[],
+        mdToken     rExtends[],
+        mdTypeDef   rEnclosingClasses[],
+        char const* rNamespaces[],
+        char const* rNames[]) override
+    {
+        std::lock_guard<pal::ReadLock> lock { this->_lock.GetReadLock() };
+        return _import->GetTypeDefPropsBatch(rTypeDefs, cTokens, rFlags, rExtends, rEnclosingClasses, rNamespaces, rNames);
+    }
+
+    STDMETHOD(GetMethodPropsBatch)(
+        mdMethodDef const rMethods[],
+        ULONG       cTokens,
+        mdTypeDef   rClasses[],
+        DWORD       rFlags[],
+        DWORD       rImplFlags[],
+        ULONG       rCodeRVAs[],
+        char const* rNames[],
+        PCCOR_SIGNATURE rSigBlobs[],
+        ULONG       rSigBlobLengths[]) override
+    {
+        std::lock_guard<pal::ReadLock> lock { this->_lock.GetReadLock() };
+        return _import->GetMethodPropsBatch(rMethods, cTokens, rClasses, rFlags, rImplFlags, rCodeRVAs, rNames, rSigBlobs, rSigBlobLengths);
+    }
+
+    STDMETHOD(GetFieldPropsBatch)(
+        mdFieldDef const rFields[],
+        ULONG       cTokens,
+        mdTypeDef   rClasses[],
+        DWORD       rFlags[],
+        char const* rNames[],
+        PCCOR_SIGNATURE rSigBlobs[],
+        ULONG       rSigBlobLengths[]) override
+    {
+        std::lock_guard<pal::ReadLock> lock { this->_lock.GetReadLock() };
+        return _import->GetFieldPropsBatch(rFields, cTokens, rClasses, rFlags, rNames, rSigBlobs, rSigBlobLengths);
+    }
 };
 
 #endif // _SRC_INTERFACES_THREADSAFE_HPP_
\ No newline at end of file
@@ -0,0 +1,1154 @@
+#include "emit.hpp"
+#include <dnmd.hpp>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include <gmock/gmock.h>
+
+namespace
+{
+    // A scope with a custom attribute on 'Target', saved and reopened with the C API to decode the value.
+    struct AttributeScope final
+    {
+        dncp::com_ptr<IMetaDataEmit> emit;
+        mdTypeDef target;
+        mdTypeDef attributeType;
+        std::vector<uint8_t> image;
+        mdhandle_ptr handle;
+    };
+
+    void CreateAttributeScope(AttributeScope& scope)
+    {
+        ASSERT_NO_FATAL_FAILURE(CreateEmit(scope.emit));
+        ASSERT_EQ(S_OK, scope.emit->DefineTypeDef(W("Target"), tdSealed, mdTypeDefNil, nullptr, &scope.target));
+        ASSERT_EQ(S_OK, scope.emit->DefineTypeDef(W("TestAttribute"), tdSealed, mdTypeDefNil, nullptr, &scope.attributeType));
+    }
+
+    void ApplyAttribute(AttributeScope& scope, mdToken ctor, std::vector<uint8_t> const& value, mdcursor_t& attribute)
+    {
+        mdCustomAttribute attr;
+        ASSERT_EQ(S_OK, scope.emit->DefineCustomAttribute(scope.target, ctor, value.data(), (ULONG)value.size(), &attr));
+
+        DWORD saveSize;
+        ASSERT_EQ(S_OK, scope.emit->GetSaveSize(cssAccurate, &saveSize));
+        scope.image.resize(saveSize);
+        ASSERT_EQ(S_OK, scope.emit->SaveToMemory(scope.image.data(), saveSize));
+
+        mdhandle_t handle;
+        ASSERT_TRUE(md_create_handle(scope.image.data(), scope.image.size(), &handle));
+        scope.handle.reset(handle);
+        ASSERT_TRUE(md_token_to_cursor(handle, attr, &attribute));
+    }
+
+    // Define a constructor on 'TestAttribute' with the signature and apply it.
+    void ApplyAttribute(AttributeScope& scope, std::vector<uint8_t> const& ctorSig, std::vector<uint8_t> const& value, mdcursor_t& attribute)
+    {
+        mdMethodDef ctor;
+        ASSERT_EQ(S_OK, scope.emit->DefineMethod(scope.attributeType, W(".ctor"), mdPublic, ctorSig.data(), (ULONG)ctorSig.size(), 0, 0, &ctor));
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctor, value, attribute));
+    }
+
+    // Define an enum with a static field before the instance value__ field.
+    void DefineEnum(IMetaDataEmit* emit, LPCWSTR name, uint8_t underlyingType, mdTypeDef& enumType)
+    {
+        mdTypeRef systemEnum;
+        ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Enum"), &systemEnum));
+        ASSERT_EQ(S_OK, emit->DefineTypeDef(name, tdPublic | tdSealed, systemEnum, nullptr, &enumType));
+
+        mdFieldDef field;
+        std::array literalSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, (uint8_t)ELEMENT_TYPE_VALUETYPE, (uint8_t)(RidFromToken(enumType) << 2) };
+        ASSERT_EQ(S_OK, emit->DefineField(enumType, W("First"), fdPublic | fdStatic | fdLiteral, literalSig.data(), (ULONG)literalSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &field));
+        std::array valueSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, underlyingType };
+        ASSERT_EQ(S_OK, emit->DefineField(enumType, W("value__"), fdPublic | fdSpecialName | fdRTSpecialName, valueSig.data(), (ULONG)valueSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &field));
+    }
+
+    uint8_t TypeDefOrRef(mdToken tk)
+    {
+        uint8_t tag = TypeFromToken(tk) == mdtTypeDef ? 0 : TypeFromToken(tk) == mdtTypeRef ? 1 : 2;
+        return (uint8_t)((RidFromToken(tk) << 2) | tag);
+    }
+
+    template<typename T>
+    void Append(std::vector<uint8_t>& blob, T value)
+    {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        blob.insert(blob.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Append a SerString, nullptr is the null string.
+    void AppendString(std::vector<uint8_t>& blob, char const* str)
+    {
+        if (str == nullptr)
+        {
+            blob.push_back(0xff);
+            return;
+        }
+        size_t len = std::strlen(str);
+        ASSERT_LT(len, 0x80u);
+        blob.push_back((uint8_t)len);
+        blob.insert(blob.end(), str, str + len);
+    }
+
+    std::vector<uint8_t> Prolog()
+    {
+        return { 0x01, 0x00 };
+    }
+
+    std::vector<md_custom_attribute_argument_t> ReadArguments(mdcursor_t attribute, bool& failed, md_resolve_enum_fn_t resolveEnum = nullptr, void* context = nullptr)
+    {
+        md_custom_attribute_iterator_t iterator;
+        EXPECT_TRUE(md_custom_attribute_iterator_init(attribute, resolveEnum, context, &iterator));
+        std::vector<md_custom_attribute_argument_t> arguments;
+        md_custom_attribute_argument_t argument;
+        while (md_custom_attribute_iterator_next(&iterator, &argument))
+            arguments.push_back(argument);
+        failed = md_custom_attribute_iterator_failed(&iterator);
+
+        // The iterator stays at the end.
+        EXPECT_FALSE(md_custom_attribute_iterator_next(&iterator, &argument));
+        return arguments;
+    }
+
+    std::string_view Name(md_custom_attribute_argument_t const& argument)
+    {
+        return { argument.name, argument.name_len };
+    }
+
+    std::string_view String(md_custom_attribute_argument_t const& argument)
+    {
+        return { argument.value.string.str, argument.value.string.len };
+    }
+
+    std::string_view EnumTypeName(md_custom_attribute_argument_t const& argument)
+    {
+        return { argument.enum_type_name, argument.enum_type_name_len };
+    }
+}
+
+TEST(CustomAttribute, GetByName)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef target1;
+    mdTypeDef target2;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target1"), tdSealed, mdTypeDefNil, nullptr, &target1));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target2"), tdSealed, mdTypeDefNil, nullptr, &target2));
+
+    // Attribute constructors on a TypeRef, a generic instantiation and a TypeDef.
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeRef obsoleteRef;
+    mdMemberRef obsoleteCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.ObsoleteAttribute"), &obsoleteRef));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(obsoleteRef, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &obsoleteCtor));
+
+    mdTypeRef genericRef;
+    mdTypeSpec genericSpec;
+    mdMemberRef genericCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("Test.GenericAttribute`1"), &genericRef));
+    std::array genericSig = { (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, (uint8_t)((RidFromToken(genericRef) << 2) | 1), (uint8_t)1, (uint8_t)ELEMENT_TYPE_I4 };
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(genericSig.data(), (ULONG)genericSig.size(), &genericSpec));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(genericSpec, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &genericCtor));
+
+    mdTypeDef localAttr;
+    mdMethodDef localCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("LocalAttribute"), tdSealed, mdTypeDefNil, nullptr, &localAttr));
+    ASSERT_EQ(S_OK, emit->DefineMethod(localAttr, W(".ctor"), mdPublic, ctorSig.data(), (ULONG)ctorSig.size(), 0, 0, &localCtor));
+
+    std::array<uint8_t, 4> obsoleteValue = { 0x01, 0x00, 0x00, 0x00 };
+    std::array<uint8_t, 5> localValue = { 0x01, 0x00, 0x00, 0x00, 0x01 };
+    mdCustomAttribute attr;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target1, obsoleteCtor, obsoleteValue.data(), (ULONG)obsoleteValue.size(), &attr));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target1, localCtor, localValue.data(), (ULONG)localValue.size(), &attr));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target2, genericCtor, obsoleteValue.data(), (ULONG)obsoleteValue.size(), &attr));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    void const* data;
+    ULONG dataLength;
+    ASSERT_EQ(S_OK, import->GetCustomAttributeByName(target1, W("System.ObsoleteAttribute"), &data, &dataLength));
+    EXPECT_THAT(std::vector((uint8_t const*)data, (uint8_t const*)data + dataLength), testing::ContainerEq(std::vector(obsoleteValue.begin(), obsoleteValue.end())));
+    ASSERT_EQ(S_OK, import->GetCustomAttributeByName(target1, W("LocalAttribute"), &data, &dataLength));
+    EXPECT_THAT(std::vector((uint8_t const*)data, (uint8_t const*)data + dataLength), testing::ContainerEq(std::vector(localValue.begin(), localValue.end())));
+    EXPECT_EQ(S_OK, import->GetCustomAttributeByName(target2, W("Test.GenericAttribute`1"), &data, &dataLength));
+
+    EXPECT_EQ(S_FALSE, import->GetCustomAttributeByName(target2, W("System.ObsoleteAttribute"), &data, &dataLength));
+    EXPECT_EQ(nullptr, data);
+    EXPECT_EQ(0u, dataLength);
+    EXPECT_EQ(S_FALSE, import->GetCustomAttributeByName(target1, W("ObsoleteAttribute"), &data, &dataLength));
+    EXPECT_EQ(S_FALSE, import->GetCustomAttributeByName(target1, W("System.ObsoleteAttributeX"), &data, &dataLength));
+    EXPECT_EQ(S_FALSE, import->GetCustomAttributeByName(localAttr, W("LocalAttribute"), &data, &dataLength));
+
+    // Attributes defined after the first lookup are found.
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target2, obsoleteCtor, obsoleteValue.data(), (ULONG)obsoleteValue.size(), &attr));
+    EXPECT_EQ(S_OK, import->GetCustomAttributeByName(target2, W("System.ObsoleteAttribute"), &data, &dataLength));
+}
+
+TEST(CustomAttribute, GetByNameThroughModifiers)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef target;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target"), tdSealed, mdTypeDefNil, nullptr, &target));
+
+    // A generic attribute type with a custom modifier before the instantiation.
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeRef modifierRef;
+    mdTypeRef genericRef;
+    mdTypeSpec genericSpec;
+    mdMemberRef genericCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Runtime.CompilerServices.IsConst"), &modifierRef));
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("Test.GenericAttribute`1"), &genericRef));
+    std::array genericSig = {
+        (uint8_t)ELEMENT_TYPE_CMOD_OPT, (uint8_t)((RidFromToken(modifierRef) << 2) | 1),
+        (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, (uint8_t)((RidFromToken(genericRef) << 2) | 1), (uint8_t)1, (uint8_t)ELEMENT_TYPE_I4 };
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(genericSig.data(), (ULONG)genericSig.size(), &genericSpec));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(genericSpec, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &genericCtor));
+
+    std::array<uint8_t, 4> value = { 0x01, 0x00, 0x00, 0x00 };
+    mdCustomAttribute attr;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target, genericCtor, value.data(), (ULONG)value.size(), &attr));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    void const* data;
+    ULONG dataLength;
+    ASSERT_EQ(S_OK, import->GetCustomAttributeByName(target, W("Test.GenericAttribute`1"), &data, &dataLength));
+    EXPECT_THAT(std::vector((uint8_t const*)data, (uint8_t const*)data + dataLength), testing::ContainerEq(std::vector(value.begin(), value.end())));
+    EXPECT_EQ(S_FALSE, import->GetCustomAttributeByName(target, W("System.Runtime.CompilerServices.IsConst"), &data, &dataLength));
+}
+
+TEST(CustomAttribute, GetByNameWithInvalidType)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef target1;
+    mdTypeDef target2;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target1"), tdSealed, mdTypeDefNil, nullptr, &target1));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target2"), tdSealed, mdTypeDefNil, nullptr, &target2));
+
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeRef obsoleteRef;
+    mdMemberRef obsoleteCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.ObsoleteAttribute"), &obsoleteRef));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(obsoleteRef, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &obsoleteCtor));
+
+    // A generic instantiation whose type is a nil TypeDef.
+    mdTypeSpec invalidSpec;
+    mdMemberRef invalidCtor;
+    std::array invalidSig = { (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, (uint8_t)0, (uint8_t)1, (uint8_t)ELEMENT_TYPE_I4 };
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(invalidSig.data(), (ULONG)invalidSig.size(), &invalidSpec));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(invalidSpec, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &invalidCtor));
+
+    // A signature that ends before the type.
+    mdTypeSpec truncatedSpec;
+    mdMemberRef truncatedCtor;
+    std::array truncatedSig = { (uint8_t)ELEMENT_TYPE_GENERICINST };
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(truncatedSig.data(), (ULONG)truncatedSig.size(), &truncatedSpec));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(truncatedSpec, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &truncatedCtor));
+
+    std::array<uint8_t, 4> value = { 0x01, 0x00, 0x00, 0x00 };
+    mdCustomAttribute attr;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target1, invalidCtor, value.data(), (ULONG)value.size(), &attr));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target1, obsoleteCtor, value.data(), (ULONG)value.size(), &attr));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target2, obsoleteCtor, value.data(), (ULONG)value.size(), &attr));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target2, truncatedCtor, value.data(), (ULONG)value.size(), &attr));
+
+    // An attribute with an invalid type is reported unless a match comes before it.
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    void const* data;
+    ULONG dataLength;
+    EXPECT_EQ(COR_E_BADIMAGEFORMAT, import->GetCustomAttributeByName(target1, W("System.ObsoleteAttribute"), &data, &dataLength));
+    EXPECT_EQ(COR_E_BADIMAGEFORMAT, import->GetCustomAttributeByName(target1, W("LocalAttribute"), &data, &dataLength));
+    EXPECT_EQ(S_OK, import->GetCustomAttributeByName(target2, W("System.ObsoleteAttribute"), &data, &dataLength));
+    EXPECT_EQ(COR_E_BADIMAGEFORMAT, import->GetCustomAttributeByName(target2, W("LocalAttribute"), &data, &dataLength));
+}
+
+TEST(CustomAttribute, EnumByType)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    std::array<mdTypeDef, 3> targets;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target1"), tdSealed, mdTypeDefNil, nullptr, &targets[0]));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target2"), tdSealed, mdTypeDefNil, nullptr, &targets[1]));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target3"), tdSealed, mdTypeDefNil, nullptr, &targets[2]));
+
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeRef obsoleteRef;
+    mdMemberRef obsoleteCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.ObsoleteAttribute"), &obsoleteRef));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(obsoleteRef, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &obsoleteCtor));
+
+    mdTypeDef localAttr;
+    mdMethodDef localCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("LocalAttribute"), tdSealed, mdTypeDefNil, nullptr, &localAttr));
+    ASSERT_EQ(S_OK, emit->DefineMethod(localAttr, W(".ctor"), mdPublic, ctorSig.data(), (ULONG)ctorSig.size(), 0, 0, &localCtor));
+
+    std::array<uint8_t, 4> value = { 0x01, 0x00, 0x00, 0x00 };
+    std::vector<mdCustomAttribute> obsoleteAttrs;
+    std::vector<mdCustomAttribute> localAttrs;
+    mdCustomAttribute attr;
+    for (mdTypeDef target : targets)
+    {
+        ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target, localCtor, value.data(), (ULONG)value.size(), &attr));
+        localAttrs.push_back(attr);
+        if (target == targets[1])
+            continue;
+        ASSERT_EQ(S_OK, emit->DefineCustomAttribute(target, obsoleteCtor, value.data(), (ULONG)value.size(), &attr));
+        obsoleteAttrs.push_back(attr);
+    }
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    auto enumAttrs = [&](mdToken tkType)
+    {
+        std::vector<mdCustomAttribute> attrs;
+        HCORENUM hEnum = nullptr;
+        std::array<mdCustomAttribute, 2> buffer;
+        ULONG count;
+        while (SUCCEEDED(import->EnumCustomAttributes(&hEnum, mdTokenNil, tkType, buffer.data(), (ULONG)buffer.size(), &count)) && count != 0)
+            attrs.insert(attrs.end(), buffer.begin(), buffer.begin() + count);
+        import->CloseEnum(hEnum);
+        return attrs;
+    };
+
+    // Attributes can be found by their constructor or the type that declares it.
+    EXPECT_THAT(enumAttrs(obsoleteRef), testing::ContainerEq(obsoleteAttrs));
+    EXPECT_THAT(enumAttrs(obsoleteCtor), testing::ContainerEq(obsoleteAttrs));
+    EXPECT_THAT(enumAttrs(localAttr), testing::ContainerEq(localAttrs));
+    EXPECT_THAT(enumAttrs(localCtor), testing::ContainerEq(localAttrs));
+    EXPECT_THAT(enumAttrs(targets[0]), testing::IsEmpty());
+
+    // The type filter can be combined with a parent.
+    HCORENUM hEnum = nullptr;
+    std::array<mdCustomAttribute, 4> buffer;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumCustomAttributes(&hEnum, targets[2], obsoleteRef, buffer.data(), (ULONG)buffer.size(), &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(obsoleteAttrs[1], buffer[0]);
+    import->CloseEnum(hEnum);
+    hEnum = nullptr;
+    ASSERT_TRUE(SUCCEEDED(import->EnumCustomAttributes(&hEnum, targets[1], obsoleteRef, buffer.data(), (ULONG)buffer.size(), &count)));
+    EXPECT_EQ(0u, count);
+    import->CloseEnum(hEnum);
+
+    mdToken parent;
+    mdToken ctor;
+    void const* blob;
+    ULONG blobLength;
+    ASSERT_EQ(S_OK, import->GetCustomAttributeProps(obsoleteAttrs[1], &parent, &ctor, &blob, &blobLength));
+    EXPECT_EQ(targets[2], parent);
+    EXPECT_EQ(obsoleteCtor, ctor);
+}
+
+TEST(CustomAttribute, EnumByTypeWhileEmitting)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    std::array<mdTypeDef, 2> targets;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target1"), tdSealed, mdTypeDefNil, nullptr, &targets[0]));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Target2"), tdSealed, mdTypeDefNil, nullptr, &targets[1]));
+
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeRef obsoleteRef;
+    mdMemberRef obsoleteCtor;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.ObsoleteAttribute"), &obsoleteRef));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(obsoleteRef, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &obsoleteCtor));
+
+    std::array<uint8_t, 4> value = { 0x01, 0x00, 0x00, 0x00 };
+    std::array<mdCustomAttribute, 2> attrs;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(targets[0], obsoleteCtor, value.data(), (ULONG)value.size(), &attrs[0]));
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(targets[1], obsoleteCtor, value.data(), (ULONG)value.size(), &attrs[1]));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    // The enumerator holds the attributes that existed when it was created,
+    // even when a new attribute is inserted before the unread ones.
+    HCORENUM hEnum = nullptr;
+    std::array<mdCustomAttribute, 4> buffer;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumCustomAttributes(&hEnum, mdTokenNil, obsoleteRef, buffer.data(), 1, &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(attrs[0], buffer[0]);
+
+    mdCustomAttribute added;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(targets[0], obsoleteCtor, value.data(), (ULONG)value.size(), &added));
+
+    ASSERT_EQ(S_OK, import->EnumCustomAttributes(&hEnum, mdTokenNil, obsoleteRef, buffer.data(), (ULONG)buffer.size(), &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(attrs[1], buffer[0]);
+    import->CloseEnum(hEnum);
+
+    // A new enumerator sees the added attribute.
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, import->EnumCustomAttributes(&hEnum, mdTokenNil, obsoleteRef, buffer.data(), (ULONG)buffer.size(), &count));
+    EXPECT_EQ(3u, count);
+    import->CloseEnum(hEnum);
+}
+
+TEST(CustomAttribute, DecodePrimitiveArguments)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdTypeRef systemType;
+    ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Type"), &systemType));
+
+    std::vector<uint8_t> ctorSig = {
+        (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 16, (uint8_t)ELEMENT_TYPE_VOID,
+        (uint8_t)ELEMENT_TYPE_BOOLEAN, (uint8_t)ELEMENT_TYPE_CHAR,
+        (uint8_t)ELEMENT_TYPE_I1, (uint8_t)ELEMENT_TYPE_U1, (uint8_t)ELEMENT_TYPE_I2, (uint8_t)ELEMENT_TYPE_U2,
+        (uint8_t)ELEMENT_TYPE_I4, (uint8_t)ELEMENT_TYPE_U4, (uint8_t)ELEMENT_TYPE_I8, (uint8_t)ELEMENT_TYPE_U8,
+        (uint8_t)ELEMENT_TYPE_R4, (uint8_t)ELEMENT_TYPE_R8, (uint8_t)ELEMENT_TYPE_STRING, (uint8_t)ELEMENT_TYPE_STRING,
+        (uint8_t)ELEMENT_TYPE_CLASS, TypeDefOrRef(systemType),
+        // A custom modifier before the parameter type is skipped.
+        (uint8_t)ELEMENT_TYPE_CMOD_OPT, TypeDefOrRef(systemType), (uint8_t)ELEMENT_TYPE_CLASS, TypeDefOrRef(systemType),
+    };
+
+    std::vector<uint8_t> value = Prolog();
+    Append<uint8_t>(value, 1);
+    Append<uint16_t>(value, u'A');
+    Append<int8_t>(value, -2);
+    Append<uint8_t>(value, 200);
+    Append<int16_t>(value, -300);
+    Append<uint16_t>(value, 60000);
+    Append<int32_t>(value, -70000);
+    Append<uint32_t>(value, 4000000000u);
+    Append<int64_t>(value, -5000000000);
+    Append<uint64_t>(value, UINT64_MAX);
+    Append<float>(value, 1.5f);
+    Append<double>(value, -2.25);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "hello"));
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, nullptr));
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "System.Int32"));
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, nullptr));
+    Append<uint16_t>(value, 2);
+    Append<uint8_t>(value, SERIALIZATION_TYPE_FIELD);
+    Append<uint8_t>(value, ELEMENT_TYPE_I4);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "Count"));
+    Append<int32_t>(value, 7);
+    Append<uint8_t>(value, SERIALIZATION_TYPE_PROPERTY);
+    Append<uint8_t>(value, SERIALIZATION_TYPE_TYPE);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "Kind"));
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "System.String"));
+
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(18u, args.size());
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        EXPECT_EQ(mdcaa_Fixed, args[i].kind);
+        EXPECT_EQ(nullptr, args[i].name);
+        EXPECT_FALSE(args[i].is_enum);
+        EXPECT_FALSE(args[i].is_boxed);
+    }
+    EXPECT_EQ(ELEMENT_TYPE_BOOLEAN, args[0].type);
+    EXPECT_TRUE(args[0].value.boolean);
+    EXPECT_EQ(ELEMENT_TYPE_CHAR, args[1].type);
+    EXPECT_EQ(u'A', args[1].value.character);
+    EXPECT_EQ(ELEMENT_TYPE_I1, args[2].type);
+    EXPECT_EQ(-2, args[2].value.i);
+    EXPECT_EQ(ELEMENT_TYPE_U1, args[3].type);
+    EXPECT_EQ(200u, args[3].value.u);
+    EXPECT_EQ(ELEMENT_TYPE_I2, args[4].type);
+    EXPECT_EQ(-300, args[4].value.i);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[5].type);
+    EXPECT_EQ(60000u, args[5].value.u);
+    EXPECT_EQ(ELEMENT_TYPE_I4, args[6].type);
+    EXPECT_EQ(-70000, args[6].value.i);
+    EXPECT_EQ(ELEMENT_TYPE_U4, args[7].type);
+    EXPECT_EQ(4000000000u, args[7].value.u);
+    EXPECT_EQ(ELEMENT_TYPE_I8, args[8].type);
+    EXPECT_EQ(-5000000000, args[8].value.i);
+    EXPECT_EQ(ELEMENT_TYPE_U8, args[9].type);
+    EXPECT_EQ(UINT64_MAX, args[9].value.u);
+    EXPECT_EQ(ELEMENT_TYPE_R4, args[10].type);
+    EXPECT_FLOAT_EQ(1.5f, args[10].value.r4);
+    EXPECT_EQ(ELEMENT_TYPE_R8, args[11].type);
+    EXPECT_DOUBLE_EQ(-2.25, args[11].value.r8);
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[12].type);
+    EXPECT_EQ("hello", String(args[12]));
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[13].type);
+    EXPECT_EQ(nullptr, args[13].value.string.str);
+    EXPECT_EQ(SERIALIZATION_TYPE_TYPE, args[14].type);
+    EXPECT_EQ("System.Int32", String(args[14]));
+    EXPECT_EQ(SERIALIZATION_TYPE_TYPE, args[15].type);
+    EXPECT_EQ(nullptr, args[15].value.string.str);
+
+    EXPECT_EQ(mdcaa_NamedField, args[16].kind);
+    EXPECT_EQ("Count", Name(args[16]));
+    EXPECT_EQ(ELEMENT_TYPE_I4, args[16].type);
+    EXPECT_EQ(7, args[16].value.i);
+    EXPECT_EQ(mdcaa_NamedProperty, args[17].kind);
+    EXPECT_EQ("Kind", Name(args[17]));
+    EXPECT_EQ(SERIALIZATION_TYPE_TYPE, args[17].type);
+    EXPECT_EQ("System.String", String(args[17]));
+
+    // Strings and names point into the blob.
+    uint8_t const* blob;
+    uint32_t blobLength;
+    ASSERT_TRUE(md_get_column_value_as_blob(attribute, mdtCustomAttribute_Value, &blob, &blobLength));
+    EXPECT_GE((uint8_t const*)args[12].value.string.str, blob);
+    EXPECT_LT((uint8_t const*)args[12].value.string.str, blob + blobLength);
+    EXPECT_GE((uint8_t const*)args[17].name, blob);
+    EXPECT_LT((uint8_t const*)args[17].name, blob + blobLength);
+}
+
+TEST(CustomAttribute, DecodeMemberRefConstructor)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    std::array ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)1, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_STRING };
+    mdTypeRef obsoleteRef;
+    mdMemberRef obsoleteCtor;
+    ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.ObsoleteAttribute"), &obsoleteRef));
+    ASSERT_EQ(S_OK, scope.emit->DefineMemberRef(obsoleteRef, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &obsoleteCtor));
+
+    std::vector<uint8_t> value = Prolog();
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "Use something else"));
+    Append<uint16_t>(value, 0);
+
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, obsoleteCtor, value, attribute));
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(1u, args.size());
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[0].type);
+    EXPECT_EQ("Use something else", String(args[0]));
+}
+
+TEST(CustomAttribute, DecodeArrayArguments)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+
+    // (int[], int[], string[], object, object[]) { Values = short[] }
+    std::vector<uint8_t> ctorSig = {
+        (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 5, (uint8_t)ELEMENT_TYPE_VOID,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_I4,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_I4,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_STRING,
+        (uint8_t)ELEMENT_TYPE_OBJECT,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_OBJECT,
+    };
+
+    std::vector<uint8_t> value = Prolog();
+    Append<uint32_t>(value, 3);
+    Append<int32_t>(value, 1);
+    Append<int32_t>(value, 2);
+    Append<int32_t>(value, 3);
+    Append<uint32_t>(value, UINT32_MAX);
+    Append<uint32_t>(value, 0);
+    // A boxed int[].
+    Append<uint8_t>(value, ELEMENT_TYPE_SZARRAY);
+    Append<uint8_t>(value, ELEMENT_TYPE_I4);
+    Append<uint32_t>(value, 2);
+    Append<int32_t>(value, 10);
+    Append<int32_t>(value, 20);
+    // An object[] with a boxed string, a boxed long and, last, a boxed byte[].
+    Append<uint32_t>(value, 3);
+    Append<uint8_t>(value, ELEMENT_TYPE_STRING);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "s"));
+    Append<uint8_t>(value, ELEMENT_TYPE_I8);
+    Append<int64_t>(value, 5);
+    Append<uint8_t>(value, ELEMENT_TYPE_SZARRAY);
+    Append<uint8_t>(value, ELEMENT_TYPE_U1);
+    Append<uint32_t>(value, 1);
+    Append<uint8_t>(value, 9);
+    Append<uint16_t>(value, 1);
+    Append<uint8_t>(value, SERIALIZATION_TYPE_PROPERTY);
+    Append<uint8_t>(value, ELEMENT_TYPE_SZARRAY);
+    Append<uint8_t>(value, ELEMENT_TYPE_I2);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "Values"));
+    Append<uint32_t>(value, 1);
+    Append<int16_t>(value, -3);
+
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(16u, args.size());
+
+    EXPECT_EQ(mdcaa_Fixed, args[0].kind);
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[0].type);
+    EXPECT_EQ(ELEMENT_TYPE_I4, args[0].value.array.element_type);
+    EXPECT_EQ(3u, args[0].value.array.count);
+    for (size_t i = 1; i <= 3; ++i)
+    {
+        EXPECT_EQ(mdcaa_ArrayElement, args[i].kind);
+        EXPECT_EQ(ELEMENT_TYPE_I4, args[i].type);
+        EXPECT_EQ((int64_t)i, args[i].value.i);
+    }
+
+    // Null and empty arrays have no elements.
+    EXPECT_EQ(mdcaa_Fixed, args[4].kind);
+    EXPECT_EQ(UINT32_MAX, args[4].value.array.count);
+    EXPECT_EQ(mdcaa_Fixed, args[5].kind);
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[5].value.array.element_type);
+    EXPECT_EQ(0u, args[5].value.array.count);
+
+    EXPECT_EQ(mdcaa_Fixed, args[6].kind);
+    EXPECT_TRUE(args[6].is_boxed);
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[6].type);
+    EXPECT_EQ(ELEMENT_TYPE_I4, args[6].value.array.element_type);
+    EXPECT_EQ(2u, args[6].value.array.count);
+    EXPECT_EQ(mdcaa_ArrayElement, args[7].kind);
+    EXPECT_FALSE(args[7].is_boxed);
+    EXPECT_EQ(10, args[7].value.i);
+    EXPECT_EQ(20, args[8].value.i);
+
+    EXPECT_EQ(mdcaa_Fixed, args[9].kind);
+    EXPECT_FALSE(args[9].is_boxed);
+    EXPECT_EQ(SERIALIZATION_TYPE_TAGGED_OBJECT, args[9].value.array.element_type);
+    EXPECT_EQ(3u, args[9].value.array.count);
+    EXPECT_EQ(mdcaa_ArrayElement, args[10].kind);
+    EXPECT_TRUE(args[10].is_boxed);
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[10].type);
+    EXPECT_EQ("s", String(args[10]));
+    EXPECT_TRUE(args[11].is_boxed);
+    EXPECT_EQ(ELEMENT_TYPE_I8, args[11].type);
+    EXPECT_EQ(5, args[11].value.i);
+    EXPECT_EQ(mdcaa_ArrayElement, args[12].kind);
+    EXPECT_TRUE(args[12].is_boxed);
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[12].type);
+    EXPECT_EQ(ELEMENT_TYPE_U1, args[12].value.array.element_type);
+    EXPECT_EQ(1u, args[12].value.array.count);
+    EXPECT_EQ(mdcaa_ArrayElement, args[13].kind);
+    EXPECT_EQ(ELEMENT_TYPE_U1, args[13].type);
+    EXPECT_EQ(9u, args[13].value.u);
+
+    EXPECT_EQ(mdcaa_NamedProperty, args[14].kind);
+    EXPECT_EQ("Values", Name(args[14]));
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[14].type);
+    EXPECT_EQ(ELEMENT_TYPE_I2, args[14].value.array.element_type);
+    EXPECT_EQ(1u, args[14].value.array.count);
+    EXPECT_EQ(mdcaa_ArrayElement, args[15].kind);
+    EXPECT_EQ(-3, args[15].value.i);
+    EXPECT_EQ(nullptr, args[15].name);
+}
+
+namespace
+{
+    struct EnumResolver final
+    {
+        std::vector<std::pair<mdToken, std::string>> calls;
+        uint8_t underlyingType;
+
+        static bool Resolve(void* context, mdToken type, char const* typeName, uint32_t typeNameLength, uint8_t* underlyingType)
+        {
+            auto resolver = (EnumResolver*)context;
+            resolver->calls.emplace_back(type, typeName != nullptr ? std::string{ typeName, typeNameLength } : std::string{});
+            *underlyingType = resolver->underlyingType;
+            return true;
+        }
+    };
+
+    // (Color, ColorRef, Kind, Color[]) { Field = Color, Property = Kind }
+    // Color is defined in the scope with a ushort value, Kind is in another module.
+    void ApplyEnumAttribute(AttributeScope& scope, mdTypeDef& color, mdTypeRef& colorRef, mdTypeRef& kindRef, mdcursor_t& attribute)
+    {
+        ASSERT_NO_FATAL_FAILURE(DefineEnum(scope.emit, W("Test.Color"), ELEMENT_TYPE_U2, color));
+        ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("Test.Color"), &colorRef));
+        mdModuleRef other;
+        ASSERT_EQ(S_OK, scope.emit->DefineModuleRef(W("Other"), &other));
+        ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(other, W("Other.Kind"), &kindRef));
+
+        std::vector<uint8_t> ctorSig = {
+            (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 4, (uint8_t)ELEMENT_TYPE_VOID,
+            (uint8_t)ELEMENT_TYPE_VALUETYPE, TypeDefOrRef(color),
+            (uint8_t)ELEMENT_TYPE_VALUETYPE, TypeDefOrRef(colorRef),
+            (uint8_t)ELEMENT_TYPE_VALUETYPE, TypeDefOrRef(kindRef),
+            (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_VALUETYPE, TypeDefOrRef(color),
+        };
+
+        std::vector<uint8_t> value = Prolog();
+        Append<uint16_t>(value, 1);
+        Append<uint16_t>(value, 2);
+        Append<int8_t>(value, -1);
+        Append<uint32_t>(value, 2);
+        Append<uint16_t>(value, 3);
+        Append<uint16_t>(value, 4);
+        Append<uint16_t>(value, 2);
+        Append<uint8_t>(value, SERIALIZATION_TYPE_FIELD);
+        Append<uint8_t>(value, SERIALIZATION_TYPE_ENUM);
+        ASSERT_NO_FATAL_FAILURE(AppendString(value, "Test.Color"));
+        ASSERT_NO_FATAL_FAILURE(AppendString(value, "Field"));
+        Append<uint16_t>(value, 5);
+        Append<uint8_t>(value, SERIALIZATION_TYPE_PROPERTY);
+        Append<uint8_t>(value, SERIALIZATION_TYPE_ENUM);
+        ASSERT_NO_FATAL_FAILURE(AppendString(value, "Other.Kind, Other"));
+        ASSERT_NO_FATAL_FAILURE(AppendString(value, "Property"));
+        Append<int8_t>(value, 6);
+
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+    }
+}
+
+TEST(CustomAttribute, DecodeEnumArguments)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdTypeDef color;
+    mdTypeRef colorRef;
+    mdTypeRef kindRef;
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyEnumAttribute(scope, color, colorRef, kindRef, attribute));
+
+    EnumResolver resolver{ {}, ELEMENT_TYPE_I1 };
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(8u, args.size());
+
+    // Enums in the scope are resolved through the TypeDef, also when referenced by a TypeRef.
+    EXPECT_TRUE(args[0].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[0].type);
+    EXPECT_EQ(color, args[0].enum_type);
+    EXPECT_EQ(nullptr, args[0].enum_type_name);
+    EXPECT_EQ(1u, args[0].value.u);
+    EXPECT_TRUE(args[1].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[1].type);
+    EXPECT_EQ(colorRef, args[1].enum_type);
+    EXPECT_EQ(2u, args[1].value.u);
+
+    // Other enums go through the callback.
+    EXPECT_TRUE(args[2].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_I1, args[2].type);
+    EXPECT_EQ(kindRef, args[2].enum_type);
+    EXPECT_EQ(-1, args[2].value.i);
+
+    // An array of enums isn't an enum, its elements are.
+    EXPECT_FALSE(args[3].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[3].type);
+    EXPECT_EQ(color, args[3].enum_type);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[3].value.array.element_type);
+    EXPECT_EQ(2u, args[3].value.array.count);
+    for (size_t i = 4; i <= 5; ++i)
+    {
+        EXPECT_EQ(mdcaa_ArrayElement, args[i].kind);
+        EXPECT_TRUE(args[i].is_enum);
+        EXPECT_EQ(ELEMENT_TYPE_U2, args[i].type);
+        EXPECT_EQ(color, args[i].enum_type);
+        EXPECT_EQ(i - 1, args[i].value.u);
+    }
+
+    // Named arguments carry the serialized type name.
+    EXPECT_EQ(mdcaa_NamedField, args[6].kind);
+    EXPECT_EQ("Field", Name(args[6]));
+    EXPECT_TRUE(args[6].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[6].type);
+    EXPECT_EQ(mdTokenNil, args[6].enum_type);
+    EXPECT_EQ("Test.Color", EnumTypeName(args[6]));
+    EXPECT_EQ(5u, args[6].value.u);
+    EXPECT_EQ(mdcaa_NamedProperty, args[7].kind);
+    EXPECT_EQ("Property", Name(args[7]));
+    EXPECT_TRUE(args[7].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_I1, args[7].type);
+    EXPECT_EQ("Other.Kind, Other", EnumTypeName(args[7]));
+    EXPECT_EQ(6, args[7].value.i);
+
+    EXPECT_THAT(resolver.calls, testing::ContainerEq(std::vector<std::pair<mdToken, std::string>>{
+        { kindRef, "" },
+        { mdTokenNil, "Other.Kind, Other" },
+    }));
+}
+
+TEST(CustomAttribute, DecodeEnumAfterEdit)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdTypeDef color;
+    mdTypeRef colorRef;
+    mdTypeRef kindRef;
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyEnumAttribute(scope, color, colorRef, kindRef, attribute));
+
+    EnumResolver resolver{ {}, ELEMENT_TYPE_I1 };
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(8u, args.size());
+
+    // Renaming the enum drops it from the name lookup, so the named argument goes through the callback.
+    // The callback's underlying type doesn't fit the value and the iteration fails.
+    mdcursor_t colorDef;
+    mdcursor_t colorTypeRef;
+    ASSERT_TRUE(md_token_to_cursor(scope.handle.get(), color, &colorDef));
+    ASSERT_TRUE(md_token_to_cursor(scope.handle.get(), colorRef, &colorTypeRef));
+    ASSERT_TRUE(md_set_column_value_as_utf8(colorDef, mdtTypeDef_TypeNamespace, "Renamed"));
+    ASSERT_TRUE(md_set_column_value_as_utf8(colorTypeRef, mdtTypeRef_TypeNamespace, "Renamed"));
+    resolver.calls.clear();
+    args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_TRUE(failed);
+    EXPECT_THAT(resolver.calls, testing::ContainerEq(std::vector<std::pair<mdToken, std::string>>{
+        { kindRef, "" },
+        { mdTokenNil, "Test.Color" },
+    }));
+
+    ASSERT_TRUE(md_set_column_value_as_utf8(colorDef, mdtTypeDef_TypeNamespace, "Test"));
+    ASSERT_TRUE(md_set_column_value_as_utf8(colorTypeRef, mdtTypeRef_TypeNamespace, "Test"));
+    args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(8u, args.size());
+
+    // Once the value__ field isn't a valid underlying type the enum can't be read.
+    mdcursor_t field;
+    uint32_t fieldCount;
+    ASSERT_TRUE(md_get_column_value_as_range(colorDef, mdtTypeDef_FieldList, &field, &fieldCount));
+    ASSERT_EQ(2u, fieldCount);
+    ASSERT_TRUE(md_cursor_next(&field));
+    std::array stringSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, (uint8_t)ELEMENT_TYPE_STRING };
+    ASSERT_TRUE(md_set_column_value_as_blob(field, mdtField_Signature, stringSig.data(), (uint32_t)stringSig.size()));
+    args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(0u, args.size());
+}
+
+TEST(CustomAttribute, DecodeUnresolvedEnum)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdTypeDef color;
+    mdTypeRef colorRef;
+    mdTypeRef kindRef;
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyEnumAttribute(scope, color, colorRef, kindRef, attribute));
+
+    // Without a callback the enum from the other module stops the iteration.
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(2u, args.size());
+
+    // A callback that returns a type that can't be the underlying type of an enum also fails.
+    EnumResolver resolver{ {}, ELEMENT_TYPE_STRING };
+    args = ReadArguments(attribute, failed, &EnumResolver::Resolve, &resolver);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(2u, args.size());
+}
+
+TEST(CustomAttribute, DecodeGenericAttribute)
+{
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdTypeDef color;
+    ASSERT_NO_FATAL_FAILURE(DefineEnum(scope.emit, W("Test.Color"), ELEMENT_TYPE_U2, color));
+    mdTypeRef genericAttribute;
+    mdTypeRef list;
+    ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("Test.GenericAttribute`3"), &genericAttribute));
+    ASSERT_EQ(S_OK, scope.emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("Test.List`2"), &list));
+
+    // GenericAttribute<List<int[1...,], delegate*<int, void>>, Color, string>
+    // The first type argument is only skipped to reach the others.
+    std::vector<uint8_t> typeSpecSig = {
+        (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, TypeDefOrRef(genericAttribute), 3,
+        (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, TypeDefOrRef(list), 2,
+        (uint8_t)ELEMENT_TYPE_ARRAY, (uint8_t)ELEMENT_TYPE_I4, 2, 1, 3, 1, 0x7f,
+        (uint8_t)ELEMENT_TYPE_FNPTR, (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, 1, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_I4,
+        (uint8_t)ELEMENT_TYPE_VALUETYPE, TypeDefOrRef(color),
+        (uint8_t)ELEMENT_TYPE_STRING,
+    };
+    mdTypeSpec typeSpec;
+    ASSERT_EQ(S_OK, scope.emit->GetTokenFromTypeSpec(typeSpecSig.data(), (ULONG)typeSpecSig.size(), &typeSpec));
+
+    // .ctor(!1, !2[])
+    std::array ctorSig = {
+        (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)2, (uint8_t)ELEMENT_TYPE_VOID,
+        (uint8_t)ELEMENT_TYPE_VAR, (uint8_t)1,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_VAR, (uint8_t)2,
+    };
+    mdMemberRef ctor;
+    ASSERT_EQ(S_OK, scope.emit->DefineMemberRef(typeSpec, W(".ctor"), ctorSig.data(), (ULONG)ctorSig.size(), &ctor));
+
+    std::vector<uint8_t> value = Prolog();
+    Append<uint16_t>(value, 3);
+    Append<uint32_t>(value, 2);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "a"));
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "b"));
+    Append<uint16_t>(value, 0);
+
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctor, value, attribute));
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(4u, args.size());
+    EXPECT_TRUE(args[0].is_enum);
+    EXPECT_EQ(ELEMENT_TYPE_U2, args[0].type);
+    EXPECT_EQ(color, args[0].enum_type);
+    EXPECT_EQ(3u, args[0].value.u);
+    EXPECT_EQ(ELEMENT_TYPE_SZARRAY, args[1].type);
+    EXPECT_EQ(ELEMENT_TYPE_STRING, args[1].value.array.element_type);
+    EXPECT_EQ(2u, args[1].value.array.count);
+    EXPECT_EQ("a", String(args[2]));
+    EXPECT_EQ("b", String(args[3]));
+
+    // A parameter past the type arguments, or a type argument that is itself a type parameter, can't be read.
+    std::vector<uint8_t> varSpecSig = {
+        (uint8_t)ELEMENT_TYPE_GENERICINST, (uint8_t)ELEMENT_TYPE_CLASS, TypeDefOrRef(genericAttribute), 1,
+        (uint8_t)ELEMENT_TYPE_VAR, 0,
+    };
+    mdTypeSpec varSpec;
+    ASSERT_EQ(S_OK, scope.emit->GetTokenFromTypeSpec(varSpecSig.data(), (ULONG)varSpecSig.size(), &varSpec));
+    for (auto [parent, index] : { std::pair{ typeSpec, 3 }, std::pair{ varSpec, 0 } })
+    {
+        std::array invalidSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, (uint8_t)1, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_VAR, (uint8_t)index };
+        ASSERT_EQ(S_OK, scope.emit->DefineMemberRef(parent, W(".ctor"), invalidSig.data(), (ULONG)invalidSig.size(), &ctor));
+        value = Prolog();
+        Append<uint32_t>(value, 0);
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctor, value, attribute));
+        args = ReadArguments(attribute, failed);
+        EXPECT_TRUE(failed);
+        EXPECT_EQ(0u, args.size());
+    }
+}
+
+TEST(CustomAttribute, DecodeEmptyValue)
+{
+    // A constructor without parameters can have an empty value.
+    std::vector<uint8_t> ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 0, (uint8_t)ELEMENT_TYPE_VOID };
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, {}, attribute));
+    bool failed;
+    EXPECT_TRUE(ReadArguments(attribute, failed).empty());
+    EXPECT_FALSE(failed);
+
+    std::vector<uint8_t> value = Prolog();
+    Append<uint16_t>(value, 0);
+    AttributeScope withProlog;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(withProlog));
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(withProlog, ctorSig, value, attribute));
+    EXPECT_TRUE(ReadArguments(attribute, failed).empty());
+    EXPECT_FALSE(failed);
+
+    // A constructor with parameters can't.
+    ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 1, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_I4 };
+    AttributeScope withParameters;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(withParameters));
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(withParameters, ctorSig, {}, attribute));
+    md_custom_attribute_iterator_t iterator;
+    EXPECT_FALSE(md_custom_attribute_iterator_init(attribute, nullptr, nullptr, &iterator));
+}
+
+TEST(CustomAttribute, DecodeInvalidConstructor)
+{
+    // Constructors return void and aren't generic.
+    std::vector<std::vector<uint8_t>> ctorSigs = {
+        { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 0, (uint8_t)ELEMENT_TYPE_I4 },
+        { (uint8_t)(IMAGE_CEE_CS_CALLCONV_HASTHIS | IMAGE_CEE_CS_CALLCONV_GENERIC), 1, 0, (uint8_t)ELEMENT_TYPE_VOID },
+        { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 1 },
+    };
+    for (std::vector<uint8_t> const& ctorSig : ctorSigs)
+    {
+        AttributeScope scope;
+        ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+        mdcursor_t attribute;
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, { 0x01, 0x00, 0x00, 0x00 }, attribute));
+        md_custom_attribute_iterator_t iterator;
+        EXPECT_FALSE(md_custom_attribute_iterator_init(attribute, nullptr, nullptr, &iterator));
+    }
+
+    // Only CustomAttribute rows can be decoded.
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 0, (uint8_t)ELEMENT_TYPE_VOID }, {}, attribute));
+    mdcursor_t typeDef;
+    ASSERT_TRUE(md_token_to_cursor(scope.handle.get(), scope.target, &typeDef));
+    md_custom_attribute_iterator_t iterator;
+    EXPECT_FALSE(md_custom_attribute_iterator_init(typeDef, nullptr, nullptr, &iterator));
+    EXPECT_FALSE(md_custom_attribute_iterator_init(attribute, nullptr, nullptr, nullptr));
+
+    md_custom_attribute_argument_t argument;
+    EXPECT_FALSE(md_custom_attribute_iterator_next(nullptr, &argument));
+    ASSERT_TRUE(md_custom_attribute_iterator_init(attribute, nullptr, nullptr, &iterator));
+    EXPECT_FALSE(md_custom_attribute_iterator_next(&iterator, nullptr));
+    EXPECT_TRUE(md_custom_attribute_iterator_failed(nullptr));
+}
+
+TEST(CustomAttribute, DecodeCorruptValue)
+{
+    // (int, string, object)
+    std::vector<uint8_t> ctorSig = {
+        (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 3, (uint8_t)ELEMENT_TYPE_VOID,
+        (uint8_t)ELEMENT_TYPE_I4, (uint8_t)ELEMENT_TYPE_STRING, (uint8_t)ELEMENT_TYPE_OBJECT,
+    };
+    auto decode = [&](std::vector<uint8_t> const& value, size_t expectedCount)
+    {
+        AttributeScope scope;
+        ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+        mdcursor_t attribute;
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+        bool failed;
+        EXPECT_EQ(expectedCount, ReadArguments(attribute, failed).size());
+        EXPECT_TRUE(failed);
+    };
+
+    std::vector<uint8_t> value = Prolog();
+    Append<int32_t>(value, 1);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "abc"));
+
+    // The string is longer than the blob.
+    std::vector<uint8_t> corrupt = value;
+    corrupt[6] = 0x20;
+    ASSERT_NO_FATAL_FAILURE(decode(corrupt, 1));
+
+    // An object can't box an object or an invalid type.
+    for (uint8_t boxed : { (uint8_t)SERIALIZATION_TYPE_TAGGED_OBJECT, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_PTR })
+    {
+        corrupt = value;
+        Append<uint8_t>(corrupt, boxed);
+        Append<uint8_t>(corrupt, ELEMENT_TYPE_I4);
+        Append<int32_t>(corrupt, 1);
+        Append<uint16_t>(corrupt, 0);
+        ASSERT_NO_FATAL_FAILURE(decode(corrupt, 2));
+    }
+
+    // An array count larger than the rest of the blob.
+    corrupt = value;
+    Append<uint8_t>(corrupt, ELEMENT_TYPE_SZARRAY);
+    Append<uint8_t>(corrupt, ELEMENT_TYPE_U1);
+    Append<uint32_t>(corrupt, 0x7fffffff);
+    Append<uint8_t>(corrupt, 0);
+    ASSERT_NO_FATAL_FAILURE(decode(corrupt, 2));
+
+    // A named argument that isn't a field or property.
+    value.push_back(ELEMENT_TYPE_I4);
+    Append<int32_t>(value, 2);
+    corrupt = value;
+    Append<uint16_t>(corrupt, 1);
+    Append<uint8_t>(corrupt, 0x50);
+    Append<uint8_t>(corrupt, ELEMENT_TYPE_I4);
+    ASSERT_NO_FATAL_FAILURE(AppendString(corrupt, "X"));
+    Append<int32_t>(corrupt, 3);
+    ASSERT_NO_FATAL_FAILURE(decode(corrupt, 3));
+
+    // A named argument without a name.
+    corrupt = value;
+    Append<uint16_t>(corrupt, 1);
+    Append<uint8_t>(corrupt, SERIALIZATION_TYPE_FIELD);
+    Append<uint8_t>(corrupt, ELEMENT_TYPE_I4);
+    ASSERT_NO_FATAL_FAILURE(AppendString(corrupt, nullptr));
+    Append<int32_t>(corrupt, 3);
+    ASSERT_NO_FATAL_FAILURE(decode(corrupt, 3));
+
+    // More named arguments than in the blob.
+    corrupt = value;
+    Append<uint16_t>(corrupt, 2);
+    Append<uint8_t>(corrupt, SERIALIZATION_TYPE_FIELD);
+    Append<uint8_t>(corrupt, ELEMENT_TYPE_I4);
+    ASSERT_NO_FATAL_FAILURE(AppendString(corrupt, "X"));
+    Append<int32_t>(corrupt, 3);
+    ASSERT_NO_FATAL_FAILURE(decode(corrupt, 4));
+
+    // An invalid prolog.
+    corrupt = value;
+    corrupt[0] = 0x02;
+    Append<uint16_t>(corrupt, 0);
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, corrupt, attribute));
+    md_custom_attribute_iterator_t iterator;
+    EXPECT_FALSE(md_custom_attribute_iterator_init(attribute, nullptr, nullptr, &iterator));
+}
+
+TEST(CustomAttribute, DecodeTruncatedValue)
+{
+    // (int[], object[]) { Values = short[] }
+    std::vector<uint8_t> ctorSig = {
+        (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 2, (uint8_t)ELEMENT_TYPE_VOID,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_I4,
+        (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_OBJECT,
+    };
+    std::vector<uint8_t> value = Prolog();
+    Append<uint32_t>(value, 2);
+    Append<int32_t>(value, 1);
+    Append<int32_t>(value, 2);
+    Append<uint32_t>(value, 2);
+    Append<uint8_t>(value, ELEMENT_TYPE_STRING);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "abc"));
+    Append<uint8_t>(value, ELEMENT_TYPE_R8);
+    Append<double>(value, 1.0);
+    Append<uint16_t>(value, 1);
+    Append<uint8_t>(value, SERIALIZATION_TYPE_PROPERTY);
+    Append<uint8_t>(value, ELEMENT_TYPE_SZARRAY);
+    Append<uint8_t>(value, ELEMENT_TYPE_I2);
+    ASSERT_NO_FATAL_FAILURE(AppendString(value, "Values"));
+    Append<uint32_t>(value, 1);
+    Append<int16_t>(value, 4);
+
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+    bool failed;
+    ASSERT_EQ(8u, ReadArguments(attribute, failed).size());
+    ASSERT_FALSE(failed);
+
+    // Every shorter value stops with a failure.
+    for (size_t length = 2; length < value.size(); ++length)
+    {
+        AttributeScope truncated;
+        ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(truncated));
+        ASSERT_NO_FATAL_FAILURE(ApplyAttribute(truncated, ctorSig, { value.begin(), value.begin() + length }, attribute));
+        EXPECT_GT(8u, ReadArguments(attribute, failed).size()) << length;
+        EXPECT_TRUE(failed) << length;
+    }
+}
+
+TEST(CustomAttribute, DecodeNestedArrayLimit)
+{
+    // An object[] whose first element is a boxed object[], nested 'depth' times.
+    auto encodeNested = [](std::vector<uint8_t>& value, uint32_t depth)
+    {
+        for (uint32_t i = 0; i < depth; ++i)
+        {
+            if (i != 0)
+            {
+                Append<uint8_t>(value, ELEMENT_TYPE_SZARRAY);
+                Append<uint8_t>(value, SERIALIZATION_TYPE_TAGGED_OBJECT);
+            }
+            Append<uint32_t>(value, 2);
+        }
+        // Each array ends with a boxed int after the nested array.
+        for (uint32_t i = 0; i <= depth; ++i)
+        {
+            Append<uint8_t>(value, ELEMENT_TYPE_I4);
+            Append<int32_t>(value, (int32_t)i);
+        }
+        Append<uint16_t>(value, 0);
+    };
+
+    std::vector<uint8_t> ctorSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_HASTHIS, 1, (uint8_t)ELEMENT_TYPE_VOID, (uint8_t)ELEMENT_TYPE_SZARRAY, (uint8_t)ELEMENT_TYPE_OBJECT };
+    std::vector<uint8_t> value = Prolog();
+    encodeNested(value, 4);
+    AttributeScope scope;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(scope));
+    mdcursor_t attribute;
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(scope, ctorSig, value, attribute));
+    bool failed;
+    std::vector<md_custom_attribute_argument_t> args = ReadArguments(attribute, failed);
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(9u, args.size());
+
+    // The iterator tracks at most four arrays with elements left.
+    value = Prolog();
+    encodeNested(value, 5);
+    AttributeScope tooDeep;
+    ASSERT_NO_FATAL_FAILURE(CreateAttributeScope(tooDeep));
+    ASSERT_NO_FATAL_FAILURE(ApplyAttribute(tooDeep, ctorSig, value, attribute));
+    args = ReadArguments(attribute, failed);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(4u, args.size());
+}
@@ -0,0 +1,304 @@
+#include "emit.hpp"
+#include <dnmd.hpp>
+#include <vector>
+
+namespace
+{
+    // Reference encoders for ECMA-335 II.23.2 compressed integers.
+    void CompressU32(uint32_t value, size_t width, std::vector<uint8_t>& data)
+    {
+        switch (width)
+        {
+        case 1:
+            data.push_back((uint8_t)value);
+            break;
+        case 2:
+            data.push_back((uint8_t)(0x80 | (value >> 8)));
+            data.push_back((uint8_t)value);
+            break;
+        default:
+            data.push_back((uint8_t)(0xc0 | (value >> 24)));
+            data.push_back((uint8_t)(value >> 16));
+            data.push_back((uint8_t)(value >> 8));
+            data.push_back((uint8_t)value);
+            break;
+        }
+    }
+
+    void CompressU32(uint32_t value, std::vector<uint8_t>& data)
+    {
+        ASSERT_LE(value, 0x1fffffffu);
+        CompressU32(value, value <= 0x7f ? 1 : value <= 0x3fff ? 2 : 4, data);
+    }
+
+    void CompressI32(int32_t value, std::vector<uint8_t>& data)
+    {
+        // The value is rotated left by one bit within the width it is encoded in,
+        // so the sign bit ends up in the least significant bit.
+        uint32_t sign = value < 0 ? 1 : 0;
+        if (value >= -0x40 && value <= 0x3f)
+            return CompressU32((((uint32_t)value << 1) & 0x7f) | sign, 1, data);
+        if (value >= -0x2000 && value <= 0x1fff)
+            return CompressU32((((uint32_t)value << 1) & 0x3fff) | sign, 2, data);
+        ASSERT_TRUE(value >= -0x10000000 && value <= 0x0fffffff);
+        CompressU32((((uint32_t)value << 1) & 0x1fffffff) | sign, 4, data);
+    }
+
+    std::vector<uint32_t> DecompressU32(std::vector<uint8_t> const& data, uint32_t count, size_t& consumed)
+    {
+        std::vector<uint32_t> values(count);
+        uint8_t const* ptr = data.data();
+        size_t len = data.size();
+        uint32_t decoded = md_decompress_u32_many(&ptr, &len, count, values.data());
+        EXPECT_LE(decoded, count);
+        EXPECT_EQ(data.size() - len, (size_t)(ptr - data.data()));
+        consumed = data.size() - len;
+        values.resize(decoded);
+        return values;
+    }
+
+    std::vector<int32_t> DecompressI32(std::vector<uint8_t> const& data, uint32_t count, size_t& consumed)
+    {
+        std::vector<int32_t> values(count);
+        uint8_t const* ptr = data.data();
+        size_t len = data.size();
+        uint32_t decoded = md_decompress_i32_many(&ptr, &len, count, values.data());
+        EXPECT_LE(decoded, count);
+        EXPECT_EQ(data.size() - len, (size_t)(ptr - data.data()));
+        consumed = data.size() - len;
+        values.resize(decoded);
+        return values;
+    }
+}
+
+TEST(Decompress, UnsignedBoundaries)
+{
+    std::vector<uint32_t> expected{ 0, 1, 0x7f, 0x80, 0x3fff, 0x4000, 0x1fffffff };
+    std::vector<uint8_t> data;
+    for (uint32_t value : expected)
+        ASSERT_NO_FATAL_FAILURE(CompressU32(value, data));
+    ASSERT_EQ((std::vector<uint8_t>{
+        0x00, 0x01, 0x7f,
+        0x80, 0x80, 0xbf, 0xff,
+        0xc0, 0x00, 0x40, 0x00, 0xdf, 0xff, 0xff, 0xff }), data);
+
+    size_t consumed;
+    EXPECT_EQ(expected, DecompressU32(data, (uint32_t)expected.size(), consumed));
+    EXPECT_EQ(data.size(), consumed);
+}
+
+TEST(Decompress, SignedSpecificationExamples)
+{
+    // The examples from ECMA-335 II.23.2.
+    std::vector<int32_t> expected{ 3, -3, 64, -64, 8192, -8192, 268435455, -268435456 };
+    std::vector<uint8_t> data{
+        0x06, 0x7b,
+        0x80, 0x80, 0x01,
+        0xc0, 0x00, 0x40, 0x00, 0x80, 0x01,
+        0xdf, 0xff, 0xff, 0xfe, 0xc0, 0x00, 0x00, 0x01 };
+
+    std::vector<uint8_t> encoded;
+    for (int32_t value : expected)
+        ASSERT_NO_FATAL_FAILURE(CompressI32(value, encoded));
+    ASSERT_EQ(data, encoded);
+
+    size_t consumed;
+    EXPECT_EQ(expected, DecompressI32(data, (uint32_t)expected.size(), consumed));
+    EXPECT_EQ(data.size(), consumed);
+}
+
+TEST(Decompress, SignedBoundaries)
+{
+    std::vector<int32_t> expected{ 0, -1, 0x3f, -0x40, 0x40, -0x41, 0x1fff, -0x2000, 0x2000, -0x2001, 0x0fffffff, -0x10000000 };
+    std::vector<uint8_t> data;
+    for (int32_t value : expected)
+        ASSERT_NO_FATAL_FAILURE(CompressI32(value, data));
+
+    size_t consumed;
+    EXPECT_EQ(expected, DecompressI32(data, (uint32_t)expected.size(), consumed));
+    EXPECT_EQ(data.size(), consumed);
+}
+
+TEST(Decompress, MixedBlocksAndWideValues)
+{
+    // Full blocks of 16 single byte values with 2 and 4 byte values between them, at
+    // varying offsets so the wide values land inside and at the edges of a block.
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 16; ++i)
+        expected.push_back(i);
+    expected.push_back(0x1234);
+    for (uint32_t i = 0; i < 16; ++i)
+        expected.push_back(0x7f - i);
+    expected.push_back(0x123456);
+    for (uint32_t i = 0; i < 7; ++i)
+        expected.push_back(i * 3);
+    expected.push_back(0x80);
+    for (uint32_t i = 0; i < 40; ++i)
+        expected.push_back(i);
+    expected.push_back(0x4000);
+    expected.push_back(0x3fff);
+    for (uint32_t i = 0; i < 15; ++i)
+        expected.push_back(i + 1);
+    expected.push_back(0x1fffffff);
+
+    std::vector<uint8_t> data;
+    for (uint32_t value : expected)
+        ASSERT_NO_FATAL_FAILURE(CompressU32(value, data));
+
+    size_t consumed;
+    EXPECT_EQ(expected, DecompressU32(data, (uint32_t)expected.size(), consumed));
+    EXPECT_EQ(data.size(), consumed);
+
+    // The same shape through the signed decoder.
+    std::vector<int32_t> expected_signed;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        int32_t value = (int32_t)(expected[i] >> 4);
+        expected_signed.push_back(i % 2 == 0 ? value : -value - 1);
+    }
+    expected_signed[20] = 0x1234;
+    expected_signed[21] = -0x12345;
+    data.clear();
+    for (int32_t value : expected_signed)
+        ASSERT_NO_FATAL_FAILURE(CompressI32(value, data));
+
+    EXPECT_EQ(expected_signed, DecompressI32(data, (uint32_t)expected_signed.size(), consumed));
+    EXPECT_EQ(data.size(), consumed);
+}
+
+TEST(Decompress, SingleByteBlockSizes)
+{
+    // Exactly one block, one value short of a block and one value over.
+    for (uint32_t length : { 15u, 16u, 17u, 32u })
+    {
+        std::vector<uint8_t> data;
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            expected.push_back(0x7f - i);
+            data.push_back((uint8_t)(0x7f - i));
+        }
+
+        size_t consumed;
+        EXPECT_EQ(expected, DecompressU32(data, length, consumed)) << length;
+        EXPECT_EQ(data.size(), consumed);
+
+        // Signed values from single bytes are sign extended from bit 6.
+        std::vector<int32_t> expected_signed;
+        for (uint8_t b : data)
+            expected_signed.push_back((b & 1) ? (int32_t)(b >> 1) - 0x40 : (int32_t)(b >> 1));
+        EXPECT_EQ(expected_signed, DecompressI32(data, length, consumed)) << length;
+        EXPECT_EQ(data.size(), consumed);
+    }
+}
+
+TEST(Decompress, CountLimitsValues)
+{
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < 40; ++i)
+        ASSERT_NO_FATAL_FAILURE(CompressU32(i == 20 ? 0x2000 : i, data));
+
+    // Stopping in the middle of a block leaves the rest of the data.
+    size_t consumed;
+    std::vector<uint32_t> values = DecompressU32(data, 10, consumed);
+    ASSERT_EQ(10u, values.size());
+    EXPECT_EQ(9u, values[9]);
+    EXPECT_EQ(10u, consumed);
+
+    values = DecompressU32(data, 21, consumed);
+    ASSERT_EQ(21u, values.size());
+    EXPECT_EQ(0x2000u, values[20]);
+    EXPECT_EQ(22u, consumed);
+
+    // Nothing is read when no values are requested.
+    uint8_t const* ptr = data.data();
+    size_t len = data.size();
+    EXPECT_EQ(0u, md_decompress_u32_many(&ptr, &len, 0, nullptr));
+    EXPECT_EQ(0u, md_decompress_i32_many(&ptr, &len, 0, nullptr));
+    EXPECT_EQ(data.data(), ptr);
+    EXPECT_EQ(data.size(), len);
+}
+
+TEST(Decompress, TruncatedData)
+{
+    // The data ends in the middle of a 2 byte value after a full block.
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < 16; ++i)
+        data.push_back((uint8_t)i);
+    ASSERT_NO_FATAL_FAILURE(CompressU32(0x1234, data));
+    data.pop_back();
+
+    size_t consumed;
+    std::vector<uint32_t> values = DecompressU32(data, 20, consumed);
+    EXPECT_EQ(16u, values.size());
+    EXPECT_EQ(16u, consumed);
+
+    // The data ends in the middle of a 4 byte value.
+    for (size_t missing = 1; missing <= 3; ++missing)
+    {
+        data = { 0x00, 0x02 };
+        ASSERT_NO_FATAL_FAILURE(CompressI32(-0x10000000, data));
+        data.resize(data.size() - missing);
+        std::vector<int32_t> signed_values = DecompressI32(data, 3, consumed);
+        EXPECT_EQ((std::vector<int32_t>{ 0, 1 }), signed_values) << missing;
+        EXPECT_EQ(2u, consumed);
+    }
+
+    // There is no data at all.
+    data.clear();
+    values = DecompressU32(data, 4, consumed);
+    EXPECT_TRUE(values.empty());
+    EXPECT_EQ(0u, consumed);
+}
+
+TEST(Decompress, InvalidValue)
+{
+    // A first byte with the top three bits set isn't a valid compressed integer.
+    for (uint8_t invalid : { (uint8_t)0xe0, (uint8_t)0xf0, (uint8_t)0xff })
+    {
+        std::vector<uint8_t> data;
+        for (uint32_t i = 0; i < 20; ++i)
+            data.push_back((uint8_t)i);
+        data.push_back(invalid);
+        data.insert(data.end(), 20, 0x01);
+
+        size_t consumed;
+        std::vector<uint32_t> values = DecompressU32(data, 41, consumed);
+        EXPECT_EQ(20u, values.size()) << (int)invalid;
+        EXPECT_EQ(20u, consumed);
+
+        std::vector<int32_t> signed_values = DecompressI32(data, 41, consumed);
+        EXPECT_EQ(20u, signed_values.size()) << (int)invalid;
+        EXPECT_EQ(20u, consumed);
+    }
+
+    // A block of 16 bytes with an invalid byte in it isn't decoded as single byte values.
+    std::vector<uint8_t> data(16, 0x02);
+    data[8] = 0xe0;
+    size_t consumed;
+    EXPECT_EQ(std::vector<uint32_t>(8, 0x02), DecompressU32(data, 16, consumed));
+    EXPECT_EQ(8u, consumed);
+}
+
+TEST(Decompress, InvalidArguments)
+{
+    uint8_t data[] = { 0x01, 0x02 };
+    uint8_t const* ptr = data;
+    uint8_t const* null_ptr = nullptr;
+    size_t len = sizeof(data);
+    uint32_t values[2];
+    int32_t signed_values[2];
+
+    EXPECT_EQ(0u, md_decompress_u32_many(nullptr, &len, 2, values));
+    EXPECT_EQ(0u, md_decompress_u32_many(&null_ptr, &len, 2, values));
+    EXPECT_EQ(0u, md_decompress_u32_many(&ptr, nullptr, 2, values));
+    EXPECT_EQ(0u, md_decompress_u32_many(&ptr, &len, 2, nullptr));
+    EXPECT_EQ(0u, md_decompress_i32_many(nullptr, &len, 2, signed_values));
+    EXPECT_EQ(0u, md_decompress_i32_many(&null_ptr, &len, 2, signed_values));
+    EXPECT_EQ(0u, md_decompress_i32_many(&ptr, nullptr, 2, signed_values));
+    EXPECT_EQ(0u, md_decompress_i32_many(&ptr, &len, 2, nullptr));
+
+    // Failed calls leave the data where it was.
+    EXPECT_EQ(data, ptr);
+    EXPECT_EQ(sizeof(data), len);
+}
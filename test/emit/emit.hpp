@@ -36,4 +36,15 @@ inline void CreateEmit(dncp::com_ptr<IMetaDataAssemblyEmit>& emit)
     ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenser, (void**)&dispenser));
     ASSERT_EQ(S_OK, dispenser->DefineScope(CLSID_CorMetaDataRuntime, 0, IID_IMetaDataAssemblyEmit, (IUnknown**)&emit));
 }
+
+inline void CreateEmit(dncp::com_ptr<IMetaDataEmit2>& emit, CorCheckDuplicatesFor checkDuplicatesFor)
+{
+    dncp::com_ptr<IMetaDataDispenserEx> dispenser;
+    ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenserEx, (void**)&dispenser));
+    VARIANT option;
+    V_VT(&option) = VT_UI4;
+    V_UI4(&option) = (ULONG)checkDuplicatesFor;
+    ASSERT_EQ(S_OK, dispenser->SetOption(MetaDataCheckDuplicatesFor, &option));
+    ASSERT_EQ(S_OK, dispenser->DefineScope(CLSID_CorMetaDataRuntime, 0, IID_IMetaDataEmit2, (IUnknown**)&emit));
+}
 #endif // DNMD_TEST_EMIT_EMIT_HPP
@@ -0,0 +1,40 @@
+#include "emit.hpp"
+
+TEST(ExportedType, FindByName)
+{
+    dncp::com_ptr<IMetaDataAssemblyEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    ASSEMBLYMETADATA assemblyMetadata = {};
+    assemblyMetadata.szLocale = const_cast<LPWSTR>(W(""));
+    mdAssemblyRef assemblyRef;
+    ASSERT_EQ(S_OK, emit->DefineAssemblyRef(nullptr, 0, W("Lib"), &assemblyMetadata, nullptr, 0, 0, &assemblyRef));
+
+    mdExportedType outer;
+    mdExportedType inner;
+    mdExportedType other;
+    ASSERT_EQ(S_OK, emit->DefineExportedType(W("Lib.Outer"), assemblyRef, mdTypeDefNil, tdPublic, &outer));
+    ASSERT_EQ(S_OK, emit->DefineExportedType(W("Inner"), outer, mdTypeDefNil, tdNestedPublic, &inner));
+    ASSERT_EQ(S_OK, emit->DefineExportedType(W("Lib.Other"), assemblyRef, mdTypeDefNil, tdPublic, &other));
+
+    dncp::com_ptr<IMetaDataAssemblyImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&import));
+    mdExportedType found;
+    ASSERT_EQ(S_OK, import->FindExportedTypeByName(W("Lib.Other"), mdExportedTypeNil, &found));
+    EXPECT_EQ(other, found);
+    ASSERT_EQ(S_OK, import->FindExportedTypeByName(W("Inner"), outer, &found));
+    EXPECT_EQ(inner, found);
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindExportedTypeByName(W("Inner"), mdExportedTypeNil, &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindExportedTypeByName(W("Lib.Outer"), outer, &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindExportedTypeByName(W("Lib.Missing"), mdExportedTypeNil, &found));
+
+    // Exported types defined after the first lookup are found as well.
+    mdExportedType added;
+    ASSERT_EQ(S_OK, emit->DefineExportedType(W("Lib.Added"), assemblyRef, mdTypeDefNil, tdPublic, &added));
+    ASSERT_EQ(S_OK, import->FindExportedTypeByName(W("Lib.Added"), mdExportedTypeNil, &found));
+    EXPECT_EQ(added, found);
+
+    // Lookups observe changes to exported types that were already defined.
+    ASSERT_EQ(S_OK, emit->SetExportedTypeProps(other, assemblyRef, mdTypeDefNil, tdPublic));
+    ASSERT_EQ(S_OK, import->FindExportedTypeByName(W("Lib.Other"), mdExportedTypeNil, &found));
+    EXPECT_EQ(other, found);
+}
@@ -0,0 +1,27 @@
+#include "emit.hpp"
+
+TEST(ManifestResource, FindByName)
+{
+    dncp::com_ptr<IMetaDataAssemblyEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdManifestResource first;
+    mdManifestResource second;
+    ASSERT_EQ(S_OK, emit->DefineManifestResource(W("Lib.Strings.resources"), mdFileNil, 0, mrPublic, &first));
+    ASSERT_EQ(S_OK, emit->DefineManifestResource(W("Lib.Images.resources"), mdFileNil, 0x100, mrPublic, &second));
+
+    dncp::com_ptr<IMetaDataAssemblyImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&import));
+    mdManifestResource found;
+    ASSERT_EQ(S_OK, import->FindManifestResourceByName(W("Lib.Images.resources"), &found));
+    EXPECT_EQ(second, found);
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindManifestResourceByName(W("Lib.Images"), &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindManifestResourceByName(W("Lib.Images.resources.extra"), &found));
+
+    // Resources defined after the first lookup are found as well.
+    mdManifestResource third;
+    ASSERT_EQ(S_OK, emit->DefineManifestResource(W("Lib.Other.resources"), mdFileNil, 0x200, mrPrivate, &third));
+    ASSERT_EQ(S_OK, import->FindManifestResourceByName(W("Lib.Other.resources"), &found));
+    EXPECT_EQ(third, found);
+    ASSERT_EQ(S_OK, import->FindManifestResourceByName(W("Lib.Strings.resources"), &found));
+    EXPECT_EQ(first, found);
+}
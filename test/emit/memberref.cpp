@@ -59,4 +59,94 @@ TEST(MemberRef, SetParent)
     EXPECT_EQ(W("Foo"), readName.substr(0, readNameLength - 1));
     EXPECT_EQ(TokenFromRid(2, mdtTypeRef), parent);
     EXPECT_THAT(std::vector(sigBlob, sigBlob + sigBlobLength), testing::ContainerEq(std::vector(signature.begin(), signature.end())));
-}
\ No newline at end of file
+}
+
+TEST(MemberRef, Find)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    std::array<uint8_t, 3> signature1 = {0x01, 0x02, 0x03};
+    std::array<uint8_t, 3> signature2 = {0x01, 0x02, 0x04};
+    mdMemberRef memberRef1;
+    mdMemberRef memberRef2;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), signature1.data(), (ULONG)signature1.size(), &memberRef1));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), signature2.data(), (ULONG)signature2.size(), &memberRef2));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    mdMemberRef found;
+    ASSERT_EQ(S_OK, import->FindMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), signature2.data(), (ULONG)signature2.size(), &found));
+    EXPECT_EQ(memberRef2, found);
+    ASSERT_EQ(S_OK, import->FindMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), nullptr, 0, &found));
+    EXPECT_EQ(memberRef1, found);
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindMemberRef(TokenFromRid(1, mdtTypeDef), W("Fo"), nullptr, 0, &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindMemberRef(TokenFromRid(2, mdtTypeRef), W("Foo"), nullptr, 0, &found));
+
+    // Lookups observe changes to rows that were already indexed.
+    ASSERT_EQ(S_OK, emit->SetParent(memberRef1, TokenFromRid(2, mdtTypeRef)));
+    ASSERT_EQ(S_OK, import->FindMemberRef(TokenFromRid(2, mdtTypeRef), W("Foo"), signature1.data(), (ULONG)signature1.size(), &found));
+    EXPECT_EQ(memberRef1, found);
+    ASSERT_EQ(S_OK, import->FindMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), nullptr, 0, &found));
+    EXPECT_EQ(memberRef2, found);
+
+    mdMemberRef memberRef3;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(mdTokenNil, W("Bar"), signature1.data(), (ULONG)signature1.size(), &memberRef3));
+    ASSERT_EQ(S_OK, import->FindMemberRef(mdTypeRefNil, W("Bar"), signature1.data(), (ULONG)signature1.size(), &found));
+    EXPECT_EQ(memberRef3, found);
+}
+
+TEST(MemberRef, EnumByParent)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    std::array<uint8_t, 3> signature = {0x01, 0x02, 0x03};
+    mdMemberRef memberRef1;
+    mdMemberRef memberRef2;
+    mdMemberRef otherMemberRef;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeRef), W("Foo"), signature.data(), (ULONG)signature.size(), &memberRef1));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(2, mdtTypeRef), W("Foo"), signature.data(), (ULONG)signature.size(), &otherMemberRef));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeRef), W("Bar"), signature.data(), (ULONG)signature.size(), &memberRef2));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    HCORENUM hEnum = nullptr;
+    std::array<mdMemberRef, 4> memberRefs;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumMemberRefs(&hEnum, TokenFromRid(1, mdtTypeRef), memberRefs.data(), (ULONG)memberRefs.size(), &count));
+    import->CloseEnum(hEnum);
+    EXPECT_THAT(std::vector(memberRefs.begin(), memberRefs.begin() + count), testing::ElementsAre(memberRef1, memberRef2));
+
+    // Member refs defined or changed after the first enumeration are observed.
+    mdMemberRef memberRef3;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeRef), W("Baz"), signature.data(), (ULONG)signature.size(), &memberRef3));
+    ASSERT_EQ(S_OK, emit->SetParent(otherMemberRef, TokenFromRid(1, mdtTypeRef)));
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, import->EnumMemberRefs(&hEnum, TokenFromRid(1, mdtTypeRef), memberRefs.data(), (ULONG)memberRefs.size(), &count));
+    import->CloseEnum(hEnum);
+    EXPECT_THAT(std::vector(memberRefs.begin(), memberRefs.begin() + count), testing::ElementsAre(memberRef1, otherMemberRef, memberRef2, memberRef3));
+
+    hEnum = nullptr;
+    ASSERT_TRUE(SUCCEEDED(import->EnumMemberRefs(&hEnum, TokenFromRid(2, mdtTypeRef), memberRefs.data(), (ULONG)memberRefs.size(), &count)));
+    import->CloseEnum(hEnum);
+    EXPECT_EQ(0, count);
+}
+
+TEST(MemberRef, DefineDuplicate)
+{
+    dncp::com_ptr<IMetaDataEmit2> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit, (CorCheckDuplicatesFor)(MDDupTypeRef | MDDupMemberRef)));
+
+    mdTypeRef type1, type2;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Object"), &type1));
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Object"), &type2));
+    EXPECT_EQ(type1, type2);
+
+    std::array<uint8_t, 3> signature = {0x01, 0x02, 0x03};
+    std::array<uint8_t, 3> overload = {0x01, 0x02, 0x04};
+    mdMemberRef member1, member2, other;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(type1, W("Foo"), signature.data(), (ULONG)signature.size(), &member1));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(type1, W("Foo"), overload.data(), (ULONG)overload.size(), &other));
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(type2, W("Foo"), signature.data(), (ULONG)signature.size(), &member2));
+    EXPECT_EQ(member1, member2);
+    EXPECT_NE(member1, other);
+}
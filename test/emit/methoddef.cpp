@@ -1,5 +1,9 @@
 #include "emit.hpp"
+#include <dnmd.hpp>
+#include <algorithm>
 #include <array>
+#include <map>
+#include <vector>
 #include <gmock/gmock.h>
 
 TEST(MethodDef, Define)
@@ -115,3 +119,342 @@ TEST(MethodDef, SetProps)
     EXPECT_EQ(miForwardRef, implFlags);
     EXPECT_THAT(std::vector(sigBlob, sigBlob + sigBlobLength), testing::ContainerEq(std::vector(sig.begin(), sig.end())));
 }
+
+TEST(MethodDef, GetOwningType)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    std::array sig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeDef type1;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type1"), tdSealed, mdTypeDefNil, nullptr, &type1));
+    std::vector<mdTypeDef> owners;
+    std::vector<mdMethodDef> methods;
+    for (int i = 0; i < 2; ++i)
+    {
+        mdMethodDef method;
+        ASSERT_EQ(S_OK, emit->DefineMethod(type1, W("M"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &method));
+        owners.push_back(type1);
+        methods.push_back(method);
+    }
+
+    mdTypeDef owner;
+    DWORD attr;
+    PCCOR_SIGNATURE sigBlob;
+    ULONG sigBlobLength;
+    ULONG rva;
+    DWORD implFlags;
+    for (size_t i = 0; i < methods.size(); ++i)
+    {
+        ASSERT_EQ(S_OK, import->GetMethodProps(methods[i], &owner, nullptr, 0, nullptr, &attr, &sigBlob, &sigBlobLength, &rva, &implFlags));
+        EXPECT_EQ(owners[i], owner);
+    }
+
+    // Types and methods defined after the first lookup are attributed to their owner.
+    mdTypeDef type2;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type2"), tdSealed, mdTypeDefNil, nullptr, &type2));
+    for (int i = 0; i < 3; ++i)
+    {
+        mdMethodDef method;
+        ASSERT_EQ(S_OK, emit->DefineMethod(type2, W("M"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &method));
+        owners.push_back(type2);
+        methods.push_back(method);
+    }
+
+    for (size_t i = 0; i < methods.size(); ++i)
+    {
+        ASSERT_EQ(S_OK, import->GetMethodProps(methods[i], &owner, nullptr, 0, nullptr, &attr, &sigBlob, &sigBlobLength, &rva, &implFlags));
+        EXPECT_EQ(owners[i], owner);
+    }
+}
+
+TEST(MethodDef, GetOwningTypeThroughIndirection)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    std::array sig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    std::array fieldSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, (uint8_t)ELEMENT_TYPE_I4 };
+    std::array<mdTypeDef, 3> types;
+    std::vector<std::pair<mdToken, mdTypeDef>> members;
+    auto defineMembers = [&](mdTypeDef type, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            mdMethodDef method;
+            ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &method));
+            members.emplace_back(method, type);
+            mdFieldDef field;
+            ASSERT_EQ(S_OK, emit->DefineField(type, W("F"), fdStatic, fieldSig.data(), (ULONG)fieldSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &field));
+            members.emplace_back(field, type);
+        }
+    };
+
+    auto checkOwners = [&]()
+    {
+        for (auto const& [member, type] : members)
+        {
+            SCOPED_TRACE(member);
+            mdTypeDef owner = mdTypeDefNil;
+            DWORD attr;
+            PCCOR_SIGNATURE sigBlob;
+            ULONG sigBlobLength;
+            if (TypeFromToken(member) == mdtMethodDef)
+            {
+                ULONG rva;
+                DWORD implFlags;
+                ASSERT_EQ(S_OK, import->GetMethodProps(member, &owner, nullptr, 0, nullptr, &attr, &sigBlob, &sigBlobLength, &rva, &implFlags));
+            }
+            else
+            {
+                DWORD valueType;
+                UVCP_CONSTANT value;
+                ULONG valueLength;
+                ASSERT_EQ(S_OK, import->GetFieldProps(member, &owner, nullptr, 0, nullptr, &attr, &sigBlob, &sigBlobLength, &valueType, &value, &valueLength));
+            }
+            EXPECT_EQ(type, owner);
+        }
+    };
+
+    // Define each type's members before the next type, so the lists start out in row order.
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type1"), tdSealed, mdTypeDefNil, nullptr, &types[0]));
+    ASSERT_NO_FATAL_FAILURE(defineMembers(types[0], 2));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type2"), tdSealed, mdTypeDefNil, nullptr, &types[1]));
+    ASSERT_NO_FATAL_FAILURE(defineMembers(types[1], 2));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type3"), tdSealed, mdTypeDefNil, nullptr, &types[2]));
+    ASSERT_NO_FATAL_FAILURE(defineMembers(types[2], 1));
+    ASSERT_NO_FATAL_FAILURE(checkOwners());
+
+    // Adding members to the first and middle types once later types have members requires the
+    // MethodPtr and FieldPtr tables, so the lists are no longer in row order.
+    ASSERT_NO_FATAL_FAILURE(defineMembers(types[1], 2));
+    ASSERT_NO_FATAL_FAILURE(defineMembers(types[0], 1));
+    ASSERT_EQ(TokenFromRid(6, mdtMethodDef), members[10].first);
+    ASSERT_EQ(types[1], members[10].second);
+    ASSERT_NO_FATAL_FAILURE(checkOwners());
+
+    // The members can be found through the owners' lists too.
+    for (mdTypeDef type : types)
+    {
+        HCORENUM hEnum = nullptr;
+        std::array<mdMethodDef, 8> methods;
+        ULONG count;
+        ASSERT_EQ(S_OK, import->EnumMethods(&hEnum, type, methods.data(), (ULONG)methods.size(), &count));
+        import->CloseEnum(hEnum);
+        for (ULONG i = 0; i < count; ++i)
+            EXPECT_NE(members.end(), std::find(members.begin(), members.end(), std::make_pair((mdToken)methods[i], type)));
+    }
+}
+
+TEST(MethodDef, GetPropsBatchRandomOrder)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+
+    // Define enough methods that the batch is gathered in several chunks.
+    std::array sig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    std::vector<mdMethodDef> methods(150);
+    for (size_t i = 0; i < methods.size(); ++i)
+    {
+        WSTR_string name = W("M") + WSTR_string(i + 1, W('x'));
+        ASSERT_EQ(S_OK, emit->DefineMethod(TokenFromRid(1, mdtTypeDef), name.c_str(), mdStatic, sig.data(), (ULONG)sig.size(), (ULONG)(0x1000 + i), 0, &methods[i]));
+    }
+
+    // Visit the methods out of order.
+    std::vector<mdMethodDef> tokens;
+    for (size_t i = 0; i < methods.size(); ++i)
+        tokens.push_back(methods[(i * 97) % methods.size()]);
+
+    dncp::com_ptr<IDNMDImportBatch> batch;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IDNMDImportBatch, (void**)&batch));
+
+    std::vector<ULONG> rvas(tokens.size());
+    std::vector<char const*> names(tokens.size());
+    std::vector<ULONG> sigLengths(tokens.size());
+    ASSERT_EQ(S_OK, batch->GetMethodPropsBatch(tokens.data(), (ULONG)tokens.size(), nullptr, nullptr, nullptr, rvas.data(), names.data(), nullptr, sigLengths.data()));
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        size_t index = RidFromToken(tokens[i]) - 1;
+        EXPECT_EQ(0x1000 + index, rvas[i]);
+        EXPECT_EQ("M" + std::string(index + 1, 'x'), names[i]);
+        EXPECT_EQ(sig.size(), sigLengths[i]);
+    }
+}
+
+namespace
+{
+    class RecordingTokenMap final : public IMapToken
+    {
+    public:
+        std::map<mdToken, mdToken> Remaps;
+
+        STDMETHOD(QueryInterface)(REFIID riid, void** ppvObject) override
+        {
+            if (riid == IID_IUnknown || riid == IID_IMapToken)
+            {
+                *ppvObject = static_cast<IMapToken*>(this);
+                return S_OK;
+            }
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        STDMETHOD_(ULONG, AddRef)() override { return 1; }
+        STDMETHOD_(ULONG, Release)() override { return 1; }
+
+        STDMETHOD(Map)(mdToken tkImp, mdToken tkEmit) override
+        {
+            Remaps[tkImp] = tkEmit;
+            return S_OK;
+        }
+    };
+}
+
+TEST(MethodDef, RemoveIndirectionTablesOnSave)
+{
+    dncp::com_ptr<IMetaDataDispenserEx> dispenser;
+    ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenserEx, (void**)&dispenser));
+    VARIANT option;
+    V_VT(&option) = VT_UI4;
+    V_UI4(&option) = 1;
+    ASSERT_EQ(S_OK, dispenser->SetOption(MetaDataRemoveIndirectionTables, &option));
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_EQ(S_OK, dispenser->DefineScope(CLSID_CorMetaDataRuntime, 0, IID_IMetaDataEmit, (IUnknown**)&emit));
+    RecordingTokenMap tokenMap;
+    ASSERT_EQ(S_OK, emit->SetHandler(&tokenMap));
+
+    std::array sig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeDef type1;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type1"), tdSealed, mdTypeDefNil, nullptr, &type1));
+    mdTypeDef type2;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Type2"), tdSealed, mdTypeDefNil, nullptr, &type2));
+
+    // Adding a method to the first type after the second type has methods requires a MethodPtr table.
+    mdMethodDef methodB;
+    ASSERT_EQ(S_OK, emit->DefineMethod(type2, W("B"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &methodB));
+    mdMethodDef methodA;
+    ASSERT_EQ(S_OK, emit->DefineMethod(type1, W("A"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &methodA));
+    ASSERT_EQ(TokenFromRid(1, mdtMethodDef), methodB);
+    ASSERT_EQ(TokenFromRid(2, mdtMethodDef), methodA);
+
+    // The CustomAttribute table is sorted by parent, so moving the methods reorders the attributes.
+    std::array value = { (uint8_t)0x01, (uint8_t)0x00, (uint8_t)0x00, (uint8_t)0x00 };
+    mdCustomAttribute attrB;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(methodB, methodB, value.data(), (ULONG)value.size(), &attrB));
+    mdCustomAttribute attrA;
+    ASSERT_EQ(S_OK, emit->DefineCustomAttribute(methodA, methodB, value.data(), (ULONG)value.size(), &attrA));
+
+    DWORD saveSize;
+    ASSERT_EQ(S_OK, emit->GetSaveSize(cssAccurate, &saveSize));
+    EXPECT_THAT(tokenMap.Remaps, testing::ContainerEq(std::map<mdToken, mdToken>{
+        { methodB, methodA },
+        { methodA, methodB },
+        { attrB, attrA },
+        { attrA, attrB },
+    }));
+
+    // The scope reflects the new tokens.
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    HCORENUM hEnum = nullptr;
+    mdMethodDef methods[2];
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumMethods(&hEnum, type1, methods, 2, &count));
+    import->CloseEnum(hEnum);
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(TokenFromRid(1, mdtMethodDef), methods[0]);
+
+    mdToken parent;
+    mdToken ctor;
+    void const* blob;
+    ULONG blobLength;
+    ASSERT_EQ(S_OK, import->GetCustomAttributeProps(TokenFromRid(1, mdtCustomAttribute), &parent, &ctor, &blob, &blobLength));
+    EXPECT_EQ(TokenFromRid(1, mdtMethodDef), parent);
+    EXPECT_EQ(TokenFromRid(2, mdtMethodDef), ctor);
+
+    // The saved image has a compressed table heap.
+    std::vector<uint8_t> image(saveSize);
+    ASSERT_EQ(S_OK, emit->SaveToMemory(image.data(), saveSize));
+    std::array<uint8_t, 3> const compressedTablesName = { '#', '~', '\0' };
+    EXPECT_NE(image.end(), std::search(image.begin(), image.end(), compressedTablesName.begin(), compressedTablesName.end()));
+
+    dncp::com_ptr<IMetaDataImport> saved;
+    ASSERT_EQ(S_OK, dispenser->OpenScopeOnMemory(image.data(), saveSize, ofReadOnly, IID_IMetaDataImport, (IUnknown**)&saved));
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, saved->EnumMethods(&hEnum, type2, methods, 2, &count));
+    saved->CloseEnum(hEnum);
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(TokenFromRid(2, mdtMethodDef), methods[0]);
+}
+
+TEST(MethodDef, RemoveIndirectionTablesOnSaveKeepsEncTables)
+{
+    // Build an image with a MethodPtr table and an ENCLog row.
+    dncp::com_ptr<IMetaDataEmit> baseEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(baseEmit));
+    std::array sig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    mdTypeDef type1;
+    ASSERT_EQ(S_OK, baseEmit->DefineTypeDef(W("Type1"), tdSealed, mdTypeDefNil, nullptr, &type1));
+    mdTypeDef type2;
+    ASSERT_EQ(S_OK, baseEmit->DefineTypeDef(W("Type2"), tdSealed, mdTypeDefNil, nullptr, &type2));
+    mdMethodDef methodB;
+    ASSERT_EQ(S_OK, baseEmit->DefineMethod(type2, W("B"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &methodB));
+    mdMethodDef methodA;
+    ASSERT_EQ(S_OK, baseEmit->DefineMethod(type1, W("A"), mdStatic, sig.data(), (ULONG)sig.size(), 0, 0, &methodA));
+
+    DWORD baseSize;
+    ASSERT_EQ(S_OK, baseEmit->GetSaveSize(cssAccurate, &baseSize));
+    std::vector<uint8_t> baseImage(baseSize);
+    ASSERT_EQ(S_OK, baseEmit->SaveToMemory(baseImage.data(), baseSize));
+
+    std::vector<uint8_t> encImage;
+    {
+        mdhandle_t handle;
+        ASSERT_TRUE(md_create_handle(baseImage.data(), baseImage.size(), &handle));
+        mdhandle_ptr handlePtr{ handle };
+        {
+            md_added_row_t encLog;
+            ASSERT_TRUE(md_append_row(handle, mdtid_ENCLog, &encLog));
+            ASSERT_TRUE(md_set_column_value_as_constant(encLog, mdtENCLog_Token, methodA));
+            ASSERT_TRUE(md_set_column_value_as_constant(encLog, mdtENCLog_Op, 0));
+        }
+        size_t encSize = 0;
+        ASSERT_FALSE(md_write_to_buffer(handle, nullptr, &encSize));
+        encImage.resize(encSize);
+        ASSERT_TRUE(md_write_to_buffer(handle, encImage.data(), &encSize));
+    }
+
+    dncp::com_ptr<IMetaDataDispenserEx> dispenser;
+    ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenserEx, (void**)&dispenser));
+    VARIANT option;
+    V_VT(&option) = VT_UI4;
+    V_UI4(&option) = 1;
+    ASSERT_EQ(S_OK, dispenser->SetOption(MetaDataRemoveIndirectionTables, &option));
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_EQ(S_OK, dispenser->OpenScopeOnMemory(encImage.data(), (ULONG)encImage.size(), 0, IID_IMetaDataEmit, (IUnknown**)&emit));
+    RecordingTokenMap tokenMap;
+    ASSERT_EQ(S_OK, emit->SetHandler(&tokenMap));
+
+    // The EnC log refers to the existing tokens, so the image is saved with its indirection tables.
+    DWORD saveSize;
+    ASSERT_EQ(S_OK, emit->GetSaveSize(cssAccurate, &saveSize));
+    std::vector<uint8_t> image(saveSize);
+    ASSERT_EQ(S_OK, emit->SaveToMemory(image.data(), saveSize));
+    EXPECT_TRUE(tokenMap.Remaps.empty());
+    std::array<uint8_t, 3> const uncompressedTablesName = { '#', '-', '\0' };
+    EXPECT_NE(image.end(), std::search(image.begin(), image.end(), uncompressedTablesName.begin(), uncompressedTablesName.end()));
+
+    dncp::com_ptr<IMetaDataImport> saved;
+    ASSERT_EQ(S_OK, dispenser->OpenScopeOnMemory(image.data(), saveSize, ofReadOnly, IID_IMetaDataImport, (IUnknown**)&saved));
+    HCORENUM hEnum = nullptr;
+    mdMethodDef methods[2];
+    ULONG count;
+    ASSERT_EQ(S_OK, saved->EnumMethods(&hEnum, type1, methods, 2, &count));
+    saved->CloseEnum(hEnum);
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(methodA, methods[0]);
+}
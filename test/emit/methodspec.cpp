@@ -0,0 +1,21 @@
+#include "emit.hpp"
+#include <array>
+
+TEST(MethodSpec, DefineDuplicate)
+{
+    // Methods instantiated over the same arguments share a MethodSpec when requested.
+    dncp::com_ptr<IMetaDataEmit2> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit, MDDupMethodSpec));
+    std::array<uint8_t, 3> signature = {IMAGE_CEE_CS_CALLCONV_DEFAULT, 0x00, ELEMENT_TYPE_VOID};
+    mdMemberRef method;
+    ASSERT_EQ(S_OK, emit->DefineMemberRef(TokenFromRid(1, mdtTypeDef), W("Foo"), signature.data(), (ULONG)signature.size(), &method));
+
+    std::array<uint8_t, 3> instantiation = {IMAGE_CEE_CS_CALLCONV_GENERICINST, 0x01, ELEMENT_TYPE_I4};
+    std::array<uint8_t, 3> otherInstantiation = {IMAGE_CEE_CS_CALLCONV_GENERICINST, 0x01, ELEMENT_TYPE_I8};
+    mdMethodSpec methodSpec1, methodSpec2, other;
+    ASSERT_EQ(S_OK, emit->DefineMethodSpec(method, instantiation.data(), (ULONG)instantiation.size(), &methodSpec1));
+    ASSERT_EQ(S_OK, emit->DefineMethodSpec(method, otherInstantiation.data(), (ULONG)otherInstantiation.size(), &other));
+    ASSERT_EQ(S_OK, emit->DefineMethodSpec(method, instantiation.data(), (ULONG)instantiation.size(), &methodSpec2));
+    EXPECT_EQ(methodSpec1, methodSpec2);
+    EXPECT_NE(methodSpec1, other);
+}
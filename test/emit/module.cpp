@@ -1,4 +1,6 @@
 #include "emit.hpp"
+#include <dnmd.hpp>
+#include <cstring>
 
 TEST(Module, ModuleNameExcludesDirectoryWin32Paths)
 {
@@ -85,4 +87,30 @@ TEST(Module, NullName)
     dncp::com_ptr<IMetaDataEmit> emit;
     ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
     ASSERT_EQ(S_OK, emit->SetModuleProps(nullptr));
-}
\ No newline at end of file
+}
+TEST(Module, GatherGuidColumns)
+{
+    mdhandle_ptr handle{ md_create_new_handle() };
+    ASSERT_NE(nullptr, handle.get());
+
+    mdcursor_t module;
+    ASSERT_TRUE(md_token_to_cursor(handle.get(), TokenFromRid(1, mdtModule), &module));
+    mdguid_t mvid = { 0x01020304, 0x0506, 0x0708, { 9, 10, 11, 12, 13, 14, 15, 16 } };
+    mdguid_t encId = { 0xa0b0c0d0, 0xe0f0, 0x1020, { 1, 2, 3, 4, 5, 6, 7, 8 } };
+    ASSERT_TRUE(md_set_column_value_as_guid(module, mdtModule_Mvid, mvid));
+    ASSERT_TRUE(md_set_column_value_as_guid(module, mdtModule_EncId, encId));
+
+    std::array<mdToken, 2> tokens = { TokenFromRid(1, mdtModule), TokenFromRid(1, mdtModule) };
+    std::array<mdcolumnvalue_t, 2> values;
+    ASSERT_TRUE(md_gather_column_values(handle.get(), mdtModule_Mvid, tokens.data(), (uint32_t)tokens.size(), values.data()));
+    for (mdcolumnvalue_t const& value : values)
+        EXPECT_EQ(0, std::memcmp(&mvid, &value.guid, sizeof(mdguid_t)));
+
+    ASSERT_TRUE(md_gather_column_values(handle.get(), mdtModule_EncId, tokens.data(), 1, values.data()));
+    EXPECT_EQ(0, std::memcmp(&encId, &values[0].guid, sizeof(mdguid_t)));
+
+    // A zero #GUID index is the null GUID.
+    mdguid_t nullGuid = {};
+    ASSERT_TRUE(md_gather_column_values(handle.get(), mdtModule_EncBaseId, tokens.data(), 1, values.data()));
+    EXPECT_EQ(0, std::memcmp(&nullGuid, &values[0].guid, sizeof(mdguid_t)));
+}
@@ -20,4 +20,16 @@ TEST(ModuleRef, Define)
     ULONG readNameLength;
     ASSERT_EQ(S_OK, import->GetModuleRefProps(moduleRef, readName.data(), (ULONG)readName.capacity(), &readNameLength));
     EXPECT_EQ(name, readName.substr(0, readNameLength - 1));
-}
\ No newline at end of file
+}
+
+TEST(ModuleRef, DefineDuplicate)
+{
+    dncp::com_ptr<IMetaDataEmit2> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit, MDDupModuleRef));
+    mdModuleRef moduleRef1, moduleRef2, other;
+    ASSERT_EQ(S_OK, emit->DefineModuleRef(W("Foo"), &moduleRef1));
+    ASSERT_EQ(S_OK, emit->DefineModuleRef(W("Bar"), &other));
+    ASSERT_EQ(S_OK, emit->DefineModuleRef(W("Foo"), &moduleRef2));
+    EXPECT_EQ(moduleRef1, moduleRef2);
+    EXPECT_NE(moduleRef1, other);
+}
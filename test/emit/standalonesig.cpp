@@ -20,4 +20,27 @@ TEST(StandaloneSig, Define)
     ULONG sigBlobLength;
     ASSERT_EQ(S_OK, import->GetSigFromToken(sig, &sigBlob, &sigBlobLength));
     EXPECT_THAT(std::vector(sigBlob, sigBlob + sigBlobLength), testing::ContainerEq(std::vector(signature.begin(), signature.end())));
-}
\ No newline at end of file
+}
+
+TEST(StandaloneSig, DefineDuplicate)
+{
+    std::array<uint8_t, 3> signature = {0x01, 0x02, 0x03};
+    std::array<uint8_t, 3> otherSignature = {0x01, 0x02, 0x04};
+
+    // Duplicates are only found when requested.
+    dncp::com_ptr<IMetaDataEmit2> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdSignature sig1, sig2;
+    ASSERT_EQ(S_OK, emit->GetTokenFromSig(signature.data(), (ULONG)signature.size(), &sig1));
+    ASSERT_EQ(S_OK, emit->GetTokenFromSig(signature.data(), (ULONG)signature.size(), &sig2));
+    EXPECT_NE(sig1, sig2);
+
+    dncp::com_ptr<IMetaDataEmit2> dedupEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(dedupEmit, MDDupSignature));
+    mdSignature other;
+    ASSERT_EQ(S_OK, dedupEmit->GetTokenFromSig(signature.data(), (ULONG)signature.size(), &sig1));
+    ASSERT_EQ(S_OK, dedupEmit->GetTokenFromSig(otherSignature.data(), (ULONG)otherSignature.size(), &other));
+    ASSERT_EQ(S_OK, dedupEmit->GetTokenFromSig(signature.data(), (ULONG)signature.size(), &sig2));
+    EXPECT_EQ(sig1, sig2);
+    EXPECT_NE(sig1, other);
+}
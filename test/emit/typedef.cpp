@@ -1,4 +1,7 @@
 #include "emit.hpp"
+#include <dnmd.hpp>
+#include <array>
+#include <vector>
 
 TEST(TypeDef, Define)
 {
@@ -201,3 +204,364 @@ TEST(TypeDef, SetProps)
     EXPECT_EQ(typeDef, classType);
     EXPECT_EQ(implements[0], interfaceType);
 }
+
+TEST(TypeDef, DefineWithNameCache)
+{
+    dncp::com_ptr<IMetaDataDispenserEx> dispenser;
+    ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenserEx, (void**)&dispenser));
+    VARIANT option;
+    V_VT(&option) = VT_UI4;
+    V_UI4(&option) = 16;
+    ASSERT_EQ(S_OK, dispenser->SetOption(MetaDataNameCacheSize, &option));
+
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_EQ(S_OK, dispenser->DefineScope(CLSID_CorMetaDataRuntime, 0, IID_IMetaDataEmit, (IUnknown**)&emit));
+
+    WSTR_string name = W("Namespace.Foo");
+    mdTypeDef typeDef;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(name.c_str(), 0, mdTypeDefNil, nullptr, &typeDef));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    // Read the name multiple times to read from the cache.
+    for (int i = 0; i < 2; ++i)
+    {
+        WSTR_string readName;
+        readName.resize(name.size() + 1);
+        ULONG readNameLength;
+        DWORD typeDefFlags;
+        mdToken extends;
+        ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef, nullptr, 0, &readNameLength, &typeDefFlags, &extends));
+        EXPECT_EQ(name.size() + 1, readNameLength);
+        ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef, readName.data(), (ULONG)readName.size(), &readNameLength, &typeDefFlags, &extends));
+        EXPECT_EQ(name, readName.substr(0, readNameLength - 1));
+    }
+
+    WCHAR truncated[4];
+    ULONG readNameLength;
+    DWORD typeDefFlags;
+    mdToken extends;
+    ASSERT_EQ(CLDB_S_TRUNCATION, import->GetTypeDefProps(typeDef, truncated, 4, &readNameLength, &typeDefFlags, &extends));
+    EXPECT_EQ(name.size() + 1, readNameLength);
+    EXPECT_EQ(name.substr(0, 3), WSTR_string(truncated));
+
+    // Defining new names must not affect names that were already read.
+    WSTR_string name2 = W("Namespace.Bar");
+    mdTypeDef typeDef2;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(name2.c_str(), 0, mdTypeDefNil, nullptr, &typeDef2));
+
+    WSTR_string readName;
+    readName.resize(name2.size() + 1);
+    ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef2, readName.data(), (ULONG)readName.size(), &readNameLength, &typeDefFlags, &extends));
+    EXPECT_EQ(name2, readName.substr(0, readNameLength - 1));
+    ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef, readName.data(), (ULONG)readName.size(), &readNameLength, &typeDefFlags, &extends));
+    EXPECT_EQ(name, readName.substr(0, readNameLength - 1));
+}
+
+TEST(TypeDef, FindByName)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdToken implements = mdTokenNil;
+    mdTypeDef foo;
+    mdTypeDef bar;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("NS.Foo"), 0, mdTypeDefNil, &implements, &foo));
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("NS.Bar"), 0, mdTypeDefNil, &implements, &bar));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    mdTypeDef found;
+    ASSERT_EQ(S_OK, import->FindTypeDefByName(W("NS.Foo"), mdTokenNil, &found));
+    EXPECT_EQ(foo, found);
+    ASSERT_EQ(S_OK, import->FindTypeDefByName(W("NS.Bar"), mdTokenNil, &found));
+    EXPECT_EQ(bar, found);
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindTypeDefByName(W("NS.Fo"), mdTokenNil, &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindTypeDefByName(W("Foo"), mdTokenNil, &found));
+
+    // Names added after a lookup must still be found.
+    mdTypeDef baz;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("NS.Baz"), 0, mdTypeDefNil, &implements, &baz));
+    ASSERT_EQ(S_OK, import->FindTypeDefByName(W("NS.Baz"), mdTokenNil, &found));
+    EXPECT_EQ(baz, found);
+}
+
+TEST(TypeDef, EnumMembersWithName)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef type;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Foo"), tdSealed, mdTypeDefNil, nullptr, &type));
+
+    std::array methodSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    std::array fieldSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, (uint8_t)ELEMENT_TYPE_I4 };
+    std::array<mdMethodDef, 3> methods;
+    std::array<mdFieldDef, 2> fields;
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &methods[0]));
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("N"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &methods[1]));
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &methods[2]));
+    ASSERT_EQ(S_OK, emit->DefineField(type, W("M"), fdStatic, fieldSig.data(), (ULONG)fieldSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &fields[0]));
+    ASSERT_EQ(S_OK, emit->DefineField(type, W("F"), fdStatic, fieldSig.data(), (ULONG)fieldSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &fields[1]));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    // Matches are produced as they're read, counting or resetting finds the rest.
+    HCORENUM hEnum = nullptr;
+    std::array<mdToken, 4> members;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), 1, &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(methods[0], members[0]);
+
+    ULONG total;
+    ASSERT_EQ(S_OK, import->CountEnum(hEnum, &total));
+    EXPECT_EQ(3u, total);
+
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), (ULONG)members.size(), &count));
+    ASSERT_EQ(2u, count);
+    EXPECT_EQ(methods[2], members[0]);
+    EXPECT_EQ(fields[0], members[1]);
+
+    ASSERT_EQ(S_OK, import->ResetEnum(hEnum, 0));
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), (ULONG)members.size(), &count));
+    EXPECT_EQ(3u, count);
+    import->CloseEnum(hEnum);
+}
+
+TEST(TypeDef, EnumMembersWithNameWhileEmitting)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef type;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Foo"), tdSealed, mdTypeDefNil, nullptr, &type));
+
+    std::array methodSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    std::array<mdMethodDef, 2> methods;
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &methods[0]));
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &methods[1]));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    // The enumerator holds the members that existed when it was created.
+    HCORENUM hEnum = nullptr;
+    std::array<mdToken, 4> members;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), 1, &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(methods[0], members[0]);
+
+    mdMethodDef added;
+    ASSERT_EQ(S_OK, emit->DefineMethod(type, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0, 0, &added));
+
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), (ULONG)members.size(), &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(methods[1], members[0]);
+    ASSERT_EQ(S_OK, import->ResetEnum(hEnum, 0));
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), (ULONG)members.size(), &count));
+    EXPECT_EQ(2u, count);
+    import->CloseEnum(hEnum);
+
+    // A new enumerator sees the added member.
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, import->EnumMembersWithName(&hEnum, type, W("M"), members.data(), (ULONG)members.size(), &count));
+    ASSERT_EQ(3u, count);
+    EXPECT_EQ(added, members[2]);
+    import->CloseEnum(hEnum);
+}
+
+TEST(TypeDef, GetPropsBatch)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef outer, nested;
+    mdToken implements = mdTokenNil;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(W("Ns.Outer"), tdPublic, TokenFromRid(1, mdtTypeRef), &implements, &outer));
+    ASSERT_EQ(S_OK, emit->DefineNestedType(W("Inner"), tdSealed, mdTypeDefNil, &implements, outer, &nested));
+
+    std::array methodSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_DEFAULT, (uint8_t)0, (uint8_t)ELEMENT_TYPE_VOID };
+    std::array fieldSig = { (uint8_t)IMAGE_CEE_CS_CALLCONV_FIELD, (uint8_t)ELEMENT_TYPE_I4 };
+    std::array<mdMethodDef, 2> methods;
+    std::array<mdFieldDef, 1> fields;
+    ASSERT_EQ(S_OK, emit->DefineMethod(nested, W("M"), mdStatic, methodSig.data(), (ULONG)methodSig.size(), 0x2050, miIL, &methods[0]));
+    ASSERT_EQ(S_OK, emit->DefineMethod(nested, W("N"), mdPublic, methodSig.data(), (ULONG)methodSig.size(), 0, miRuntime, &methods[1]));
+    ASSERT_EQ(S_OK, emit->DefineField(nested, W("F"), fdStatic, fieldSig.data(), (ULONG)fieldSig.size(), ELEMENT_TYPE_VOID, nullptr, 0, &fields[0]));
+
+    dncp::com_ptr<IDNMDImportBatch> batch;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IDNMDImportBatch, (void**)&batch));
+
+    std::array types = { outer, nested };
+    std::array<DWORD, 2> typeFlags;
+    std::array<mdToken, 2> extends;
+    std::array<mdTypeDef, 2> enclosing;
+    std::array<char const*, 2> namespaces;
+    std::array<char const*, 2> typeNames;
+    ASSERT_EQ(S_OK, batch->GetTypeDefPropsBatch(types.data(), (ULONG)types.size(), typeFlags.data(), extends.data(), enclosing.data(), namespaces.data(), typeNames.data()));
+    EXPECT_EQ((DWORD)tdPublic, typeFlags[0]);
+    EXPECT_EQ((DWORD)tdSealed, typeFlags[1]);
+    EXPECT_EQ(TokenFromRid(1, mdtTypeRef), extends[0]);
+    EXPECT_EQ(mdTypeRefNil, extends[1]);
+    EXPECT_EQ(mdTypeDefNil, enclosing[0]);
+    EXPECT_EQ(outer, enclosing[1]);
+    EXPECT_STREQ("Ns", namespaces[0]);
+    EXPECT_STREQ("Outer", typeNames[0]);
+    EXPECT_STREQ("", namespaces[1]);
+    EXPECT_STREQ("Inner", typeNames[1]);
+
+    std::array<mdTypeDef, 2> classes;
+    std::array<DWORD, 2> methodFlags;
+    std::array<DWORD, 2> implFlags;
+    std::array<ULONG, 2> rvas;
+    std::array<char const*, 2> methodNames;
+    std::array<PCCOR_SIGNATURE, 2> sigs;
+    std::array<ULONG, 2> sigLengths;
+    ASSERT_EQ(S_OK, batch->GetMethodPropsBatch(methods.data(), (ULONG)methods.size(), classes.data(), methodFlags.data(), implFlags.data(), rvas.data(), methodNames.data(), sigs.data(), sigLengths.data()));
+    for (size_t i = 0; i < methods.size(); ++i)
+    {
+        EXPECT_EQ(nested, classes[i]);
+        ASSERT_EQ(methodSig.size(), sigLengths[i]);
+        EXPECT_EQ(0, memcmp(methodSig.data(), sigs[i], methodSig.size()));
+    }
+    EXPECT_EQ((DWORD)mdStatic, methodFlags[0]);
+    EXPECT_EQ((DWORD)mdPublic, methodFlags[1]);
+    EXPECT_EQ((DWORD)miIL, implFlags[0]);
+    EXPECT_EQ((DWORD)miRuntime, implFlags[1]);
+    EXPECT_EQ(0x2050u, rvas[0]);
+    EXPECT_EQ(0u, rvas[1]);
+    EXPECT_STREQ("M", methodNames[0]);
+    EXPECT_STREQ("N", methodNames[1]);
+
+    // Outputs are optional.
+    std::array<DWORD, 1> fieldFlags;
+    std::array<char const*, 1> fieldNames;
+    ASSERT_EQ(S_OK, batch->GetFieldPropsBatch(fields.data(), (ULONG)fields.size(), classes.data(), fieldFlags.data(), fieldNames.data(), nullptr, nullptr));
+    EXPECT_EQ(nested, classes[0]);
+    EXPECT_EQ((DWORD)fdStatic, fieldFlags[0]);
+    EXPECT_STREQ("F", fieldNames[0]);
+
+    // The batch stops at the first token that can't be read.
+    std::array<mdFieldDef, 2> badFields = { fields[0], TokenFromRid(5, mdtFieldDef) };
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, batch->GetFieldPropsBatch(badFields.data(), (ULONG)badFields.size(), nullptr, nullptr, nullptr, nullptr, nullptr));
+    EXPECT_EQ(E_INVALIDARG, batch->GetFieldPropsBatch(methods.data(), (ULONG)methods.size(), nullptr, nullptr, nullptr, nullptr, nullptr));
+}
+
+TEST(TypeDef, DefineWithNonAsciiName)
+{
+    // ASCII runs longer than a 16 code unit block on either side of two, three and four byte UTF-8 sequences.
+    WSTR_string name = W("AbcdefghijklmnopqrsT");
+    name += (WCHAR)0x00e9;
+    name += (WCHAR)0x4e2d;
+    name += (WCHAR)0xd83d;
+    name += (WCHAR)0xde00;
+    name += W("uvwxyzABCDEFGHIJK");
+    std::string expectedUtf8 = "AbcdefghijklmnopqrsT\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80uvwxyzABCDEFGHIJK";
+
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef typeDef;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(name.c_str(), 0, mdTypeDefNil, nullptr, &typeDef));
+
+    dncp::com_ptr<IDNMDImportBatch> batch;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IDNMDImportBatch, (void**)&batch));
+    char const* utf8Name;
+    ASSERT_EQ(S_OK, batch->GetTypeDefPropsBatch(&typeDef, 1, nullptr, nullptr, nullptr, nullptr, &utf8Name));
+    EXPECT_EQ(expectedUtf8, utf8Name);
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    WSTR_string readName;
+    readName.resize(name.size() + 1);
+    ULONG readNameLength;
+    DWORD typeDefFlags;
+    mdToken extends;
+    ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef, readName.data(), (ULONG)readName.size(), &readNameLength, &typeDefFlags, &extends));
+    ASSERT_EQ(name.size() + 1, readNameLength);
+    EXPECT_EQ(name, readName.substr(0, readNameLength - 1));
+
+    // A truncated name reports the full length.
+    std::array<WCHAR, 22> truncated;
+    ASSERT_EQ(CLDB_S_TRUNCATION, import->GetTypeDefProps(typeDef, truncated.data(), (ULONG)truncated.size(), &readNameLength, &typeDefFlags, &extends));
+    EXPECT_EQ(name.size() + 1, readNameLength);
+    EXPECT_EQ(name.substr(0, truncated.size() - 1), WSTR_string(truncated.data()));
+
+    mdTypeDef found;
+    ASSERT_EQ(S_OK, import->FindTypeDefByName(name.c_str(), mdTokenNil, &found));
+    EXPECT_EQ(typeDef, found);
+}
+
+TEST(TypeDef, DefineWithIllFormedName)
+{
+    // Unpaired surrogates are replaced with U+FFFD.
+    WSTR_string name = W("A");
+    name += (WCHAR)0xd800;
+    name += W("B");
+    name += (WCHAR)0xdc00;
+    WSTR_string expectedName = W("A");
+    expectedName += (WCHAR)0xfffd;
+    expectedName += W("B");
+    expectedName += (WCHAR)0xfffd;
+
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeDef typeDef;
+    ASSERT_EQ(S_OK, emit->DefineTypeDef(name.c_str(), 0, mdTypeDefNil, nullptr, &typeDef));
+
+    dncp::com_ptr<IDNMDImportBatch> batch;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IDNMDImportBatch, (void**)&batch));
+    char const* utf8Name;
+    ASSERT_EQ(S_OK, batch->GetTypeDefPropsBatch(&typeDef, 1, nullptr, nullptr, nullptr, nullptr, &utf8Name));
+    EXPECT_STREQ("A\xef\xbf\xbd" "B\xef\xbf\xbd", utf8Name);
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    std::array<WCHAR, 16> readName;
+    ULONG readNameLength;
+    DWORD typeDefFlags;
+    mdToken extends;
+    ASSERT_EQ(S_OK, import->GetTypeDefProps(typeDef, readName.data(), (ULONG)readName.size(), &readNameLength, &typeDefFlags, &extends));
+    EXPECT_EQ(expectedName, WSTR_string(readName.data()));
+}
+
+TEST(TypeDef, GatherExtendsColumn)
+{
+    mdhandle_ptr handle{ md_create_new_handle() };
+    ASSERT_NE(nullptr, handle.get());
+
+    for (int i = 0; i < 2; ++i)
+    {
+        md_added_row_t typeRef;
+        ASSERT_TRUE(md_append_row(handle.get(), mdtid_TypeRef, &typeRef));
+    }
+    {
+        md_added_row_t typeSpec;
+        ASSERT_TRUE(md_append_row(handle.get(), mdtid_TypeSpec, &typeSpec));
+    }
+
+    // Each TypeDefOrRef tag, plus a nil base type.
+    std::vector<mdToken> extends = { TokenFromRid(2, mdtTypeRef), TokenFromRid(1, mdtTypeDef), TokenFromRid(1, mdtTypeSpec), mdTypeDefNil, TokenFromRid(1, mdtTypeRef) };
+    std::vector<mdToken> typeDefs;
+    for (mdToken tk : extends)
+    {
+        md_added_row_t typeDef;
+        ASSERT_TRUE(md_append_row(handle.get(), mdtid_TypeDef, &typeDef));
+        ASSERT_TRUE(md_set_column_value_as_token(typeDef, mdtTypeDef_Extends, tk));
+        mdToken typeDefToken;
+        ASSERT_TRUE(md_cursor_to_token(typeDef, &typeDefToken));
+        typeDefs.push_back(typeDefToken);
+    }
+
+    // Gather the rows out of order.
+    std::vector<mdToken> tokens = { typeDefs[3], typeDefs[0], typeDefs[4], typeDefs[2], typeDefs[1] };
+    std::vector<mdToken> expected = { extends[3], extends[0], extends[4], extends[2], extends[1] };
+    std::vector<mdcolumnvalue_t> values(tokens.size());
+    ASSERT_TRUE(md_gather_column_values(handle.get(), mdtTypeDef_Extends, tokens.data(), (uint32_t)tokens.size(), values.data()));
+    for (size_t i = 0; i < tokens.size(); ++i)
+        EXPECT_EQ(expected[i], values[i].token);
+
+    // A token past the end of the table fails the whole gather.
+    tokens.push_back(TokenFromRid((uint32_t)typeDefs.size() + 2, mdtTypeDef));
+    values.resize(tokens.size());
+    EXPECT_FALSE(md_gather_column_values(handle.get(), mdtTypeDef_Extends, tokens.data(), (uint32_t)tokens.size(), values.data()));
+}
@@ -1,4 +1,5 @@
 #include "emit.hpp"
+#include <cstring>
 
 TEST(TypeRef, ValidScopeAndDottedName)
 {
@@ -50,4 +51,170 @@ TEST(TypeRef, ValidScopeAndNonDottedName)
     EXPECT_EQ(TokenFromRid(1, mdtModule), resolutionScope);
     EXPECT_EQ(readNameLength, name.size() + 1);
     EXPECT_EQ(name, readName.substr(0, readNameLength - 1));
-}
\ No newline at end of file
+}
+
+TEST(TypeRef, Find)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    mdTypeRef objectRef;
+    mdTypeRef stringRef;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Object"), &objectRef));
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.String"), &stringRef));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+    mdTypeRef found;
+    ASSERT_EQ(S_OK, import->FindTypeRef(TokenFromRid(1, mdtModule), W("System.String"), &found));
+    EXPECT_EQ(stringRef, found);
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindTypeRef(TokenFromRid(1, mdtModule), W("System.Int32"), &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindTypeRef(TokenFromRid(1, mdtModuleRef), W("System.String"), &found));
+    EXPECT_EQ(CLDB_E_RECORD_NOTFOUND, import->FindTypeRef(TokenFromRid(1, mdtModule), W("System"), &found));
+
+    // Type refs defined after the first lookup are found as well.
+    mdTypeRef lastRef = mdTypeRefNil;
+    for (int i = 0; i < 64; ++i)
+    {
+        WSTR_string name = W("Ns.Type") + WSTR_string(1, (WCHAR)(W('A') + i));
+        ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), name.c_str(), &lastRef));
+        ASSERT_EQ(S_OK, import->FindTypeRef(TokenFromRid(1, mdtModule), name.c_str(), &found));
+        EXPECT_EQ(lastRef, found);
+    }
+    ASSERT_EQ(S_OK, import->FindTypeRef(TokenFromRid(1, mdtModule), W("System.Object"), &found));
+    EXPECT_EQ(objectRef, found);
+
+    // The first matching type ref is returned.
+    mdTypeRef duplicateRef;
+    ASSERT_EQ(S_OK, emit->DefineTypeRefByName(TokenFromRid(1, mdtModule), W("System.Object"), &duplicateRef));
+    ASSERT_EQ(S_OK, import->FindTypeRef(TokenFromRid(1, mdtModule), W("System.Object"), &found));
+    EXPECT_EQ(objectRef, found);
+}
+
+TEST(TypeRef, TranslateSigWithScopeImportsOnce)
+{
+    dncp::com_ptr<IMetaDataAssemblyEmit> sourceAssemblyEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(sourceAssemblyEmit));
+    dncp::com_ptr<IMetaDataEmit> sourceEmit;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->QueryInterface(IID_IMetaDataEmit, (void**)&sourceEmit));
+
+    ASSEMBLYMETADATA assemblyMetadata{};
+    assemblyMetadata.szLocale = const_cast<LPWSTR>(W(""));
+    mdAssembly assembly;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->DefineAssembly(nullptr, 0, 0, W("Source"), &assemblyMetadata, 0, &assembly));
+    mdAssemblyRef assemblyRef;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->DefineAssemblyRef(nullptr, 0, W("Lib"), &assemblyMetadata, nullptr, 0, 0, &assemblyRef));
+    mdTypeRef typeRef;
+    ASSERT_EQ(S_OK, sourceEmit->DefineTypeRefByName(assemblyRef, W("Lib.Foo"), &typeRef));
+    ASSERT_EQ(1, RidFromToken(typeRef));
+
+    dncp::com_ptr<IMetaDataAssemblyEmit> targetAssemblyEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(targetAssemblyEmit));
+    dncp::com_ptr<IMetaDataEmit> targetEmit;
+    ASSERT_EQ(S_OK, targetAssemblyEmit->QueryInterface(IID_IMetaDataEmit, (void**)&targetEmit));
+    ASSERT_EQ(S_OK, targetAssemblyEmit->DefineAssembly(nullptr, 0, 0, W("Target"), &assemblyMetadata, 0, &assembly));
+
+    dncp::com_ptr<IMetaDataAssemblyImport> sourceAssemblyImport;
+    ASSERT_EQ(S_OK, sourceEmit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&sourceAssemblyImport));
+    dncp::com_ptr<IMetaDataImport> sourceImport;
+    ASSERT_EQ(S_OK, sourceEmit->QueryInterface(IID_IMetaDataImport, (void**)&sourceImport));
+
+    // FieldSig of a class type referenced by TypeRef row 1.
+    uint8_t const signature[] = { IMAGE_CEE_CS_CALLCONV_FIELD, ELEMENT_TYPE_CLASS, 0x05 };
+    uint8_t first[16];
+    ULONG firstLength;
+    ASSERT_EQ(S_OK, targetEmit->TranslateSigWithScope(sourceAssemblyImport, nullptr, 0, sourceImport, signature, sizeof(signature), targetAssemblyEmit, targetEmit, first, sizeof(first), &firstLength));
+    uint8_t second[16];
+    ULONG secondLength;
+    ASSERT_EQ(S_OK, targetEmit->TranslateSigWithScope(sourceAssemblyImport, nullptr, 0, sourceImport, signature, sizeof(signature), targetAssemblyEmit, targetEmit, second, sizeof(second), &secondLength));
+
+    // Both translations refer to TypeRef row 1 in the target.
+    uint8_t const expected[] = { IMAGE_CEE_CS_CALLCONV_FIELD, ELEMENT_TYPE_CLASS, 0x05 };
+    ASSERT_EQ(sizeof(expected), firstLength);
+    EXPECT_EQ(0, std::memcmp(expected, first, sizeof(expected)));
+    ASSERT_EQ(sizeof(expected), secondLength);
+    EXPECT_EQ(0, std::memcmp(expected, second, sizeof(expected)));
+
+    // The second translation must reuse the rows added by the first.
+    dncp::com_ptr<IMetaDataImport> targetImport;
+    ASSERT_EQ(S_OK, targetEmit->QueryInterface(IID_IMetaDataImport, (void**)&targetImport));
+    HCORENUM hEnum = nullptr;
+    mdTypeRef typeRefs[2];
+    ULONG count;
+    ASSERT_EQ(S_OK, targetImport->EnumTypeRefs(&hEnum, typeRefs, 2, &count));
+    targetImport->CloseEnum(hEnum);
+    EXPECT_EQ(1, count);
+
+    dncp::com_ptr<IMetaDataAssemblyImport> targetAssemblyImport;
+    ASSERT_EQ(S_OK, targetEmit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&targetAssemblyImport));
+    hEnum = nullptr;
+    mdAssemblyRef assemblyRefs[2];
+    ASSERT_EQ(S_OK, targetAssemblyImport->EnumAssemblyRefs(&hEnum, assemblyRefs, 2, &count));
+    targetAssemblyImport->CloseEnum(hEnum);
+    EXPECT_EQ(1, count);
+}
+
+TEST(TypeRef, TranslateSigWithScopeAfterTargetEdit)
+{
+    dncp::com_ptr<IMetaDataAssemblyEmit> sourceAssemblyEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(sourceAssemblyEmit));
+    dncp::com_ptr<IMetaDataEmit> sourceEmit;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->QueryInterface(IID_IMetaDataEmit, (void**)&sourceEmit));
+
+    ASSEMBLYMETADATA assemblyMetadata{};
+    assemblyMetadata.szLocale = const_cast<LPWSTR>(W(""));
+    mdAssembly assembly;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->DefineAssembly(nullptr, 0, 0, W("Source"), &assemblyMetadata, 0, &assembly));
+    mdAssemblyRef assemblyRef;
+    ASSERT_EQ(S_OK, sourceAssemblyEmit->DefineAssemblyRef(nullptr, 0, W("Lib"), &assemblyMetadata, nullptr, 0, 0, &assemblyRef));
+    mdTypeRef typeRef;
+    ASSERT_EQ(S_OK, sourceEmit->DefineTypeRefByName(assemblyRef, W("Lib.Foo"), &typeRef));
+
+    dncp::com_ptr<IMetaDataAssemblyEmit> targetAssemblyEmit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(targetAssemblyEmit));
+    dncp::com_ptr<IMetaDataEmit> targetEmit;
+    ASSERT_EQ(S_OK, targetAssemblyEmit->QueryInterface(IID_IMetaDataEmit, (void**)&targetEmit));
+    ASSERT_EQ(S_OK, targetAssemblyEmit->DefineAssembly(nullptr, 0, 0, W("Target"), &assemblyMetadata, 0, &assembly));
+
+    dncp::com_ptr<IMetaDataAssemblyImport> sourceAssemblyImport;
+    ASSERT_EQ(S_OK, sourceEmit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&sourceAssemblyImport));
+    dncp::com_ptr<IMetaDataImport> sourceImport;
+    ASSERT_EQ(S_OK, sourceEmit->QueryInterface(IID_IMetaDataImport, (void**)&sourceImport));
+
+    // Translate through the source emitter so its cache holds entries for the target scope.
+    uint8_t const signature[] = { IMAGE_CEE_CS_CALLCONV_FIELD, ELEMENT_TYPE_CLASS, 0x05 };
+    uint8_t translated[16];
+    ULONG translatedLength;
+    ASSERT_EQ(S_OK, sourceEmit->TranslateSigWithScope(sourceAssemblyImport, nullptr, 0, sourceImport, signature, sizeof(signature), targetAssemblyEmit, targetEmit, translated, sizeof(translated), &translatedLength));
+    uint8_t const expectedFirst[] = { IMAGE_CEE_CS_CALLCONV_FIELD, ELEMENT_TYPE_CLASS, 0x05 };
+    ASSERT_EQ(sizeof(expectedFirst), translatedLength);
+    EXPECT_EQ(0, std::memcmp(expectedFirst, translated, sizeof(expectedFirst)));
+
+    // Rename the imported AssemblyRef through the target's own emitter.
+    // The row count doesn't change, but the TypeRef no longer refers to the source's AssemblyRef.
+    dncp::com_ptr<IMetaDataAssemblyImport> targetAssemblyImport;
+    ASSERT_EQ(S_OK, targetEmit->QueryInterface(IID_IMetaDataAssemblyImport, (void**)&targetAssemblyImport));
+    HCORENUM hEnum = nullptr;
+    mdAssemblyRef assemblyRefs[3];
+    ULONG count;
+    ASSERT_EQ(S_OK, targetAssemblyImport->EnumAssemblyRefs(&hEnum, assemblyRefs, 3, &count));
+    targetAssemblyImport->CloseEnum(hEnum);
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(S_OK, targetAssemblyEmit->SetAssemblyRefProps(assemblyRefs[0], nullptr, 0, W("Other"), &assemblyMetadata, nullptr, 0, 0));
+
+    // The second translation imports a new AssemblyRef and TypeRef instead of reusing stale tokens.
+    ASSERT_EQ(S_OK, sourceEmit->TranslateSigWithScope(sourceAssemblyImport, nullptr, 0, sourceImport, signature, sizeof(signature), targetAssemblyEmit, targetEmit, translated, sizeof(translated), &translatedLength));
+    uint8_t const expectedSecond[] = { IMAGE_CEE_CS_CALLCONV_FIELD, ELEMENT_TYPE_CLASS, 0x09 };
+    ASSERT_EQ(sizeof(expectedSecond), translatedLength);
+    EXPECT_EQ(0, std::memcmp(expectedSecond, translated, sizeof(expectedSecond)));
+
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, targetAssemblyImport->EnumAssemblyRefs(&hEnum, assemblyRefs, 3, &count));
+    targetAssemblyImport->CloseEnum(hEnum);
+    ASSERT_EQ(2, count);
+
+    dncp::com_ptr<IMetaDataImport> targetImport;
+    ASSERT_EQ(S_OK, targetEmit->QueryInterface(IID_IMetaDataImport, (void**)&targetImport));
+    mdToken scope;
+    ASSERT_EQ(S_OK, targetImport->GetTypeRefProps(TokenFromRid(2, mdtTypeRef), &scope, nullptr, 0, nullptr));
+    EXPECT_EQ(assemblyRefs[1], scope);
+}
@@ -20,4 +20,17 @@ TEST(TypeSpec, Define)
     ULONG sigBlobLength;
     ASSERT_EQ(S_OK, import->GetTypeSpecFromToken(spec, &sigBlob, &sigBlobLength));
     EXPECT_THAT(std::vector(sigBlob, sigBlob + sigBlobLength), testing::ContainerEq(std::vector(signature.begin(), signature.end())));
-}
\ No newline at end of file
+}
+
+TEST(TypeSpec, DefineDuplicate)
+{
+    dncp::com_ptr<IMetaDataEmit2> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit, MDDupTypeSpec));
+    std::array<uint8_t, 3> signature = {0x01, 0x02, 0x03};
+    mdTypeSpec spec1, spec2, other;
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(signature.data(), (ULONG)signature.size(), &spec1));
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(signature.data(), 2, &other));
+    ASSERT_EQ(S_OK, emit->GetTokenFromTypeSpec(signature.data(), (ULONG)signature.size(), &spec2));
+    EXPECT_EQ(spec1, spec2);
+    EXPECT_NE(spec1, other);
+}
@@ -0,0 +1,39 @@
+#include "emit.hpp"
+#include <array>
+#include <vector>
+#include <gmock/gmock.h>
+
+TEST(UserString, EnumWhileEmitting)
+{
+    dncp::com_ptr<IMetaDataEmit> emit;
+    ASSERT_NO_FATAL_FAILURE(CreateEmit(emit));
+    std::array<mdString, 2> strings;
+    ASSERT_EQ(S_OK, emit->DefineUserString(W("First"), 5, &strings[0]));
+    ASSERT_EQ(S_OK, emit->DefineUserString(W("Second"), 6, &strings[1]));
+
+    dncp::com_ptr<IMetaDataImport> import;
+    ASSERT_EQ(S_OK, emit->QueryInterface(IID_IMetaDataImport, (void**)&import));
+
+    // The enumerator holds the strings that existed when it was created.
+    HCORENUM hEnum = nullptr;
+    std::array<mdString, 4> buffer;
+    ULONG count;
+    ASSERT_EQ(S_OK, import->EnumUserStrings(&hEnum, buffer.data(), 1, &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(strings[0], buffer[0]);
+
+    mdString added;
+    ASSERT_EQ(S_OK, emit->DefineUserString(W("Third"), 5, &added));
+
+    ASSERT_EQ(S_OK, import->EnumUserStrings(&hEnum, buffer.data(), (ULONG)buffer.size(), &count));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(strings[1], buffer[0]);
+    import->CloseEnum(hEnum);
+
+    // A new enumerator sees the added string.
+    hEnum = nullptr;
+    ASSERT_EQ(S_OK, import->EnumUserStrings(&hEnum, buffer.data(), (ULONG)buffer.size(), &count));
+    std::vector<mdString> all(buffer.begin(), buffer.begin() + count);
+    EXPECT_THAT(all, testing::ElementsAre(strings[0], strings[1], added));
+    import->CloseEnum(hEnum);
+}
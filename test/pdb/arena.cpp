@@ -0,0 +1,470 @@
+#include "pdb.hpp"
+
+#include <type_traits>
+
+namespace
+{
+    using ImportEntry = std::remove_extent<decltype(md_imports_t::imports)>::type;
+
+    // An 8-byte aligned arena buffer.
+    struct ArenaBuffer final
+    {
+        std::vector<uint64_t> storage;
+        md_parse_arena_t arena;
+
+        explicit ArenaBuffer(size_t capacity)
+            : storage((capacity + sizeof(uint64_t) - 1) / sizeof(uint64_t) + 1)
+        {
+            md_init_parse_arena(&arena, storage.data(), capacity);
+        }
+    };
+
+    bool IsAligned(void const* ptr)
+    {
+        return (uintptr_t)ptr % sizeof(uint64_t) == 0;
+    }
+
+    // The rows of a table with a non-empty blob in a column.
+    std::vector<mdcursor_t> GetRowsWithBlob(mdhandle_t handle, mdtable_id_t table, col_index_t column)
+    {
+        mdcursor_t c;
+        uint32_t count;
+        EXPECT_TRUE(md_create_cursor(handle, table, &c, &count));
+        std::vector<mdcursor_t> rows;
+        for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&c))
+        {
+            uint8_t const* blob;
+            uint32_t blob_len;
+            EXPECT_TRUE(md_get_column_value_as_blob(c, column, &blob, &blob_len));
+            if (blob_len != 0)
+                rows.push_back(c);
+        }
+        return rows;
+    }
+
+    void GetBlob(mdcursor_t row, col_index_t column, uint8_t const*& blob, uint32_t& blob_len)
+    {
+        ASSERT_TRUE(md_get_column_value_as_blob(row, column, &blob, &blob_len));
+    }
+
+    void ExpectEqual(md_sequence_points_t const& expected, md_sequence_points_t const& actual)
+    {
+        EXPECT_EQ(expected.signature, actual.signature);
+        EXPECT_EQ(GetRowId(expected.document), GetRowId(actual.document));
+        ASSERT_EQ(expected.record_count, actual.record_count);
+        for (uint32_t i = 0; i < expected.record_count; ++i)
+        {
+            SCOPED_TRACE(i);
+            auto const& e = expected.records[i];
+            auto const& a = actual.records[i];
+            ASSERT_EQ(e.kind, a.kind);
+            switch (e.kind)
+            {
+            case mdsp_DocumentRecord:
+                EXPECT_EQ(GetRowId(e.document.document), GetRowId(a.document.document));
+                break;
+            case mdsp_HiddenSequencePointRecord:
+                EXPECT_EQ(e.hidden_sequence_point.rolling_il_offset, a.hidden_sequence_point.rolling_il_offset);
+                break;
+            case mdsp_SequencePointRecord:
+                EXPECT_EQ(e.sequence_point.rolling_il_offset, a.sequence_point.rolling_il_offset);
+                EXPECT_EQ(e.sequence_point.delta_lines, a.sequence_point.delta_lines);
+                EXPECT_EQ(e.sequence_point.delta_columns, a.sequence_point.delta_columns);
+                EXPECT_EQ(e.sequence_point.rolling_start_line, a.sequence_point.rolling_start_line);
+                EXPECT_EQ(e.sequence_point.rolling_start_column, a.sequence_point.rolling_start_column);
+                break;
+            }
+        }
+    }
+
+    void ExpectEqual(md_local_constant_sig_t const& expected, md_local_constant_sig_t const& actual)
+    {
+        ASSERT_EQ(expected.constant_kind, actual.constant_kind);
+        switch (expected.constant_kind)
+        {
+        case md_local_constant_sig_t::mdck_PrimitiveConstant:
+            EXPECT_EQ(expected.primitive.type_code, actual.primitive.type_code);
+            break;
+        case md_local_constant_sig_t::mdck_EnumConstant:
+            EXPECT_EQ(expected.enum_constant.type_code, actual.enum_constant.type_code);
+            EXPECT_EQ(expected.enum_constant.enum_type, actual.enum_constant.enum_type);
+            break;
+        case md_local_constant_sig_t::mdck_GeneralConstant:
+            EXPECT_EQ(expected.general.kind, actual.general.kind);
+            EXPECT_EQ(expected.general.type, actual.general.type);
+            break;
+        }
+        EXPECT_EQ(expected.value_blob, actual.value_blob);
+        EXPECT_EQ(expected.value_len, actual.value_len);
+        ASSERT_EQ(expected.custom_modifier_count, actual.custom_modifier_count);
+        for (uint32_t i = 0; i < expected.custom_modifier_count; ++i)
+        {
+            EXPECT_EQ(expected.custom_modifiers[i].required, actual.custom_modifiers[i].required);
+            EXPECT_EQ(expected.custom_modifiers[i].type, actual.custom_modifiers[i].type);
+        }
+    }
+
+    void ExpectEqual(md_imports_t const& expected, md_imports_t const& actual)
+    {
+        ASSERT_EQ(expected.count, actual.count);
+        for (uint32_t i = 0; i < expected.count; ++i)
+        {
+            SCOPED_TRACE(i);
+            ImportEntry const& e = expected.imports[i];
+            ImportEntry const& a = actual.imports[i];
+            EXPECT_EQ(e.kind, a.kind);
+            EXPECT_EQ(e.alias, a.alias);
+            EXPECT_EQ(e.alias_len, a.alias_len);
+            EXPECT_EQ(e.assembly, a.assembly);
+            EXPECT_EQ(e.target_namespace, a.target_namespace);
+            EXPECT_EQ(e.target_namespace_len, a.target_namespace_len);
+            EXPECT_EQ(e.target_type, a.target_type);
+        }
+    }
+
+    // Parse with the two-call parsers.
+    template<typename T, typename TParse>
+    T* ParseWithBuffer(std::vector<uint64_t>& buffer, TParse parse)
+    {
+        size_t buffer_len = 0;
+        EXPECT_EQ(mdbpr_InsufficientBuffer, parse(nullptr, &buffer_len));
+        buffer.resize((buffer_len + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        EXPECT_EQ(mdbpr_Success, parse((T*)buffer.data(), &buffer_len));
+        return (T*)buffer.data();
+    }
+}
+
+TEST(ParseArena, InitAndReset)
+{
+    uint64_t buffer[4];
+    md_parse_arena_t arena;
+    md_init_parse_arena(&arena, buffer, sizeof(buffer));
+    EXPECT_EQ((uint8_t*)buffer, arena.buffer);
+    EXPECT_EQ(sizeof(buffer), arena.capacity);
+    EXPECT_EQ(0u, arena.used);
+    EXPECT_EQ(0u, arena.needed);
+
+    arena.used = 16;
+    arena.needed = 8;
+    md_reset_parse_arena(&arena);
+    EXPECT_EQ(0u, arena.used);
+    EXPECT_EQ(0u, arena.needed);
+    EXPECT_EQ(sizeof(buffer), arena.capacity);
+
+    // An arena without a buffer has no space.
+    md_init_parse_arena(&arena, nullptr, 64);
+    EXPECT_EQ(0u, arena.capacity);
+}
+
+TEST(ParseArena, SequencePointsMatchParser)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    std::vector<mdcursor_t> methods = GetRowsWithBlob(pdb.handle.get(), mdtid_MethodDebugInformation, mdtMethodDebugInformation_SequencePoints);
+    ASSERT_LT(1u, methods.size());
+
+    // Every method is parsed into one arena, one result after another.
+    ArenaBuffer arena{ 4096 };
+    std::vector<md_sequence_points_t*> results;
+    for (mdcursor_t method : methods)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(method, mdtMethodDebugInformation_SequencePoints, blob, blob_len));
+        size_t used = arena.arena.used;
+        md_sequence_points_t* sequence_points = nullptr;
+        ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, &sequence_points));
+        ASSERT_NE(nullptr, sequence_points);
+        EXPECT_TRUE(IsAligned(sequence_points));
+        EXPECT_LE(arena.arena.buffer + used, (uint8_t*)sequence_points);
+        EXPECT_LT(used, arena.arena.used);
+        results.push_back(sequence_points);
+    }
+
+    // Later results don't overwrite earlier ones.
+    for (size_t i = 0; i < methods.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(methods[i], mdtMethodDebugInformation_SequencePoints, blob, blob_len));
+        std::vector<uint64_t> buffer;
+        md_sequence_points_t* expected = ParseWithBuffer<md_sequence_points_t>(buffer, [&](md_sequence_points_t* sequence_points, size_t* buffer_len)
+        {
+            return md_parse_sequence_points(methods[i], blob, blob_len, sequence_points, buffer_len);
+        });
+        ASSERT_NO_FATAL_FAILURE(ExpectEqual(*expected, *results[i]));
+    }
+}
+
+TEST(ParseArena, LocalConstantsMatchParser)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    std::vector<mdcursor_t> constants = GetRowsWithBlob(handle, mdtid_LocalConstant, mdtLocalConstant_Signature);
+    ASSERT_LT(1u, constants.size());
+
+    ArenaBuffer arena{ 4096 };
+    std::vector<md_local_constant_sig_t*> results;
+    for (mdcursor_t constant : constants)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(constant, mdtLocalConstant_Signature, blob, blob_len));
+        md_local_constant_sig_t* local_constant_sig = nullptr;
+        ASSERT_EQ(mdbpr_Success, md_parse_local_constant_sig_in_arena(handle, blob, blob_len, &arena.arena, &local_constant_sig));
+        ASSERT_NE(nullptr, local_constant_sig);
+        EXPECT_TRUE(IsAligned(local_constant_sig));
+        results.push_back(local_constant_sig);
+    }
+
+    for (size_t i = 0; i < constants.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(constants[i], mdtLocalConstant_Signature, blob, blob_len));
+        std::vector<uint64_t> buffer;
+        md_local_constant_sig_t* expected = ParseWithBuffer<md_local_constant_sig_t>(buffer, [&](md_local_constant_sig_t* local_constant_sig, size_t* buffer_len)
+        {
+            return md_parse_local_constant_sig(handle, blob, blob_len, local_constant_sig, buffer_len);
+        });
+        ASSERT_NO_FATAL_FAILURE(ExpectEqual(*expected, *results[i]));
+    }
+}
+
+TEST(ParseArena, ImportsMatchParser)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    std::vector<mdcursor_t> scopes = GetRowsWithBlob(handle, mdtid_ImportScope, mdtImportScope_Imports);
+    ASSERT_LT(0u, scopes.size());
+
+    ArenaBuffer arena{ 4096 };
+    std::vector<md_imports_t*> results;
+    for (mdcursor_t scope : scopes)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(scope, mdtImportScope_Imports, blob, blob_len));
+        md_imports_t* imports = nullptr;
+        ASSERT_EQ(mdbpr_Success, md_parse_imports_in_arena(handle, blob, blob_len, &arena.arena, &imports));
+        ASSERT_NE(nullptr, imports);
+        EXPECT_TRUE(IsAligned(imports));
+        results.push_back(imports);
+    }
+
+    for (size_t i = 0; i < scopes.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(scopes[i], mdtImportScope_Imports, blob, blob_len));
+        std::vector<uint64_t> buffer;
+        md_imports_t* expected = ParseWithBuffer<md_imports_t>(buffer, [&](md_imports_t* imports, size_t* buffer_len)
+        {
+            return md_parse_imports(handle, blob, blob_len, imports, buffer_len);
+        });
+        ASSERT_NO_FATAL_FAILURE(ExpectEqual(*expected, *results[i]));
+    }
+}
+
+TEST(ParseArena, InsufficientBuffer)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetBlob(method, mdtMethodDebugInformation_SequencePoints, blob, blob_len));
+
+    // From an empty arena the result needs as much space as the two-call parser.
+    size_t buffer_len = 0;
+    ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_sequence_points(method, blob, blob_len, nullptr, &buffer_len));
+    for (size_t capacity = 0; capacity < buffer_len; ++capacity)
+    {
+        SCOPED_TRACE(capacity);
+        ArenaBuffer arena{ capacity };
+        md_sequence_points_t* sequence_points = nullptr;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, &sequence_points));
+        EXPECT_EQ(nullptr, sequence_points);
+        EXPECT_EQ(buffer_len, arena.arena.needed);
+        EXPECT_EQ(0u, arena.arena.used);
+    }
+
+    ArenaBuffer exact{ buffer_len };
+    md_sequence_points_t* sequence_points = nullptr;
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &exact.arena, &sequence_points));
+    EXPECT_EQ(buffer_len, exact.arena.used);
+    EXPECT_EQ(0u, exact.arena.needed);
+
+    // After a result that leaves the arena unaligned, the space needed includes the padding.
+    ArenaBuffer partial{ 64 };
+    partial.arena.used = 3;
+    sequence_points = nullptr;
+    ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_sequence_points_in_arena(method, blob, blob_len, &partial.arena, &sequence_points));
+    EXPECT_EQ(nullptr, sequence_points);
+    EXPECT_EQ(buffer_len + 5, partial.arena.needed);
+    EXPECT_EQ(3u, partial.arena.used);
+
+    ArenaBuffer grown{ 3 + partial.arena.needed };
+    grown.arena.used = 3;
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &grown.arena, &sequence_points));
+    EXPECT_EQ(grown.arena.buffer + 8, (uint8_t*)sequence_points);
+    EXPECT_EQ(grown.arena.capacity, grown.arena.used);
+}
+
+TEST(ParseArena, InsufficientBufferForEachParser)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // Results with the most records exercise the arena running out part way through the records.
+    std::vector<mdcursor_t> scopes = GetRowsWithBlob(handle, mdtid_ImportScope, mdtImportScope_Imports);
+    for (mdcursor_t scope : scopes)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(scope, mdtImportScope_Imports, blob, blob_len));
+        size_t buffer_len = 0;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_imports(handle, blob, blob_len, nullptr, &buffer_len));
+        for (size_t capacity = 0; capacity < buffer_len; capacity += 4)
+        {
+            ArenaBuffer arena{ capacity };
+            md_imports_t* imports = nullptr;
+            ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_imports_in_arena(handle, blob, blob_len, &arena.arena, &imports));
+            EXPECT_EQ(buffer_len, arena.arena.needed);
+            EXPECT_EQ(0u, arena.arena.used);
+            EXPECT_EQ(nullptr, imports);
+        }
+        ArenaBuffer exact{ buffer_len };
+        md_imports_t* imports = nullptr;
+        EXPECT_EQ(mdbpr_Success, md_parse_imports_in_arena(handle, blob, blob_len, &exact.arena, &imports));
+        EXPECT_EQ(buffer_len, exact.arena.used);
+    }
+
+    std::vector<mdcursor_t> constants = GetRowsWithBlob(handle, mdtid_LocalConstant, mdtLocalConstant_Signature);
+    for (mdcursor_t constant : constants)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_NO_FATAL_FAILURE(GetBlob(constant, mdtLocalConstant_Signature, blob, blob_len));
+        size_t buffer_len = 0;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_local_constant_sig(handle, blob, blob_len, nullptr, &buffer_len));
+        ArenaBuffer small{ buffer_len - 1 };
+        md_local_constant_sig_t* local_constant_sig = nullptr;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_local_constant_sig_in_arena(handle, blob, blob_len, &small.arena, &local_constant_sig));
+        EXPECT_EQ(buffer_len, small.arena.needed);
+        EXPECT_EQ(0u, small.arena.used);
+        ArenaBuffer exact{ buffer_len };
+        EXPECT_EQ(mdbpr_Success, md_parse_local_constant_sig_in_arena(handle, blob, blob_len, &exact.arena, &local_constant_sig));
+        EXPECT_EQ(buffer_len, exact.arena.used);
+    }
+}
+
+TEST(ParseArena, ResetReusesSpace)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetBlob(method, mdtMethodDebugInformation_SequencePoints, blob, blob_len));
+
+    ArenaBuffer arena{ 4096 };
+    md_sequence_points_t* first;
+    md_sequence_points_t* second;
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, &first));
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, &second));
+    EXPECT_LT(first, second);
+
+    md_reset_parse_arena(&arena.arena);
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, &second));
+    EXPECT_EQ(first, second);
+}
+
+TEST(ParseArena, CorruptBlobs)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(handle, MainMethod, method));
+
+    // Invalid blobs fail the same in a full arena and in one with space, and leave it unchanged.
+    for (size_t capacity : { (size_t)0, (size_t)8, (size_t)1024 })
+    {
+        SCOPED_TRACE(capacity);
+        ArenaBuffer arena{ capacity };
+        arena.arena.used = capacity != 0 ? 1 : 0;
+        size_t used = arena.arena.used;
+
+        // A document record with a row out of range, and a blob without a header.
+        uint8_t const bad_document_record[] = { 0x00, 0x01, 0x00, 0x00, 0x01, 0x0a, 0x09, 0x00, 0x09 };
+        uint8_t const no_header[] = { 0x00 };
+        md_sequence_points_t* sequence_points = nullptr;
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_sequence_points_in_arena(method, bad_document_record, sizeof(bad_document_record), &arena.arena, &sequence_points));
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_sequence_points_in_arena(method, no_header, sizeof(no_header), &arena.arena, &sequence_points));
+        EXPECT_EQ(nullptr, sequence_points);
+
+        // An int constant with a one byte value, and a custom modifier without a type.
+        uint8_t const short_value[] = { 0x08, 0x01 };
+        uint8_t const truncated_modifier[] = { 0x1f };
+        md_local_constant_sig_t* local_constant_sig = nullptr;
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_local_constant_sig_in_arena(handle, short_value, sizeof(short_value), &arena.arena, &local_constant_sig));
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_local_constant_sig_in_arena(handle, truncated_modifier, sizeof(truncated_modifier), &arena.arena, &local_constant_sig));
+        EXPECT_EQ(nullptr, local_constant_sig);
+
+        // An unknown kind, a namespace without a value and a namespace outside the #Blob heap.
+        uint8_t const unknown_kind[] = { 0x01, 0x00, 0x0a, 0x00 };
+        uint8_t const truncated_import[] = { 0x01, 0x00, 0x01 };
+        uint8_t const bad_namespace[] = { 0x01, 0x00, 0x01, 0xdf, 0xff, 0xff, 0xff };
+        md_imports_t* imports = nullptr;
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_imports_in_arena(handle, unknown_kind, sizeof(unknown_kind), &arena.arena, &imports));
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_imports_in_arena(handle, truncated_import, sizeof(truncated_import), &arena.arena, &imports));
+        EXPECT_EQ(mdbpr_InvalidBlob, md_parse_imports_in_arena(handle, bad_namespace, sizeof(bad_namespace), &arena.arena, &imports));
+        EXPECT_EQ(nullptr, imports);
+
+        EXPECT_EQ(used, arena.arena.used);
+        EXPECT_EQ(0u, arena.arena.needed);
+    }
+}
+
+TEST(ParseArena, InvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(handle, MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetBlob(method, mdtMethodDebugInformation_SequencePoints, blob, blob_len));
+    uint8_t const constant[] = { 0x08, 0x01, 0x00, 0x00, 0x00 };
+    uint8_t const imports_blob[] = { 0x01, 0x01 };
+
+    ArenaBuffer arena{ 64 };
+    md_sequence_points_t* sequence_points;
+    md_local_constant_sig_t* local_constant_sig;
+    md_imports_t* imports;
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_sequence_points_in_arena(method, blob, blob_len, nullptr, &sequence_points));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_sequence_points_in_arena(method, blob, blob_len, &arena.arena, nullptr));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_sequence_points_in_arena(method, nullptr, 0, &arena.arena, &sequence_points));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_local_constant_sig_in_arena(handle, constant, sizeof(constant), nullptr, &local_constant_sig));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_local_constant_sig_in_arena(handle, constant, sizeof(constant), &arena.arena, nullptr));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_local_constant_sig_in_arena(nullptr, constant, sizeof(constant), &arena.arena, &local_constant_sig));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_imports_in_arena(handle, imports_blob, sizeof(imports_blob), nullptr, &imports));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_imports_in_arena(handle, imports_blob, sizeof(imports_blob), &arena.arena, nullptr));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_imports_in_arena(nullptr, imports_blob, sizeof(imports_blob), &arena.arena, &imports));
+
+    // An arena that claims to use more than its capacity.
+    arena.arena.used = arena.arena.capacity + 1;
+    EXPECT_EQ(mdbpr_InvalidArgument, md_parse_imports_in_arena(handle, imports_blob, sizeof(imports_blob), &arena.arena, &imports));
+    EXPECT_EQ(arena.arena.capacity + 1, arena.arena.used);
+    EXPECT_EQ(0u, arena.arena.needed);
+}
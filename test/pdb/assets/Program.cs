@@ -0,0 +1,32 @@
+using System;
+using System.Threading.Tasks;
+using IO = System.IO;
+
+namespace PdbTest
+{
+    public static partial class Program
+    {
+        public static int Main()
+        {
+            int sum = 0;
+            for (int i = 0; i < 3; i++)
+            {
+                int square = i * i;
+                sum += square;
+            }
+
+            const int Offset = 10;
+#line 100 "Generated.cs"
+            sum += Offset;
+#line default
+            return sum + Helper(sum) + RunAsync(sum).Result;
+        }
+
+        public static async Task<int> RunAsync(int value)
+        {
+            int local = value + 1;
+            await Task.Yield();
+            return local * 2;
+        }
+    }
+}
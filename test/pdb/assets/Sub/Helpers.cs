@@ -0,0 +1,11 @@
+namespace PdbTest
+{
+    public static partial class Program
+    {
+        private static int Helper(int value)
+        {
+            const string Name = "Helper";
+            return value * 3 + Name.Length;
+        }
+    }
+}
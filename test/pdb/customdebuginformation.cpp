@@ -0,0 +1,165 @@
+#include "pdb.hpp"
+
+namespace
+{
+    constexpr mdToken ModuleToken = 0x00000001;
+
+    // {755F52A8-91C5-45BE-B4B8-209571E552BD}
+    constexpr mdguid_t EncLocalSlotMap = { 0x755f52a8, 0x91c5, 0x45be, { 0xb4, 0xb8, 0x20, 0x95, 0x71, 0xe5, 0x52, 0xbd } };
+
+    // {54FD2AC5-E925-401A-9C2A-F94F171072F8}
+    constexpr mdguid_t AsyncMethodSteppingInformation = { 0x54fd2ac5, 0xe925, 0x401a, { 0x9c, 0x2a, 0xf9, 0x4f, 0x17, 0x10, 0x72, 0xf8 } };
+
+    // {6DA9A61E-F8C7-4874-BE62-68BC5630DF71}
+    constexpr mdguid_t StateMachineHoistedLocalScopes = { 0x6da9a61e, 0xf8c7, 0x4874, { 0xbe, 0x62, 0x68, 0xbc, 0x56, 0x30, 0xdf, 0x71 } };
+
+    // {0E8A571B-6926-466E-B4AD-8AB04611F5FE}
+    constexpr mdguid_t EmbeddedSource = { 0x0e8a571b, 0x6926, 0x466e, { 0xb4, 0xad, 0x8a, 0xb0, 0x46, 0x11, 0xf5, 0xfe } };
+
+    // {B5FEEC05-8CD0-4A83-96DA-466284BB4BD8}
+    constexpr mdguid_t CompilationMetadataReferences = { 0xb5feec05, 0x8cd0, 0x4a83, { 0x96, 0xda, 0x46, 0x62, 0x84, 0xbb, 0x4b, 0xd8 } };
+
+    // {7E4D4708-096E-4C5C-AEDA-CB10BA6A740D}
+    constexpr mdguid_t CompilationOptions = { 0x7e4d4708, 0x096e, 0x4c5c, { 0xae, 0xda, 0xcb, 0x10, 0xba, 0x6a, 0x74, 0x0d } };
+
+    // {83C563C4-B4F3-47D5-B824-BA5441477EA8}
+    constexpr mdguid_t DynamicLocalVariables = { 0x83c563c4, 0xb4f3, 0x47d5, { 0xb8, 0x24, 0xba, 0x54, 0x41, 0x47, 0x7e, 0xa8 } };
+
+    // The row and value length of each CustomDebugInformation row found.
+    using Rows = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    Rows FindCustomDebugInformation(mdhandle_t handle, mdToken parent, mdguid_t kind)
+    {
+        int32_t count = md_find_custom_debug_information(handle, parent, kind, 0, nullptr);
+        EXPECT_LE(0, count);
+        if (count <= 0)
+            return {};
+
+        std::vector<md_custom_debug_information_t> values(count);
+        EXPECT_EQ(count, md_find_custom_debug_information(handle, parent, kind, (uint32_t)values.size(), values.data()));
+        Rows rows;
+        for (md_custom_debug_information_t const& value : values)
+        {
+            // The value is the Value column of the row.
+            uint8_t const* blob;
+            uint32_t blob_len;
+            EXPECT_TRUE(md_get_column_value_as_blob(value.custom_debug_information, mdtCustomDebugInformation_Value, &blob, &blob_len));
+            EXPECT_EQ(blob_len, value.value_len);
+            if (blob_len != 0)
+                EXPECT_EQ(blob, value.value);
+
+            rows.emplace_back(GetRowId(value.custom_debug_information), value.value_len);
+        }
+        return rows;
+    }
+
+    void AppendCustomDebugInformation(mdhandle_t handle, mdToken parent, mdguid_t kind, std::vector<uint8_t> const& value)
+    {
+        md_added_row_t added;
+        ASSERT_TRUE(md_append_row(handle, mdtid_CustomDebugInformation, &added));
+        ASSERT_TRUE(md_set_column_value_as_token(added, mdtCustomDebugInformation_Parent, parent));
+        ASSERT_TRUE(md_set_column_value_as_guid(added, mdtCustomDebugInformation_Kind, kind));
+        ASSERT_TRUE(md_set_column_value_as_blob(added, mdtCustomDebugInformation_Value, value.data(), (uint32_t)value.size()));
+    }
+}
+
+TEST(CustomDebugInformation, FindMethodInformation)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // The state machine of RunAsync has three kinds of information.
+    EXPECT_EQ((Rows{ { 8, 9 } }), FindCustomDebugInformation(handle, MoveNextMethod, EncLocalSlotMap));
+    EXPECT_EQ((Rows{ { 9, 13 } }), FindCustomDebugInformation(handle, MoveNextMethod, AsyncMethodSteppingInformation));
+    EXPECT_EQ((Rows{ { 10, 8 } }), FindCustomDebugInformation(handle, MoveNextMethod, StateMachineHoistedLocalScopes));
+
+    EXPECT_EQ((Rows{ { 1, 10 } }), FindCustomDebugInformation(handle, MainMethod, EncLocalSlotMap));
+    EXPECT_EQ((Rows{ { 4, 2 } }), FindCustomDebugInformation(handle, RunAsyncMethod, EncLocalSlotMap));
+    EXPECT_EQ((Rows{ { 7, 2 } }), FindCustomDebugInformation(handle, HelperMethod, EncLocalSlotMap));
+}
+
+TEST(CustomDebugInformation, FindModuleAndDocumentInformation)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    EXPECT_EQ((Rows{ { 2, 250 } }), FindCustomDebugInformation(handle, ModuleToken, CompilationMetadataReferences));
+    EXPECT_EQ((Rows{ { 3, 98 } }), FindCustomDebugInformation(handle, ModuleToken, CompilationOptions));
+
+    // Only Helpers.cs has embedded source.
+    EXPECT_EQ((Rows{ { 6, 147 } }), FindCustomDebugInformation(handle, DocumentToken(HelpersDocument), EmbeddedSource));
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, DocumentToken(ProgramDocument), EmbeddedSource, 0, nullptr));
+}
+
+TEST(CustomDebugInformation, FindMissing)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // A kind that is in the PDB, but not on the parent.
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, MainMethod, StateMachineHoistedLocalScopes, 0, nullptr));
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, 0x06000004, EncLocalSlotMap, 0, nullptr));
+
+    // A kind that isn't in the PDB.
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, MainMethod, DynamicLocalVariables, 0, nullptr));
+
+    // A parent with the same row id in another table.
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, DocumentToken(1), EncLocalSlotMap, 0, nullptr));
+}
+
+TEST(CustomDebugInformation, FindInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+
+    EXPECT_EQ(-1, md_find_custom_debug_information(nullptr, MainMethod, EncLocalSlotMap, 0, nullptr));
+    EXPECT_EQ(-1, md_find_custom_debug_information(pdb.handle.get(), MainMethod, EncLocalSlotMap, 1, nullptr));
+
+    // A PDB without the table has no information.
+    mdhandle_ptr empty{ md_create_new_pdb_handle() };
+    ASSERT_NE(nullptr, empty.get());
+    EXPECT_EQ(0, md_find_custom_debug_information(empty.get(), MainMethod, EncLocalSlotMap, 0, nullptr));
+}
+
+TEST(CustomDebugInformation, FindAfterAppend)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, MainMethod, DynamicLocalVariables, 0, nullptr));
+
+    // Appending rows out of parent order makes the table unsorted, the rows are still found in row order.
+    ASSERT_NO_FATAL_FAILURE(AppendCustomDebugInformation(handle, MainMethod, DynamicLocalVariables, { 0x01 }));
+    ASSERT_NO_FATAL_FAILURE(AppendCustomDebugInformation(handle, ModuleToken, DynamicLocalVariables, { 0x02, 0x03 }));
+    ASSERT_NO_FATAL_FAILURE(AppendCustomDebugInformation(handle, MainMethod, DynamicLocalVariables, { 0x04, 0x05, 0x06 }));
+
+    EXPECT_EQ((Rows{ { 11, 1 }, { 13, 3 } }), FindCustomDebugInformation(handle, MainMethod, DynamicLocalVariables));
+    EXPECT_EQ((Rows{ { 12, 2 } }), FindCustomDebugInformation(handle, ModuleToken, DynamicLocalVariables));
+    EXPECT_EQ((Rows{ { 1, 10 } }), FindCustomDebugInformation(handle, MainMethod, EncLocalSlotMap));
+
+    // Only the first match is written when the buffer is too small, but all are counted.
+    md_custom_debug_information_t value;
+    ASSERT_EQ(2, md_find_custom_debug_information(handle, MainMethod, DynamicLocalVariables, 1, &value));
+    EXPECT_EQ(11u, GetRowId(value.custom_debug_information));
+    ASSERT_EQ(1u, value.value_len);
+    EXPECT_EQ(0x01, value.value[0]);
+}
+
+TEST(CustomDebugInformation, EditDropsIndex)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ((Rows{ { 4, 2 } }), FindCustomDebugInformation(handle, RunAsyncMethod, EncLocalSlotMap));
+
+    // Move the slot map of RunAsync to Main.
+    mdcursor_t row;
+    ASSERT_TRUE(md_token_to_cursor(handle, (mdtid_CustomDebugInformation << 24) | 4, &row));
+    ASSERT_TRUE(md_set_column_value_as_token(row, mdtCustomDebugInformation_Parent, MainMethod));
+
+    EXPECT_EQ(0, md_find_custom_debug_information(handle, RunAsyncMethod, EncLocalSlotMap, 0, nullptr));
+    EXPECT_EQ((Rows{ { 1, 10 }, { 4, 2 } }), FindCustomDebugInformation(handle, MainMethod, EncLocalSlotMap));
+}
@@ -0,0 +1,148 @@
+#include "pdb.hpp"
+
+namespace
+{
+    void GetDocument(mdhandle_t handle, uint32_t row, mdcursor_t& document)
+    {
+        ASSERT_TRUE(md_token_to_cursor(handle, DocumentToken(row), &document));
+    }
+
+    std::string GetDocumentPath(mdcursor_t document)
+    {
+        char const* path;
+        uint32_t path_len;
+        EXPECT_TRUE(md_get_document_path(document, &path, &path_len));
+        EXPECT_EQ('\0', path[path_len]);
+        return { path, path_len };
+    }
+
+    std::vector<uint32_t> FindDocuments(mdhandle_t handle, char const* path, md_document_match_t match)
+    {
+        int32_t count = md_find_documents(handle, path, match, 0, nullptr);
+        EXPECT_LE(0, count);
+        if (count <= 0)
+            return {};
+
+        std::vector<mdcursor_t> documents(count);
+        EXPECT_EQ(count, md_find_documents(handle, path, match, (uint32_t)documents.size(), documents.data()));
+        std::vector<uint32_t> rows;
+        for (mdcursor_t document : documents)
+            rows.push_back(GetRowId(document));
+        return rows;
+    }
+}
+
+TEST(Documents, GetPath)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t document;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(pdb.handle.get(), ProgramDocument, document));
+    EXPECT_EQ("/src/Program.cs", GetDocumentPath(document));
+    ASSERT_NO_FATAL_FAILURE(GetDocument(pdb.handle.get(), HelpersDocument, document));
+    EXPECT_EQ("/src/Sub/Helpers.cs", GetDocumentPath(document));
+    ASSERT_NO_FATAL_FAILURE(GetDocument(pdb.handle.get(), GeneratedDocument, document));
+    EXPECT_EQ("/src/Generated.cs", GetDocumentPath(document));
+}
+
+TEST(Documents, GetPathInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t document;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(pdb.handle.get(), ProgramDocument, document));
+
+    char const* path;
+    uint32_t path_len;
+    EXPECT_FALSE(md_get_document_path(document, nullptr, &path_len));
+    EXPECT_FALSE(md_get_document_path(document, &path, nullptr));
+    EXPECT_FALSE(md_get_document_path({}, &path, &path_len));
+
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    EXPECT_FALSE(md_get_document_path(method, &path, &path_len));
+}
+
+TEST(Documents, FindExact)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ(std::vector<uint32_t>{ ProgramDocument }, FindDocuments(handle, "/src/Program.cs", mddm_Exact));
+    EXPECT_EQ(std::vector<uint32_t>{ HelpersDocument }, FindDocuments(handle, "/src/Sub/Helpers.cs", mddm_Exact));
+    EXPECT_TRUE(FindDocuments(handle, "/src/program.cs", mddm_Exact).empty());
+    EXPECT_TRUE(FindDocuments(handle, "Program.cs", mddm_Exact).empty());
+    EXPECT_TRUE(FindDocuments(handle, "\\src\\Program.cs", mddm_Exact).empty());
+    EXPECT_TRUE(FindDocuments(handle, "", mddm_Exact).empty());
+}
+
+TEST(Documents, FindIgnoreCase)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ(std::vector<uint32_t>{ ProgramDocument }, FindDocuments(handle, "/SRC/program.CS", mddm_IgnoreCase));
+    EXPECT_EQ(std::vector<uint32_t>{ GeneratedDocument }, FindDocuments(handle, "/src/generated.cs", mddm_IgnoreCase));
+    EXPECT_TRUE(FindDocuments(handle, "/src/sub\\helpers.cs", mddm_IgnoreCase).empty());
+    EXPECT_TRUE(FindDocuments(handle, "program.cs", mddm_IgnoreCase).empty());
+}
+
+TEST(Documents, FindPathSuffix)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ(std::vector<uint32_t>{ ProgramDocument }, FindDocuments(handle, "Program.cs", mddm_PathSuffix));
+    EXPECT_EQ(std::vector<uint32_t>{ HelpersDocument }, FindDocuments(handle, "helpers.cs", mddm_PathSuffix));
+    EXPECT_EQ(std::vector<uint32_t>{ HelpersDocument }, FindDocuments(handle, "sub\\HELPERS.cs", mddm_PathSuffix));
+    EXPECT_EQ(std::vector<uint32_t>{ HelpersDocument }, FindDocuments(handle, "\\src\\Sub\\Helpers.cs", mddm_PathSuffix));
+    EXPECT_EQ(std::vector<uint32_t>{ HelpersDocument }, FindDocuments(handle, "/src/Sub/Helpers.cs", mddm_PathSuffix));
+
+    // The suffix has to start at a path component.
+    EXPECT_TRUE(FindDocuments(handle, "ub/Helpers.cs", mddm_PathSuffix).empty());
+    EXPECT_TRUE(FindDocuments(handle, "rogram.cs", mddm_PathSuffix).empty());
+    EXPECT_TRUE(FindDocuments(handle, "Sub/Program.cs", mddm_PathSuffix).empty());
+    EXPECT_TRUE(FindDocuments(handle, "/other/src/Program.cs", mddm_PathSuffix).empty());
+}
+
+TEST(Documents, FindInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    mdcursor_t document;
+    EXPECT_EQ(-1, md_find_documents(handle, nullptr, mddm_Exact, 1, &document));
+    EXPECT_EQ(-1, md_find_documents(handle, "Program.cs", (md_document_match_t)-1, 1, &document));
+    EXPECT_EQ(-1, md_find_documents(handle, "Program.cs", mddm_PathSuffix, 1, nullptr));
+    EXPECT_EQ(-1, md_find_documents(nullptr, "Program.cs", mddm_PathSuffix, 1, &document));
+}
+
+TEST(Documents, FindAfterAppend)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ(std::vector<uint32_t>{ ProgramDocument }, FindDocuments(handle, "/src/Program.cs", mddm_Exact));
+
+    // Add a second document with the same name.
+    mdcursor_t program;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(handle, ProgramDocument, program));
+    uint8_t const* name;
+    uint32_t name_len;
+    ASSERT_TRUE(md_get_column_value_as_blob(program, mdtDocument_Name, &name, &name_len));
+    std::vector<uint8_t> name_copy{ name, name + name_len };
+    {
+        md_added_row_t added;
+        ASSERT_TRUE(md_append_row(handle, mdtid_Document, &added));
+        ASSERT_TRUE(md_set_column_value_as_blob(added, mdtDocument_Name, name_copy.data(), (uint32_t)name_copy.size()));
+    }
+
+    // Only the first match is written when the buffer is too small, but all are counted.
+    mdcursor_t document;
+    ASSERT_EQ(2, md_find_documents(handle, "program.cs", mddm_PathSuffix, 1, &document));
+    EXPECT_EQ(ProgramDocument, GetRowId(document));
+    EXPECT_EQ((std::vector<uint32_t>{ ProgramDocument, 4 }), FindDocuments(handle, "/src/Program.cs", mddm_Exact));
+
+    ASSERT_NO_FATAL_FAILURE(GetDocument(handle, 4, document));
+    EXPECT_EQ("/src/Program.cs", GetDocumentPath(document));
+}
@@ -0,0 +1,696 @@
+#include "pdb.hpp"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    // The kinds are declared in unnamed structs, which C++ can only name through the members.
+    using ImportEntry = std::remove_extent<decltype(md_imports_t::imports)>::type;
+    using GeneralConstant = decltype(md_local_constant_sig_t::general);
+
+    // Storage for a blob parser result with a trailing array.
+    template<typename T, typename TEntry>
+    struct FlexibleBuffer final
+    {
+        std::vector<uint64_t> storage;
+
+        explicit FlexibleBuffer(size_t count)
+            : storage((sizeof(T) + count * sizeof(TEntry) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+        { }
+
+        T* get() { return (T*)storage.data(); }
+        T* operator->() { return get(); }
+    };
+
+    using ImportsBuffer = FlexibleBuffer<md_imports_t, ImportEntry>;
+
+    void CreatePdb(mdhandle_ptr& pdb)
+    {
+        mdhandle_t handle = md_create_new_pdb_handle();
+        ASSERT_NE(nullptr, handle);
+        pdb.reset(handle);
+    }
+
+    void AppendRow(mdhandle_t handle, mdtable_id_t table, mdcursor_t& row)
+    {
+        md_added_row_t added;
+        ASSERT_TRUE(md_append_row(handle, table, &added));
+        row = added;
+    }
+
+    void AppendDocuments(mdhandle_t handle, uint32_t count, std::vector<mdcursor_t>& documents)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            mdcursor_t document;
+            ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_Document, document));
+            documents.push_back(document);
+        }
+    }
+
+    md_sequence_point_t SequencePoint(mdcursor_t document, uint32_t il_offset, uint32_t start_line, uint32_t start_column, uint32_t end_line, uint32_t end_column)
+    {
+        return { mdsp_SequencePointRecord, document, il_offset, start_line, start_column, end_line, end_column };
+    }
+
+    md_sequence_point_t HiddenSequencePoint(mdcursor_t document, uint32_t il_offset)
+    {
+        md_sequence_point_t sequence_point{};
+        sequence_point.kind = mdsp_HiddenSequencePointRecord;
+        sequence_point.document = document;
+        sequence_point.il_offset = il_offset;
+        return sequence_point;
+    }
+
+    void ReadSequencePoints(mdcursor_t method_debug_information, mdToken& signature, std::vector<md_sequence_point_t>& sequence_points)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_TRUE(md_get_column_value_as_blob(method_debug_information, mdtMethodDebugInformation_SequencePoints, &blob, &blob_len));
+
+        md_sequence_point_iterator_t iterator;
+        ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_init(method_debug_information, blob, blob_len, &iterator));
+        signature = iterator.signature;
+
+        md_sequence_point_t sequence_point;
+        while (md_sequence_point_iterator_next(&iterator, &sequence_point))
+        {
+            if (sequence_point.kind != mdsp_DocumentRecord)
+                sequence_points.push_back(sequence_point);
+        }
+        ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_result(&iterator));
+    }
+
+    void ExpectEqual(md_sequence_point_t const& expected, md_sequence_point_t const& actual)
+    {
+        EXPECT_EQ(expected.kind, actual.kind);
+        EXPECT_EQ(GetRowId(expected.document), GetRowId(actual.document));
+        EXPECT_EQ(expected.il_offset, actual.il_offset);
+        if (expected.kind == mdsp_SequencePointRecord)
+        {
+            EXPECT_EQ(expected.start_line, actual.start_line);
+            EXPECT_EQ(expected.start_column, actual.start_column);
+            EXPECT_EQ(expected.end_line, actual.end_line);
+            EXPECT_EQ(expected.end_column, actual.end_column);
+        }
+    }
+
+    std::vector<uint8_t> GetBlob(mdcursor_t row, col_index_t column)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        EXPECT_TRUE(md_get_column_value_as_blob(row, column, &blob, &blob_len));
+        return { blob, blob + blob_len };
+    }
+
+    void ParseLocalConstantSig(mdcursor_t local_constant, std::vector<uint64_t>& buffer, md_local_constant_sig_t*& local_constant_sig)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_TRUE(md_get_column_value_as_blob(local_constant, mdtLocalConstant_Signature, &blob, &blob_len));
+        mdhandle_t handle = md_extract_handle_from_cursor(local_constant);
+
+        size_t buffer_len = 0;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_local_constant_sig(handle, blob, blob_len, nullptr, &buffer_len));
+        buffer.resize((buffer_len + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        local_constant_sig = (md_local_constant_sig_t*)buffer.data();
+        ASSERT_EQ(mdbpr_Success, md_parse_local_constant_sig(handle, blob, blob_len, local_constant_sig, &buffer_len));
+    }
+
+    void ParseImports(mdcursor_t import_scope, std::vector<uint64_t>& buffer, md_imports_t*& imports)
+    {
+        uint8_t const* blob;
+        uint32_t blob_len;
+        ASSERT_TRUE(md_get_column_value_as_blob(import_scope, mdtImportScope_Imports, &blob, &blob_len));
+        mdhandle_t handle = md_extract_handle_from_cursor(import_scope);
+
+        size_t buffer_len = 0;
+        ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_imports(handle, blob, blob_len, nullptr, &buffer_len));
+        buffer.resize((buffer_len + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        imports = (md_imports_t*)buffer.data();
+        ASSERT_EQ(mdbpr_Success, md_parse_imports(handle, blob, blob_len, imports, &buffer_len));
+    }
+
+    std::string Alias(ImportEntry const& entry)
+    {
+        return { entry.alias, entry.alias_len };
+    }
+
+    std::string Namespace(ImportEntry const& entry)
+    {
+        return { entry.target_namespace, entry.target_namespace_len };
+    }
+
+    void SetString(char const* str, char const*& field, uint32_t& field_len)
+    {
+        field = str;
+        field_len = (uint32_t)std::strlen(str);
+    }
+}
+
+TEST(Encoders, SequencePointsRoundTrip)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    std::vector<mdcursor_t> documents;
+    ASSERT_NO_FATAL_FAILURE(AppendDocuments(pdb.get(), 2, documents));
+    mdcursor_t method_debug_information;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_MethodDebugInformation, method_debug_information));
+
+    // Cover multi-byte deltas, a hidden point, a single line span and a switch between documents.
+    std::vector<md_sequence_point_t> expected =
+    {
+        SequencePoint(documents[0], 0, 10, 9, 10, 10),
+        SequencePoint(documents[0], 1, 11, 13, 11, 25),
+        HiddenSequencePoint(documents[0], 5),
+        SequencePoint(documents[0], 300, 9000, 200, 9001, 1),
+        SequencePoint(documents[1], 310, 100, 13, 100, 27),
+        HiddenSequencePoint(documents[1], 320),
+        SequencePoint(documents[0], 70000, 5, 1, 6, 2),
+    };
+    ASSERT_TRUE(md_encode_sequence_points(method_debug_information, 0x11000002, expected.data(), (uint32_t)expected.size()));
+
+    // With more than one document the Document column is nil and the blob holds the initial document.
+    mdToken document;
+    ASSERT_TRUE(md_get_column_value_as_token(method_debug_information, mdtMethodDebugInformation_Document, &document));
+    EXPECT_EQ(0u, document & 0x00ffffff);
+
+    mdToken signature;
+    std::vector<md_sequence_point_t> actual;
+    ASSERT_NO_FATAL_FAILURE(ReadSequencePoints(method_debug_information, signature, actual));
+    EXPECT_EQ(2u, signature);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+        ExpectEqual(expected[i], actual[i]);
+}
+
+TEST(Encoders, SequencePointsSingleDocument)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    std::vector<mdcursor_t> documents;
+    ASSERT_NO_FATAL_FAILURE(AppendDocuments(pdb.get(), 2, documents));
+    mdcursor_t method_debug_information;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_MethodDebugInformation, method_debug_information));
+
+    // Document records in the input are skipped.
+    md_sequence_point_t document_record{};
+    document_record.kind = mdsp_DocumentRecord;
+    document_record.document = documents[1];
+    std::array<md_sequence_point_t, 3> input =
+    {
+        document_record,
+        SequencePoint(documents[1], 0, 1, 1, 1, 5),
+        SequencePoint(documents[1], 4, 2, 1, 2, 5),
+    };
+    ASSERT_TRUE(md_encode_sequence_points(method_debug_information, 0, input.data(), (uint32_t)input.size()));
+
+    // The document of every record is kept in the Document column.
+    mdToken document;
+    ASSERT_TRUE(md_get_column_value_as_token(method_debug_information, mdtMethodDebugInformation_Document, &document));
+    EXPECT_EQ(DocumentToken(2), document);
+
+    mdToken signature;
+    std::vector<md_sequence_point_t> actual;
+    ASSERT_NO_FATAL_FAILURE(ReadSequencePoints(method_debug_information, signature, actual));
+    EXPECT_EQ(0u, signature);
+    ASSERT_EQ(2u, actual.size());
+    ExpectEqual(input[1], actual[0]);
+    ExpectEqual(input[2], actual[1]);
+}
+
+TEST(Encoders, SequencePointsEmpty)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    mdcursor_t method_debug_information;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_MethodDebugInformation, method_debug_information));
+
+    ASSERT_TRUE(md_encode_sequence_points(method_debug_information, 0x11000001, nullptr, 0));
+    EXPECT_TRUE(GetBlob(method_debug_information, mdtMethodDebugInformation_SequencePoints).empty());
+
+    mdToken document;
+    ASSERT_TRUE(md_get_column_value_as_token(method_debug_information, mdtMethodDebugInformation_Document, &document));
+    EXPECT_EQ(0u, document & 0x00ffffff);
+}
+
+TEST(Encoders, SequencePointsMatchCompiler)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // Re-encoding the points read from the compiler's blobs gives the same bytes.
+    for (mdToken method : { MainMethod, HelperMethod, MoveNextMethod })
+    {
+        mdcursor_t original;
+        ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(handle, method, original));
+        std::vector<uint8_t> expected = GetBlob(original, mdtMethodDebugInformation_SequencePoints);
+        mdToken expected_document;
+        ASSERT_TRUE(md_get_column_value_as_token(original, mdtMethodDebugInformation_Document, &expected_document));
+
+        mdToken signature;
+        std::vector<md_sequence_point_t> sequence_points;
+        ASSERT_NO_FATAL_FAILURE(ReadSequencePoints(original, signature, sequence_points));
+
+        mdcursor_t copy;
+        ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_MethodDebugInformation, copy));
+        ASSERT_TRUE(md_encode_sequence_points(copy, (mdtid_StandAloneSig << 24) | signature, sequence_points.data(), (uint32_t)sequence_points.size()));
+        EXPECT_EQ(expected, GetBlob(copy, mdtMethodDebugInformation_SequencePoints));
+
+        mdToken document;
+        ASSERT_TRUE(md_get_column_value_as_token(copy, mdtMethodDebugInformation_Document, &document));
+        EXPECT_EQ(expected_document, document);
+    }
+}
+
+TEST(Encoders, SequencePointsInvalidArguments)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    std::vector<mdcursor_t> documents;
+    ASSERT_NO_FATAL_FAILURE(AppendDocuments(pdb.get(), 1, documents));
+    mdcursor_t method_debug_information;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_MethodDebugInformation, method_debug_information));
+
+    md_sequence_point_t sequence_point = SequencePoint(documents[0], 0, 1, 1, 1, 2);
+    EXPECT_FALSE(md_encode_sequence_points(documents[0], 0, &sequence_point, 1));
+    EXPECT_FALSE(md_encode_sequence_points(method_debug_information, 0, nullptr, 1));
+
+    // The local signature must be a StandAloneSig.
+    EXPECT_FALSE(md_encode_sequence_points(method_debug_information, 0x02000001, &sequence_point, 1));
+
+    // The document of a record must be a Document row.
+    md_sequence_point_t not_a_document = SequencePoint(method_debug_information, 0, 1, 1, 1, 2);
+    EXPECT_FALSE(md_encode_sequence_points(method_debug_information, 0, &not_a_document, 1));
+}
+
+TEST(Encoders, LocalConstantSigRoundTrip)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+
+    int32_t const int_value = 10;
+    char16_t const string_value[] = u"Helper";
+    uint8_t const enum_value[] = { 0x02, 0x00 };
+
+    std::vector<md_local_constant_sig_t> sigs(5);
+    sigs[0].constant_kind = md_local_constant_sig_t::mdck_PrimitiveConstant;
+    sigs[0].primitive.type_code = 0x08; // ELEMENT_TYPE_I4
+    sigs[0].value_blob = (uint8_t const*)&int_value;
+    sigs[0].value_len = sizeof(int_value);
+
+    sigs[1].constant_kind = md_local_constant_sig_t::mdck_PrimitiveConstant;
+    sigs[1].primitive.type_code = 0x0e; // ELEMENT_TYPE_STRING
+    sigs[1].value_blob = (uint8_t const*)string_value;
+    sigs[1].value_len = sizeof(string_value) - sizeof(char16_t);
+
+    sigs[2].constant_kind = md_local_constant_sig_t::mdck_EnumConstant;
+    sigs[2].enum_constant.type_code = 0x07; // ELEMENT_TYPE_U2
+    sigs[2].enum_constant.enum_type = 0x01000003;
+    sigs[2].value_blob = enum_value;
+    sigs[2].value_len = sizeof(enum_value);
+
+    sigs[3].constant_kind = md_local_constant_sig_t::mdck_GeneralConstant;
+    sigs[3].general.kind = GeneralConstant::mdgc_Class;
+    sigs[3].general.type = 0x1b000001;
+
+    sigs[4].constant_kind = md_local_constant_sig_t::mdck_GeneralConstant;
+    sigs[4].general.kind = GeneralConstant::mdgc_ValueType;
+    sigs[4].general.type = 0x02000004;
+    sigs[4].value_blob = enum_value;
+    sigs[4].value_len = sizeof(enum_value);
+
+    for (md_local_constant_sig_t const& expected : sigs)
+    {
+        mdcursor_t local_constant;
+        ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_LocalConstant, local_constant));
+        ASSERT_TRUE(md_encode_local_constant_sig(local_constant, &expected));
+
+        std::vector<uint64_t> buffer;
+        md_local_constant_sig_t* actual;
+        ASSERT_NO_FATAL_FAILURE(ParseLocalConstantSig(local_constant, buffer, actual));
+        EXPECT_EQ(expected.constant_kind, actual->constant_kind);
+        EXPECT_EQ(0u, actual->custom_modifier_count);
+        ASSERT_EQ(expected.value_len, actual->value_len);
+        if (expected.value_len != 0)
+            EXPECT_EQ(0, std::memcmp(expected.value_blob, actual->value_blob, expected.value_len));
+
+        switch (expected.constant_kind)
+        {
+            case md_local_constant_sig_t::mdck_PrimitiveConstant:
+                EXPECT_EQ(expected.primitive.type_code, actual->primitive.type_code);
+                break;
+            case md_local_constant_sig_t::mdck_EnumConstant:
+                EXPECT_EQ(expected.enum_constant.type_code, actual->enum_constant.type_code);
+                EXPECT_EQ(expected.enum_constant.enum_type, actual->enum_constant.enum_type);
+                break;
+            case md_local_constant_sig_t::mdck_GeneralConstant:
+                EXPECT_EQ(expected.general.kind, actual->general.kind);
+                EXPECT_EQ(expected.general.type, actual->general.type);
+                break;
+        }
+    }
+}
+
+TEST(Encoders, LocalConstantSigCustomModifiers)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+
+    FlexibleBuffer<md_local_constant_sig_t, std::remove_extent<decltype(md_local_constant_sig_t::custom_modifiers)>::type> expected{ 2 };
+    std::memset(expected.get(), 0, expected.storage.size() * sizeof(uint64_t));
+    int64_t const value = -1;
+    expected->constant_kind = md_local_constant_sig_t::mdck_PrimitiveConstant;
+    expected->primitive.type_code = 0x0a; // ELEMENT_TYPE_I8
+    expected->value_blob = (uint8_t const*)&value;
+    expected->value_len = sizeof(value);
+    expected->custom_modifier_count = 2;
+    expected->custom_modifiers[0].required = true;
+    expected->custom_modifiers[0].type = 0x01000001;
+    expected->custom_modifiers[1].required = false;
+    expected->custom_modifiers[1].type = 0x02000002;
+
+    mdcursor_t local_constant;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_LocalConstant, local_constant));
+    ASSERT_TRUE(md_encode_local_constant_sig(local_constant, expected.get()));
+
+    std::vector<uint64_t> buffer;
+    md_local_constant_sig_t* actual;
+    ASSERT_NO_FATAL_FAILURE(ParseLocalConstantSig(local_constant, buffer, actual));
+    ASSERT_EQ(2u, actual->custom_modifier_count);
+    EXPECT_TRUE(actual->custom_modifiers[0].required);
+    EXPECT_EQ(0x01000001u, actual->custom_modifiers[0].type);
+    EXPECT_FALSE(actual->custom_modifiers[1].required);
+    EXPECT_EQ(0x02000002u, actual->custom_modifiers[1].type);
+    EXPECT_EQ(0x0a, actual->primitive.type_code);
+    ASSERT_EQ(sizeof(value), actual->value_len);
+    EXPECT_EQ(0, std::memcmp(&value, actual->value_blob, sizeof(value)));
+}
+
+TEST(Encoders, LocalConstantSigMatchCompiler)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    mdcursor_t original;
+    uint32_t count;
+    ASSERT_TRUE(md_create_cursor(handle, mdtid_LocalConstant, &original, &count));
+    ASSERT_EQ(2u, count);
+    for (uint32_t i = 0; i < count; ++i, (void)md_cursor_next(&original))
+    {
+        std::vector<uint64_t> buffer;
+        md_local_constant_sig_t* sig;
+        ASSERT_NO_FATAL_FAILURE(ParseLocalConstantSig(original, buffer, sig));
+
+        mdcursor_t copy;
+        ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_LocalConstant, copy));
+        ASSERT_TRUE(md_encode_local_constant_sig(copy, sig));
+        EXPECT_EQ(GetBlob(original, mdtLocalConstant_Signature), GetBlob(copy, mdtLocalConstant_Signature));
+    }
+}
+
+TEST(Encoders, LocalConstantSigFromGrowingHeap)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // Re-encode the value of the previous copy, which is in the heap that grows with each copy.
+    mdcursor_t previous;
+    ASSERT_TRUE(md_token_to_cursor(handle, (mdtid_LocalConstant << 24) | 2, &previous));
+    std::vector<uint8_t> expected = GetBlob(previous, mdtLocalConstant_Signature);
+    for (int i = 0; i < 256; ++i)
+    {
+        std::vector<uint64_t> buffer;
+        md_local_constant_sig_t* sig;
+        ASSERT_NO_FATAL_FAILURE(ParseLocalConstantSig(previous, buffer, sig));
+
+        mdcursor_t copy;
+        ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_LocalConstant, copy));
+        ASSERT_TRUE(md_encode_local_constant_sig(copy, sig));
+        ASSERT_EQ(expected, GetBlob(copy, mdtLocalConstant_Signature));
+        previous = copy;
+    }
+}
+
+TEST(Encoders, LocalConstantSigInvalid)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    mdcursor_t local_constant;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_LocalConstant, local_constant));
+
+    int32_t const value = 1;
+    md_local_constant_sig_t sig{};
+    sig.constant_kind = md_local_constant_sig_t::mdck_PrimitiveConstant;
+    sig.primitive.type_code = 0x0a; // ELEMENT_TYPE_I8
+    sig.value_blob = (uint8_t const*)&value;
+    sig.value_len = sizeof(value);
+
+    // The value must have the size of the type.
+    EXPECT_FALSE(md_encode_local_constant_sig(local_constant, &sig));
+
+    // Only integral types can be the underlying type of an enum.
+    sig.constant_kind = md_local_constant_sig_t::mdck_EnumConstant;
+    sig.enum_constant.type_code = 0x0c; // ELEMENT_TYPE_R4
+    sig.enum_constant.enum_type = 0x01000001;
+    EXPECT_FALSE(md_encode_local_constant_sig(local_constant, &sig));
+
+    // A primitive type code is required.
+    sig.constant_kind = md_local_constant_sig_t::mdck_PrimitiveConstant;
+    sig.primitive.type_code = 0x12; // ELEMENT_TYPE_CLASS
+    EXPECT_FALSE(md_encode_local_constant_sig(local_constant, &sig));
+
+    sig.primitive.type_code = 0x08; // ELEMENT_TYPE_I4
+    sig.value_blob = nullptr;
+    EXPECT_FALSE(md_encode_local_constant_sig(local_constant, &sig));
+    EXPECT_FALSE(md_encode_local_constant_sig(local_constant, nullptr));
+
+    mdcursor_t not_a_local_constant;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_Document, not_a_local_constant));
+    sig.value_blob = (uint8_t const*)&value;
+    EXPECT_FALSE(md_encode_local_constant_sig(not_a_local_constant, &sig));
+    EXPECT_TRUE(md_encode_local_constant_sig(local_constant, &sig));
+}
+
+TEST(Encoders, ImportsRoundTrip)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+
+    ImportsBuffer expected{ 8 };
+    std::memset(expected.get(), 0, expected.storage.size() * sizeof(uint64_t));
+    expected->count = 8;
+    auto& imports = expected->imports;
+    imports[0].kind = ImportEntry::mdidk_ImportNamespace;
+    SetString("System", imports[0].target_namespace, imports[0].target_namespace_len);
+    imports[1].kind = ImportEntry::mdidk_ImportAssemblyNamespace;
+    imports[1].assembly = 0x23000002;
+    SetString("System.Collections", imports[1].target_namespace, imports[1].target_namespace_len);
+    imports[2].kind = ImportEntry::mdidk_ImportType;
+    imports[2].target_type = 0x01000005;
+    imports[3].kind = ImportEntry::mdidk_ImportXmlNamespace;
+    SetString("xs", imports[3].alias, imports[3].alias_len);
+    SetString("http://www.w3.org/2001/XMLSchema", imports[3].target_namespace, imports[3].target_namespace_len);
+    imports[4].kind = ImportEntry::mdidk_ImportAssemblyReferenceAlias;
+    SetString("Ext", imports[4].alias, imports[4].alias_len);
+    imports[5].kind = ImportEntry::mdidk_AliasAssemblyReference;
+    SetString("Ext", imports[5].alias, imports[5].alias_len);
+    imports[5].assembly = 0x23000001;
+    imports[6].kind = ImportEntry::mdidk_AliasAssemblyNamespace;
+    SetString("Col", imports[6].alias, imports[6].alias_len);
+    imports[6].assembly = 0x23000001;
+    SetString("System.Collections.Generic", imports[6].target_namespace, imports[6].target_namespace_len);
+    imports[7].kind = ImportEntry::mdidk_AliasType;
+    SetString("Str", imports[7].alias, imports[7].alias_len);
+    imports[7].target_type = 0x1b000001;
+
+    mdcursor_t import_scope;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_ImportScope, import_scope));
+    ASSERT_TRUE(md_encode_imports(import_scope, expected.get()));
+
+    std::vector<uint64_t> buffer;
+    md_imports_t* actual;
+    ASSERT_NO_FATAL_FAILURE(ParseImports(import_scope, buffer, actual));
+    ASSERT_EQ(expected->count, actual->count);
+    for (uint32_t i = 0; i < expected->count; ++i)
+    {
+        EXPECT_EQ(imports[i].kind, actual->imports[i].kind);
+        EXPECT_EQ(Alias(imports[i]), Alias(actual->imports[i]));
+        EXPECT_EQ(Namespace(imports[i]), Namespace(actual->imports[i]));
+        EXPECT_EQ(imports[i].assembly, actual->imports[i].assembly);
+        EXPECT_EQ(imports[i].target_type, actual->imports[i].target_type);
+    }
+}
+
+TEST(Encoders, ImportsMatchCompiler)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // The using directives of Program.cs.
+    mdcursor_t original;
+    ASSERT_TRUE(md_token_to_cursor(handle, (mdtid_ImportScope << 24) | 2, &original));
+    std::vector<uint64_t> original_buffer;
+    md_imports_t* expected;
+    ASSERT_NO_FATAL_FAILURE(ParseImports(original, original_buffer, expected));
+    ASSERT_EQ(3u, expected->count);
+
+    mdcursor_t copy;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_ImportScope, copy));
+    ASSERT_TRUE(md_encode_imports(copy, expected));
+
+    // The strings are added to the heap again, so only the decoded imports match.
+    std::vector<uint64_t> copy_buffer;
+    md_imports_t* actual;
+    ASSERT_NO_FATAL_FAILURE(ParseImports(copy, copy_buffer, actual));
+    ASSERT_EQ(3u, actual->count);
+    EXPECT_EQ(ImportEntry::mdidk_ImportNamespace, actual->imports[0].kind);
+    EXPECT_EQ("System", Namespace(actual->imports[0]));
+    EXPECT_EQ(ImportEntry::mdidk_ImportNamespace, actual->imports[1].kind);
+    EXPECT_EQ("System.Threading.Tasks", Namespace(actual->imports[1]));
+    EXPECT_EQ(ImportEntry::mdidk_AliasNamespace, actual->imports[2].kind);
+    EXPECT_EQ("IO", Alias(actual->imports[2]));
+    EXPECT_EQ("System.IO", Namespace(actual->imports[2]));
+}
+
+TEST(Encoders, ImportsFromGrowingHeap)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // Re-encode the imports of the previous copy, whose strings are in the heap that grows with each copy.
+    mdcursor_t previous;
+    ASSERT_TRUE(md_token_to_cursor(handle, (mdtid_ImportScope << 24) | 2, &previous));
+    for (int i = 0; i < 256; ++i)
+    {
+        std::vector<uint64_t> buffer;
+        md_imports_t* imports;
+        ASSERT_NO_FATAL_FAILURE(ParseImports(previous, buffer, imports));
+
+        mdcursor_t copy;
+        ASSERT_NO_FATAL_FAILURE(AppendRow(handle, mdtid_ImportScope, copy));
+        ASSERT_TRUE(md_encode_imports(copy, imports));
+        previous = copy;
+    }
+
+    std::vector<uint64_t> buffer;
+    md_imports_t* actual;
+    ASSERT_NO_FATAL_FAILURE(ParseImports(previous, buffer, actual));
+    ASSERT_EQ(3u, actual->count);
+    EXPECT_EQ("System", Namespace(actual->imports[0]));
+    EXPECT_EQ("System.Threading.Tasks", Namespace(actual->imports[1]));
+    EXPECT_EQ("IO", Alias(actual->imports[2]));
+    EXPECT_EQ("System.IO", Namespace(actual->imports[2]));
+}
+
+TEST(Encoders, ImportsEmpty)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    mdcursor_t import_scope;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_ImportScope, import_scope));
+
+    md_imports_t imports{};
+    ASSERT_TRUE(md_encode_imports(import_scope, &imports));
+    EXPECT_TRUE(GetBlob(import_scope, mdtImportScope_Imports).empty());
+}
+
+TEST(Encoders, ImportsInvalid)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    mdcursor_t import_scope;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_ImportScope, import_scope));
+
+    ImportsBuffer imports{ 1 };
+    std::memset(imports.get(), 0, imports.storage.size() * sizeof(uint64_t));
+    imports->count = 1;
+
+    // Unknown kind.
+    imports->imports[0].kind = (decltype(imports->imports[0].kind))10;
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    // The assembly must be an AssemblyRef.
+    imports->imports[0].kind = ImportEntry::mdidk_ImportAssemblyNamespace;
+    imports->imports[0].assembly = 0x02000001;
+    SetString("System", imports->imports[0].target_namespace, imports->imports[0].target_namespace_len);
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    // A string with a length must have characters.
+    imports->imports[0].kind = ImportEntry::mdidk_ImportNamespace;
+    imports->imports[0].target_namespace = nullptr;
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    EXPECT_FALSE(md_encode_imports(import_scope, nullptr));
+
+    mdcursor_t not_an_import_scope;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_Document, not_an_import_scope));
+    SetString("System", imports->imports[0].target_namespace, imports->imports[0].target_namespace_len);
+    EXPECT_FALSE(md_encode_imports(not_an_import_scope, imports.get()));
+    EXPECT_TRUE(md_encode_imports(import_scope, imports.get()));
+}
+
+TEST(Encoders, ImportsInvalidLeavesHeapUnchanged)
+{
+    mdhandle_ptr pdb;
+    ASSERT_NO_FATAL_FAILURE(CreatePdb(pdb));
+    mdcursor_t import_scope;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_ImportScope, import_scope));
+
+    // Each one-byte blob takes two bytes of the #Blob heap, so the offset of the next one shows whether the heap grew.
+    mdcursor_t document;
+    ASSERT_NO_FATAL_FAILURE(AppendRow(pdb.get(), mdtid_Document, document));
+    auto addBlob = [&]()
+    {
+        uint8_t hash = 1;
+        EXPECT_TRUE(md_set_column_value_as_blob(document, mdtDocument_Hash, &hash, 1));
+        uint32_t offset = 0;
+        EXPECT_TRUE(md_get_column_value_as_heap_offset(document, mdtDocument_Hash, &offset));
+        return offset;
+    };
+
+    // The first import adds strings to the heap, the second is invalid.
+    ImportsBuffer imports{ 2 };
+    std::memset(imports.get(), 0, imports.storage.size() * sizeof(uint64_t));
+    imports->count = 2;
+    imports->imports[0].kind = ImportEntry::mdidk_AliasNamespace;
+    SetString("IO", imports->imports[0].alias, imports->imports[0].alias_len);
+    SetString("System.IO", imports->imports[0].target_namespace, imports->imports[0].target_namespace_len);
+
+    uint32_t offset = addBlob();
+
+    // Unknown kind.
+    imports->imports[1].kind = (decltype(imports->imports[1].kind))10;
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    // The assembly must be an AssemblyRef.
+    imports->imports[1].kind = ImportEntry::mdidk_AliasAssemblyNamespace;
+    SetString("Col", imports->imports[1].alias, imports->imports[1].alias_len);
+    imports->imports[1].assembly = 0x02000001;
+    SetString("System.Collections", imports->imports[1].target_namespace, imports->imports[1].target_namespace_len);
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    // The type must be a TypeDefOrRef.
+    imports->imports[1].kind = ImportEntry::mdidk_AliasType;
+    imports->imports[1].target_type = 0x06000001;
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    // A string with a length must have characters.
+    imports->imports[1].kind = ImportEntry::mdidk_AliasNamespace;
+    imports->imports[1].target_namespace = nullptr;
+    EXPECT_FALSE(md_encode_imports(import_scope, imports.get()));
+
+    uint32_t nextOffset = addBlob();
+    EXPECT_EQ(offset + 2, nextOffset);
+
+    SetString("System.Collections", imports->imports[1].target_namespace, imports->imports[1].target_namespace_len);
+    EXPECT_TRUE(md_encode_imports(import_scope, imports.get()));
+    EXPECT_LT(nextOffset + 2, addBlob());
+}
@@ -0,0 +1,129 @@
+#include "pdb.hpp"
+
+namespace
+{
+    std::vector<md_local_scope_t> FindLocalScopes(mdhandle_t handle, mdToken method, uint32_t il_offset)
+    {
+        int32_t count = md_find_local_scopes(handle, method, il_offset, 0, nullptr);
+        EXPECT_LE(0, count);
+        if (count <= 0)
+            return {};
+
+        std::vector<md_local_scope_t> scopes(count);
+        EXPECT_EQ(count, md_find_local_scopes(handle, method, il_offset, (uint32_t)scopes.size(), scopes.data()));
+        return scopes;
+    }
+
+    std::vector<uint32_t> GetScopeRows(std::vector<md_local_scope_t> const& scopes)
+    {
+        std::vector<uint32_t> rows;
+        for (md_local_scope_t const& scope : scopes)
+            rows.push_back(GetRowId(scope.scope));
+        return rows;
+    }
+
+    std::vector<std::string> GetNames(mdcursor_t first, uint32_t count, col_index_t name_column)
+    {
+        std::vector<std::string> names;
+        mdcursor_t cursor = first;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            char const* name;
+            EXPECT_TRUE(md_get_column_value_as_utf8(cursor, name_column, &name));
+            names.push_back(name);
+            EXPECT_TRUE(md_cursor_next(&cursor));
+        }
+        return names;
+    }
+}
+
+TEST(LocalScopes, FindNestedScopes)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    // Main has the method scope [0, 61), the loop scope [3, 29) and the loop body scope [7, 17).
+    std::vector<md_local_scope_t> scopes = FindLocalScopes(handle, MainMethod, 8);
+    ASSERT_EQ((std::vector<uint32_t>{ 3, 2, 1 }), GetScopeRows(scopes));
+    EXPECT_EQ(7u, scopes[0].start_offset);
+    EXPECT_EQ(10u, scopes[0].length);
+    EXPECT_EQ(std::vector<std::string>{ "square" }, GetNames(scopes[0].variables, scopes[0].variable_count, mdtLocalVariable_Name));
+    EXPECT_EQ(0u, scopes[0].constant_count);
+    EXPECT_EQ(3u, scopes[1].start_offset);
+    EXPECT_EQ(26u, scopes[1].length);
+    EXPECT_EQ(std::vector<std::string>{ "i" }, GetNames(scopes[1].variables, scopes[1].variable_count, mdtLocalVariable_Name));
+    EXPECT_EQ(0u, scopes[2].start_offset);
+    EXPECT_EQ(61u, scopes[2].length);
+    EXPECT_EQ(std::vector<std::string>{ "sum" }, GetNames(scopes[2].variables, scopes[2].variable_count, mdtLocalVariable_Name));
+    EXPECT_EQ(std::vector<std::string>{ "Offset" }, GetNames(scopes[2].constants, scopes[2].constant_count, mdtLocalConstant_Name));
+
+    EXPECT_EQ((std::vector<uint32_t>{ 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 4)));
+    EXPECT_EQ((std::vector<uint32_t>{ 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 3)));
+    EXPECT_EQ((std::vector<uint32_t>{ 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 2)));
+    EXPECT_EQ((std::vector<uint32_t>{ 3, 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 16)));
+
+    // Past the end of a nested scope, only the scopes that still contain the offset.
+    EXPECT_EQ((std::vector<uint32_t>{ 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 17)));
+    EXPECT_EQ((std::vector<uint32_t>{ 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 40)));
+    EXPECT_EQ((std::vector<uint32_t>{ 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 60)));
+    EXPECT_TRUE(FindLocalScopes(handle, MainMethod, 61).empty());
+}
+
+TEST(LocalScopes, FindScopesOfOtherMethods)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    std::vector<md_local_scope_t> scopes = FindLocalScopes(handle, HelperMethod, 0);
+    ASSERT_EQ((std::vector<uint32_t>{ 5 }), GetScopeRows(scopes));
+    EXPECT_EQ(0u, scopes[0].variable_count);
+    EXPECT_EQ(std::vector<std::string>{ "Name" }, GetNames(scopes[0].constants, scopes[0].constant_count, mdtLocalConstant_Name));
+
+    scopes = FindLocalScopes(handle, RunAsyncMethod, 55);
+    ASSERT_EQ((std::vector<uint32_t>{ 4 }), GetScopeRows(scopes));
+    EXPECT_EQ(0u, scopes[0].variable_count);
+    EXPECT_EQ(0u, scopes[0].constant_count);
+
+    EXPECT_EQ((std::vector<uint32_t>{ 6 }), GetScopeRows(FindLocalScopes(handle, MoveNextMethod, 100)));
+
+    // Methods without scopes.
+    EXPECT_TRUE(FindLocalScopes(handle, 0x06000004, 0).empty());
+    EXPECT_TRUE(FindLocalScopes(handle, 0x06000100, 0).empty());
+}
+
+TEST(LocalScopes, FindTruncated)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+
+    // The total is returned, and only the innermost scopes are written.
+    md_local_scope_t scope;
+    ASSERT_EQ(3, md_find_local_scopes(pdb.handle.get(), MainMethod, 8, 1, &scope));
+    EXPECT_EQ(3u, GetRowId(scope.scope));
+}
+
+TEST(LocalScopes, FindInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    md_local_scope_t scope;
+    EXPECT_EQ(-1, md_find_local_scopes(pdb.handle.get(), 0x02000001, 0, 1, &scope));
+    EXPECT_EQ(-1, md_find_local_scopes(pdb.handle.get(), MainMethod, 0, 1, nullptr));
+    EXPECT_EQ(-1, md_find_local_scopes(nullptr, MainMethod, 0, 1, &scope));
+}
+
+TEST(LocalScopes, EditDropsIndex)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    EXPECT_EQ((std::vector<uint32_t>{ 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 20)));
+
+    // Extend the loop body scope to [7, 27).
+    mdcursor_t scope;
+    ASSERT_TRUE(md_token_to_cursor(handle, LocalScopeToken(3), &scope));
+    ASSERT_TRUE(md_set_column_value_as_constant(scope, mdtLocalScope_Length, 20));
+    EXPECT_EQ((std::vector<uint32_t>{ 3, 2, 1 }), GetScopeRows(FindLocalScopes(handle, MainMethod, 20)));
+}
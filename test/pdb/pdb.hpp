@@ -0,0 +1,69 @@
+#ifndef DNMD_TEST_PDB_PDB_HPP
+#define DNMD_TEST_PDB_PDB_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <dnmd.hpp>
+#include <dnmd_pdb.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// assets/PdbTest.pdb is the Portable PDB of assets/Program.cs and assets/Sub/Helpers.cs, compiled with:
+//   csc -target:exe -debug:portable -deterministic -optimize- -pathmap:<assets>/=/src/ -embed:Sub/Helpers.cs
+//       -out:PdbTest.dll Program.cs Sub/Helpers.cs
+// The expected values in the tests are the ones System.Reflection.Metadata reads from the same file.
+
+constexpr mdToken DocumentToken(uint32_t rid) { return (mdtid_Document << 24) | rid; }
+constexpr mdToken LocalScopeToken(uint32_t rid) { return (mdtid_LocalScope << 24) | rid; }
+
+// The MethodDef tokens of the methods in the PDB.
+constexpr mdToken MainMethod = 0x06000001;
+constexpr mdToken RunAsyncMethod = 0x06000002;
+constexpr mdToken HelperMethod = 0x06000003;
+constexpr mdToken MoveNextMethod = 0x06000005;
+
+// The Document rows in the PDB.
+constexpr uint32_t ProgramDocument = 1;
+constexpr uint32_t HelpersDocument = 2;
+constexpr uint32_t GeneratedDocument = 3;
+
+// A test PDB and the handle over it. The data must outlive the handle.
+struct TestPdb final
+{
+    std::vector<uint8_t> data;
+    mdhandle_ptr handle;
+};
+
+inline std::vector<uint8_t> ReadAsset(char const* name)
+{
+    std::ifstream file{ std::string{ PDB_TEST_ASSETS } + "/" + name, std::ios::binary };
+    return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+inline void OpenTestPdb(TestPdb& pdb)
+{
+    pdb.data = ReadAsset("PdbTest.pdb");
+    ASSERT_FALSE(pdb.data.empty());
+    mdhandle_t handle;
+    ASSERT_TRUE(md_create_handle(pdb.data.data(), pdb.data.size(), &handle));
+    pdb.handle.reset(handle);
+}
+
+// Get the MethodDebugInformation row of a MethodDef, which shares its row id.
+inline void GetMethodDebugInformation(mdhandle_t handle, mdToken method, mdcursor_t& cursor)
+{
+    ASSERT_TRUE(md_token_to_cursor(handle, (mdtid_MethodDebugInformation << 24) | (method & 0x00ffffff), &cursor));
+}
+
+inline uint32_t GetRowId(mdcursor_t cursor)
+{
+    mdToken tk;
+    EXPECT_TRUE(md_cursor_to_token(cursor, &tk));
+    return tk & 0x00ffffff;
+}
+
+#endif // DNMD_TEST_PDB_PDB_HPP
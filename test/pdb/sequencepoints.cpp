@@ -0,0 +1,480 @@
+#include "pdb.hpp"
+
+namespace
+{
+    struct ExpectedSequencePoint
+    {
+        md_sequence_point_kind_t kind;
+        uint32_t document;
+        uint32_t il_offset;
+        uint32_t start_line;
+        uint32_t start_column;
+        uint32_t end_line;
+        uint32_t end_column;
+    };
+
+    ExpectedSequencePoint Point(uint32_t document, uint32_t il_offset, uint32_t start_line, uint32_t start_column, uint32_t end_line, uint32_t end_column)
+    {
+        return { mdsp_SequencePointRecord, document, il_offset, start_line, start_column, end_line, end_column };
+    }
+
+    ExpectedSequencePoint Hidden(uint32_t document, uint32_t il_offset)
+    {
+        return { mdsp_HiddenSequencePointRecord, document, il_offset, 0, 0, 0, 0 };
+    }
+
+    ExpectedSequencePoint Document(uint32_t document)
+    {
+        return { mdsp_DocumentRecord, document, 0, 0, 0, 0, 0 };
+    }
+
+    void GetSequencePointsBlob(mdcursor_t method_debug_information, uint8_t const*& blob, uint32_t& blob_len)
+    {
+        ASSERT_TRUE(md_get_column_value_as_blob(method_debug_information, mdtMethodDebugInformation_SequencePoints, &blob, &blob_len));
+    }
+
+    void ReadSequencePoints(mdcursor_t method_debug_information, uint8_t const* blob, size_t blob_len, md_blob_parse_result_t& result, std::vector<ExpectedSequencePoint>& records)
+    {
+        md_sequence_point_iterator_t iterator;
+        result = md_sequence_point_iterator_init(method_debug_information, blob, blob_len, &iterator);
+        if (result != mdbpr_Success)
+            return;
+
+        md_sequence_point_t sequence_point;
+        while (md_sequence_point_iterator_next(&iterator, &sequence_point))
+        {
+            records.push_back({
+                sequence_point.kind,
+                GetRowId(sequence_point.document),
+                sequence_point.il_offset,
+                sequence_point.start_line,
+                sequence_point.start_column,
+                sequence_point.end_line,
+                sequence_point.end_column });
+            EXPECT_EQ(GetRowId(sequence_point.document), GetRowId(iterator.document));
+        }
+        result = md_sequence_point_iterator_result(&iterator);
+    }
+
+    void AssertSequencePoints(std::vector<ExpectedSequencePoint> const& expected, std::vector<ExpectedSequencePoint> const& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            SCOPED_TRACE(i);
+            EXPECT_EQ(expected[i].kind, actual[i].kind);
+            EXPECT_EQ(expected[i].document, actual[i].document);
+            EXPECT_EQ(expected[i].il_offset, actual[i].il_offset);
+            EXPECT_EQ(expected[i].start_line, actual[i].start_line);
+            EXPECT_EQ(expected[i].start_column, actual[i].start_column);
+            EXPECT_EQ(expected[i].end_line, actual[i].end_line);
+            EXPECT_EQ(expected[i].end_column, actual[i].end_column);
+        }
+    }
+
+    // Main has no Document column, so its initial document is in the blob, and switches to Generated.cs for a #line block.
+    std::vector<ExpectedSequencePoint> const MainSequencePoints =
+    {
+        Point(ProgramDocument, 0, 10, 9, 10, 10),
+        Point(ProgramDocument, 1, 11, 13, 11, 25),
+        Point(ProgramDocument, 3, 12, 18, 12, 27),
+        Hidden(ProgramDocument, 5),
+        Point(ProgramDocument, 7, 13, 13, 13, 14),
+        Point(ProgramDocument, 8, 14, 17, 14, 36),
+        Point(ProgramDocument, 12, 15, 17, 15, 31),
+        Point(ProgramDocument, 16, 16, 13, 16, 14),
+        Point(ProgramDocument, 17, 12, 36, 12, 39),
+        Point(ProgramDocument, 21, 12, 29, 12, 34),
+        Hidden(ProgramDocument, 26),
+        Document(GeneratedDocument),
+        Point(GeneratedDocument, 29, 100, 13, 100, 27),
+        Document(ProgramDocument),
+        Point(ProgramDocument, 34, 22, 13, 22, 61),
+        Point(ProgramDocument, 58, 23, 9, 23, 10),
+    };
+}
+
+TEST(SequencePoints, IterateWithInitialDocumentInBlob)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetSequencePointsBlob(method, blob, blob_len));
+
+    md_sequence_point_iterator_t iterator;
+    ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_init(method, blob, blob_len, &iterator));
+    EXPECT_EQ(1u, iterator.signature);
+    EXPECT_EQ(ProgramDocument, GetRowId(iterator.document));
+
+    md_blob_parse_result_t result;
+    std::vector<ExpectedSequencePoint> records;
+    ReadSequencePoints(method, blob, blob_len, result, records);
+    EXPECT_EQ(mdbpr_Success, result);
+    AssertSequencePoints(MainSequencePoints, records);
+}
+
+TEST(SequencePoints, IterateWithDocumentColumn)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), HelperMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetSequencePointsBlob(method, blob, blob_len));
+
+    md_sequence_point_iterator_t iterator;
+    ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_init(method, blob, blob_len, &iterator));
+    EXPECT_EQ(3u, iterator.signature);
+    EXPECT_EQ(HelpersDocument, GetRowId(iterator.document));
+
+    md_blob_parse_result_t result;
+    std::vector<ExpectedSequencePoint> records;
+    ReadSequencePoints(method, blob, blob_len, result, records);
+    EXPECT_EQ(mdbpr_Success, result);
+    AssertSequencePoints(
+        {
+            Point(HelpersDocument, 0, 6, 9, 6, 10),
+            Point(HelpersDocument, 1, 8, 13, 8, 44),
+            Point(HelpersDocument, 18, 9, 9, 9, 10),
+        }, records);
+}
+
+TEST(SequencePoints, IterateHiddenSequencePoints)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MoveNextMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetSequencePointsBlob(method, blob, blob_len));
+
+    md_blob_parse_result_t result;
+    std::vector<ExpectedSequencePoint> records;
+    ReadSequencePoints(method, blob, blob_len, result, records);
+    EXPECT_EQ(mdbpr_Success, result);
+    // The first two points are hidden, so the first visible point still has an absolute start line and column.
+    AssertSequencePoints(
+        {
+            Hidden(ProgramDocument, 0),
+            Hidden(ProgramDocument, 7),
+            Point(ProgramDocument, 14, 26, 9, 26, 10),
+            Point(ProgramDocument, 15, 27, 13, 27, 35),
+            Point(ProgramDocument, 29, 28, 13, 28, 32),
+            Hidden(ProgramDocument, 43),
+            Point(ProgramDocument, 125, 29, 13, 29, 30),
+            Hidden(ProgramDocument, 136),
+            Point(ProgramDocument, 162, 30, 9, 30, 10),
+            Hidden(ProgramDocument, 170),
+        }, records);
+}
+
+TEST(SequencePoints, IterateMatchesParse)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetSequencePointsBlob(method, blob, blob_len));
+
+    size_t buffer_len = 0;
+    ASSERT_EQ(mdbpr_InsufficientBuffer, md_parse_sequence_points(method, blob, blob_len, nullptr, &buffer_len));
+    std::vector<uint8_t> buffer(buffer_len);
+    md_sequence_points_t* sequence_points = reinterpret_cast<md_sequence_points_t*>(buffer.data());
+    ASSERT_EQ(mdbpr_Success, md_parse_sequence_points(method, blob, blob_len, sequence_points, &buffer_len));
+
+    ASSERT_EQ(MainSequencePoints.size(), sequence_points->record_count);
+    for (uint32_t i = 0; i < sequence_points->record_count; ++i)
+    {
+        SCOPED_TRACE(i);
+        ExpectedSequencePoint const& expected = MainSequencePoints[i];
+        auto const& record = sequence_points->records[i];
+        ASSERT_EQ(expected.kind, record.kind);
+        switch (record.kind)
+        {
+        case mdsp_DocumentRecord:
+            EXPECT_EQ(expected.document, GetRowId(record.document.document));
+            break;
+        case mdsp_HiddenSequencePointRecord:
+            EXPECT_EQ(expected.il_offset, record.hidden_sequence_point.rolling_il_offset);
+            break;
+        case mdsp_SequencePointRecord:
+            EXPECT_EQ(expected.il_offset, record.sequence_point.rolling_il_offset);
+            EXPECT_EQ(expected.start_line, record.sequence_point.rolling_start_line);
+            EXPECT_EQ(expected.start_column, record.sequence_point.rolling_start_column);
+            EXPECT_EQ(expected.end_line - expected.start_line, record.sequence_point.delta_lines);
+            EXPECT_EQ((int64_t)expected.end_column - expected.start_column, record.sequence_point.delta_columns);
+            break;
+        }
+    }
+}
+
+TEST(SequencePoints, IterateTruncatedBlob)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_NO_FATAL_FAILURE(GetSequencePointsBlob(method, blob, blob_len));
+
+    // Every prefix of the blob either fails in the header or decodes a prefix of the records.
+    for (uint32_t len = 0; len < blob_len; ++len)
+    {
+        SCOPED_TRACE(len);
+        md_blob_parse_result_t result;
+        std::vector<ExpectedSequencePoint> records;
+
+        // Each prefix is copied, so reading past its end is caught by the sanitizers.
+        std::vector<uint8_t> prefix{ blob, blob + len };
+        ReadSequencePoints(method, len != 0 ? prefix.data() : blob, len, result, records);
+        if (len < 2)
+        {
+            EXPECT_EQ(mdbpr_InvalidBlob, result);
+            continue;
+        }
+
+        EXPECT_TRUE(result == mdbpr_Success || result == mdbpr_InvalidBlob);
+        ASSERT_LT(records.size(), MainSequencePoints.size());
+        AssertSequencePoints({ MainSequencePoints.begin(), MainSequencePoints.begin() + records.size() }, records);
+    }
+}
+
+TEST(SequencePoints, IterateCorruptBlob)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+
+    md_blob_parse_result_t result;
+    std::vector<ExpectedSequencePoint> records;
+
+    // Initial document row out of range.
+    uint8_t const bad_initial_document[] = { 0x00, 0x09, 0x00, 0x00, 0x01, 0x0a, 0x09 };
+    ReadSequencePoints(method, bad_initial_document, sizeof(bad_initial_document), result, records);
+    EXPECT_EQ(mdbpr_InvalidBlob, result);
+    EXPECT_TRUE(records.empty());
+
+    // Document record with a row out of range.
+    uint8_t const bad_document_record[] = { 0x00, 0x01, 0x00, 0x00, 0x01, 0x0a, 0x09, 0x00, 0x09 };
+    records.clear();
+    ReadSequencePoints(method, bad_document_record, sizeof(bad_document_record), result, records);
+    EXPECT_EQ(mdbpr_InvalidBlob, result);
+    AssertSequencePoints({ Point(ProgramDocument, 0, 10, 9, 10, 10) }, records);
+
+    // Start line delta of -5 from line 1.
+    uint8_t const negative_start_line[] = { 0x00, 0x01, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x01, 0x77, 0x00 };
+    records.clear();
+    ReadSequencePoints(method, negative_start_line, sizeof(negative_start_line), result, records);
+    EXPECT_EQ(mdbpr_InvalidBlob, result);
+    AssertSequencePoints({ Point(ProgramDocument, 0, 1, 1, 1, 2) }, records);
+
+    // Iteration stays stopped after an invalid record.
+    md_sequence_point_iterator_t iterator;
+    ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_init(method, bad_document_record, sizeof(bad_document_record), &iterator));
+    md_sequence_point_t sequence_point;
+    EXPECT_TRUE(md_sequence_point_iterator_next(&iterator, &sequence_point));
+    EXPECT_FALSE(md_sequence_point_iterator_next(&iterator, &sequence_point));
+    EXPECT_FALSE(md_sequence_point_iterator_next(&iterator, &sequence_point));
+    EXPECT_EQ(mdbpr_InvalidBlob, md_sequence_point_iterator_result(&iterator));
+}
+
+TEST(SequencePoints, IterateInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+
+    uint8_t const blob[] = { 0x00, 0x01 };
+    md_sequence_point_iterator_t iterator;
+    EXPECT_EQ(mdbpr_InvalidArgument, md_sequence_point_iterator_init(method, nullptr, 0, &iterator));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_sequence_point_iterator_init(method, blob, sizeof(blob), nullptr));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_sequence_point_iterator_init({}, blob, sizeof(blob), &iterator));
+    EXPECT_EQ(mdbpr_InvalidArgument, md_sequence_point_iterator_result(nullptr));
+
+    // A blob with only a header has no records.
+    ASSERT_EQ(mdbpr_Success, md_sequence_point_iterator_init(method, blob, sizeof(blob), &iterator));
+    md_sequence_point_t sequence_point;
+    EXPECT_FALSE(md_sequence_point_iterator_next(&iterator, &sequence_point));
+    EXPECT_EQ(mdbpr_Success, md_sequence_point_iterator_result(&iterator));
+}
+
+TEST(SequencePoints, FindByILOffset)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+
+    md_source_location_t location;
+    ASSERT_TRUE(md_find_sequence_point(method, 0, &location));
+    EXPECT_EQ(ProgramDocument, GetRowId(location.document));
+    EXPECT_EQ(0u, location.il_offset);
+    EXPECT_EQ(10u, location.start_line);
+    EXPECT_EQ(9u, location.start_column);
+
+    // An offset between two points maps to the earlier one.
+    ASSERT_TRUE(md_find_sequence_point(method, 2, &location));
+    EXPECT_EQ(1u, location.il_offset);
+    EXPECT_EQ(11u, location.start_line);
+    EXPECT_EQ(13u, location.start_column);
+
+    // Offsets covered by a hidden point have no location.
+    EXPECT_FALSE(md_find_sequence_point(method, 5, &location));
+    EXPECT_FALSE(md_find_sequence_point(method, 6, &location));
+    EXPECT_FALSE(md_find_sequence_point(method, 28, &location));
+
+    // The document of a point after a document record.
+    ASSERT_TRUE(md_find_sequence_point(method, 30, &location));
+    EXPECT_EQ(GeneratedDocument, GetRowId(location.document));
+    EXPECT_EQ(29u, location.il_offset);
+    EXPECT_EQ(100u, location.start_line);
+    EXPECT_EQ(13u, location.start_column);
+
+    ASSERT_TRUE(md_find_sequence_point(method, 34, &location));
+    EXPECT_EQ(ProgramDocument, GetRowId(location.document));
+    EXPECT_EQ(22u, location.start_line);
+
+    // Offsets past the last point map to the last point.
+    ASSERT_TRUE(md_find_sequence_point(method, UINT32_MAX, &location));
+    EXPECT_EQ(58u, location.il_offset);
+    EXPECT_EQ(23u, location.start_line);
+    EXPECT_EQ(9u, location.start_column);
+}
+
+TEST(SequencePoints, FindByILOffsetBeforeFirstVisiblePoint)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MoveNextMethod, method));
+
+    md_source_location_t location;
+    EXPECT_FALSE(md_find_sequence_point(method, 0, &location));
+    EXPECT_FALSE(md_find_sequence_point(method, 13, &location));
+    ASSERT_TRUE(md_find_sequence_point(method, 14, &location));
+    EXPECT_EQ(26u, location.start_line);
+    ASSERT_TRUE(md_find_sequence_point(method, 135, &location));
+    EXPECT_EQ(125u, location.il_offset);
+    EXPECT_EQ(29u, location.start_line);
+    EXPECT_FALSE(md_find_sequence_point(method, 200, &location));
+
+    // A method without sequence points.
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), RunAsyncMethod, method));
+    EXPECT_FALSE(md_find_sequence_point(method, 0, &location));
+}
+
+TEST(SequencePoints, FindByILOffsetInvalidArguments)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, method));
+
+    md_source_location_t location;
+    EXPECT_FALSE(md_find_sequence_point(method, 0, nullptr));
+    EXPECT_FALSE(md_find_sequence_point({}, 0, &location));
+
+    mdcursor_t document;
+    ASSERT_TRUE(md_token_to_cursor(pdb.handle.get(), DocumentToken(ProgramDocument), &document));
+    EXPECT_FALSE(md_find_sequence_point(document, 0, &location));
+}
+
+TEST(SequencePoints, BuildIndex)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+
+    mdcursor_t cursor;
+    uint32_t count;
+    ASSERT_TRUE(md_create_cursor(handle, mdtid_MethodDebugInformation, &cursor, &count));
+    ASSERT_EQ(6u, count);
+
+    EXPECT_EQ(0u, md_get_sequence_point_index_size(handle));
+    EXPECT_FALSE(md_build_sequence_point_index(handle, 0, 1));
+    EXPECT_FALSE(md_build_sequence_point_index(handle, 1, count + 1));
+    EXPECT_FALSE(md_build_sequence_point_index(handle, count + 1, 1));
+    EXPECT_TRUE(md_build_sequence_point_index(handle, count + 1, 0));
+
+    // Build in two ranges, as separate threads would.
+    ASSERT_TRUE(md_build_sequence_point_index(handle, 1, 3));
+    size_t partial_size = md_get_sequence_point_index_size(handle);
+    EXPECT_NE(0u, partial_size);
+    ASSERT_TRUE(md_build_sequence_point_index(handle, 4, count - 3));
+    EXPECT_GT(md_get_sequence_point_index_size(handle), partial_size);
+
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(handle, HelperMethod, method));
+    md_source_location_t location;
+    ASSERT_TRUE(md_find_sequence_point(method, 17, &location));
+    EXPECT_EQ(HelpersDocument, GetRowId(location.document));
+    EXPECT_EQ(1u, location.il_offset);
+    EXPECT_EQ(8u, location.start_line);
+    EXPECT_EQ(13u, location.start_column);
+}
+
+TEST(SequencePoints, EditDropsIndex)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+    mdhandle_t handle = pdb.handle.get();
+    mdcursor_t method;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(handle, HelperMethod, method));
+
+    md_source_location_t location;
+    ASSERT_TRUE(md_find_sequence_point(method, 0, &location));
+    EXPECT_EQ(6u, location.start_line);
+    EXPECT_NE(0u, md_get_sequence_point_index_size(handle));
+
+    // Replace the points of Helper with a single point at 7:2-7:7.
+    uint8_t const blob[] = { 0x03, 0x00, 0x00, 0x05, 0x07, 0x02 };
+    ASSERT_TRUE(md_set_column_value_as_blob(method, mdtMethodDebugInformation_SequencePoints, blob, sizeof(blob)));
+    EXPECT_EQ(0u, md_get_sequence_point_index_size(handle));
+
+    ASSERT_TRUE(md_find_sequence_point(method, 18, &location));
+    EXPECT_EQ(HelpersDocument, GetRowId(location.document));
+    EXPECT_EQ(0u, location.il_offset);
+    EXPECT_EQ(7u, location.start_line);
+    EXPECT_EQ(2u, location.start_column);
+}
+
+TEST(SequencePoints, DecompressWholeBlob)
+{
+    TestPdb pdb;
+    ASSERT_NO_FATAL_FAILURE(OpenTestPdb(pdb));
+
+    // Every field of a sequence points blob is a compressed integer.
+    mdcursor_t cursor;
+    ASSERT_NO_FATAL_FAILURE(GetMethodDebugInformation(pdb.handle.get(), MainMethod, cursor));
+    uint8_t const* blob;
+    uint32_t blob_len;
+    ASSERT_TRUE(md_get_column_value_as_blob(cursor, mdtMethodDebugInformation_SequencePoints, &blob, &blob_len));
+    ASSERT_LT(0u, blob_len);
+
+    // Decode the whole blob as unsigned values at once and compare with decoding one value at a time,
+    // which never takes the block path.
+    std::vector<uint32_t> expected;
+    uint8_t const* ptr = blob;
+    size_t len = blob_len;
+    uint32_t value;
+    while (len > 0 && md_decompress_u32_many(&ptr, &len, 1, &value) == 1)
+        expected.push_back(value);
+    EXPECT_EQ(0u, len);
+
+    std::vector<uint32_t> actual(blob_len);
+    ptr = blob;
+    len = blob_len;
+    actual.resize(md_decompress_u32_many(&ptr, &len, blob_len, actual.data()));
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(0u, len);
+}
@@ -0,0 +1,541 @@
+#include "pdb.hpp"
+
+#include <internal/dnmd_platform.hpp>
+#include <external/corsym.h>
+#include <dnmd_interfaces.hpp>
+#include <internal/dnmd_tools_platform.hpp>
+
+#include <array>
+
+using WSTR_string = std::basic_string<WCHAR>;
+
+namespace
+{
+    // The asset paths are ASCII.
+    WSTR_string GetAssetPath(char const* name)
+    {
+        std::string path = std::string{ PDB_TEST_ASSETS } + "/" + name;
+        return { path.begin(), path.end() };
+    }
+
+    // The importer owns a copy of the module's metadata.
+    void OpenModule(dncp::com_ptr<IMetaDataImport>& importer)
+    {
+        malloc_span<uint8_t> module;
+        ASSERT_TRUE(read_in_file((std::string{ PDB_TEST_ASSETS } + "/PdbTest.dll").c_str(), module));
+        ASSERT_TRUE(get_metadata_from_pe(module));
+
+        dncp::com_ptr<IMetaDataDispenser> dispenser;
+        ASSERT_EQ(S_OK, GetDispenser(IID_IMetaDataDispenser, (void**)&dispenser));
+        ASSERT_EQ(S_OK, dispenser->OpenScopeOnMemory(module, (ULONG)module.size(), ofCopyMemory, IID_IMetaDataImport, (IUnknown**)&importer));
+    }
+
+    void CreateReader(IUnknown* importer, dncp::com_ptr<ISymUnmanagedReader>& reader)
+    {
+        dncp::com_ptr<ISymUnmanagedBinder> binder;
+        ASSERT_EQ(S_OK, GetSymBinder(IID_ISymUnmanagedBinder, (void**)&binder));
+        ASSERT_EQ(S_OK, binder->GetReaderForFile(importer, GetAssetPath("PdbTest.dll").c_str(), nullptr, &reader));
+    }
+
+    void CreateReader(dncp::com_ptr<ISymUnmanagedReader>& reader)
+    {
+        dncp::com_ptr<IMetaDataImport> importer;
+        ASSERT_NO_FATAL_FAILURE(OpenModule(importer));
+        ASSERT_NO_FATAL_FAILURE(CreateReader(importer, reader));
+    }
+
+    template<typename T>
+    WSTR_string GetName(T* obj)
+    {
+        ULONG32 length;
+        EXPECT_EQ(S_OK, obj->GetName(0, &length, nullptr));
+        WSTR_string name(length, W('\0'));
+        EXPECT_EQ(S_OK, obj->GetName(length, &length, &name[0]));
+        name.resize(length != 0 ? length - 1 : 0);
+        return name;
+    }
+
+    WSTR_string GetURL(ISymUnmanagedDocument* document)
+    {
+        ULONG32 length;
+        EXPECT_EQ(S_OK, document->GetURL(0, &length, nullptr));
+        WSTR_string url(length, W('\0'));
+        EXPECT_EQ(S_OK, document->GetURL(length, &length, &url[0]));
+        url.resize(length != 0 ? length - 1 : 0);
+        return url;
+    }
+
+    void GetDocument(ISymUnmanagedReader* reader, WCHAR const* url, dncp::com_ptr<ISymUnmanagedDocument>& document)
+    {
+        ASSERT_EQ(S_OK, reader->GetDocument(const_cast<WCHAR*>(url), GUID{}, GUID{}, GUID{}, &document));
+    }
+
+    void GetMethod(ISymUnmanagedReader* reader, mdMethodDef token, dncp::com_ptr<ISymUnmanagedMethod>& method)
+    {
+        ASSERT_EQ(S_OK, reader->GetMethod(token, &method));
+    }
+
+    mdMethodDef GetToken(ISymUnmanagedMethod* method)
+    {
+        mdMethodDef token = mdMethodDefNil;
+        EXPECT_EQ(S_OK, method->GetToken(&token));
+        return token;
+    }
+
+    std::vector<WSTR_string> GetNamespaceNames(ULONG32 count, ISymUnmanagedNamespace* namespaces[])
+    {
+        std::vector<WSTR_string> names;
+        for (ULONG32 i = 0; i < count; ++i)
+        {
+            names.push_back(GetName(namespaces[i]));
+            (void)namespaces[i]->Release();
+        }
+        return names;
+    }
+
+    // {3F5162F8-07C6-11D3-9053-00C04FA302A1}
+    constexpr GUID LanguageCSharp = { 0x3f5162f8, 0x07c6, 0x11d3, { 0x90, 0x53, 0x00, 0xc0, 0x4f, 0xa3, 0x02, 0xa1 } };
+
+    // {8829D00F-11B8-4213-878B-770E8597AC16}
+    constexpr GUID HashAlgorithmSha256 = { 0x8829d00f, 0x11b8, 0x4213, { 0x87, 0x8b, 0x77, 0x0e, 0x85, 0x97, 0xac, 0x16 } };
+
+    constexpr ULONG32 HiddenLine = 0xfeefee;
+}
+
+TEST(SymReader, GetDocuments)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    ULONG32 count;
+    ASSERT_EQ(S_OK, reader->GetDocuments(0, &count, nullptr));
+    ASSERT_EQ(3u, count);
+
+    std::array<ISymUnmanagedDocument*, 3> documents;
+    ASSERT_EQ(S_OK, reader->GetDocuments((ULONG32)documents.size(), &count, documents.data()));
+    ASSERT_EQ(3u, count);
+
+    std::array<WSTR_string, 3> urls = { W("/src/Program.cs"), W("/src/Sub/Helpers.cs"), W("/src/Generated.cs") };
+    for (size_t i = 0; i < documents.size(); ++i)
+    {
+        EXPECT_EQ(urls[i], GetURL(documents[i]));
+
+        GUID language;
+        EXPECT_EQ(S_OK, documents[i]->GetLanguage(&language));
+        EXPECT_EQ(LanguageCSharp, language);
+        (void)documents[i]->Release();
+    }
+}
+
+TEST(SymReader, GetDocument)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> document;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Program.cs"), document));
+    EXPECT_EQ(W("/src/Program.cs"), GetURL(document));
+
+    GUID algorithm;
+    ASSERT_EQ(S_OK, document->GetCheckSumAlgorithmId(&algorithm));
+    EXPECT_EQ(HashAlgorithmSha256, algorithm);
+
+    ULONG32 length;
+    ASSERT_EQ(S_OK, document->GetCheckSum(0, &length, nullptr));
+    ASSERT_EQ(32u, length);
+    std::array<BYTE, 32> checksum;
+    ASSERT_EQ(S_OK, document->GetCheckSum((ULONG32)checksum.size(), &length, checksum.data()));
+    EXPECT_EQ(0xac, checksum[0]);
+    EXPECT_EQ(0xea, checksum[1]);
+    EXPECT_EQ(0xf3, checksum[2]);
+    EXPECT_EQ(0xbd, checksum[3]);
+
+    // Paths are also matched without case.
+    dncp::com_ptr<ISymUnmanagedDocument> ignoreCase;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/SRC/program.cs"), ignoreCase));
+    EXPECT_EQ(W("/src/Program.cs"), GetURL(ignoreCase));
+
+    dncp::com_ptr<ISymUnmanagedDocument> missing;
+    EXPECT_EQ(S_FALSE, reader->GetDocument(const_cast<WCHAR*>(W("/src/Missing.cs")), GUID{}, GUID{}, GUID{}, &missing));
+    EXPECT_EQ(nullptr, missing);
+}
+
+TEST(SymReader, EmbeddedSource)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> helpers;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Sub/Helpers.cs"), helpers));
+
+    BOOL hasSource;
+    ASSERT_EQ(S_OK, helpers->HasEmbeddedSource(&hasSource));
+    EXPECT_TRUE(hasSource);
+
+    ULONG32 length;
+    ASSERT_EQ(S_OK, helpers->GetSourceLength(&length));
+    EXPECT_EQ(147u, length);
+
+    // The source is returned as stored, a 4-byte uncompressed size followed by the deflated text.
+    std::vector<BYTE> source(length);
+    ULONG32 read;
+    EXPECT_EQ(E_INVALIDARG, helpers->GetSourceRange(1, 1, 2, 1, length, &read, source.data()));
+    EXPECT_EQ(E_NOT_SUFFICIENT_BUFFER, helpers->GetSourceRange(0, 0, INT32_MAX, INT32_MAX, length - 1, &read, source.data()));
+    ASSERT_EQ(S_OK, helpers->GetSourceRange(0, 0, INT32_MAX, INT32_MAX, length, &read, source.data()));
+    EXPECT_EQ(147u, read);
+    EXPECT_EQ(0xe1, source[0]);
+    EXPECT_EQ(0x00, source[1]);
+    EXPECT_EQ(0x00, source[2]);
+    EXPECT_EQ(0x00, source[3]);
+
+    dncp::com_ptr<ISymUnmanagedDocument> program;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Program.cs"), program));
+    ASSERT_EQ(S_OK, program->HasEmbeddedSource(&hasSource));
+    EXPECT_FALSE(hasSource);
+    ASSERT_EQ(S_OK, program->GetSourceLength(&length));
+    EXPECT_EQ(0u, length);
+}
+
+TEST(SymReader, GetUserEntryPoint)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    mdMethodDef entryPoint;
+    ASSERT_EQ(S_OK, reader->GetUserEntryPoint(&entryPoint));
+    EXPECT_EQ(MainMethod, entryPoint);
+}
+
+TEST(SymReader, GetSequencePoints)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, HelperMethod, method));
+    EXPECT_EQ(HelperMethod, GetToken(method));
+
+    ULONG32 count;
+    ASSERT_EQ(S_OK, method->GetSequencePointCount(&count));
+    ASSERT_EQ(3u, count);
+
+    std::array<ULONG32, 3> offsets;
+    std::array<ISymUnmanagedDocument*, 3> documents;
+    std::array<ULONG32, 3> lines;
+    std::array<ULONG32, 3> columns;
+    std::array<ULONG32, 3> endLines;
+    std::array<ULONG32, 3> endColumns;
+    ASSERT_EQ(S_OK, method->GetSequencePoints(3, &count, offsets.data(), documents.data(), lines.data(), columns.data(), endLines.data(), endColumns.data()));
+    ASSERT_EQ(3u, count);
+    EXPECT_EQ((std::array<ULONG32, 3>{ 0, 1, 18 }), offsets);
+    EXPECT_EQ((std::array<ULONG32, 3>{ 6, 8, 9 }), lines);
+    EXPECT_EQ((std::array<ULONG32, 3>{ 9, 13, 9 }), columns);
+    EXPECT_EQ((std::array<ULONG32, 3>{ 6, 8, 9 }), endLines);
+    EXPECT_EQ((std::array<ULONG32, 3>{ 10, 44, 10 }), endColumns);
+    for (ISymUnmanagedDocument* document : documents)
+    {
+        EXPECT_EQ(W("/src/Sub/Helpers.cs"), GetURL(document));
+        (void)document->Release();
+    }
+}
+
+TEST(SymReader, GetSequencePointsHiddenAndOtherDocument)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, method));
+
+    ULONG32 count;
+    ASSERT_EQ(S_OK, method->GetSequencePointCount(&count));
+    ASSERT_EQ(14u, count);
+
+    std::vector<ULONG32> offsets(count);
+    std::vector<ISymUnmanagedDocument*> documents(count);
+    std::vector<ULONG32> lines(count);
+    ASSERT_EQ(S_OK, method->GetSequencePoints(count, &count, offsets.data(), documents.data(), lines.data(), nullptr, nullptr, nullptr));
+    ASSERT_EQ(14u, count);
+    EXPECT_EQ((std::vector<ULONG32>{ 0, 1, 3, 5, 7, 8, 12, 16, 17, 21, 26, 29, 34, 58 }), offsets);
+    EXPECT_EQ((std::vector<ULONG32>{ 10, 11, 12, HiddenLine, 13, 14, 15, 16, 12, 12, HiddenLine, 100, 22, 23 }), lines);
+    EXPECT_EQ(W("/src/Generated.cs"), GetURL(documents[11]));
+    EXPECT_EQ(W("/src/Program.cs"), GetURL(documents[12]));
+    for (ISymUnmanagedDocument* document : documents)
+        (void)document->Release();
+
+    // Methods without sequence points are still found.
+    dncp::com_ptr<ISymUnmanagedMethod> runAsync;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, RunAsyncMethod, runAsync));
+    ASSERT_EQ(S_OK, runAsync->GetSequencePointCount(&count));
+    EXPECT_EQ(0u, count);
+}
+
+TEST(SymReader, GetSourceStartEnd)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MoveNextMethod, method));
+
+    std::array<ISymUnmanagedDocument*, 2> documents;
+    std::array<ULONG32, 2> lines;
+    std::array<ULONG32, 2> columns;
+    BOOL found;
+    ASSERT_EQ(S_OK, method->GetSourceStartEnd(documents.data(), lines.data(), columns.data(), &found));
+    ASSERT_TRUE(found);
+    EXPECT_EQ((std::array<ULONG32, 2>{ 26, 30 }), lines);
+    EXPECT_EQ((std::array<ULONG32, 2>{ 9, 10 }), columns);
+    for (ISymUnmanagedDocument* document : documents)
+    {
+        EXPECT_EQ(W("/src/Program.cs"), GetURL(document));
+        (void)document->Release();
+    }
+
+    dncp::com_ptr<ISymUnmanagedMethod> runAsync;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, RunAsyncMethod, runAsync));
+    ASSERT_EQ(S_OK, runAsync->GetSourceStartEnd(nullptr, lines.data(), nullptr, &found));
+    EXPECT_FALSE(found);
+}
+
+TEST(SymReader, GetMethodFromDocumentPosition)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> program;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Program.cs"), program));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_EQ(S_OK, reader->GetMethodFromDocumentPosition(program, 14, 0, &method));
+    EXPECT_EQ(MainMethod, GetToken(method));
+
+    // Lines between sequence points belong to the method that spans them.
+    method.Release();
+    ASSERT_EQ(S_OK, reader->GetMethodFromDocumentPosition(program, 18, 0, &method));
+    EXPECT_EQ(MainMethod, GetToken(method));
+
+    // The body of an async method is in its state machine.
+    method.Release();
+    ASSERT_EQ(S_OK, reader->GetMethodFromDocumentPosition(program, 27, 0, &method));
+    EXPECT_EQ(MoveNextMethod, GetToken(method));
+
+    method.Release();
+    EXPECT_EQ(E_FAIL, reader->GetMethodFromDocumentPosition(program, 5, 0, &method));
+    EXPECT_EQ(nullptr, method);
+
+    dncp::com_ptr<ISymUnmanagedDocument> generated;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Generated.cs"), generated));
+    ASSERT_EQ(S_OK, reader->GetMethodFromDocumentPosition(generated, 100, 0, &method));
+    EXPECT_EQ(MainMethod, GetToken(method));
+}
+
+TEST(SymReader, GetMethodsFromDocumentPosition)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> helpers;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Sub/Helpers.cs"), helpers));
+
+    ULONG32 count;
+    ASSERT_EQ(S_OK, reader->GetMethodsFromDocumentPosition(helpers, 8, 0, 0, &count, nullptr));
+    ASSERT_EQ(1u, count);
+
+    ISymUnmanagedMethod* method;
+    ASSERT_EQ(S_OK, reader->GetMethodsFromDocumentPosition(helpers, 8, 0, 1, &count, &method));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(HelperMethod, GetToken(method));
+    (void)method->Release();
+
+    ASSERT_EQ(S_OK, reader->GetMethodsFromDocumentPosition(helpers, 2, 0, 0, &count, nullptr));
+    EXPECT_EQ(0u, count);
+}
+
+TEST(SymReader, FindClosestLine)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> program;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Program.cs"), program));
+
+    ULONG32 line;
+    ASSERT_EQ(S_OK, program->FindClosestLine(12, &line));
+    EXPECT_EQ(12u, line);
+    ASSERT_EQ(S_OK, program->FindClosestLine(17, &line));
+    EXPECT_EQ(22u, line);
+    ASSERT_EQ(S_OK, program->FindClosestLine(1, &line));
+    EXPECT_EQ(10u, line);
+    EXPECT_EQ(E_FAIL, program->FindClosestLine(31, &line));
+}
+
+TEST(SymReader, GetOffsetAndRanges)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedDocument> program;
+    ASSERT_NO_FATAL_FAILURE(GetDocument(reader, W("/src/Program.cs"), program));
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, method));
+
+    ULONG32 offset;
+    ASSERT_EQ(S_OK, method->GetOffset(program, 14, 0, &offset));
+    EXPECT_EQ(8u, offset);
+    ASSERT_EQ(S_OK, method->GetOffset(program, 12, 0, &offset));
+    EXPECT_EQ(3u, offset);
+    EXPECT_EQ(E_FAIL, method->GetOffset(program, 18, 0, &offset));
+
+    // The for statement on line 12 has its initializer, condition and increment at different offsets.
+    ULONG32 count;
+    ASSERT_EQ(S_OK, method->GetRanges(program, 12, 0, 0, &count, nullptr));
+    ASSERT_EQ(6u, count);
+    std::array<ULONG32, 6> ranges;
+    ASSERT_EQ(S_OK, method->GetRanges(program, 12, 0, (ULONG32)ranges.size(), &count, ranges.data()));
+    ASSERT_EQ(6u, count);
+    EXPECT_EQ((std::array<ULONG32, 6>{ 3, 5, 17, 21, 21, 26 }), ranges);
+
+    // The last sequence point covers the IL up to the end of the method.
+    std::array<ULONG32, 2> last;
+    ASSERT_EQ(S_OK, method->GetRanges(program, 23, 0, (ULONG32)last.size(), &count, last.data()));
+    ASSERT_EQ(2u, count);
+    EXPECT_EQ((std::array<ULONG32, 2>{ 58, 61 }), last);
+
+    // A buffer for one range only returns the first range.
+    ASSERT_EQ(S_OK, method->GetRanges(program, 12, 0, (ULONG32)last.size(), &count, last.data()));
+    ASSERT_EQ(2u, count);
+    EXPECT_EQ((std::array<ULONG32, 2>{ 3, 5 }), last);
+}
+
+TEST(SymReader, GetScopesAndLocals)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, method));
+
+    dncp::com_ptr<ISymUnmanagedScope> root;
+    ASSERT_EQ(S_OK, method->GetRootScope(&root));
+
+    ULONG32 offset;
+    ASSERT_EQ(S_OK, root->GetStartOffset(&offset));
+    EXPECT_EQ(0u, offset);
+    ASSERT_EQ(S_OK, root->GetEndOffset(&offset));
+    EXPECT_EQ(61u, offset);
+
+    ULONG32 count;
+    ISymUnmanagedVariable* sum;
+    ASSERT_EQ(S_OK, root->GetLocals(1, &count, &sum));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(W("sum"), GetName(sum));
+
+    // The type of the local is read from the local signature in the module.
+    BYTE signature[8];
+    ULONG32 signatureLength;
+    ASSERT_EQ(S_OK, sum->GetSignature((ULONG32)sizeof(signature), &signatureLength, signature));
+    ASSERT_EQ(1u, signatureLength);
+    EXPECT_EQ(ELEMENT_TYPE_I4, signature[0]);
+    (void)sum->Release();
+
+    // The innermost scope at an offset.
+    dncp::com_ptr<ISymUnmanagedScope> inner;
+    ASSERT_EQ(S_OK, method->GetScopeFromOffset(10, &inner));
+    ASSERT_EQ(S_OK, inner->GetStartOffset(&offset));
+    EXPECT_EQ(7u, offset);
+    ASSERT_EQ(S_OK, inner->GetEndOffset(&offset));
+    EXPECT_EQ(17u, offset);
+
+    ISymUnmanagedVariable* square;
+    ASSERT_EQ(S_OK, inner->GetLocals(1, &count, &square));
+    ASSERT_EQ(1u, count);
+    EXPECT_EQ(W("square"), GetName(square));
+    ULONG32 slot;
+    ASSERT_EQ(S_OK, square->GetAddressField1(&slot));
+    EXPECT_EQ(2u, slot);
+    (void)square->Release();
+}
+
+TEST(SymReader, GetSignatureWithoutImporter)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(nullptr, reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, method));
+    dncp::com_ptr<ISymUnmanagedScope> root;
+    ASSERT_EQ(S_OK, method->GetRootScope(&root));
+
+    ULONG32 count;
+    ISymUnmanagedVariable* sum;
+    ASSERT_EQ(S_OK, root->GetLocals(1, &count, &sum));
+    ASSERT_EQ(1u, count);
+
+    ULONG32 signatureLength;
+    EXPECT_EQ(E_FAIL, sum->GetSignature(0, &signatureLength, nullptr));
+    (void)sum->Release();
+
+    dncp::com_ptr<ISymUnmanagedNamespace> ns;
+    EXPECT_EQ(E_FAIL, method->GetNamespace(&ns));
+}
+
+TEST(SymReader, GetNamespaces)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    // Project level imports are the only global namespaces.
+    ULONG32 count;
+    ASSERT_EQ(S_OK, reader->GetNamespaces(0, &count, nullptr));
+    EXPECT_EQ(0u, count);
+
+    dncp::com_ptr<ISymUnmanagedMethod> method;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, method));
+
+    // The using directives of Program.cs, without the alias.
+    dncp::com_ptr<ISymUnmanagedScope> root;
+    ASSERT_EQ(S_OK, method->GetRootScope(&root));
+    ASSERT_EQ(S_OK, root->GetNamespaces(0, &count, nullptr));
+    ASSERT_EQ(2u, count);
+    std::array<ISymUnmanagedNamespace*, 2> namespaces;
+    ASSERT_EQ(S_OK, root->GetNamespaces((ULONG32)namespaces.size(), &count, namespaces.data()));
+    EXPECT_EQ((std::vector<WSTR_string>{ W("System"), W("System.Threading.Tasks") }), GetNamespaceNames(count, namespaces.data()));
+
+    // Helpers.cs has no using directives.
+    dncp::com_ptr<ISymUnmanagedMethod> helper;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, HelperMethod, helper));
+    dncp::com_ptr<ISymUnmanagedScope> helperRoot;
+    ASSERT_EQ(S_OK, helper->GetRootScope(&helperRoot));
+    ASSERT_EQ(S_OK, helperRoot->GetNamespaces(0, &count, nullptr));
+    EXPECT_EQ(0u, count);
+}
+
+TEST(SymReader, GetMethodNamespace)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    dncp::com_ptr<ISymUnmanagedMethod> main;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MainMethod, main));
+    dncp::com_ptr<ISymUnmanagedNamespace> ns;
+    ASSERT_EQ(S_OK, main->GetNamespace(&ns));
+    EXPECT_EQ(W("PdbTest"), GetName(ns.p));
+
+    // The state machine is nested in Program.
+    dncp::com_ptr<ISymUnmanagedMethod> moveNext;
+    ASSERT_NO_FATAL_FAILURE(GetMethod(reader, MoveNextMethod, moveNext));
+    dncp::com_ptr<ISymUnmanagedNamespace> nestedNs;
+    ASSERT_EQ(S_OK, moveNext->GetNamespace(&nestedNs));
+    EXPECT_EQ(W("PdbTest"), GetName(nestedNs.p));
+}
+
+TEST(SymReader, GetSymAttribute)
+{
+    dncp::com_ptr<ISymUnmanagedReader> reader;
+    ASSERT_NO_FATAL_FAILURE(CreateReader(reader));
+
+    ULONG32 length;
+    EXPECT_EQ(S_FALSE, reader->GetSymAttribute(MainMethod, const_cast<WCHAR*>(W("MD2")), 0, &length, nullptr));
+    EXPECT_EQ(0u, length);
+}